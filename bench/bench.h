@@ -0,0 +1,101 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+
+#include "workshop_esp.h"
+
+// Minimal benchmark harness for the host build. A case runs its body
+// `iterations` times; the runner picks the count, repeats the measurement
+// and reports the median ns/op plus heap allocations per op (NativeHeap
+// counts String buffers, malloc and every operator new).
+
+typedef void (*BenchFunction)(uint32_t iterations);
+
+struct BenchCase {
+  const char *name;
+  BenchFunction run;
+  BenchCase *next;
+};
+
+struct BenchRegistrar {
+  explicit BenchRegistrar(BenchCase &entry);
+};
+
+#define BENCH(name)                                                            \
+  static void bench_##name(uint32_t iterations);                               \
+  static BenchCase benchCase_##name = {#name, bench_##name, nullptr};          \
+  static BenchRegistrar benchRegistrar_##name(benchCase_##name);               \
+  static void bench_##name(uint32_t iterations)
+
+BenchCase *benchCases();
+
+// Keeps the optimiser from discarding a result
+template <typename T> inline void benchKeep(const T &value) {
+  asm volatile("" : : "g"(&value) : "memory");
+}
+
+// Shared WorkshopESP with LEDs and routes set up (serial muted)
+WorkshopESP &benchWorkshop();
+
+// Runs one request through the routing table and resets the request arena
+// like handleClient() does; returns the status code
+int benchRequest(HTTPMethod method, const char *uri,
+                 const char *body = nullptr);
+
+// One line per check, "ok" or "FAILED"; a run*Check() calls
+// benchCheckStart() first and returns benchCheckEnd() with its name
+void expect(bool ok, const char *what);
+void benchCheckStart();
+// Prints "<name> CHECK OK" or "<name> CHECK FAILED"; the exit code
+int benchCheckEnd(const char *name);
+
+// Heap soak: `requests` mixed dashboard requests, fails if the largest
+// free block shrinks
+int runSoak(uint32_t requests);
+
+// /api/status?fields= with every long name in several orders, and lists
+// too long or with unknown names rejected
+int runStatusCheck();
+
+// Heap after a sketch's setup() with WorkshopESP's embedded server and
+// display against the old constructor-allocated layout
+int runStartupHeapCheck();
+
+// Bus time per loop tick of the sliced display flush against one blocking
+// display(), at several I2C clocks; fails if a tick overruns its budget
+int runDisplayCheck();
+
+// Text through GlyphCache against Adafruit_GFX: same pixels, and pixels
+// per microsecond for each text size
+int runGlyphCheck();
+
+// Sparkline frames at 30 fps in both modes: bus time per frame, panel
+// contents, and incremental columns against a full redraw
+int runPlotCheck();
+
+// Sensor filter stages: step and spike responses against what each stage
+// promises, then ns and cycles per sample for each stage and two chains
+int runFilterCheck();
+
+// Analog-to-LED bindings configured over the API: latency from a reading
+// to the LED, curves, switch hysteresis, no allocations while sampling
+int runBindingCheck();
+
+// Event bus: delivery by type, changes during dispatch, no allocations,
+// the events WorkshopESP and HttpServer publish, then ns per event and per
+// subscriber
+int runEventCheck();
+
+// Seqlock<SampleState> with a writer thread in place of an ISR and reader
+// threads: no torn or stale copies, write cost, and how often a plain
+// copy tears; then WorkshopESP's snapshots against its LEDs and readings
+int runSeqlockCheck();
+
+// WorkshopESP's animations on a HeadlessDisplay: frames, bus bytes and bus
+// time per animation; final frames against bench/golden/ (rewritten
+// instead with `updateGolden`), PBM and GIF exports into `outDir` if given
+int runFrameReport(const char *outDir, bool updateGolden);
+
+#endif
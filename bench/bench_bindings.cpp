@@ -0,0 +1,254 @@
+// --bindings: analog-to-LED bindings set up over /api/bindings, driven
+// from a fake A0 on the virtual clock. Checks the latency from a new
+// reading to the LED, with a quick loop and with one that blocks, the
+// curves, switch hysteresis and that sampling never allocates; binding_*
+// cases time the sampling path.
+
+#include <algorithm>
+
+#include "bench.h"
+#include "native_hal.h"
+#include "native_heap.h"
+
+namespace {
+
+std::string request(HTTPMethod method, const char *uri, int *code) {
+  std::string body = benchWorkshop().httpServer().simulateRequest(
+      method, uri, nullptr, code);
+  benchWorkshop().arena().reset();
+  return body;
+}
+
+bool configured(const char *query) {
+  int code = 0;
+  std::string uri = std::string("/api/bindings?") + query;
+  request(HTTP_POST, uri.c_str(), &code);
+  return code == 200;
+}
+
+const uint32_t PERIOD = WORKSHOP_BINDING_PERIOD_US;
+
+// Runs the loop in `step` us iterations until `done`, for at most 200 of
+// them; false if it never was. `took` is the time it took.
+template <typename Done>
+bool loopUntil(Done done, uint32_t &took, uint32_t step = 50) {
+  uint32_t start = micros();
+  for (int i = 0; i < 200; i++) {
+    benchWorkshop().handleClient();
+    took = micros() - start;
+    if (done())
+      return true;
+    NativeHal::advanceMicros(step);
+  }
+  return false;
+}
+
+// Nothing wired up; for bindings only read back
+void ignoreOutput(void *, const AnalogBindings::Binding &, uint16_t) {}
+
+void checkApi() {
+  printf("API\n");
+  expect(configured("led=1&mode=level&curve=custom&points=0,0,0,0,0,0,0,0,"
+                    "512,1023,1023,1023,1023,1023,1023,1023,1023"),
+         "led 1 level, custom curve");
+  expect(configured("led=1&mode=level&curve=gamma"), "led 1 level, gamma");
+  expect(configured("led=2&mode=switch&on=600&off=400"),
+         "led 2 switch on at 600, off at 400");
+  const char *rejected[] = {
+      "led=3&mode=level",
+      "led=1&mode=blink",
+      "led=1&mode=level&curve=steep",
+      "led=2&mode=switch&on=400&off=600",
+      "led=2&mode=switch&on=600",
+      "led=1&mode=level&curve=custom&points=0,512,1023",
+      "led=1&mode=level&curve=custom&points=0,64,128,192,256,320,384,448,"
+      "512,576,640,704,768,832,896,960,2000",
+  };
+  bool all = true;
+  for (const char *query : rejected)
+    all &= !configured(query);
+  expect(all, "bad LEDs, modes, curves, thresholds and points get 400");
+
+  int code = 0;
+  std::string json = request(HTTP_GET, "/api/bindings", &code);
+  bool listed = code == 200 && json.find("\"curve\":\"gamma\"") !=
+                                   std::string::npos &&
+                json.find("\"on\":600,\"off\":400") != std::string::npos;
+  expect(listed, "GET lists both, a rejected change left them alone");
+}
+
+// Worst time from a step at A0 to LED 1's PWM value, `step` us per loop
+bool levelLatency(uint32_t step, uint32_t &worst) {
+  const uint16_t steps[] = {0, 1023, 300, 700, 512, 0, 1023};
+  worst = 0;
+  bool all = true;
+  for (uint16_t input : steps) {
+    NativeHal::setAnalogValue(A0, input);
+    int expected = AnalogBindings::curveValue(
+        benchWorkshop().analogBindings().find(1)->points, input);
+    uint32_t took = 0;
+    all &= loopUntil([&]() { return NativeHal::pwmValue(D2) == expected; },
+                     took, step);
+    worst = std::max(worst, took);
+  }
+  return all;
+}
+
+void checkLatency() {
+  printf("Latency, %u us period\n", (unsigned)PERIOD);
+  // A sketch's loop() doing nothing else: one period, plus a step
+  uint32_t worst = 0;
+  bool all = levelLatency(50, worst);
+  char what[64];
+  snprintf(what, sizeof(what), "50 us loop: reading to LED level in %u us",
+           (unsigned)worst);
+  expect(all && worst <= PERIOD + 50, what);
+
+  // The switch follows a crossing just as fast
+  uint32_t took = 0;
+  NativeHal::setAnalogValue(A0, 300);
+  loopUntil([]() { return !benchWorkshop().getLEDState(2); }, took);
+  NativeHal::setAnalogValue(A0, 650);
+  bool switched =
+      loopUntil([]() { return benchWorkshop().getLEDState(2); }, took);
+  snprintf(what, sizeof(what), "50 us loop: crossing to switch in %u us",
+           (unsigned)took);
+  expect(switched && took <= PERIOD + 50 &&
+             NativeHal::digitalState(D3) == HIGH,
+         what);
+
+  // A loop that blocks for a 30 ms frame between calls: the bound is the
+  // period plus the longest gap, not the period
+  const uint32_t frame = 30000;
+  all = levelLatency(frame, worst);
+  snprintf(what, sizeof(what), "%u ms loop: reading to LED level in %u us",
+           (unsigned)(frame / 1000), (unsigned)worst);
+  expect(all && worst <= PERIOD + frame && worst >= frame, what);
+}
+
+void checkCurves() {
+  printf("Curves\n");
+  uint16_t linear[AnalogBindings::CURVE_POINTS];
+  uint16_t gamma[AnalogBindings::CURVE_POINTS];
+  AnalogBindings probe;
+  probe.setOutputHandler(ignoreOutput, nullptr);
+  probe.bindLevel(1, A0, AnalogBindings::CURVE_LINEAR);
+  probe.bindLevel(2, A0, AnalogBindings::CURVE_GAMMA);
+  memcpy(linear, probe.find(1)->points, sizeof(linear));
+  memcpy(gamma, probe.find(2)->points, sizeof(gamma));
+
+  bool identity = true, monotonic = true;
+  uint16_t previous = 0;
+  for (uint16_t x = 0; x <= AnalogBindings::INPUT_MAX; x++) {
+    identity &= abs(AnalogBindings::curveValue(linear, x) - x) <= 1;
+    uint16_t y = AnalogBindings::curveValue(gamma, x);
+    monotonic &= y >= previous;
+    previous = y;
+  }
+  expect(identity, "linear is the input within 1");
+  expect(monotonic && AnalogBindings::curveValue(gamma, 0) == 0 &&
+             AnalogBindings::curveValue(gamma, 1023) == 1023,
+         "gamma rises from 0 to 1023");
+}
+
+void checkHysteresis() {
+  printf("Switch hysteresis\n");
+  // Up and down through both thresholds with +-40 of noise
+  uint32_t took = 0;
+  NativeHal::setAnalogValue(A0, 200);
+  loopUntil([]() { return !benchWorkshop().getLEDState(2); }, took);
+  uint32_t state = 1;
+  uint32_t changes = 0;
+  bool on = false;
+  for (int pass = 0; pass < 2; pass++) {
+    for (int level = 200; level <= 800; level += 2) {
+      state = state * 1103515245u + 12345u;
+      int noise = (int)((state >> 16) % 81) - 40;
+      int input = pass == 0 ? level : 1000 - level;
+      NativeHal::setAnalogValue(A0, input + noise);
+      benchWorkshop().handleClient();
+      NativeHal::advanceMicros(PERIOD);
+      if (benchWorkshop().getLEDState(2) != on) {
+        on = !on;
+        changes++;
+      }
+    }
+  }
+  char what[64];
+  snprintf(what, sizeof(what), "%u switches for one rise and one fall",
+           (unsigned)changes);
+  expect(changes == 2, what);
+}
+
+void checkHeap() {
+  printf("Heap\n");
+  AnalogBindings &bindings = benchWorkshop().analogBindings();
+  NativeHeap::Stats before = NativeHeap::stats();
+  for (int i = 0; i < 10000; i++) {
+    NativeHal::setAnalogValue(A0, (i * 37) % 1024);
+    bindings.tick();
+    NativeHal::advanceMicros(PERIOD);
+  }
+  NativeHeap::Stats after = NativeHeap::stats();
+  expect(after.allocations == before.allocations,
+         "10000 samples, no allocations");
+}
+
+} // namespace
+
+int runBindingCheck() {
+  benchCheckStart();
+  NativeHal::useVirtualClock(true);
+  benchWorkshop();
+  checkApi();
+  checkLatency();
+  checkCurves();
+  checkHysteresis();
+  checkHeap();
+  configured("led=1&mode=off");
+  configured("led=2&mode=off");
+  NativeHal::useVirtualClock(false);
+
+  return benchCheckEnd("BINDING");
+}
+
+namespace {
+
+int sweep(uint8_t pin) {
+  static int value = 0;
+  (void)pin;
+  value = (value + 37) % 1024;
+  return value;
+}
+
+void writePin(void *, const AnalogBindings::Binding &binding,
+              uint16_t value) {
+  if (binding.mode == AnalogBindings::MODE_LEVEL)
+    analogWrite(binding.output, value);
+  else
+    digitalWrite(binding.output, value != 0 ? HIGH : LOW);
+}
+
+} // namespace
+
+// One sample through a gamma level binding and a switch, outputs written
+// to pins
+BENCH(binding_sample) {
+  static AnalogBindings bindings;
+  bindings.setOutputHandler(writePin, nullptr);
+  bindings.setPeriodMicros(0);
+  bindings.bindLevel(D2, A0, AnalogBindings::CURVE_GAMMA);
+  bindings.bindSwitch(D3, A0, 600, 400);
+  NativeHal::setAnalogSource(sweep);
+  for (uint32_t i = 0; i < iterations; i++)
+    bindings.tick();
+  NativeHal::setAnalogSource(nullptr);
+}
+
+BENCH(binding_curve_value) {
+  static uint16_t points[AnalogBindings::CURVE_POINTS];
+  for (uint8_t i = 0; i < AnalogBindings::CURVE_POINTS; i++)
+    points[i] = i * 63;
+  for (uint32_t i = 0; i < iterations; i++)
+    benchKeep(AnalogBindings::curveValue(points, i & 1023));
+}
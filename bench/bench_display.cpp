@@ -0,0 +1,364 @@
+// Display rendering: GFX text into the framebuffer and the I2C flush,
+// plus the --display check of the sliced flush's per-tick bus time and
+// the --glyphs comparison of cached glyphs against GFX, and the --plot
+// check of the sparkline's bus time per frame
+
+#include <chrono>
+#include <math.h>
+
+#include "bench.h"
+#include "headless_display.h"
+#include "sparkline.h"
+#include "workshop_strings.h"
+
+namespace {
+
+Adafruit_SSD1306 &panel() {
+  static Adafruit_SSD1306 oled(128, 64, &Wire, -1);
+  static bool ready = oled.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  (void)ready;
+  return oled;
+}
+
+DisplayFlusher &flusher() {
+  static DisplayFlusher slices;
+  if (!slices.isAttached())
+    slices.attach(&Wire, 0x3C, panel().getBuffer());
+  return slices;
+}
+
+// Different text on every page, so no page can be skipped
+void drawFrame(Adafruit_SSD1306 &oled, uint32_t frame) {
+  oled.clearDisplay();
+  oled.setTextSize(1);
+  oled.setTextColor(SSD1306_WHITE);
+  for (int line = 0; line < 8; line++) {
+    oled.setCursor(0, line * 8);
+    oled.print(frame + line);
+  }
+}
+
+} // namespace
+
+BENCH(display_status_screen) {
+  WorkshopESP &workshop = benchWorkshop();
+  for (uint32_t i = 0; i < iterations; i++) {
+    workshop.displayStatus();
+  }
+}
+
+BENCH(display_message) {
+  WorkshopESP &workshop = benchWorkshop();
+  for (uint32_t i = 0; i < iterations; i++) {
+    workshop.displayMessage("Ready for Workshop!", (i & 1) != 0);
+  }
+}
+
+BENCH(gfx_text_line) {
+  Adafruit_SSD1306 &oled = panel();
+  oled.setTextSize(1);
+  oled.setTextColor(SSD1306_WHITE);
+  for (uint32_t i = 0; i < iterations; i++) {
+    oled.setCursor(0, 0);
+    oled.print("Uptime: 12345 s");
+  }
+}
+
+BENCH(gfx_clear) {
+  Adafruit_SSD1306 &oled = panel();
+  for (uint32_t i = 0; i < iterations; i++) {
+    oled.clearDisplay();
+  }
+}
+
+BENCH(ssd1306_flush) {
+  Adafruit_SSD1306 &oled = panel();
+  for (uint32_t i = 0; i < iterations; i++) {
+    oled.display();
+  }
+}
+
+BENCH(display_present_frame) {
+  Adafruit_SSD1306 &oled = panel();
+  DisplayFlusher &slices = flusher();
+  for (uint32_t i = 0; i < iterations; i++) {
+    drawFrame(oled, i);
+    slices.present();
+    slices.finish();
+  }
+}
+
+BENCH(display_present_unchanged) {
+  DisplayFlusher &slices = flusher();
+  slices.finish();
+  for (uint32_t i = 0; i < iterations; i++) {
+    slices.present(); // compares pages, sends nothing
+  }
+}
+
+BENCH(display_tick) {
+  Adafruit_SSD1306 &oled = panel();
+  DisplayFlusher &slices = flusher();
+  for (uint32_t i = 0; i < iterations; i++) {
+    if (!slices.isBusy()) {
+      drawFrame(oled, i);
+      slices.present();
+    }
+    slices.tick();
+  }
+}
+
+int runDisplayCheck() {
+  Adafruit_SSD1306 &oled = panel();
+  DisplayFlusher &slices = flusher();
+  slices.finish();
+  HeadlessDisplay model; // the panel, decoded from the bus traffic
+  model.listen();
+
+  printf("%8s %10s %8s %10s %12s\n", "clock", "display()", "ticks",
+         "worst tick", "budget");
+  bool failed = false;
+  const uint32_t clocks[] = {100000, 400000, 1000000};
+  for (uint32_t clock : clocks) {
+    // Blocking flush at the same clock for reference
+    Adafruit_SSD1306 blocking(128, 64, &Wire, -1, clock);
+    blocking.begin(SSD1306_SWITCHCAPVCC, 0x3D); // not the modelled panel
+    Wire.resetStats();
+    blocking.display();
+    uint64_t whole = Wire.busMicros();
+
+    // Re-attaching forgets the panel contents: a full frame goes out
+    slices.attach(&Wire, 0x3C, oled.getBuffer());
+    slices.setBusSpeed(clock);
+    drawFrame(oled, clock);
+    slices.present();
+    uint32_t ticks = 0;
+    uint64_t worst = 0;
+    while (slices.isBusy()) {
+      Wire.resetStats();
+      slices.tick();
+      ticks++;
+      if (Wire.busMicros() > worst)
+        worst = Wire.busMicros();
+    }
+
+    // One transaction always goes, even if it alone exceeds the budget
+    uint32_t floor = DisplayFlusher::transferMicros(DisplayFlusher::CHUNK + 1,
+                                                    clock) +
+                     DisplayFlusher::transferMicros(7, clock);
+    uint32_t limit = std::max(slices.tickBudget(), floor);
+    bool over = worst > limit;
+    bool wrong = !model.showing(oled.getBuffer());
+    printf("%8u %8llu us %8u %7llu us %9u us%s%s\n", clock,
+           (unsigned long long)whole, ticks, (unsigned long long)worst,
+           slices.tickBudget(), over ? "  OVER" : "",
+           wrong ? "  PANEL DIFFERS" : "");
+    failed |= over || wrong;
+  }
+  slices.setBusSpeed(WORKSHOP_I2C_CLOCK);
+
+  // Scattered small changes: only their column spans go out, and the
+  // panel still ends up equal to the framebuffer
+  uint64_t before = Wire.bytesSent();
+  const uint32_t frames = 200;
+  for (uint32_t i = 0; i < frames; i++) {
+    oled.drawPixel((i * 37) % 128, (i * 11) % 64, SSD1306_INVERSE);
+    oled.drawPixel((i * 53) % 128, (i * 29) % 64, SSD1306_INVERSE);
+    slices.present();
+    slices.finish();
+    if (!model.showing(oled.getBuffer())) {
+      printf("panel differs after sparse frame %u\n", i);
+      failed = true;
+      break;
+    }
+  }
+  printf("two changed pixels per frame: %.1f bus bytes per frame\n",
+         (double)(Wire.bytesSent() - before) / frames);
+
+  printf(failed ? "DISPLAY CHECK FAILED\n" : "DISPLAY CHECK OK\n");
+  return failed ? 1 : 0;
+}
+
+BENCH(widget_value_redraw) {
+  Adafruit_SSD1306 &oled = panel();
+  static WidgetScreen ui;
+  static uint8_t uptime = ui.addValue(0, 24, 21, Text::FMT_STATUS_UPTIME.p());
+  for (uint32_t i = 0; i < iterations; i++) {
+    ui.setValue(uptime, i); // one line re-rasterized per op
+    benchKeep(ui.render(oled));
+  }
+}
+
+BENCH(glyph_gfx_text_size3) {
+  Adafruit_SSD1306 &oled = panel();
+  oled.setTextSize(3);
+  oled.setTextColor(SSD1306_WHITE);
+  for (uint32_t i = 0; i < iterations; i++) {
+    oled.setCursor(0, 25);
+    oled.print("Welcome!");
+  }
+}
+
+BENCH(glyph_cache_text_size3) {
+  Adafruit_SSD1306 &oled = panel();
+  static GlyphCache glyphs;
+  for (uint32_t i = 0; i < iterations; i++) {
+    oled.setCursor(0, 25);
+    glyphs.print(oled, "Welcome!", 3);
+  }
+}
+
+int runGlyphCheck() {
+  // Character cells drawn per pass: every size, aligned and unaligned y
+  static const char *const text = "Hello Team 42!";
+  static const int16_t rows[] = {0, 3, 20, 25};
+  Adafruit_SSD1306 gfx(128, 64, &Wire, -1);
+  Adafruit_SSD1306 cached(128, 64, &Wire, -1);
+  gfx.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  cached.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  static GlyphCache glyphs;
+
+  printf("%4s %6s %14s %14s %8s\n", "size", "chars", "GFX px/us",
+         "cache px/us", "speedup");
+  bool failed = false;
+  for (uint8_t size = 1; size <= 3; size++) {
+    // Same output first, including wrapping past the right edge
+    for (int16_t y : rows) {
+      gfx.clearDisplay();
+      cached.clearDisplay();
+      gfx.setTextSize(size);
+      gfx.setTextColor(SSD1306_WHITE);
+      gfx.setCursor(0, y);
+      gfx.print(text);
+      cached.setCursor(0, y);
+      glyphs.print(cached, text, size);
+      if (memcmp(gfx.getBuffer(), cached.getBuffer(), 1024) != 0 ||
+          gfx.getCursorX() != cached.getCursorX() ||
+          gfx.getCursorY() != cached.getCursorY()) {
+        printf("size %u at y %d differs from GFX\n", size, y);
+        failed = true;
+      }
+    }
+
+    const uint32_t passes = 2000;
+    double ns[2];
+    for (int path = 0; path < 2; path++) {
+      Adafruit_SSD1306 &oled = path == 0 ? gfx : cached;
+      auto start = std::chrono::steady_clock::now();
+      for (uint32_t i = 0; i < passes; i++) {
+        oled.setCursor(0, rows[i % 4]);
+        if (path == 0)
+          oled.print(text);
+        else
+          glyphs.print(oled, text, size);
+      }
+      auto end = std::chrono::steady_clock::now();
+      ns[path] = std::chrono::duration<double, std::nano>(end - start).count();
+    }
+    size_t chars = strlen(text);
+    double pixels = (double)passes * chars * 6 * size * 8 * size;
+    printf("%4u %6u %14.1f %14.1f %7.1fx\n", size, (unsigned)chars,
+           pixels / ns[0] * 1000, pixels / ns[1] * 1000, ns[0] / ns[1]);
+  }
+  printf("cache: %u bytes, %u hits, %u misses, %u evictions\n",
+         (unsigned)glyphs.used(), glyphs.hits(), glyphs.misses(),
+         glyphs.evictions());
+
+  printf(failed ? "GLYPH CHECK FAILED\n" : "GLYPH CHECK OK\n");
+  return failed ? 1 : 0;
+}
+
+namespace {
+
+// Pot-like signal: slow sweeps, a burst of fast wobble whose envelope has
+// to show, and a drop to a small range the axis has to shrink to
+int16_t plotSignal(uint32_t sample) {
+  uint32_t phase = sample % 2400;
+  if (phase < 800)
+    return 512 + 400 * sin(sample * 0.01);
+  if (phase < 1600)
+    return 512 + 300 * sin(sample * 0.9);
+  return 200 + 20 * sin(sample * 0.05);
+}
+
+} // namespace
+
+BENCH(sparkline_sweep_frame) {
+  Adafruit_SSD1306 &oled = panel();
+  static Sparkline plot;
+  static bool ready = (plot.begin(0, 1, 128, 7), true);
+  (void)ready;
+  for (uint32_t i = 0; i < iterations; i++) {
+    for (uint32_t s = 0; s < 4; s++)
+      plot.add(plotSignal(i * 4 + s));
+    benchKeep(plot.render(oled));
+  }
+}
+
+int runPlotCheck() {
+  // Layout of the potentiometer example: header on page 0, plot below
+  const uint32_t frameMicros = 1000000 / 30;
+  const uint32_t samplesPerFrame = 4; // 120 Hz sampling, 30 fps
+  const uint32_t frames = 3000;
+  Adafruit_SSD1306 oled(128, 64, &Wire, -1);
+  oled.begin(SSD1306_SWITCHCAPVCC, 0x3C);
+  DisplayFlusher slices;
+  HeadlessDisplay model;
+  model.listen();
+
+  printf("%6s %10s %12s %12s %10s %9s\n", "mode", "rescales", "bus/frame",
+         "worst frame", "ticks", "bus duty");
+  bool failed = false;
+  const Sparkline::Mode modes[] = {Sparkline::SWEEP, Sparkline::SCROLL};
+  for (Sparkline::Mode mode : modes) {
+    const char *name = mode == Sparkline::SWEEP ? "sweep" : "scroll";
+    oled.clearDisplay();
+    slices.attach(&Wire, 0x3C, oled.getBuffer());
+    slices.present();
+    slices.finish();
+    Sparkline plot;
+    plot.begin(0, 1, 128, 7, mode);
+
+    uint64_t total = 0;
+    uint64_t worst = 0;
+    uint32_t ticks = 0;
+    uint8_t incremental[1024];
+    for (uint32_t frame = 0; frame < frames && !failed; frame++) {
+      for (uint32_t s = 0; s < samplesPerFrame; s++)
+        plot.add(plotSignal(frame * samplesPerFrame + s));
+      plot.render(oled);
+
+      // The incremental column must equal drawing the history again
+      memcpy(incremental, oled.getBuffer(), sizeof(incremental));
+      plot.redraw(oled);
+      if (memcmp(incremental, oled.getBuffer(), sizeof(incremental)) != 0) {
+        printf("%s frame %u differs from a full redraw\n", name, frame);
+        failed = true;
+      }
+
+      Wire.resetStats();
+      slices.present();
+      while (slices.tick())
+        ticks++;
+      ticks++;
+      total += Wire.busMicros();
+      if (Wire.busMicros() > worst)
+        worst = Wire.busMicros();
+      if (!model.showing(oled.getBuffer())) {
+        printf("%s frame %u: panel differs\n", name, frame);
+        failed = true;
+      }
+    }
+    // 30 fps holds if even the worst frame (a rescale redraws the whole
+    // plot) fits a frame period on the bus
+    bool slow = worst > frameMicros;
+    printf("%6s %10u %9llu us %9llu us %10.1f %8.0f%%%s\n", name,
+           plot.rescales(), (unsigned long long)(total / frames),
+           (unsigned long long)worst, (double)ticks / frames,
+           100.0 * total / frames / frameMicros, slow ? "  SLOW" : "");
+    failed |= slow;
+  }
+
+  printf(failed ? "PLOT CHECK FAILED\n" : "PLOT CHECK OK\n");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,317 @@
+// --events: the event bus on its own (delivery by type, unsubscribing and
+// publishing from a handler, a full table, no allocations), then the
+// events WorkshopESP and HttpServer publish, then the cost of a publish
+// by number of subscribers. event_publish_* cases time it in the table.
+
+#include <chrono>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+
+#include "bench.h"
+#include "native_hal.h"
+#include "native_heap.h"
+
+namespace {
+
+// Events one subscriber got, by type, and the last of each
+struct Received {
+  uint32_t count[BUS_EVENT_TYPES] = {};
+  BusEvent last[BUS_EVENT_TYPES];
+
+  uint32_t total() const {
+    uint32_t sum = 0;
+    for (uint32_t n : count)
+      sum += n;
+    return sum;
+  }
+};
+
+void record(void *context, const BusEvent &event) {
+  Received *received = static_cast<Received *>(context);
+  received->count[event.type]++;
+  received->last[event.type] = event;
+}
+
+void publishOneOfEach(EventBus &bus) {
+  bus.publish(LedChanged{1, true});
+  bus.publish(SampleReady{A0, 512});
+  bus.publish(WiFiState{true, WL_CONNECTED});
+  bus.publish(ClientEvent{0, true, 0x0100007F});
+}
+
+void checkDelivery() {
+  printf("Delivery\n");
+  EventBus bus;
+  Received leds, samples, state, all;
+  bus.subscribe(busMask(BUS_LED_CHANGED), record, &leds);
+  bus.subscribe(busMask(BUS_SAMPLE_READY), record, &samples);
+  bus.subscribe(busMask(BUS_LED_CHANGED) | busMask(BUS_WIFI_STATE), record,
+                &state);
+  bus.subscribe(0xFF, record, &all);
+  for (int i = 0; i < 10; i++)
+    publishOneOfEach(bus);
+
+  expect(leds.total() == 10 && leds.count[BUS_LED_CHANGED] == 10,
+         "LED subscriber: 10 LED events, nothing else");
+  expect(samples.total() == 10 && samples.count[BUS_SAMPLE_READY] == 10 &&
+             samples.last[BUS_SAMPLE_READY].sample.value == 512,
+         "sample subscriber: 10 samples with their value");
+  expect(state.total() == 20 && state.count[BUS_WIFI_STATE] == 10,
+         "LED + Wi-Fi subscriber: 10 of each");
+  expect(all.total() == 40 && bus.delivered() == 80 && bus.published() == 40,
+         "everything subscriber: all 40; 80 deliveries in all");
+}
+
+struct Remover {
+  EventBus *bus;
+  int8_t victim;
+  uint32_t calls;
+};
+
+void removeVictim(void *context, const BusEvent &) {
+  Remover *remover = static_cast<Remover *>(context);
+  remover->calls++;
+  remover->bus->unsubscribe(remover->victim);
+}
+
+struct Relay {
+  EventBus *bus;
+};
+
+void relayToWiFi(void *context, const BusEvent &event) {
+  static_cast<Relay *>(context)->bus->publish(
+      WiFiState{event.led.on, WL_CONNECTED});
+}
+
+void checkChanges() {
+  printf("Changes during dispatch\n");
+  EventBus bus;
+  Remover remover = {&bus, -1, 0};
+  Received victim;
+  bus.subscribe(busMask(BUS_LED_CHANGED), removeVictim, &remover);
+  remover.victim = bus.subscribe(busMask(BUS_LED_CHANGED), record, &victim);
+  bus.publish(LedChanged{1, true});
+  bus.publish(LedChanged{1, false});
+  expect(remover.calls == 2 && victim.total() == 0,
+         "unsubscribed by an earlier handler: not called");
+
+  // The freed id is reused, and a handler can remove itself
+  Received again;
+  int8_t id = bus.subscribe(busMask(BUS_LED_CHANGED), record, &again);
+  remover.victim = 0;
+  bus.publish(LedChanged{2, true});
+  bus.publish(LedChanged{2, false});
+  expect(id == 1 && remover.calls == 3 && again.total() == 2,
+         "freed id reused; a handler removing itself runs once more");
+
+  EventBus relayed;
+  Relay relay = {&relayed};
+  Received wifi;
+  relayed.subscribe(busMask(BUS_LED_CHANGED), relayToWiFi, &relay);
+  relayed.subscribe(busMask(BUS_WIFI_STATE), record, &wifi);
+  relayed.publish(LedChanged{1, true});
+  expect(wifi.count[BUS_WIFI_STATE] == 1 &&
+             wifi.last[BUS_WIFI_STATE].wifi.connected,
+         "event published from a handler delivered once");
+
+  EventBus full;
+  Received sink;
+  bool filled = true;
+  for (uint8_t i = 0; i < EventBus::MAX_SUBSCRIBERS; i++)
+    filled &= full.subscribe(busMask(BUS_CLIENT), record, &sink) == i;
+  expect(filled && full.subscribe(busMask(BUS_CLIENT), record, &sink) == -1 &&
+             full.subscribers() == EventBus::MAX_SUBSCRIBERS,
+         "full table: subscribe() returns -1");
+}
+
+void checkHeap() {
+  printf("Heap\n");
+  EventBus bus;
+  Received received[EventBus::MAX_SUBSCRIBERS];
+  for (Received &r : received)
+    bus.subscribe(0xFF, record, &r);
+  NativeHeap::Stats before = NativeHeap::stats();
+  for (int i = 0; i < 25000; i++)
+    publishOneOfEach(bus);
+  NativeHeap::Stats after = NativeHeap::stats();
+  expect(after.allocations == before.allocations,
+         "100000 events to 8 subscribers, no allocations");
+}
+
+// Runs the loop in 50 ms steps until `done`, for at most 20 s
+template <typename Done> bool loopUntil(Done done) {
+  for (int i = 0; i < 400 && !done(); i++) {
+    benchWorkshop().handleClient();
+    NativeHal::advanceMicros(50000);
+  }
+  return done();
+}
+
+void checkWorkshop() {
+  printf("WorkshopESP\n");
+  WorkshopESP &workshop = benchWorkshop();
+  Received received;
+  int8_t id = workshop.events().subscribe(0xFF, record, &received);
+
+  uint32_t generation = workshop.generation();
+  bool was = workshop.getLEDState(1);
+  benchRequest(HTTP_POST, "/api/led/1/toggle");
+  const LedChanged &led = received.last[BUS_LED_CHANGED].led;
+  expect(received.count[BUS_LED_CHANGED] == 1 && led.led == 1 &&
+             led.on == !was && workshop.generation() == generation + 1,
+         "toggle: one LedChanged, /api/status generation bumped");
+  workshop.setLED(2, true);
+  expect(received.count[BUS_LED_CHANGED] == 2 &&
+             received.last[BUS_LED_CHANGED].led.led == 2,
+         "setLED(): one LedChanged");
+
+  int code = 0;
+  workshop.httpServer().simulateRequest(HTTP_POST,
+                                        "/api/bindings?led=1&mode=level",
+                                        nullptr, &code);
+  workshop.arena().reset();
+  NativeHal::setAnalogValue(A0, 321);
+  loopUntil([&]() { return received.count[BUS_SAMPLE_READY] > 0; });
+  const SampleReady &sample = received.last[BUS_SAMPLE_READY].sample;
+  expect(code == 200 && sample.input == A0 && sample.value == 321,
+         "bound A0: SampleReady with the reading");
+  benchRequest(HTTP_POST, "/api/bindings?led=1&mode=off");
+
+  generation = workshop.generation();
+  WiFi.begin("bench");
+  bool up = loopUntil([&]() { return received.count[BUS_WIFI_STATE] == 1; });
+  bool upConnected = received.last[BUS_WIFI_STATE].wifi.connected;
+  WiFi.disconnect();
+  bool down = loopUntil([&]() { return received.count[BUS_WIFI_STATE] == 2; });
+  expect(up && upConnected && down &&
+             !received.last[BUS_WIFI_STATE].wifi.connected,
+         "Wi-Fi up and down: one WiFiState each");
+  expect(workshop.generation() == generation,
+         "and no LED generation bump for /api/leds/wait");
+  workshop.events().unsubscribe(id);
+}
+
+// A real socket on loopback connects to an HttpServer and hangs up
+void checkClients() {
+  printf("HttpServer\n");
+  const uint16_t port = 1049;
+  EventBus bus;
+  Received received;
+  bus.subscribe(busMask(BUS_CLIENT), record, &received);
+  HttpServer server(port);
+  server.attachBus(bus);
+  server.begin();
+
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(NativeHal::hostPort(port));
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  bool connected = fd >= 0 && connect(fd, (sockaddr *)&addr, sizeof(addr)) == 0;
+  for (int i = 0; i < 200 && received.count[BUS_CLIENT] == 0; i++) {
+    server.handleClient();
+    usleep(1000);
+  }
+  ClientEvent accepted = received.last[BUS_CLIENT].client;
+  expect(connected && received.count[BUS_CLIENT] == 1 && accepted.connected &&
+             accepted.ip == 0x0100007F,
+         "accepted: ClientEvent connected, with the address");
+
+  if (fd >= 0)
+    close(fd);
+  for (int i = 0; i < 200 && received.count[BUS_CLIENT] == 1; i++) {
+    server.handleClient();
+    usleep(1000);
+  }
+  const ClientEvent &closed = received.last[BUS_CLIENT].client;
+  expect(received.count[BUS_CLIENT] == 2 && !closed.connected &&
+             closed.slot == accepted.slot,
+         "closed by the client: ClientEvent disconnected");
+  server.close();
+}
+
+uint32_t handled = 0;
+
+void count(void *, const BusEvent &) { handled++; }
+
+// ns per publish with `subscribers` trivial handlers
+double publishNanos(uint8_t subscribers) {
+  EventBus bus;
+  for (uint8_t i = 0; i < subscribers; i++)
+    bus.subscribe(busMask(BUS_LED_CHANGED), count);
+  const uint32_t events = 2000000;
+  double best = 0;
+  for (int round = 0; round < 5; round++) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < events; i++)
+      bus.publish(LedChanged{1, (i & 1) != 0});
+    auto end = std::chrono::steady_clock::now();
+    double ns =
+        std::chrono::duration<double, std::nano>(end - start).count() / events;
+    if (round == 0 || ns < best)
+      best = ns;
+  }
+  return best;
+}
+
+// The first subscriber also pays for the event's timestamp, so the cost
+// of each further one is shown separately
+void reportCost() {
+  printf("\n%-12s %14s %16s %16s\n", "subscribers", "ns per event",
+         "ns per delivery", "ns each after 1");
+  double none = publishNanos(0);
+  printf("%-12u %14.2f %16s %16s\n", 0u, none, "-", "-");
+  double one = 0;
+  const uint8_t counts[] = {1, 2, 4, 8};
+  for (uint8_t n : counts) {
+    if (n > EventBus::MAX_SUBSCRIBERS)
+      break;
+    double ns = publishNanos(n);
+    if (n == 1) {
+      one = ns;
+      printf("%-12u %14.2f %16.2f %16s\n", 1u, ns, ns - none, "-");
+      continue;
+    }
+    printf("%-12u %14.2f %16.2f %16.2f\n", (unsigned)n, ns, (ns - none) / n,
+           (ns - one) / (n - 1));
+  }
+}
+
+} // namespace
+
+int runEventCheck() {
+  benchCheckStart();
+  checkDelivery();
+  checkChanges();
+  checkHeap();
+  NativeHal::useVirtualClock(true);
+  checkWorkshop();
+  NativeHal::useVirtualClock(false);
+  checkClients();
+  reportCost();
+
+  return benchCheckEnd("EVENT");
+}
+
+namespace {
+
+void publishTo(uint8_t subscribers, uint32_t iterations) {
+  static EventBus bus;
+  static uint8_t subscribed = 0;
+  while (subscribed < subscribers)
+    bus.subscribe(busMask(BUS_SAMPLE_READY), count), subscribed++;
+  while (subscribed > subscribers)
+    bus.unsubscribe(--subscribed);
+  for (uint32_t i = 0; i < iterations; i++)
+    bus.publish(SampleReady{A0, (int32_t)(i & 1023)});
+  benchKeep(handled);
+}
+
+} // namespace
+
+BENCH(event_publish_none) { publishTo(0, iterations); }
+
+BENCH(event_publish_1) { publishTo(1, iterations); }
+
+BENCH(event_publish_4) { publishTo(4, iterations); }
@@ -0,0 +1,275 @@
+// Sensor filter stages (src/sensor_filter.h): --sensor-filters checks
+// their step and spike responses and reports cycles per sample; the
+// filter_* cases time them in the benchmark table.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "bench.h"
+#include "sensor_filter.h"
+
+using namespace SensorFilter;
+
+namespace {
+
+// Deterministic pot-like input: a level with a few LSB of noise and, if
+// `spikes`, a full-scale glitch every 97 readings
+struct NoisyInput {
+  uint32_t state = 12345;
+  bool spikes;
+
+  explicit NoisyInput(bool spikes) : spikes(spikes) {}
+
+  int32_t next(int32_t level, uint32_t i) {
+    state = state * 1103515245u + 12345u;
+    int32_t noise = (int32_t)((state >> 16) % 9) - 4;
+    if (spikes && i % 97 == 50)
+      return level < 512 ? 1023 : 0;
+    return std::min<int32_t>(1023, std::max<int32_t>(0, level + noise));
+  }
+};
+
+template <typename Stage> int32_t feed(Stage &stage, int32_t in) {
+  int32_t out = 0;
+  stage.push(in, out);
+  return out;
+}
+
+template <uint8_t TAPS> void checkMedian() {
+  printf("Median<%u>\n", TAPS);
+  char what[64];
+
+  // Every input with values 0..4 against a sort
+  bool matches = true;
+  uint32_t combinations = 1;
+  for (uint8_t i = 0; i < TAPS; i++)
+    combinations *= 5;
+  for (uint32_t n = 0; n < combinations; n++) {
+    Median<TAPS> median;
+    int32_t values[TAPS];
+    int32_t out = 0;
+    for (uint32_t i = 0, rest = n; i < TAPS; i++, rest /= 5) {
+      values[i] = rest % 5;
+      median.push(values[i], out);
+    }
+    std::sort(values, values + TAPS);
+    matches &= out == values[TAPS / 2];
+  }
+  snprintf(what, sizeof(what), "median of all %u inputs of 0..4",
+           (unsigned)combinations);
+  expect(matches, what);
+
+  // A step passes unsmoothed, TAPS / 2 readings late
+  Median<TAPS> step;
+  step.reset(100);
+  bool edge = true;
+  for (int i = 0; i < 10; i++) {
+    int32_t out = feed(step, 900);
+    edge &= out == (i < TAPS / 2 ? 100 : 900);
+  }
+  snprintf(what, sizeof(what), "step 100 -> 900 passes after %u readings",
+           TAPS / 2);
+  expect(edge, what);
+
+  // Spikes up to TAPS / 2 long vanish; one longer gets through
+  for (int length = 1; length <= TAPS / 2 + 1; length++) {
+    Median<TAPS> spike;
+    spike.reset(300);
+    int32_t highest = 0;
+    for (int i = 0; i < 20; i++)
+      highest = std::max(highest, feed(spike, i >= 5 && i < 5 + length
+                                                  ? 1023
+                                                  : 300));
+    bool removed = highest == 300;
+    snprintf(what, sizeof(what), "spike of %d reading%s %s", length,
+             length > 1 ? "s" : "", length <= TAPS / 2 ? "removed" : "passes");
+    expect(removed == (length <= TAPS / 2), what);
+  }
+}
+
+template <uint8_t SHIFT> void checkEma() {
+  printf("Ema<%u>\n", SHIFT);
+  char what[64];
+
+  // Up: monotonic, no overshoot, within 1 of the step when the
+  // exponential says it should be
+  double alpha = 1.0 / (1 << SHIFT);
+  uint32_t expected = (uint32_t)ceil(log(1.0 / 1023) / log(1 - alpha));
+  Ema<SHIFT> ema;
+  ema.reset(0);
+  int32_t previous = 0;
+  bool monotonic = true;
+  uint32_t within = 0;
+  uint32_t exact = 0;
+  int32_t plain = 0; // y += (x - y) >> SHIFT, which stops short
+  for (uint32_t i = 1; i <= 1000; i++) {
+    int32_t out = feed(ema, 1023);
+    plain += (1023 - plain) >> SHIFT;
+    monotonic &= out >= previous && out <= 1023;
+    previous = out;
+    if (within == 0 && out >= 1022)
+      within = i;
+    if (out == 1023 && exact == 0)
+      exact = i;
+  }
+  expect(monotonic, "step 0 -> 1023 rises without overshoot");
+  snprintf(what, sizeof(what), "within 1 after %u readings (exponential %u)",
+           within, expected);
+  expect(within > 0 && within <= expected + 1, what);
+  snprintf(what, sizeof(what), "settles on 1023 after %u (plain form at %ld)",
+           exact, (long)plain);
+  expect(exact > 0 && previous == 1023, what);
+
+  int32_t out = 0;
+  for (int i = 0; i < 1000; i++)
+    out = feed(ema, 0);
+  expect(out == 0, "step 1023 -> 0 settles on 0");
+}
+
+void checkOversample() {
+  printf("Oversample<2>\n");
+  Oversample<2> oversample;
+  uint32_t outputs = 0;
+  int32_t out = 0;
+  bool cadence = true;
+  // Alternating 500/501: the average, 500.5, in quarter steps
+  for (uint32_t i = 1; i <= 64; i++) {
+    bool ready = oversample.push(500 + (i & 1), out);
+    cadence &= ready == (i % Oversample<2>::RATIO == 0);
+    outputs += ready;
+  }
+  expect(cadence && outputs == 4, "one output per 16 readings");
+  expect(out == 2002, "500/501 dither averages to 500.50 (2002 / 4)");
+}
+
+void checkChain() {
+  printf("Chain<Oversample<1>, Median<3>, Ema<2>>\n");
+  typedef Chain<Oversample<1>, Median<3>, Ema<2>> Smoothed;
+  char what[64];
+  expect(Smoothed::GAIN_BITS == 1, "one bit gained");
+  snprintf(what, sizeof(what), "%u bytes: stages plus one word",
+           (unsigned)sizeof(Smoothed));
+  expect(sizeof(Smoothed) == sizeof(Oversample<1>) + sizeof(Median<3>) +
+                                 sizeof(Ema<2>) + sizeof(int32_t),
+         what);
+  expect(sizeof(Chain<>) <= 4, "an empty chain is just the output word");
+
+  Smoothed chain;
+  chain.reset(200);
+  for (int i = 0; i < 200; i++)
+    chain.push(700);
+  expect(Smoothed::toInput(chain.value()) == 700 && chain.value() == 1400,
+         "step 200 -> 700 settles on 1400 (700 in input units)");
+
+  // Noise and spikes around a level: the pot example's filter against
+  // the raw readings, after the first second
+  Chain<Median<3>, Ema<3>> pot;
+  NoisyInput input(true);
+  double rawError = 0, smoothError = 0;
+  int32_t rawWorst = 0, smoothWorst = 0;
+  for (uint32_t i = 0; i < 1000; i++) {
+    int32_t raw = input.next(600, i);
+    pot.push(raw);
+    if (i < 100)
+      continue;
+    int32_t rawDiff = abs(raw - 600), smoothDiff = abs(pot.value() - 600);
+    rawError += rawDiff * rawDiff;
+    smoothError += smoothDiff * smoothDiff;
+    rawWorst = std::max(rawWorst, rawDiff);
+    smoothWorst = std::max(smoothWorst, smoothDiff);
+  }
+  rawError = sqrt(rawError / 900);
+  smoothError = sqrt(smoothError / 900);
+  printf("  pot filter, level 600: raw rms %.2f worst %ld, filtered rms "
+         "%.2f worst %ld\n",
+         rawError, (long)rawWorst, smoothError, (long)smoothWorst);
+  expect(smoothError < rawError / 2 && smoothWorst <= 4,
+         "pot filter halves the noise and removes the spikes");
+}
+
+// Time per input sample; TSC cycles where the host has a cycle counter
+template <typename Filter> void timeFilter(const char *name) {
+  static int32_t inputs[4096];
+  NoisyInput input(true);
+  for (uint32_t i = 0; i < 4096; i++)
+    inputs[i] = input.next(600, i);
+  Filter filter;
+  const uint32_t samples = 1 << 22;
+  auto start = std::chrono::steady_clock::now();
+#if defined(__x86_64__) || defined(__i386__)
+  uint64_t startCycles = __rdtsc();
+#endif
+  for (uint32_t i = 0; i < samples; i++) {
+    filter.push(inputs[i & 4095]);
+    benchKeep(filter);
+  }
+#if defined(__x86_64__) || defined(__i386__)
+  double cycles = (double)(__rdtsc() - startCycles) / samples;
+#else
+  double cycles = 0;
+#endif
+  auto end = std::chrono::steady_clock::now();
+  double ns = std::chrono::duration<double, std::nano>(end - start).count() /
+              samples;
+  printf("%-38s %8.2f %8.1f\n", name, ns, cycles);
+}
+
+} // namespace
+
+int runFilterCheck() {
+  benchCheckStart();
+  checkMedian<3>();
+  checkMedian<5>();
+  checkEma<2>();
+  checkEma<4>();
+  checkOversample();
+  checkChain();
+
+  printf("\n%-38s %8s %8s\n", "per sample", "ns", "cycles");
+  timeFilter<Chain<>>("Chain<> (loop overhead)");
+  timeFilter<Chain<Median<3>>>("Median<3>");
+  timeFilter<Chain<Median<5>>>("Median<5>");
+  timeFilter<Chain<Ema<3>>>("Ema<3>");
+  timeFilter<Chain<Oversample<2>>>("Oversample<2>");
+  timeFilter<Chain<Median<3>, Ema<3>>>("Median<3>, Ema<3> (pot example)");
+  timeFilter<Chain<Oversample<1>, Median<5>, Ema<4>>>(
+      "Oversample<1>, Median<5>, Ema<4>");
+
+  return benchCheckEnd("FILTER");
+}
+
+namespace {
+
+template <typename Filter> void benchFilter(uint32_t iterations) {
+  static NoisyInput input(true);
+  static int32_t inputs[256];
+  static bool filled = false;
+  for (uint32_t i = 0; !filled && i < 256; i++)
+    inputs[i] = input.next(600, i);
+  filled = true;
+  Filter filter;
+  for (uint32_t i = 0; i < iterations; i++) {
+    filter.push(inputs[i & 255]);
+    benchKeep(filter);
+  }
+}
+
+} // namespace
+
+BENCH(filter_median3) { benchFilter<Chain<Median<3>>>(iterations); }
+
+BENCH(filter_median5) { benchFilter<Chain<Median<5>>>(iterations); }
+
+BENCH(filter_ema3) { benchFilter<Chain<Ema<3>>>(iterations); }
+
+BENCH(filter_oversample2) { benchFilter<Chain<Oversample<2>>>(iterations); }
+
+// potentiometer_control's filter
+BENCH(filter_pot_chain) {
+  benchFilter<Chain<Median<3>, Ema<3>>>(iterations);
+}
@@ -0,0 +1,153 @@
+// --frames: WorkshopESP's screens and animations drawn on a
+// HeadlessDisplay. Reports frames and I2C cost per animation, compares
+// the frames against bench/golden/ and optionally exports PBM and GIF.
+
+#include <sys/stat.h>
+
+#include <string>
+
+#include "bench.h"
+#include "headless_display.h"
+#include "native_hal.h"
+
+namespace {
+
+const char *const GOLDEN_DIR = "bench/golden/";
+
+struct Animation {
+  const char *name;
+  void (*play)(WorkshopESP &workshop);
+  bool golden; // frames are deterministic (no uptime or heap figures)
+};
+
+const Animation ANIMATIONS[] = {
+    {"setup", [](WorkshopESP &w) { w.setupDisplay(); }, true},
+    {"wifi_ap",
+     [](WorkshopESP &w) { w.setupWiFiAP("IoT-Workshop-Team 1", ""); }, true},
+    {"hello", [](WorkshopESP &w) { w.animateHello("Team 1"); }, true},
+    {"welcome",
+     [](WorkshopESP &w) { w.displayWelcome("Team 1", "Alice", "Bob"); },
+     true},
+    {"message", [](WorkshopESP &w) { w.displayMessage("Bench", true); }, true},
+    {"complete",
+     [](WorkshopESP &w) {
+       w.playCompleteAnimation("Team 1", "Alice", "Bob", "Carol");
+     },
+     false},
+    {"status",
+     [](WorkshopESP &w) {
+       w.displayStatus();
+       w.displayFlusher().finish(); // sent from handleClient() otherwise
+     },
+     false},
+};
+
+} // namespace
+
+int runFrameReport(const char *outDir, bool updateGolden) {
+  // Time only moves with delay(), so captures and timings repeat exactly
+  NativeHal::useVirtualClock(true);
+  static HeadlessDisplay headless;
+  static WorkshopESP workshop;
+  workshop.setDisplay(&headless);
+  workshop.begin();
+  headless.listen(&workshop.displayFlusher());
+  if (outDir != nullptr)
+    mkdir(outDir, 0755);
+
+  printf("%-10s %7s %10s %11s %12s %12s %8s\n", "animation", "frames",
+         "bus bytes", "bytes/frame", "bus time", "duration", "golden");
+  bool failed = false;
+  for (const Animation &animation : ANIMATIONS) {
+    headless.clearFrames();
+    uint64_t start = micros();
+    animation.play(workshop);
+    const std::vector<HeadlessDisplay::Frame> &frames = headless.frames();
+    if (frames.empty()) {
+      printf("%-10s no frames\n", animation.name);
+      failed = true;
+      continue;
+    }
+
+    uint64_t bytes = 0;
+    uint64_t busMicros = 0;
+    for (const HeadlessDisplay::Frame &frame : frames) {
+      bytes += frame.bytes;
+      busMicros += frame.busMicros;
+    }
+
+    const char *verdict = "-";
+    std::string golden = std::string(GOLDEN_DIR) + animation.name + ".pbm";
+    if (animation.golden && updateGolden) {
+      verdict = headless.writePbm(golden.c_str()) ? "written" : "UNWRITABLE";
+    } else if (animation.golden) {
+      // One more than captured, so extra golden frames show up too
+      std::vector<uint8_t> expected((frames.size() + 1) *
+                                    HeadlessDisplay::FRAME_SIZE);
+      size_t count = HeadlessDisplay::readPbm(golden.c_str(), expected.data(),
+                                              frames.size() + 1);
+      verdict = count == 0 ? "MISSING" : "ok";
+      for (size_t i = 0; i < frames.size() && count > 0; i++) {
+        if (i >= count || memcmp(&expected[i * HeadlessDisplay::FRAME_SIZE],
+                                 frames[i].pixels,
+                                 HeadlessDisplay::FRAME_SIZE) != 0) {
+          verdict = "DIFFERS";
+          break;
+        }
+      }
+      if (count > frames.size())
+        verdict = "DIFFERS";
+    }
+    failed |= verdict[0] >= 'A' && verdict[0] <= 'Z';
+
+    printf("%-10s %7u %10llu %11llu %9.1f ms %9.1f ms %8s\n", animation.name,
+           (unsigned)frames.size(), (unsigned long long)bytes,
+           (unsigned long long)(bytes / frames.size()), busMicros / 1000.0,
+           (frames.back().atMicros - start) / 1000.0, verdict);
+
+    if (outDir != nullptr) {
+      std::string base = std::string(outDir) + "/" + animation.name;
+      headless.writePbmSequence((base + "_").c_str());
+      headless.writeGif((base + ".gif").c_str());
+    }
+  }
+  headless.stopListening();
+
+  // The complete animation again with every flush taking its bus time,
+  // at slower and slower clocks: it must keep its length and drop frames
+  // instead
+  printf("\n%-18s %10s %7s %8s %7s %11s\n", "complete, flush at",
+         "duration", "frames", "dropped", "fps", "worst frame");
+  const uint32_t clocks[] = {0, 400000, 100000, 20000};
+  uint64_t nominal = 0;
+  NativeHal::muteSerial(true);
+  for (uint32_t clock : clocks) {
+    NativeHal::stallOnI2C(clock != 0);
+    if (clock != 0)
+      workshop.displayFlusher().setBusSpeed(clock);
+    uint64_t start = micros();
+    workshop.playCompleteAnimation("Team 1", "Alice", "Bob", "Carol");
+    uint64_t duration = micros() - start;
+    if (clock == 0)
+      nominal = duration;
+    const FrameClock &frames = workshop.animationFrames();
+    // The final frame may still be flushing when the last hold expires
+    bool late = duration > nominal + nominal / 100;
+    char label[24];
+    if (clock == 0)
+      snprintf(label, sizeof(label), "no bus time");
+    else
+      snprintf(label, sizeof(label), "%u kHz", (unsigned)(clock / 1000));
+    printf("%-18s %7.1f s %7u %8u %7.1f %8.1f ms%s\n", label,
+           duration / 1e6, frames.frames(), frames.dropped(),
+           frames.achievedFps(), frames.worstFrameMicros() / 1000.0,
+           late ? "  LATE" : "");
+    failed |= late;
+  }
+  NativeHal::stallOnI2C(false);
+  workshop.displayFlusher().setBusSpeed(WORKSHOP_I2C_CLOCK);
+  NativeHal::useVirtualClock(false);
+
+  printf(failed ? "FRAME CHECK FAILED\n" : "FRAME CHECK OK\n");
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,64 @@
+// JSON generation without the HTTP layer
+
+#include <StreamString.h>
+
+#include "bench.h"
+
+BENCH(json_status_scratch) {
+  WorkshopESP &workshop = benchWorkshop();
+  for (uint32_t i = 0; i < iterations; i++) {
+    RequestArena::Scope scope(workshop.arena());
+    ScratchString json(workshop.arena());
+    workshop.writeSystemStatusJSON(json);
+    benchKeep(json.length());
+  }
+}
+
+BENCH(json_status_string) {
+  WorkshopESP &workshop = benchWorkshop();
+  for (uint32_t i = 0; i < iterations; i++) {
+    String json = workshop.getSystemStatusJSON();
+    benchKeep(json.length());
+  }
+}
+
+BENCH(json_boot_trace) {
+  WorkshopESP &workshop = benchWorkshop();
+  for (uint32_t i = 0; i < iterations; i++) {
+    RequestArena::Scope scope(workshop.arena());
+    ScratchString json(workshop.arena(), 512);
+    workshop.boot().printJSON(json);
+    benchKeep(json.length());
+  }
+}
+
+// Encoder alone on a fixed snapshot: full JSON vs one LED, short keys,
+// MessagePack
+static const StatusSnapshot benchStatus = {true, 3600, 39712, true, false,
+                                           3600123};
+
+static void encodeStatus(uint32_t iterations, const StatusFormat &format) {
+  WorkshopESP &workshop = benchWorkshop();
+  for (uint32_t i = 0; i < iterations; i++) {
+    RequestArena::Scope scope(workshop.arena());
+    ScratchString out(workshop.arena(), 128);
+    StatusEncoder::write(out, benchStatus, format);
+    benchKeep(out.length());
+  }
+}
+
+BENCH(status_encode_json) { encodeStatus(iterations, StatusFormat()); }
+
+BENCH(status_encode_led1_short) {
+  StatusFormat format;
+  format.fields = STATUS_LED1;
+  format.shortKeys = true;
+  encodeStatus(iterations, format);
+}
+
+BENCH(status_encode_msgpack_short) {
+  StatusFormat format;
+  format.shortKeys = true;
+  format.msgpack = true;
+  encodeStatus(iterations, format);
+}
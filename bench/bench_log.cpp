@@ -0,0 +1,42 @@
+// Logging with the UART modelled at 115200 baud: a queued line against the
+// same line printed straight to the serial port, and a line compiled out.
+// Queued lines that do not fit while the FIFO is busy are dropped, not
+// waited for.
+
+#include "bench.h"
+#include "native_hal.h"
+#include "workshop_strings.h"
+
+BENCH(log_line_queued) {
+  NativeHal::stallOnSerial(true);
+  for (uint32_t i = 0; i < iterations; i++) {
+    LOG_INFO(Text::RED_LED_TOGGLED, Text::onOff(i & 1));
+    workshopLog.drain();
+  }
+  NativeHal::stallOnSerial(false);
+}
+
+BENCH(log_format_queued) {
+  NativeHal::stallOnSerial(true);
+  for (uint32_t i = 0; i < iterations; i++) {
+    LOGF_INFO(Text::FMT_WIFI_ATTEMPT.p(), 3, (int)(i & 7), 10);
+    workshopLog.drain();
+  }
+  NativeHal::stallOnSerial(false);
+}
+
+BENCH(log_line_serial) {
+  NativeHal::stallOnSerial(true);
+  for (uint32_t i = 0; i < iterations; i++) {
+    Serial.print(Text::RED_LED_TOGGLED);
+    Serial.println(Text::onOff(i & 1));
+  }
+  NativeHal::stallOnSerial(false);
+}
+
+BENCH(log_line_disabled) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    LOG_DEBUG(Text::RED_LED_TOGGLED, Text::onOff(i & 1));
+    benchKeep(i);
+  }
+}
@@ -0,0 +1,203 @@
+// Benchmark runner for the host build (pio run -e native_bench).
+//
+//   bench [--filter text] [--min-time ms] [--repeat n] [--json]
+//   bench --soak requests
+//   bench --startup-heap
+//   bench --status
+//   bench --display
+//   bench --glyphs
+//   bench --plot
+//   bench --sensor-filters
+//   bench --bindings
+//   bench --events
+//   bench --seqlock
+//   bench --frames [--frames-out dir] [--update-golden]
+
+#include <chrono>
+#include <vector>
+
+#include "bench.h"
+#include "native_hal.h"
+#include "native_heap.h"
+
+namespace {
+
+BenchCase *firstCase = nullptr;
+BenchCase **lastCase = &firstCase;
+
+struct Result {
+  const char *name;
+  uint64_t iterations;
+  double nsPerOp;
+  double allocsPerOp;
+  double bytesPerOp;
+};
+
+double elapsedNs(BenchFunction run, uint32_t iterations) {
+  auto start = std::chrono::steady_clock::now();
+  run(iterations);
+  auto end = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+Result measure(BenchCase &entry, double minTimeNs, int repeat) {
+  entry.run(1); // warm up caches and lazy setup
+
+  // Grow the batch until one repetition takes its share of the time
+  uint32_t iterations = 1;
+  double sliceNs = minTimeNs / repeat;
+  while (iterations < (1u << 30)) {
+    double ns = elapsedNs(entry.run, iterations);
+    if (ns >= sliceNs)
+      break;
+    double scale = ns > 0 ? sliceNs / ns * 1.2 : 10;
+    iterations = (uint32_t)std::min(iterations * std::max(scale, 1.5), 1e9);
+  }
+
+  std::vector<double> samples;
+  samples.reserve(repeat);
+  NativeHeap::Stats before = NativeHeap::stats();
+  for (int i = 0; i < repeat; i++) {
+    samples.push_back(elapsedNs(entry.run, iterations) / iterations);
+  }
+  NativeHeap::Stats after = NativeHeap::stats();
+  std::sort(samples.begin(), samples.end());
+
+  double total = (double)iterations * repeat;
+  Result result;
+  result.name = entry.name;
+  result.iterations = (uint64_t)total;
+  result.nsPerOp = samples[samples.size() / 2];
+  result.allocsPerOp = (after.allocations - before.allocations) / total;
+  result.bytesPerOp = (after.bytesAllocated - before.bytesAllocated) / total;
+  return result;
+}
+
+} // namespace
+
+BenchRegistrar::BenchRegistrar(BenchCase &entry) {
+  *lastCase = &entry;
+  lastCase = &entry.next;
+}
+
+BenchCase *benchCases() { return firstCase; }
+
+int main(int argc, char **argv) {
+  const char *filter = nullptr;
+  double minTimeMs = 200;
+  int repeat = 5;
+  bool json = false;
+  long soak = -1;
+  bool startupHeap = false;
+  bool statusCheck = false;
+  bool displayCheck = false;
+  bool glyphCheck = false;
+  bool plotCheck = false;
+  bool filterCheck = false;
+  bool bindingCheck = false;
+  bool eventCheck = false;
+  bool seqlockCheck = false;
+  bool frameReport = false;
+  const char *framesOut = nullptr;
+  bool updateGolden = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+      filter = argv[++i];
+    else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+      minTimeMs = atof(argv[++i]);
+    else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+      repeat = std::max(1, atoi(argv[++i]));
+    else if (strcmp(argv[i], "--json") == 0)
+      json = true;
+    else if (strcmp(argv[i], "--soak") == 0 && i + 1 < argc)
+      soak = atol(argv[++i]);
+    else if (strcmp(argv[i], "--startup-heap") == 0)
+      startupHeap = true;
+    else if (strcmp(argv[i], "--status") == 0)
+      statusCheck = true;
+    else if (strcmp(argv[i], "--display") == 0)
+      displayCheck = true;
+    else if (strcmp(argv[i], "--glyphs") == 0)
+      glyphCheck = true;
+    else if (strcmp(argv[i], "--plot") == 0)
+      plotCheck = true;
+    else if (strcmp(argv[i], "--sensor-filters") == 0)
+      filterCheck = true;
+    else if (strcmp(argv[i], "--bindings") == 0)
+      bindingCheck = true;
+    else if (strcmp(argv[i], "--events") == 0)
+      eventCheck = true;
+    else if (strcmp(argv[i], "--seqlock") == 0)
+      seqlockCheck = true;
+    else if (strcmp(argv[i], "--frames") == 0)
+      frameReport = true;
+    else if (strcmp(argv[i], "--frames-out") == 0 && i + 1 < argc)
+      framesOut = argv[++i];
+    else if (strcmp(argv[i], "--update-golden") == 0)
+      updateGolden = true;
+    else {
+      fprintf(stderr,
+              "usage: %s [--filter text] [--min-time ms] [--repeat n] "
+              "[--json] [--soak requests] [--startup-heap] [--status] "
+              "[--display] [--glyphs] [--plot] "
+              "[--sensor-filters] [--bindings] [--events] [--seqlock] "
+              "[--frames [--frames-out dir] [--update-golden]]\n",
+              argv[0]);
+      return 2;
+    }
+  }
+
+  setbuf(stdout, nullptr);
+  NativeHal::muteSerial(true);
+
+  if (soak >= 0)
+    return runSoak((uint32_t)soak);
+  if (startupHeap)
+    return runStartupHeapCheck();
+  if (statusCheck)
+    return runStatusCheck();
+  if (displayCheck)
+    return runDisplayCheck();
+  if (glyphCheck)
+    return runGlyphCheck();
+  if (plotCheck)
+    return runPlotCheck();
+  if (filterCheck)
+    return runFilterCheck();
+  if (bindingCheck)
+    return runBindingCheck();
+  if (eventCheck)
+    return runEventCheck();
+  if (seqlockCheck)
+    return runSeqlockCheck();
+  if (frameReport)
+    return runFrameReport(framesOut, updateGolden);
+
+  if (json)
+    printf("[\n");
+  else
+    printf("%-28s %12s %12s %10s %10s\n", "benchmark", "iterations",
+           "ns/op", "allocs/op", "B/op");
+
+  bool first = true;
+  for (BenchCase *entry = benchCases(); entry; entry = entry->next) {
+    if (filter && strstr(entry->name, filter) == nullptr)
+      continue;
+    Result r = measure(*entry, minTimeMs * 1e6, repeat);
+    if (json) {
+      printf("%s  {\"name\":\"%s\",\"iterations\":%llu,\"ns_per_op\":%.1f,"
+             "\"allocs_per_op\":%.2f,\"bytes_per_op\":%.1f}",
+             first ? "" : ",\n", r.name, (unsigned long long)r.iterations,
+             r.nsPerOp, r.allocsPerOp, r.bytesPerOp);
+    } else {
+      printf("%-28s %12llu %12.1f %10.2f %10.1f\n", r.name,
+             (unsigned long long)r.iterations, r.nsPerOp, r.allocsPerOp,
+             r.bytesPerOp);
+    }
+    first = false;
+  }
+  if (json)
+    printf("\n]\n");
+  return 0;
+}
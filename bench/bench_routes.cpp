@@ -0,0 +1,91 @@
+// Route handlers end to end: routing, handler, response formatting
+
+#include "bench.h"
+
+BENCH(route_status) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    benchKeep(benchRequest(HTTP_GET, "/api/status"));
+  }
+}
+
+// Every request re-renders the body (state changes in between)
+BENCH(route_status_changed) {
+  WorkshopESP &workshop = benchWorkshop();
+  for (uint32_t i = 0; i < iterations; i++) {
+    workshop.setLED(1, i & 1);
+    benchKeep(benchRequest(HTTP_GET, "/api/status"));
+  }
+}
+
+BENCH(route_status_not_modified) {
+  HttpServer &server = benchWorkshop().httpServer();
+  for (uint32_t i = 0; i < iterations; i++) {
+    server.simulateHeader("If-None-Match", "*");
+    benchKeep(benchRequest(HTTP_GET, "/api/status"));
+  }
+}
+
+BENCH(route_status_fields) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    benchKeep(benchRequest(HTTP_GET, "/api/status?fields=leds.1&compact=1"));
+  }
+}
+
+BENCH(route_status_msgpack) {
+  HttpServer &server = benchWorkshop().httpServer();
+  for (uint32_t i = 0; i < iterations; i++) {
+    server.simulateHeader("Accept", "application/msgpack");
+    benchKeep(benchRequest(HTTP_GET, "/api/status?compact=1"));
+  }
+}
+
+BENCH(route_led_toggle) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    benchKeep(benchRequest(HTTP_POST, "/api/led/1/toggle"));
+  }
+}
+
+BENCH(route_led_state) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    benchKeep(benchRequest(HTTP_POST, "/api/led/2/state",
+                           (i & 1) ? "{\"state\":true}" : "{\"state\":false}"));
+  }
+}
+
+BENCH(route_dashboard) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    benchKeep(benchRequest(HTTP_GET, "/"));
+  }
+}
+
+BENCH(route_boot) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    benchKeep(benchRequest(HTTP_GET, "/api/boot"));
+  }
+}
+
+BENCH(route_not_found) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    benchKeep(benchRequest(HTTP_GET, "/favicon.ico"));
+  }
+}
+
+// Limiter check alone: a full table of clients taking turns, and one
+// client past its budget (the 429 path before any handler runs)
+BENCH(rate_admit_table) {
+  RateLimiter limiter;
+  limiter.setRate(RATE_READ, 1000, 1000);
+  unsigned long now = 0;
+  for (uint32_t i = 0; i < iterations; i++) {
+    uint32_t ip = 0x0101a8c0 + ((i % RateLimiter::MAX_CLIENTS) << 24);
+    benchKeep(limiter.admit(ip, RATE_READ, now += (i & 1)));
+  }
+}
+
+BENCH(rate_admit_rejected) {
+  RateLimiter limiter;
+  unsigned long retryMs;
+  for (uint32_t i = 0; i < iterations; i++) {
+    benchKeep(limiter.admit(0x0101a8c0, RATE_WRITE, 0, &retryMs));
+  }
+}
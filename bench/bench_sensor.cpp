@@ -0,0 +1,54 @@
+// Sensor paths: ADC read, scaling, and the potentiometer WebSocket update
+
+#include <WebSocketsServer.h>
+
+#include "bench.h"
+#include "native_hal.h"
+
+namespace {
+
+int sweep(uint8_t pin) {
+  static int value = 0;
+  (void)pin;
+  value = (value + 37) % 1024;
+  return value;
+}
+
+} // namespace
+
+BENCH(sensor_analog_read) {
+  NativeHal::setAnalogSource(sweep);
+  for (uint32_t i = 0; i < iterations; i++) {
+    benchKeep(analogRead(A0));
+  }
+  NativeHal::setAnalogSource(nullptr);
+}
+
+BENCH(sensor_pot_to_pwm) {
+  NativeHal::setAnalogSource(sweep);
+  for (uint32_t i = 0; i < iterations; i++) {
+    int raw = analogRead(A0);
+    analogWrite(D2, map(raw, 0, 1023, 0, 255));
+  }
+  NativeHal::setAnalogSource(nullptr);
+}
+
+// Same work as potentiometer_control's sendPotData()
+BENCH(sensor_pot_broadcast) {
+  static WebSocketsServer webSocket(81);
+  RequestArena &arena = benchWorkshop().arena();
+  NativeHal::setAnalogSource(sweep);
+  for (uint32_t i = 0; i < iterations; i++) {
+    RequestArena::Scope scope(arena);
+    int potValue = analogRead(A0);
+    float voltage = (potValue / 1023.0) * 3.3;
+    ScratchString json(arena);
+    json.print("{\"pot\": ");
+    json.print(potValue);
+    json.print(", \"voltage\": ");
+    json.print(voltage, 2);
+    json.print("}");
+    webSocket.broadcastTXT(json.c_str(), json.length());
+  }
+  NativeHal::setAnalogSource(nullptr);
+}
@@ -0,0 +1,231 @@
+// --seqlock: Seqlock<SampleState> under a writer thread standing in for
+// the timer ISR sampler and reader threads standing in for the JSON
+// handlers. Every copy a reader keeps has to be one the writer wrote; the
+// same loop without the sequence check shows how often a plain copy
+// tears. Then WorkshopESP's own snapshots are checked against the LEDs
+// and the readings it reports.
+// seqlock_* cases time a write and a read in the table.
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "native_hal.h"
+#include "seqlock.h"
+
+namespace {
+
+// Write n: every field follows from n, so a mix of two writes shows
+SampleState stateFor(uint32_t n) {
+  SampleState state;
+  memset(&state, 0, sizeof(state));
+  state.samples = n;
+  state.sample = (int32_t)(n ^ 0x5A5A5A5A);
+  state.level[0] = n & 1023;
+  state.level[1] = 1023 - (n & 1023);
+  state.sampleInput = (n * 2654435761u) >> 24;
+  return state;
+}
+
+bool consistent(const SampleState &state) {
+  SampleState expected = stateFor(state.samples);
+  return memcmp(&state, &expected, sizeof(state)) == 0;
+}
+
+void checkSingleThread() {
+  printf("One thread\n");
+  Seqlock<SampleState> lock;
+  bool all = true;
+  for (uint32_t n = 1; n <= 1000; n++) {
+    lock.write(stateFor(n));
+    SampleState state;
+    all &= lock.tryRead(state) && consistent(state) && state.samples == n;
+  }
+  expect(all && lock.version() == 1000,
+         "1000 writes, each read back whole; version 1000");
+}
+
+struct Totals {
+  std::atomic<uint64_t> reads{0};
+  std::atomic<uint64_t> retries{0};
+  std::atomic<uint64_t> torn{0};
+  std::atomic<uint64_t> stale{0}; // older than a copy read before
+};
+
+// Reads until `stop`; `checked` keeps copies only when the sequence says
+// so, otherwise the words are copied with no check at all
+void reader(const Seqlock<SampleState> &lock,
+            const std::atomic<uint32_t> &plain, const std::atomic<bool> &stop,
+            bool checked, Totals &totals) {
+  uint64_t reads = 0, torn = 0, stale = 0;
+  uint32_t retries = 0, newest = 0;
+  SampleState state;
+  while (!stop.load(std::memory_order_relaxed)) {
+    if (checked) {
+      state = lock.read(&retries);
+    } else {
+      // A second plain copy the writer fills word by word
+      const std::atomic<uint32_t> *words = &plain;
+      uint32_t buffer[(sizeof(SampleState) + 3) / 4];
+      for (size_t i = 0; i < sizeof(buffer) / 4; i++)
+        buffer[i] = words[i].load(std::memory_order_relaxed);
+      memcpy(&state, buffer, sizeof(state));
+    }
+    reads++;
+    if (!consistent(state))
+      torn++;
+    else if (state.samples < newest)
+      stale++;
+    else
+      newest = state.samples;
+  }
+  totals.reads += reads;
+  totals.retries += retries;
+  totals.torn += torn;
+  totals.stale += stale;
+}
+
+// Holds the unchecked copy, one atomic word at a time
+struct PlainCopy {
+  std::atomic<uint32_t> words[(sizeof(SampleState) + 3) / 4];
+
+  PlainCopy() {
+    for (std::atomic<uint32_t> &word : words)
+      word.store(0, std::memory_order_relaxed);
+  }
+
+  void write(const SampleState &state) {
+    uint32_t buffer[sizeof(words) / sizeof(words[0])] = {};
+    memcpy(buffer, &state, sizeof(state));
+    for (size_t i = 0; i < sizeof(buffer) / 4; i++)
+      words[i].store(buffer[i], std::memory_order_relaxed);
+  }
+};
+
+void checkThreads(unsigned readers, int millis) {
+  printf("Writer thread, %u readers (half unchecked), %d ms\n", readers,
+         millis);
+  Seqlock<SampleState> lock;
+  PlainCopy plain;
+  lock.write(stateFor(0));
+  plain.write(stateFor(0));
+  std::atomic<bool> stop(false);
+  Totals checked, unchecked;
+
+  // The "ISR": writes back to back, timing each write
+  uint32_t writes = 0;
+  double worstNs = 0, totalNs = 0;
+  std::thread writer([&]() {
+    while (!stop.load(std::memory_order_relaxed)) {
+      SampleState next = stateFor(++writes);
+      auto start = std::chrono::steady_clock::now();
+      lock.write(next);
+      auto end = std::chrono::steady_clock::now();
+      plain.write(next);
+      double ns =
+          std::chrono::duration<double, std::nano>(end - start).count();
+      totalNs += ns;
+      if (ns > worstNs)
+        worstNs = ns;
+    }
+  });
+  std::vector<std::thread> threads;
+  for (unsigned i = 0; i < readers; i++) {
+    bool useLock = i % 2 == 0;
+    threads.emplace_back(reader, std::cref(lock), std::cref(plain.words[0]),
+                         std::cref(stop), useLock,
+                         std::ref(useLock ? checked : unchecked));
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+  stop = true;
+  writer.join();
+  for (std::thread &thread : threads)
+    thread.join();
+
+  printf("  %u writes, %.0f ns average, %.0f ns worst (preemption "
+         "included)\n",
+         (unsigned)writes, totalNs / writes, worstNs);
+  printf("  seqlock reads: %llu, retried %llu times\n",
+         (unsigned long long)checked.reads.load(),
+         (unsigned long long)checked.retries.load());
+  printf("  plain reads:   %llu, %llu torn\n",
+         (unsigned long long)unchecked.reads.load(),
+         (unsigned long long)unchecked.torn.load());
+
+  char what[64];
+  snprintf(what, sizeof(what), "%llu seqlock reads, none torn",
+           (unsigned long long)checked.reads.load());
+  expect(checked.reads > 0 && checked.torn == 0, what);
+  expect(checked.stale == 0, "no reader saw a write older than one it saw");
+  expect(lock.version() == writes + 1, "version counts every write");
+}
+
+void checkWorkshop() {
+  printf("WorkshopESP\n");
+  WorkshopESP &workshop = benchWorkshop();
+  workshop.setLED(1, true);
+  workshop.setLED(2, false);
+  LedState leds = workshop.ledState();
+  expect(leds.led[0] && !leds.led[1] &&
+             leds.generation == workshop.generation(),
+         "LED snapshot has the LEDs and the generation");
+  workshop.toggleLED(2);
+  LedState toggled = workshop.ledState();
+  expect(toggled.led[1] && toggled.generation == leds.generation + 1,
+         "and follows a toggle");
+
+  // Written by the sampler itself, not through the event bus
+  int code = 0;
+  workshop.httpServer().simulateRequest(HTTP_POST,
+                                        "/api/bindings?led=1&mode=level",
+                                        nullptr, &code);
+  workshop.arena().reset();
+  uint32_t samples = workshop.sampleState().samples;
+  NativeHal::setAnalogValue(A0, 1023);
+  for (int i = 0; i < 10; i++) {
+    workshop.handleClient();
+    NativeHal::advanceMicros(WORKSHOP_BINDING_PERIOD_US);
+  }
+  SampleState sampled = workshop.sampleState();
+  expect(code == 200 && sampled.samples > samples &&
+             sampled.sampleInput == A0 && sampled.sample == 1023 &&
+             sampled.level[0] == AnalogBindings::OUTPUT_MAX,
+         "sample snapshot follows the sampler");
+  expect(workshop.generation() == toggled.generation,
+         "readings leave the LED generation alone");
+  benchRequest(HTTP_POST, "/api/bindings?led=1&mode=off");
+}
+
+} // namespace
+
+int runSeqlockCheck() {
+  benchCheckStart();
+  checkSingleThread();
+  unsigned cores = std::thread::hardware_concurrency();
+  checkThreads(2, 300);
+  checkThreads(cores > 4 ? cores & ~1u : 4, 1000);
+  NativeHal::useVirtualClock(true);
+  checkWorkshop();
+  NativeHal::useVirtualClock(false);
+
+  return benchCheckEnd("SEQLOCK");
+}
+
+BENCH(seqlock_write) {
+  static Seqlock<SampleState> lock;
+  SampleState state = stateFor(0);
+  for (uint32_t i = 0; i < iterations; i++) {
+    state.sample = i;
+    lock.write(state);
+  }
+  benchKeep(lock);
+}
+
+BENCH(seqlock_read) {
+  static Seqlock<SampleState> lock;
+  lock.write(stateFor(1));
+  for (uint32_t i = 0; i < iterations; i++)
+    benchKeep(lock.read());
+}
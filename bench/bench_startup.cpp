@@ -0,0 +1,106 @@
+// --startup-heap: the heap after a sketch's setup() with WorkshopESP as it
+// is (server and display embedded, framebuffer allocated by begin()) and
+// as it was (server and display allocated by the constructor during
+// static init, framebuffer by setupDisplay()), on the simulated 40 KB
+// heap. Object sizes are the host fakes'; the fake server holds a 4 KB
+// request buffer the core's does not, so the board gains less.
+
+#include <ESP8266WebServer.h>
+
+#include "bench.h"
+#include "native_heap.h"
+
+namespace {
+
+struct HeapState {
+  uint32_t free;
+  uint32_t largest;
+  uint8_t fragmentation;
+};
+
+HeapState heapNow() {
+  HeapState state;
+  state.largest = NativeHeap::maxFreeBlock(); // merges free neighbours
+  state.free = NativeHeap::freeBytes();
+  state.fragmentation = NativeHeap::fragmentation();
+  return state;
+}
+
+const size_t FRAMEBUFFER = 128 * 64 / 8;
+
+// setup() of a sketch that names its AP with a String, then brings up
+// the network and the display; `framebufferFirst` is begin() at the top
+HeapState runSetup(bool framebufferFirst, void **framebuffer) {
+  if (framebufferFirst)
+    *framebuffer = NativeHeap::alloc(FRAMEBUFFER);
+  {
+    String ssid = String("IoT-Workshop-") + String("Team 1");
+    String banner = String("Connect to ") + ssid;
+    // setupWiFiAP(), setupWebServer(), then setupDisplay()
+    if (!framebufferFirst)
+      *framebuffer = NativeHeap::alloc(FRAMEBUFFER);
+  }
+  return heapNow();
+}
+
+void print(const char *layout, const HeapState &before,
+           const HeapState &after) {
+  printf("%-30s %7u %7u %7u %7u %5u%%\n", layout,
+         (unsigned)(before.free - after.free), (unsigned)after.free,
+         (unsigned)after.largest, (unsigned)(after.free - after.largest),
+         (unsigned)after.fragmentation);
+}
+
+} // namespace
+
+int runStartupHeapCheck() {
+  benchCheckStart();
+  HeapState empty = heapNow();
+
+  printf("Constructor\n");
+  // One allocation for the object itself, which is in .bss on the board
+  NativeHeap::Stats before = NativeHeap::stats();
+  WorkshopESP *workshop = new WorkshopESP();
+  NativeHeap::Stats after = NativeHeap::stats();
+  expect(after.allocations - before.allocations == 1 &&
+             heapNow().free == empty.free,
+         "WorkshopESP() allocates nothing itself");
+  delete workshop;
+
+  printf("\nsizeof ESP8266WebServer %u, Adafruit_SSD1306 %u\n",
+         (unsigned)sizeof(ESP8266WebServer),
+         (unsigned)sizeof(Adafruit_SSD1306));
+  printf("%-30s %7s %7s %7s %7s %6s\n", "after setup()", "used", "free",
+         "largest", "holes", "frag");
+
+  // Then: `new ESP8266WebServer(80)` and `new Adafruit_SSD1306(...)` in
+  // the constructor, the framebuffer once setupDisplay() ran
+  void *server = NativeHeap::alloc(sizeof(ESP8266WebServer));
+  void *display = NativeHeap::alloc(sizeof(Adafruit_SSD1306));
+  void *framebuffer = nullptr;
+  HeapState old = runSetup(false, &framebuffer);
+  print("constructor allocates (was)", empty, old);
+  NativeHeap::free(framebuffer);
+  NativeHeap::free(display);
+  NativeHeap::free(server);
+
+  HeapState now = runSetup(true, &framebuffer);
+  print("embedded, begin() first (now)", empty, now);
+  NativeHeap::free(framebuffer);
+
+  printf("\n");
+  char what[64];
+  snprintf(what, sizeof(what), "%u bytes more free heap after setup()",
+           (unsigned)(now.free - old.free));
+  expect(now.free > old.free, what);
+  // The setup() Strings freed below the framebuffer leave holes
+  snprintf(what, sizeof(what), "free bytes in holes %u -> %u",
+           (unsigned)(old.free - old.largest),
+           (unsigned)(now.free - now.largest));
+  expect(now.free - now.largest < old.free - old.largest, what);
+  snprintf(what, sizeof(what), "largest free block %u -> %u bytes",
+           (unsigned)old.largest, (unsigned)now.largest);
+  expect(now.largest > old.largest, what);
+
+  return benchCheckEnd("STARTUP HEAP");
+}
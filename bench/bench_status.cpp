@@ -0,0 +1,57 @@
+// --status: /api/status?fields= with every field under its long name, in
+// the default order and others, against the default body; lists longer
+// than any valid one and unknown names get a 400.
+
+#include "bench.h"
+#include "native_hal.h"
+
+namespace {
+
+std::string status(const char *query, int *code) {
+  std::string uri = std::string("/api/status") + query;
+  std::string body = benchWorkshop().httpServer().simulateRequest(
+      HTTP_GET, uri.c_str(), nullptr, code);
+  benchWorkshop().arena().reset();
+  return body;
+}
+
+// Each long name once, in orders that cut differently
+const char *const FULL_LISTS[] = {
+    "wifi_connected,uptime,free_heap,leds.1,leds.2,timestamp",
+    "timestamp,leds.2,leds.1,free_heap,uptime,wifi_connected",
+    "free_heap,timestamp,wifi_connected,leds.2,uptime,leds.1",
+};
+
+void checkLists() {
+  printf("Field lists\n");
+  int code = 0;
+  std::string expected = status("", &code);
+  for (const char *list : FULL_LISTS) {
+    std::string body = status((std::string("?fields=") + list).c_str(),
+                              &code);
+    char what[80];
+    snprintf(what, sizeof(what), "%.32s...: the default body", list);
+    expect(strlen(list) == StatusEncoder::MAX_FIELDS_LENGTH &&
+               code == 200 && body == expected,
+           what);
+  }
+
+  status("?fields=timestamp,leds,free_heap,uptime,wifi_connected", &code);
+  expect(code == 200, "leds for both LEDs, shorter list");
+  std::string longer = std::string("?fields=") + FULL_LISTS[1] + ",";
+  status(longer.c_str(), &code);
+  expect(code == 400, "one character over the longest list: 400");
+  status("?fields=timestamp,leds.2,leds.1,free_heap,uptime,wifi_co", &code);
+  expect(code == 400, "unknown (cut) name: 400");
+}
+
+} // namespace
+
+int runStatusCheck() {
+  benchCheckStart();
+  NativeHal::useVirtualClock(true);
+  checkLists();
+  NativeHal::useVirtualClock(false);
+
+  return benchCheckEnd("STATUS");
+}
@@ -0,0 +1,38 @@
+// Binary trace events against the text log: recording the same LED change
+// and request start as log_format_queued. The queue is read out whenever
+// it is half full, as a client polling /api/trace would.
+
+#include "bench.h"
+#include "event_trace.h"
+
+namespace {
+
+uint8_t chunk[EventTrace::CAPACITY + EventTrace::CHUNK_HEADER];
+
+void readHalfFull() {
+  if (workshopTrace.queued() > EventTrace::CAPACITY / 2)
+    benchKeep(workshopTrace.read(chunk, sizeof(chunk)));
+}
+
+} // namespace
+
+BENCH(trace_led_event) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    TRACE(LED_CHANGED, 1, (bool)(i & 1));
+    readHalfFull();
+  }
+}
+
+BENCH(trace_request_event) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    TRACE(HTTP_REQUEST, F("GET"), "/api/status", i & 3);
+    readHalfFull();
+  }
+}
+
+BENCH(trace_read) {
+  for (uint32_t i = 0; i < iterations; i++) {
+    TRACE(HTTP_RESPONSE, 200, 236);
+    benchKeep(workshopTrace.read(chunk, sizeof(chunk)));
+  }
+}
@@ -0,0 +1,39 @@
+#include "bench.h"
+
+WorkshopESP &benchWorkshop() {
+  static WorkshopESP workshop;
+  static bool ready = false;
+  if (!ready) {
+    workshop.begin();
+    workshop.setupLEDs();
+    workshop.setupWebServer();
+    ready = true;
+  }
+  return workshop;
+}
+
+int benchRequest(HTTPMethod method, const char *uri, const char *body) {
+  WorkshopESP &workshop = benchWorkshop();
+  int code = 0;
+  workshop.httpServer().simulateRequest(method, uri, body, &code);
+  workshop.arena().reset();
+  return code;
+}
+
+namespace {
+
+bool checkFailed = false;
+
+} // namespace
+
+void expect(bool ok, const char *what) {
+  printf("  %-58s %s\n", what, ok ? "ok" : "FAILED");
+  checkFailed |= !ok;
+}
+
+void benchCheckStart() { checkFailed = false; }
+
+int benchCheckEnd(const char *name) {
+  printf("%s CHECK %s\n", name, checkFailed ? "FAILED" : "OK");
+  return checkFailed ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+// Heap soak: hammers the routes with the dashboard's request mix and
+// watches the largest free block. Handler temporaries that outlive their
+// request or are freed out of order show up as a shrinking block.
+
+#include "bench.h"
+#include "native_heap.h"
+
+namespace {
+
+// Largest free block may dip by this much (one String's worth of slack)
+const uint32_t TOLERANCE = 256;
+const uint32_t SAMPLE_EVERY = 1000;
+
+void mixedRequest(uint32_t i) {
+  switch (i % 20) {
+  case 0:
+    benchRequest(HTTP_POST, "/api/led/1/toggle");
+    break;
+  case 5:
+    benchRequest(HTTP_POST, "/api/led/2/state",
+                 (i & 32) ? "{\"state\":true}" : "{\"state\":false}");
+    break;
+  case 10:
+    benchRequest(HTTP_GET, "/api/boot");
+    break;
+  case 15:
+    benchRequest(HTTP_GET, (i & 64) ? "/" : "/missing");
+    break;
+  default:
+    benchRequest(HTTP_GET, "/api/status");
+    break;
+  }
+}
+
+} // namespace
+
+int runSoak(uint32_t requests) {
+  WorkshopESP &workshop = benchWorkshop();
+
+  // Let lazily allocated state settle before taking the baseline
+  for (uint32_t i = 0; i < 100; i++)
+    mixedRequest(i);
+
+  uint32_t baseline = NativeHeap::maxFreeBlock();
+  uint32_t lowest = baseline;
+  printf("%10s %10s %12s %6s\n", "requests", "free", "max block", "frag");
+  printf("%10u %10u %12u %5u%%\n", 0u, NativeHeap::freeBytes(), baseline,
+         NativeHeap::fragmentation());
+
+  for (uint32_t i = 1; i <= requests; i++) {
+    mixedRequest(i);
+    uint32_t block = NativeHeap::maxFreeBlock();
+    if (block < lowest)
+      lowest = block;
+    if (i % SAMPLE_EVERY == 0 || i == requests) {
+      printf("%10u %10u %12u %5u%%\n", i, NativeHeap::freeBytes(), block,
+             NativeHeap::fragmentation());
+    }
+  }
+
+  uint32_t failures = workshop.arena().failures();
+  printf("max free block: baseline %u, lowest %u, final %u\n", baseline,
+         lowest, NativeHeap::maxFreeBlock());
+  printf("arena: peak %u of %u bytes, %u failed allocations\n",
+         (unsigned)workshop.arena().highWater(),
+         (unsigned)RequestArena::CAPACITY, failures);
+
+  if (lowest + TOLERANCE < baseline || failures != 0) {
+    printf("SOAK FAILED\n");
+    return 1;
+  }
+  printf("SOAK OK\n");
+  return 0;
+}
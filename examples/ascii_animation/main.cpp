@@ -25,13 +25,17 @@ void displayCoolAnimation() {
                                    "Let's Start!",
                                    "🚀"};
 
-  // Display animation frames
+  const int frameCount = sizeof(animationFrames) / sizeof(animationFrames[0]);
+
+  // Display animation frames; the clock keeps them 600 ms apart however
+  // long drawing takes
+  FrameClock clock;
   for (int frame = 0; frame < 3; frame++) {
-    for (int i = 0; i < 10; i++) {
+    for (int i = 0; i < frameCount; i++) {
       workshop.displayMessage(animationFrames[i], false);
-      delay(600);
+      clock.hold(600);
     }
-    delay(1000);
+    clock.hold(1000);
   }
 }
 
@@ -58,9 +62,10 @@ void displayTeamWelcome() {
                                    "🚀"};
 
   // Animate welcome messages
+  FrameClock clock;
   for (int i = 0; i < 19; i++) {
     workshop.displayMessage(welcomeMessages[i], false);
-    delay(600);
+    clock.hold(600);
   }
 }
 
@@ -105,25 +110,28 @@ void displayCoolPatterns() {
 
 void displaySystemInfo() {
   // Display system information
+  FrameClock clock;
   workshop.displayMessage("System Ready!", true);
-  delay(1000);
+  clock.hold(1000);
 
   workshop.displayMessage("WiFi: Connected", false);
-  delay(800);
+  clock.hold(800);
 
   workshop.displayMessage("IP: Ready", false);
-  delay(800);
+  clock.hold(800);
 
   workshop.displayMessage("API: Active", false);
-  delay(800);
+  clock.hold(800);
 
   workshop.displayMessage("Dashboard: Live", false);
-  delay(1000);
+  clock.hold(1000);
 }
 
 void setup() {
   Serial.begin(115200);
+  workshop.boot().mark("Serial.begin");
   delay(2000);
+  workshop.boot().mark("startup delay");
 
   Serial.println("\n");
   Serial.println(
@@ -152,8 +160,10 @@ void setup() {
   Serial.printf("Team: %s\n", TEAM_NAME);
   Serial.printf("Members: %s & %s\n", MEMBER_1, MEMBER_2);
   Serial.println("================================================");
+  workshop.boot().mark("banner");
 
-  // Initialize WorkshopESP
+  // Initialize WorkshopESP (hardware first, then network)
+  workshop.begin();
   workshop.setupWiFi(WIFI_SSID, WIFI_PASSWORD);
   workshop.setupWebServer();
   workshop.setupDisplay();
@@ -163,9 +173,13 @@ void setup() {
 
   // Run the cool animation sequence
   displayCoolAnimation();
+  workshop.boot().mark("displayCoolAnimation");
   displayTeamWelcome();
+  workshop.boot().mark("displayTeamWelcome");
   displayCoolPatterns();
+  workshop.boot().mark("displayCoolPatterns");
   displaySystemInfo();
+  workshop.boot().mark("displaySystemInfo");
 
   // Final welcome message
   workshop.animateTeamWelcome(TEAM_NAME);
@@ -173,6 +187,9 @@ void setup() {
   Serial.println("Animation complete! System ready for workshop.");
   Serial.println("Dashboard available at: http://" + WiFi.localIP().toString());
   Serial.println("================================================");
+
+  // Print where boot time went (also at /api/boot)
+  workshop.boot().ready(Serial);
 }
 
 void loop() {
@@ -1,7 +1,18 @@
+#include <Adafruit_SSD1306.h>
 #include <Arduino.h>
 #include <ESP8266WebServer.h>
 #include <ESP8266WiFi.h>
 #include <WebSocketsServer.h>
+#include <Wire.h>
+
+#include "display_flusher.h"
+#include "event_bus.h"
+#include "log_buffer.h"
+#include "request_arena.h"
+#include "sensor_filter.h"
+#include "session_recorder.h"
+#include "sparkline.h"
+#include "widget_screen.h"
 
 // LED pin definitions
 const int RED_LED_PIN = D2;
@@ -12,6 +23,26 @@ const int POT_PIN = A0;
 bool redLEDState = false;
 bool greenLEDState = false;
 
+// The pot is read every SAMPLE_MS. A 3-reading median drops single
+// spikes and an EMA (about 80 ms) smooths the rest, so the dashboard
+// needle and the plot no longer jitter.
+const unsigned long SAMPLE_MS = 10; // ~3 samples per plot column
+SensorFilter::Chain<SensorFilter::Median<3>, SensorFilter::Ema<3>> potFilter;
+int potRaw = 0;
+
+// OLED: reading and bar on the top line, the pot signal plotted below
+const int OLED_SDA = 14;
+const int OLED_SCL = 12;
+const uint8_t OLED_ADDRESS = 0x3C;
+const unsigned long FRAME_MS = 33;  // 30 fps
+Adafruit_SSD1306 oled(128, 64, &Wire, -1);
+DisplayFlusher flusher; // sends each frame in slices from loop()
+WidgetScreen header;
+Sparkline potPlot;
+uint8_t potReading;
+uint8_t potBar;
+bool oledReady = false;
+
 // Access Point settings
 const char *AP_SSID = "IoT-Workshop";
 const char *AP_PASSWORD = ""; // No password
@@ -20,6 +51,13 @@ const char *AP_PASSWORD = ""; // No password
 ESP8266WebServer server(80);
 WebSocketsServer webSocket = WebSocketsServer(81);
 
+// Scratch memory for handler strings, reset after every request/message
+RequestArena arena;
+
+// Samples and WebSocket clients, from where they happen to the plot and
+// the dashboard
+EventBus bus;
+
 // Team information
 const char *TEAM_NAME = "Team A";
 const char *MEMBER_1 = "Alice";
@@ -44,32 +82,129 @@ void setupWiFiAP() {
 
 void webSocketEvent(uint8_t num, WStype_t type, uint8_t *payload,
                     size_t length) {
+  RECORD_WS(num, type, payload, length);
   switch (type) {
   case WStype_DISCONNECTED:
-    Serial.printf("[%u] Disconnected!\n", num);
+    LOGF_INFO(PSTR("[%u] Disconnected!\n"), num);
+    bus.publish(ClientEvent{num, false, 0});
     break;
 
   case WStype_CONNECTED:
-    Serial.printf("[%u] Connected from %s\n", num, payload);
+    LOGF_INFO(PSTR("[%u] Connected from %s\n"), num, payload);
+    bus.publish(ClientEvent{num, true, webSocket.remoteIP(num)});
     break;
 
   case WStype_TEXT:
     // Handle incoming messages if needed
-    Serial.printf("[%u] Received: %s\n", num, payload);
+    LOGF_DEBUG(PSTR("[%u] Received: %s\n"), num, payload);
     break;
   }
 }
 
+// {"pot": filtered, "raw": last reading, "voltage": filtered in volts}
+void printPotJson(Print &json) {
+  int potValue = potFilter.value();
+  json.print("{\"pot\": ");
+  json.print(potValue);
+  json.print(", \"raw\": ");
+  json.print(potRaw);
+  json.print(", \"voltage\": ");
+  json.print((potValue / 1023.0) * 3.3, 2);
+  json.print("}");
+}
+
+void samplePot() {
+  static unsigned long lastSample = 0;
+  unsigned long now = millis();
+  if (now - lastSample < SAMPLE_MS)
+    return;
+  lastSample = now;
+  potRaw = analogRead(POT_PIN);
+  potFilter.push(potRaw);
+  bus.publish(SampleReady{(uint8_t)POT_PIN, potFilter.value()});
+}
+
+// Subscribed once the OLED is up
+void plotSample(void *, const BusEvent &event) {
+  potPlot.add(event.sample.value);
+  header.setValue(potReading, event.sample.value);
+  header.setValue(potBar, event.sample.value);
+}
+
+// A new dashboard gets the reading at once instead of at the next send
+void greetClient(void *, const BusEvent &event) {
+  if (!event.client.connected)
+    return;
+  RequestArena::Scope scope(arena);
+  ScratchString json(arena);
+  printPotJson(json);
+  webSocket.sendTXT(event.client.slot, json.c_str(), json.length());
+}
+
 void sendPotData() {
-  int potValue = analogRead(POT_PIN);
-  float voltage = (potValue / 1023.0) * 3.3;
+  // One reading per send, as before, so replays stay the same size
+  RECORD_SAMPLE(POT_PIN, potRaw);
 
-  String json = "{\"pot\": " + String(potValue) +
-                ", \"voltage\": " + String(voltage, 2) + "}";
-  webSocket.broadcastTXT(json);
+  RequestArena::Scope scope(arena);
+  ScratchString json(arena);
+  printPotJson(json);
+  webSocket.broadcastTXT(json.c_str(), json.length());
 
-  // Print to serial for debugging
-  Serial.printf("Potentiometer: %d (%.2fV)\n", potValue, voltage);
+  // Every sample at DEBUG; compiled out at the default level
+  LOGF_DEBUG(PSTR("Potentiometer: %ld (raw %d)\n"), (long)potFilter.value(),
+             potRaw);
+}
+
+// Mirrors log lines to the dashboard as {"log":"..."}; the page prints
+// them to the browser console. DEBUG lines (a sample each) stay on the
+// serial port, or the socket would carry every reading twice.
+void mirrorLog(uint8_t level, const char *text, size_t length) {
+  if (level >= WORKSHOP_LOG_DEBUG || webSocket.connectedClients() == 0)
+    return;
+  RequestArena::Scope scope(arena);
+  ScratchString json(arena, length + 16);
+  json.print("{\"log\":\"");
+  for (size_t i = 0; i < length; i++) {
+    char c = text[i];
+    if (c == '"' || c == '\\')
+      json.print('\\');
+    if ((uint8_t)c >= 0x20)
+      json.print(c);
+  }
+  json.print("\"}");
+  webSocket.broadcastTXT(json.c_str(), json.length());
+}
+
+void setupDisplay() {
+  Wire.begin(OLED_SDA, OLED_SCL);
+  oledReady = oled.begin(SSD1306_SWITCHCAPVCC, OLED_ADDRESS);
+  if (!oledReady) {
+    Serial.println("OLED not found, plotting disabled");
+    return;
+  }
+  oled.clearDisplay();
+  potReading = header.addValue(0, 0, 10, PSTR("Pot %ld"));
+  potBar = header.addBar(64, 1, 64, 6, 0, 1023);
+  potPlot.begin(0, 1, 128, 7, Sparkline::SWEEP);
+  flusher.attach(&Wire, OLED_ADDRESS, oled.getBuffer());
+  bus.subscribe(busMask(BUS_SAMPLE_READY), plotSample);
+}
+
+// Draws a frame every FRAME_MS; the flusher sends only the pages that
+// changed, a few columns each
+void updateDisplay() {
+  if (!oledReady)
+    return;
+  unsigned long now = millis();
+  static unsigned long lastFrame = 0;
+  if (now - lastFrame >= FRAME_MS) {
+    // Keep the average at 30 fps, but do not catch up after a stall
+    lastFrame = now - lastFrame < 2 * FRAME_MS ? lastFrame + FRAME_MS : now;
+    header.render(oled);
+    potPlot.render(oled);
+    flusher.present();
+  }
+  flusher.tick();
 }
 
 void setupWebServer() {
@@ -257,6 +392,10 @@ void setupWebServer() {
     html += "  };";
     html += "  ws.onmessage = function(event) {";
     html += "    const data = JSON.parse(event.data);";
+    html += "    if (data.log !== undefined) {";
+    html += "      console.log('[esp] ' + data.log);";
+    html += "      return;";
+    html += "    }";
     html += "    updatePotDisplay(data.pot, data.voltage);";
     html += "  };";
     html += "  ws.onclose = function() {";
@@ -324,51 +463,65 @@ void setupWebServer() {
 
   // API endpoints
   server.on("/api/status", []() {
-    String json = "{";
-    json += "\"wifi_connected\":" +
-            String(WiFi.status() == WL_CONNECTED ? "true" : "false") + ",";
-    json += "\"uptime\":" + String(millis() / 1000) + ",";
-    json += "\"free_heap\":" + String(ESP.getFreeHeap()) + ",";
-    json += "\"leds\":{";
-    json += "\"1\":" + String(redLEDState ? "true" : "false") + ",";
-    json += "\"2\":" + String(greenLEDState ? "true" : "false");
-    json += "},";
-    json += "\"timestamp\":" + String(millis());
-    json += "}";
-
-    server.send(200, "application/json", json);
+    ScratchString json(arena);
+    json.printf("{\"wifi_connected\":%s,\"uptime\":%lu,\"free_heap\":%u,"
+                "\"leds\":{\"1\":%s,\"2\":%s},\"timestamp\":%lu}",
+                WiFi.status() == WL_CONNECTED ? "true" : "false",
+                millis() / 1000, ESP.getFreeHeap(),
+                redLEDState ? "true" : "false",
+                greenLEDState ? "true" : "false", millis());
+
+    server.send(200, "application/json", json.c_str(), json.length());
   });
 
   server.on("/api/led/red/toggle", HTTP_POST, []() {
     redLEDState = !redLEDState;
     digitalWrite(RED_LED_PIN, redLEDState);
-    Serial.printf("Red LED toggled to: %s\n", redLEDState ? "ON" : "OFF");
+    LOGF_INFO(PSTR("Red LED toggled to: %s\n"), redLEDState ? "ON" : "OFF");
 
-    String json =
-        "{\"led\":\"red\",\"state\":" + String(redLEDState ? "true" : "false") +
-        ",\"message\":\"LED toggled successfully\"}";
-    server.send(200, "application/json", json);
+    ScratchString json(arena);
+    json.printf("{\"led\":\"red\",\"state\":%s,"
+                "\"message\":\"LED toggled successfully\"}",
+                redLEDState ? "true" : "false");
+    server.send(200, "application/json", json.c_str(), json.length());
   });
 
   server.on("/api/led/green/toggle", HTTP_POST, []() {
     greenLEDState = !greenLEDState;
     digitalWrite(GREEN_LED_PIN, greenLEDState);
-    Serial.printf("Green LED toggled to: %s\n", greenLEDState ? "ON" : "OFF");
-
-    String json = "{\"led\":\"green\",\"state\":" +
-                  String(greenLEDState ? "true" : "false") +
-                  ",\"message\":\"LED toggled successfully\"}";
-    server.send(200, "application/json", json);
+    LOGF_INFO(PSTR("Green LED toggled to: %s\n"),
+              greenLEDState ? "ON" : "OFF");
+
+    ScratchString json(arena);
+    json.printf("{\"led\":\"green\",\"state\":%s,"
+                "\"message\":\"LED toggled successfully\"}",
+                greenLEDState ? "true" : "false");
+    server.send(200, "application/json", json.c_str(), json.length());
   });
 
   server.on("/api/pot/read", []() {
-    int potValue = analogRead(POT_PIN);
-    float voltage = (potValue / 1023.0) * 3.3;
+    ScratchString json(arena);
+    printPotJson(json);
+    server.send(200, "application/json", json.c_str(), json.length());
+  });
 
-    String json = "{\"pot\": " + String(potValue) +
-                  ", \"voltage\": " + String(voltage, 2) + "}";
-    server.send(200, "application/json", json);
+#if WORKSHOP_RECORD
+  // WebSocket events and pot readings for replay on the host build; see
+  // src/session_recorder.h
+  server.on("/api/record", HTTP_GET, []() {
+    size_t size = workshopRecorder.chunkSize();
+    if (size > arena.available())
+      size = arena.available();
+    uint8_t *chunk = arena.allocate<uint8_t>(size);
+    size_t length = chunk != nullptr ? workshopRecorder.read(chunk, size) : 0;
+    if (length == 0) {
+      server.send(500, "application/json",
+                  "{\"error\":\"Response too large\"}");
+      return;
+    }
+    server.send(200, "application/octet-stream", (const char *)chunk, length);
   });
+#endif
 
   server.begin();
   Serial.println("Web server started");
@@ -389,6 +542,8 @@ void setup() {
   digitalWrite(RED_LED_PIN, LOW);
   digitalWrite(GREEN_LED_PIN, LOW);
 
+  setupDisplay();
+
   // Setup WiFi Access Point, web server, and WebSocket
   setupWiFiAP();
   setupWebServer();
@@ -396,6 +551,8 @@ void setup() {
   // Setup WebSocket
   webSocket.begin();
   webSocket.onEvent(webSocketEvent);
+  bus.subscribe(busMask(BUS_CLIENT), greetClient);
+  workshopLog.setMirror(mirrorLog);
 
   Serial.println("Potentiometer Control initialized successfully!");
   Serial.println("Dashboard available at: http://" + WiFi.localIP().toString());
@@ -405,8 +562,12 @@ void setup() {
 
 void loop() {
   server.handleClient();
+  arena.reset();
   webSocket.loop();
+  arena.reset();
+  workshopLog.drain();
 
+  samplePot();
   // Send potentiometer data every 100ms
   static unsigned long lastUpdate = 0;
   if (millis() - lastUpdate > 100) {
@@ -414,5 +575,7 @@ void loop() {
     lastUpdate = millis();
   }
 
-  delay(10);
+  updateDisplay();
+  // Short, so frames keep to 30 fps and the display flush keeps moving
+  delay(1);
 }
@@ -0,0 +1,20 @@
+#ifndef ARDUINOOTA_H
+#define ARDUINOOTA_H
+
+#include <functional>
+
+class ArduinoOTAClass {
+public:
+  typedef std::function<void(void)> THandlerFunction;
+
+  void setHostname(const char *hostname) { (void)hostname; }
+  void setPassword(const char *password) { (void)password; }
+  void onStart(THandlerFunction fn) { (void)fn; }
+  void onEnd(THandlerFunction fn) { (void)fn; }
+  void begin() {}
+  void handle() {}
+};
+
+extern ArduinoOTAClass ArduinoOTA;
+
+#endif
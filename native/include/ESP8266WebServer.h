@@ -0,0 +1,137 @@
+#ifndef ESP8266WEBSERVER_H
+#define ESP8266WEBSERVER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+enum HTTPMethod {
+  HTTP_ANY,
+  HTTP_GET,
+  HTTP_HEAD,
+  HTTP_POST,
+  HTTP_PUT,
+  HTTP_PATCH,
+  HTTP_DELETE,
+  HTTP_OPTIONS
+};
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+#define CONTENT_LENGTH_NOT_SET ((size_t)-2)
+#define HTTP_MAX_DATA_WAIT 5000
+
+// Host version of the core web server. Like the real one it services one
+// connection per handleClient() call, blocks until the request has arrived
+// and closes the connection after the response.
+class ESP8266WebServer {
+public:
+  typedef std::function<void(void)> THandlerFunction;
+
+  explicit ESP8266WebServer(int port = 80);
+
+  void begin();
+  void close();
+  void stop() { close(); }
+  void handleClient();
+
+  void on(const String &uri, THandlerFunction handler);
+  void on(const String &uri, HTTPMethod method, THandlerFunction handler);
+  void onNotFound(THandlerFunction handler);
+
+  String uri() const { return currentUri; }
+  HTTPMethod method() const { return currentMethod; }
+  WiFiClient &client() { return currentClient; }
+
+  String arg(const String &name) const;
+  String arg(int index) const;
+  String argName(int index) const;
+  int args() const { return argCount; }
+  bool hasArg(const String &name) const;
+  String header(const String &name) const;
+  String header(int index) const;
+  String headerName(int index) const;
+  int headers() const { return headerCount; }
+  bool hasHeader(const String &name) const;
+  void collectHeaders(const char *headerKeys[], size_t count) {
+    (void)headerKeys, (void)count; // all headers are collected
+  }
+
+  void send(int code, const char *contentType = nullptr,
+            const String &content = String(""));
+  void send(int code, const String &contentType, const String &content);
+  void send(int code, const char *contentType, const char *content);
+  void send(int code, const char *contentType, const char *content,
+            size_t length);
+  void send_P(int code, PGM_P contentType, PGM_P content);
+  void send_P(int code, PGM_P contentType, PGM_P content, size_t length);
+  void setContentLength(size_t length) { contentLength = length; }
+  void sendHeader(const String &name, const String &value,
+                  bool first = false);
+  void sendContent(const String &content);
+  void sendContent(const char *content, size_t length);
+  void sendContent_P(PGM_P content);
+  void sendContent_P(PGM_P content, size_t length);
+
+  // Host-only: run a request through the routing table without a socket.
+  // Returns the response body; status code and raw response size are
+  // reported through the optional pointers.
+  const std::string &simulateRequest(HTTPMethod method, const char *uri,
+                                     const char *body = nullptr,
+                                     int *code = nullptr,
+                                     size_t *responseBytes = nullptr);
+  // Host-only: add a request header for the next simulateRequest()
+  void simulateHeader(const char *name, const char *value);
+
+private:
+  struct Route {
+    String uri;
+    HTTPMethod method;
+    THandlerFunction handler;
+  };
+
+  static const int MAX_ARGS = 16;
+  static const int MAX_HEADERS = 16;
+  static const size_t MAX_REQUEST = 4096;
+
+  bool readRequest();
+  bool parseRequest(const char *request, size_t length);
+  void parseArgs(const char *query, size_t length);
+  void dispatch();
+  void resetRequest();
+  void writeRaw(const char *data, size_t length);
+  void writeHeaders(int code, const char *contentType, size_t length);
+
+  WiFiServer server;
+  WiFiClient currentClient;
+  std::vector<Route> routes;
+  THandlerFunction notFoundHandler;
+
+  String currentUri;
+  HTTPMethod currentMethod = HTTP_GET;
+  String argNames[MAX_ARGS];
+  String argValues[MAX_ARGS];
+  int argCount = 0;
+  String headerNames[MAX_HEADERS];
+  String headerValues[MAX_HEADERS];
+  int headerCount = 0;
+  bool http10 = false;
+
+  // Response state
+  String pendingHeaders;
+  size_t contentLength = CONTENT_LENGTH_NOT_SET;
+  bool chunked = false;
+  int responseCode = 0;
+  size_t responseBytes = 0;
+
+  // simulateRequest() capture
+  bool capturing = false;
+  std::string captureBody;
+  bool headersSent = false;
+
+  char requestBuffer[MAX_REQUEST + 1];
+};
+
+#endif
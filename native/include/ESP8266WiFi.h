@@ -0,0 +1,84 @@
+#ifndef ESP8266WIFI_H
+#define ESP8266WIFI_H
+
+#include <Arduino.h>
+
+#include "IPAddress.h"
+#include "WiFiClient.h"
+#include "WiFiServer.h"
+
+typedef enum {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3
+} WiFiMode_t;
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_WRONG_PASSWORD = 6,
+  WL_DISCONNECTED = 7
+} wl_status_t;
+
+// Simulated radio: station connects succeed after a configurable latency
+// (NativeHal::setWiFiConnectLatency) and the device is reachable on the
+// host's loopback interface.
+class ESP8266WiFiClass {
+public:
+  bool mode(WiFiMode_t mode);
+  WiFiMode_t getMode() { return currentMode; }
+  void persistent(bool enabled) { (void)enabled; }
+  bool setAutoReconnect(bool enabled) { return (void)enabled, true; }
+  bool hostname(const char *name) { return (void)name, true; }
+
+  wl_status_t begin(const char *ssid, const char *password = nullptr,
+                    int32_t channel = 0, const uint8_t *bssid = nullptr,
+                    bool connect = true);
+  bool config(IPAddress ip, IPAddress gateway, IPAddress subnet,
+              IPAddress dns1 = (uint32_t)0, IPAddress dns2 = (uint32_t)0);
+  bool disconnect(bool wifiOff = false);
+  bool reconnect();
+  wl_status_t status();
+  bool isConnected() { return status() == WL_CONNECTED; }
+
+  IPAddress localIP();
+  IPAddress gatewayIP();
+  IPAddress subnetMask();
+  IPAddress dnsIP(uint8_t index = 0);
+  String macAddress();
+  String SSID() { return String(ssid); }
+  int32_t RSSI();
+  int32_t channel();
+  uint8_t *BSSID();
+  String BSSIDstr();
+
+  bool softAP(const char *ssid, const char *password = nullptr,
+              int channel = 1, int hidden = 0, int maxConnections = 4);
+  IPAddress softAPIP();
+  uint8_t softAPgetStationNum() { return 0; }
+
+  // Host-only: force the next begin() to fail (tests the fallback path)
+  void simulateConnectFailure(bool fail) { failNextConnect = fail; }
+
+private:
+  WiFiMode_t currentMode = WIFI_OFF;
+  char ssid[33] = {0};
+  bool connecting = false;
+  bool failNextConnect = false;
+  unsigned long connectAt = 0;
+  IPAddress staticIP;
+  IPAddress staticGateway;
+  IPAddress staticSubnet;
+  IPAddress staticDNS;
+  uint8_t bssid[6] = {0x02, 0x00, 0x5E, 0x10, 0x20, 0x30};
+  int32_t currentChannel = 6;
+};
+
+extern ESP8266WiFiClass WiFi;
+
+#endif
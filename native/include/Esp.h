@@ -0,0 +1,30 @@
+#ifndef ESP_H
+#define ESP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "WString.h"
+
+class EspClass {
+public:
+  uint32_t getFreeHeap();
+  uint32_t getMaxFreeBlockSize();
+  uint8_t getHeapFragmentation();
+  void getHeapStats(uint32_t *free, uint32_t *maxBlock, uint8_t *frag);
+
+  uint32_t getChipId() { return 0x00C0FFEE; }
+  uint32_t getCycleCount(); // 80 MHz equivalent
+  uint8_t getCpuFreqMHz() { return 80; }
+  String getResetReason() { return String("External System"); }
+
+  // 512 bytes of RTC user memory; offset in 4-byte blocks, size in bytes
+  bool rtcUserMemoryRead(uint32_t offset, uint32_t *data, size_t size);
+  bool rtcUserMemoryWrite(uint32_t offset, uint32_t *data, size_t size);
+
+  void restart();
+};
+
+extern EspClass ESP;
+
+#endif
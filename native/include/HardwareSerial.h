@@ -0,0 +1,29 @@
+#ifndef HARDWARESERIAL_H
+#define HARDWARESERIAL_H
+
+#include "Print.h"
+
+class HardwareSerial : public Print {
+public:
+  void begin(unsigned long baud) { this->baud = baud; }
+  void end() {}
+  int available() { return 0; }
+  int read() { return -1; }
+  int availableForWrite() override;
+  void flush() override;
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+
+  operator bool() const { return true; }
+
+private:
+  void transmit(size_t bytes);
+
+  unsigned long baud = 115200;
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef IPADDRESS_H
+#define IPADDRESS_H
+
+#include <stdint.h>
+
+#include "Print.h"
+#include "WString.h"
+
+class IPAddress : public Printable {
+public:
+  IPAddress() : address(0) {}
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d)
+      : address((uint32_t)a | ((uint32_t)b << 8) | ((uint32_t)c << 16) |
+                ((uint32_t)d << 24)) {}
+  IPAddress(uint32_t address) : address(address) {}
+
+  operator uint32_t() const { return address; }
+  uint8_t operator[](int index) const {
+    return (address >> (index * 8)) & 0xFF;
+  }
+  bool operator==(const IPAddress &other) const {
+    return address == other.address;
+  }
+  bool operator!=(const IPAddress &other) const {
+    return address != other.address;
+  }
+
+  bool isSet() const { return address != 0; }
+  bool fromString(const char *str);
+  bool fromString(const String &str) { return fromString(str.c_str()); }
+  String toString() const;
+  size_t printTo(Print &p) const override;
+
+private:
+  uint32_t address; // network byte order, like lwIP
+};
+
+#endif
@@ -0,0 +1,6 @@
+#ifndef SPI_H
+#define SPI_H
+
+// Nothing on the workshop board uses SPI; header exists for includes only
+
+#endif
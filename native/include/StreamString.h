@@ -0,0 +1,17 @@
+#ifndef STREAMSTRING_H
+#define STREAMSTRING_H
+
+#include "Print.h"
+#include "WString.h"
+
+// String that can be printed into (the core's version is a full Stream)
+class StreamString : public String, public Print {
+public:
+  size_t write(uint8_t c) override { return concat((char)c) ? 1 : 0; }
+  size_t write(const uint8_t *buffer, size_t size) override {
+    return concat((const char *)buffer, size) ? size : 0;
+  }
+  using Print::write;
+};
+
+#endif
@@ -0,0 +1,126 @@
+#ifndef WSTRING_H
+#define WSTRING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+class __FlashStringHelper;
+
+// Host version of the Arduino String. Buffers come from the simulated heap
+// (native_heap.h) and short strings stay inline like the ESP8266 core's
+// small-string optimisation.
+class String {
+public:
+  String(const char *cstr = "");
+  String(const char *cstr, size_t length);
+  String(const __FlashStringHelper *str);
+  String(const String &other);
+  String(String &&other) noexcept;
+  explicit String(char c);
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(long long value, unsigned char base = 10);
+  explicit String(unsigned long long value, unsigned char base = 10);
+  explicit String(float value, unsigned char decimals = 2);
+  explicit String(double value, unsigned char decimals = 2);
+  ~String();
+
+  String &operator=(const String &other);
+  String &operator=(String &&other) noexcept;
+  String &operator=(const char *cstr);
+  String &operator=(const __FlashStringHelper *str);
+
+  bool reserve(size_t size);
+  unsigned int length() const { return len; }
+  bool isEmpty() const { return len == 0; }
+  const char *c_str() const { return buffer(); }
+  char *begin() { return wbuffer(); }
+  char *end() { return wbuffer() + len; }
+  const char *begin() const { return buffer(); }
+  const char *end() const { return buffer() + len; }
+
+  bool concat(const String &str);
+  bool concat(const char *cstr);
+  bool concat(const char *cstr, size_t length);
+  bool concat(const __FlashStringHelper *str);
+  bool concat(char c);
+  bool concat(int value);
+  bool concat(unsigned int value);
+  bool concat(long value);
+  bool concat(unsigned long value);
+  bool concat(long long value);
+  bool concat(unsigned long long value);
+  bool concat(double value);
+
+  template <typename T> String &operator+=(const T &value) {
+    concat(value);
+    return *this;
+  }
+
+  bool equals(const String &other) const;
+  bool equals(const char *cstr) const;
+  bool equalsIgnoreCase(const String &other) const;
+  bool operator==(const String &other) const { return equals(other); }
+  bool operator==(const char *cstr) const { return equals(cstr); }
+  bool operator!=(const String &other) const { return !equals(other); }
+  bool operator!=(const char *cstr) const { return !equals(cstr); }
+  bool operator<(const String &other) const;
+  bool startsWith(const String &prefix) const;
+  bool startsWith(const String &prefix, unsigned int offset) const;
+  bool endsWith(const String &suffix) const;
+
+  char charAt(unsigned int index) const;
+  void setCharAt(unsigned int index, char c);
+  char operator[](unsigned int index) const { return charAt(index); }
+  char &operator[](unsigned int index);
+
+  int indexOf(char c, unsigned int from = 0) const;
+  int indexOf(const char *str, unsigned int from = 0) const;
+  int indexOf(const String &str, unsigned int from = 0) const;
+  int lastIndexOf(char c) const;
+  int lastIndexOf(const String &str) const;
+  String substring(unsigned int left) const;
+  String substring(unsigned int left, unsigned int right) const;
+
+  void replace(const String &find, const String &replace);
+  void remove(unsigned int index);
+  void remove(unsigned int index, unsigned int count);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long toInt() const;
+  float toFloat() const;
+  double toDouble() const;
+
+private:
+  // Matches the ESP8266 core's SSO capacity
+  static const size_t SSO_CAPACITY = 11;
+
+  bool isSSO() const { return heapBuffer == nullptr; }
+  const char *buffer() const { return isSSO() ? sso : heapBuffer; }
+  char *wbuffer() { return isSSO() ? sso : heapBuffer; }
+  size_t capacity() const { return isSSO() ? SSO_CAPACITY - 1 : heapCapacity; }
+  void invalidate();
+  String &copy(const char *cstr, size_t length);
+
+  char sso[SSO_CAPACITY];
+  char *heapBuffer;
+  size_t heapCapacity;
+  size_t len;
+};
+
+String operator+(const String &lhs, const String &rhs);
+String operator+(const String &lhs, const char *rhs);
+String operator+(const char *lhs, const String &rhs);
+String operator+(const String &lhs, char rhs);
+String operator+(const String &lhs, int rhs);
+String operator+(const String &lhs, unsigned int rhs);
+String operator+(const String &lhs, long rhs);
+String operator+(const String &lhs, unsigned long rhs);
+
+#endif
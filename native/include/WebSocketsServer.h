@@ -0,0 +1,75 @@
+#ifndef WEBSOCKETSSERVER_H
+#define WEBSOCKETSSERVER_H
+
+#include <functional>
+
+#include <Arduino.h>
+#include <IPAddress.h>
+
+#define WEBSOCKETS_SERVER_CLIENT_MAX 5
+
+typedef enum {
+  WStype_ERROR,
+  WStype_DISCONNECTED,
+  WStype_CONNECTED,
+  WStype_TEXT,
+  WStype_BIN,
+  WStype_FRAGMENT_TEXT_START,
+  WStype_FRAGMENT_BIN_START,
+  WStype_FRAGMENT,
+  WStype_FRAGMENT_FIN,
+  WStype_PING,
+  WStype_PONG,
+} WStype_t;
+
+// Host version of links2004/WebSockets' server. There is no socket; tools
+// inject client events and the server counts what it would have sent.
+class WebSocketsServer {
+public:
+  typedef std::function<void(uint8_t num, WStype_t type, uint8_t *payload,
+                             size_t length)>
+      WebSocketServerEvent;
+
+  explicit WebSocketsServer(uint16_t port) : port(port) {}
+  ~WebSocketsServer() {
+    if (started == this)
+      started = nullptr;
+  }
+
+  void begin() { started = this; }
+  void loop() {}
+  void onEvent(WebSocketServerEvent handler) { eventHandler = handler; }
+
+  bool sendTXT(uint8_t num, const char *payload, size_t length = 0);
+  bool sendTXT(uint8_t num, const String &payload) {
+    return sendTXT(num, payload.c_str(), payload.length());
+  }
+  bool broadcastTXT(const char *payload, size_t length = 0);
+  bool broadcastTXT(const String &payload) {
+    return broadcastTXT(payload.c_str(), payload.length());
+  }
+  uint8_t connectedClients() const { return clients; }
+  IPAddress remoteIP(uint8_t num) {
+    (void)num;
+    return IPAddress(127, 0, 0, 1);
+  }
+
+  // Host-only
+  void injectEvent(uint8_t num, WStype_t type, const char *payload,
+                   size_t length);
+  uint64_t messagesSent() const { return sent; }
+  uint64_t bytesSent() const { return sentBytes; }
+  // Most recently begun server, where replayed events go
+  static WebSocketsServer *running() { return started; }
+
+private:
+  static WebSocketsServer *started;
+
+  uint16_t port;
+  WebSocketServerEvent eventHandler;
+  uint8_t clients = 0;
+  uint64_t sent = 0;
+  uint64_t sentBytes = 0;
+};
+
+#endif
@@ -0,0 +1,54 @@
+#ifndef WIFICLIENT_H
+#define WIFICLIENT_H
+
+#include <memory>
+
+#include "IPAddress.h"
+#include "Print.h"
+
+// TCP client backed by a non-blocking host socket. Copies share the
+// connection like the core's reference-counted ClientContext.
+class WiFiClient : public Print {
+public:
+  WiFiClient() {}
+  explicit WiFiClient(int fd);
+
+  int connect(IPAddress ip, uint16_t port);
+  int connect(const char *host, uint16_t port);
+
+  uint8_t connected();
+  int available();
+  int read();
+  int read(uint8_t *buffer, size_t size);
+  int peek();
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *buffer, size_t size) override;
+  using Print::write;
+  size_t write_P(const char *buffer, size_t size) {
+    return write((const uint8_t *)buffer, size);
+  }
+  int availableForWrite() override { return 1460; }
+  void flush() override {}
+  void stop();
+  void setNoDelay(bool noDelay);
+  void setTimeout(unsigned long ms) { timeout = ms; }
+
+  IPAddress remoteIP();
+  uint16_t remotePort();
+
+  operator bool() { return connected(); }
+  bool operator==(const WiFiClient &other) const {
+    return context == other.context;
+  }
+
+private:
+  struct Context {
+    int fd;
+    bool peerClosed;
+    ~Context();
+  };
+  std::shared_ptr<Context> context;
+  unsigned long timeout = 5000;
+};
+
+#endif
@@ -0,0 +1,31 @@
+#ifndef WIFISERVER_H
+#define WIFISERVER_H
+
+#include <stdint.h>
+
+#include "WiFiClient.h"
+
+// Listens on 127.0.0.1 at NativeHal::hostPort(port)
+class WiFiServer {
+public:
+  explicit WiFiServer(uint16_t port) : port(port) {}
+  ~WiFiServer() { close(); }
+
+  void begin();
+  void begin(uint16_t port);
+  bool hasClient();
+  WiFiClient accept();
+  WiFiClient available() { return accept(); }
+  void setNoDelay(bool noDelay) { this->noDelay = noDelay; }
+  uint8_t status() { return fd >= 0 ? 1 : 0; }
+  void close();
+  void stop() { close(); }
+
+private:
+  uint16_t port;
+  int fd = -1;
+  int pendingFd = -1;
+  bool noDelay = false;
+};
+
+#endif
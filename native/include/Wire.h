@@ -0,0 +1,65 @@
+#ifndef WIRE_H
+#define WIRE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define BUFFER_LENGTH 128
+
+// I2C master that goes nowhere but keeps books: bytes written and the time
+// those bytes would have taken on the bus at the configured clock. A
+// listener sees every finished transaction (a device model, a recorder).
+class TwoWire {
+public:
+  typedef void (*Listener)(uint8_t address, const uint8_t *data,
+                           size_t length);
+
+  void begin() { begun = true; }
+  void begin(int sda, int scl) {
+    (void)sda, (void)scl;
+    begun = true;
+  }
+  void setClock(uint32_t frequency) { clock = frequency; }
+  uint32_t getClock() const { return clock; }
+
+  void beginTransmission(uint8_t address);
+  size_t write(uint8_t data);
+  size_t write(const uint8_t *data, size_t length);
+  uint8_t endTransmission(bool sendStop = true);
+  uint8_t requestFrom(uint8_t address, uint8_t quantity) {
+    (void)address, (void)quantity;
+    return 0;
+  }
+  int available() { return 0; }
+  int read() { return -1; }
+
+  // Host-only accounting
+  bool isBegun() const { return begun; }
+  uint64_t bytesSent() const { return totalBytes; }
+  uint64_t transactions() const { return totalTransactions; }
+  uint64_t busMicros() const { return totalBusMicros; }
+  void resetStats() {
+    totalBytes = 0;
+    totalTransactions = 0;
+    totalBusMicros = 0;
+  }
+
+  // Bus time for `bytes` payload bytes in one transaction at `clock` Hz
+  static uint32_t transactionMicros(size_t bytes, uint32_t clock);
+  void setListener(Listener listener) { this->listener = listener; }
+
+private:
+  bool begun = false;
+  uint32_t clock = 100000;
+  uint8_t target = 0;
+  uint8_t data[BUFFER_LENGTH];
+  size_t pending = 0;
+  Listener listener = nullptr;
+  uint64_t totalBytes = 0;
+  uint64_t totalTransactions = 0;
+  uint64_t totalBusMicros = 0;
+};
+
+extern TwoWire Wire;
+
+#endif
@@ -0,0 +1,83 @@
+#ifndef HEADLESS_DISPLAY_H
+#define HEADLESS_DISPLAY_H
+
+#include <Adafruit_SSD1306.h>
+
+#include <vector>
+
+#include "display_flusher.h"
+
+// SSD1306 without a panel, for measuring and regression-testing display
+// output on the host. It draws like Adafruit_SSD1306 (so it can stand in
+// for it behind WorkshopESP::setDisplay()) and also plays the panel: it
+// listens on the fake Wire, decodes the command stream (addressing and
+// the arguments of the init commands) and keeps the GDDRAM the bytes
+// would have written. When the DisplayFlusher it watches completes a
+// frame, the GDDRAM is captured together with the I2C traffic since the
+// previous frame. Frames sent with a blocking display() are captured by
+// calling captureFrame() afterwards.
+//
+// Captures export as binary PBM (one file per frame) or as an animated
+// GIF timed by the capture timestamps.
+class HeadlessDisplay : public Adafruit_SSD1306 {
+public:
+  static const uint8_t PANEL_WIDTH = 128;
+  static const uint8_t PANEL_PAGES = 8;
+  static const size_t FRAME_SIZE = PANEL_WIDTH * PANEL_PAGES;
+
+  struct Frame {
+    uint8_t pixels[FRAME_SIZE]; // SSD1306 page format, as on the panel
+    uint32_t bytes;             // I2C bytes including address bytes
+    uint32_t transactions;
+    uint32_t busMicros;         // at the clock each transaction ran at
+    uint64_t atMicros;          // micros() when captured
+  };
+
+  explicit HeadlessDisplay(uint8_t address = 0x3C, TwoWire *twi = &Wire);
+  ~HeadlessDisplay();
+
+  // Becomes the device on the bus (one at a time) and, if given, captures
+  // every frame `flusher` completes
+  void listen(DisplayFlusher *flusher = nullptr);
+  void stopListening();
+
+  // What the panel shows, in the framebuffer's layout
+  const uint8_t *panel() const { return ram[0]; }
+  bool showing(const uint8_t *framebuffer) const;
+
+  void captureFrame();
+  const std::vector<Frame> &frames() const { return captured; }
+  void clearFrames() { captured.clear(); }
+  // Traffic not yet part of a captured frame
+  uint32_t pendingBytes() const { return bytes; }
+
+  // Frames first.. as binary PBM (P4, 1 = lit), one image after the
+  // other in the same file as the format allows
+  bool writePbm(const char *path, size_t first = 0,
+                size_t count = SIZE_MAX) const;
+  // prefix0000.pbm, prefix0001.pbm, ...; returns files written
+  size_t writePbmSequence(const char *prefix) const;
+  // Every frame, `scale` pixels per panel pixel, looping
+  bool writeGif(const char *path, uint8_t scale = 2) const;
+  // Reads up to `maxFrames` images written by writePbm() into page format
+  // (FRAME_SIZE bytes each); returns how many
+  static size_t readPbm(const char *path, uint8_t *pixels, size_t maxFrames);
+
+private:
+  static void receive(uint8_t address, const uint8_t *data, size_t length);
+  static void frameDone(const uint8_t *frame);
+  void commandByte(uint8_t b);
+  void dataByte(uint8_t b);
+
+  uint8_t panelAddress;
+  uint8_t ram[PANEL_PAGES][PANEL_WIDTH];
+  uint8_t command; // waiting for this command's arguments
+  uint8_t args[2];
+  uint8_t argCount;
+  uint8_t columnStart, columnEnd, pageStart, pageEnd, column, page;
+  DisplayFlusher *flusher;
+  uint32_t bytes, transactions, busMicros;
+  std::vector<Frame> captured;
+};
+
+#endif
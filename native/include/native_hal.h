@@ -0,0 +1,47 @@
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+#include <stdint.h>
+
+// Knobs for the host fakes that have no Arduino equivalent. Only the
+// native environment, the benchmark suite and host tools include this.
+namespace NativeHal {
+
+// Time source for millis()/micros()/delay(). The real clock follows the
+// host's monotonic clock and delay() sleeps; the virtual clock only moves
+// when delay() or advanceMicros() is called, which lets tools replay
+// sessions as fast as the CPU allows.
+void useVirtualClock(bool enabled);
+bool virtualClock();
+void advanceMicros(uint64_t us);
+
+// Analog input: fixed value per pin, or a callback sampled on every read
+typedef int (*AnalogSource)(uint8_t pin);
+void setAnalogValue(uint8_t pin, int value);
+void setAnalogSource(AnalogSource source);
+
+int digitalState(uint8_t pin);
+int pwmValue(uint8_t pin);
+
+// Serial output goes to stdout unless muted (benchmarks mute it)
+void muteSerial(bool muted);
+
+// UART: when enabled, Serial models a 128-byte TX FIFO drained at the baud
+// rate; availableForWrite() reports its room and a write into a full FIFO
+// stalls (spins on the real clock, advances the virtual clock)
+void stallOnSerial(bool enabled);
+
+// Simulated station connect latency, full scan + DHCP vs cached channel
+void setWiFiConnectLatency(uint32_t fullMs, uint32_t cachedMs);
+
+// I2C: when enabled, every endTransmission() stalls for the modelled bus
+// time (spins on the real clock, advances the virtual clock)
+void stallOnI2C(bool enabled);
+
+// TCP port the fake servers listen on for a given device port
+// (default: device port + 8000, override with WORKSHOP_NATIVE_PORT_OFFSET)
+uint16_t hostPort(uint16_t devicePort);
+
+} // namespace NativeHal
+
+#endif
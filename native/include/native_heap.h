@@ -0,0 +1,34 @@
+#ifndef NATIVE_HEAP_H
+#define NATIVE_HEAP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Simulated ESP8266 heap for the host build. String buffers and display
+// buffers are carved out of a fixed 40 KB region with a first-fit
+// allocator, so free heap, largest free block and fragmentation behave
+// like they do on the board. Everything else uses the host allocator but
+// is still counted.
+namespace NativeHeap {
+
+static const size_t HEAP_SIZE = 40 * 1024;
+
+struct Stats {
+  uint64_t allocations; // NativeHeap::alloc + operator new
+  uint64_t frees;
+  uint64_t bytesAllocated;
+};
+
+void *alloc(size_t size);
+void *realloc(void *ptr, size_t size);
+void free(void *ptr);
+
+uint32_t freeBytes();
+uint32_t maxFreeBlock();
+uint8_t fragmentation(); // same formula as ESP.getHeapFragmentation()
+
+Stats stats();
+
+} // namespace NativeHeap
+
+#endif
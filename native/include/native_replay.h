@@ -0,0 +1,30 @@
+#ifndef NATIVE_REPLAY_H
+#define NATIVE_REPLAY_H
+
+#include <stdio.h>
+
+// Replays a session recorded on the board (GET /api/record, see
+// src/session_recorder.h) against the host build: HTTP requests go to the
+// sketch's server over loopback, WebSocket events into the running
+// WebSocketsServer and sensor readings into analogRead(). The native entry
+// point drives it with --replay FILE [--speed N|max].
+namespace NativeReplay {
+
+// Reads the recording; false (with a message on stderr) if unusable
+bool load(const char *path);
+
+// Time scale: 1 replays at the recorded pace, 0 as fast as possible (needs
+// the virtual clock, which is then moved past idle gaps)
+void setSpeed(double speed);
+
+// Sends what is due and collects responses; call before every loop().
+// False once every event is sent and every response is in.
+bool poll();
+
+// Latency per route, WebSocket/sensor counts and heap behaviour; returns
+// the number of failed requests
+int printReport(FILE *out);
+
+} // namespace NativeReplay
+
+#endif
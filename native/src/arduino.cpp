@@ -0,0 +1,215 @@
+#include <Arduino.h>
+#include <ArduinoOTA.h>
+
+#include <chrono>
+#include <thread>
+
+#include "native_hal.h"
+#include "native_heap.h"
+
+HardwareSerial Serial;
+EspClass ESP;
+ArduinoOTAClass ArduinoOTA;
+
+namespace {
+
+const int PIN_COUNT = 18;
+
+int pinStates[PIN_COUNT];
+int pwmValues[PIN_COUNT];
+int analogValues[PIN_COUNT];
+NativeHal::AnalogSource analogSource = nullptr;
+
+bool virtualClockEnabled = false;
+uint64_t virtualMicros = 0;
+const auto startTime = std::chrono::steady_clock::now();
+
+bool serialMuted = false;
+
+// UART model: a 128-byte TX FIFO emptied at the baud rate (10 bits a byte)
+const size_t SERIAL_FIFO = 128;
+bool serialStall = false;
+uint64_t serialIdleAt = 0; // µs when the FIFO will be empty
+
+uint32_t rtcMemory[128];
+
+uint64_t nowMicros() {
+  if (virtualClockEnabled)
+    return virtualMicros;
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now() - startTime)
+      .count();
+}
+
+} // namespace
+
+namespace NativeHal {
+
+void useVirtualClock(bool enabled) {
+  if (enabled && !virtualClockEnabled)
+    virtualMicros = nowMicros();
+  virtualClockEnabled = enabled;
+}
+
+bool virtualClock() { return virtualClockEnabled; }
+
+void advanceMicros(uint64_t us) {
+  if (virtualClockEnabled) {
+    virtualMicros += us;
+    return;
+  }
+  // Busy-wait so short stalls are not rounded up by the scheduler
+  uint64_t until = nowMicros() + us;
+  while (nowMicros() < until) {
+  }
+}
+
+void setAnalogValue(uint8_t pin, int value) {
+  if (pin < PIN_COUNT)
+    analogValues[pin] = value;
+}
+
+void setAnalogSource(AnalogSource source) { analogSource = source; }
+
+int digitalState(uint8_t pin) { return pin < PIN_COUNT ? pinStates[pin] : 0; }
+
+int pwmValue(uint8_t pin) { return pin < PIN_COUNT ? pwmValues[pin] : 0; }
+
+void muteSerial(bool muted) { serialMuted = muted; }
+
+void stallOnSerial(bool enabled) { serialStall = enabled; }
+
+uint16_t hostPort(uint16_t devicePort) {
+  static int offset = -1;
+  if (offset < 0) {
+    const char *env = getenv("WORKSHOP_NATIVE_PORT_OFFSET");
+    offset = env ? atoi(env) : 8000;
+  }
+  return (uint16_t)(devicePort + offset);
+}
+
+} // namespace NativeHal
+
+void pinMode(uint8_t pin, uint8_t mode) { (void)pin, (void)mode; }
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  if (pin < PIN_COUNT)
+    pinStates[pin] = value ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) { return NativeHal::digitalState(pin); }
+
+int analogRead(uint8_t pin) {
+  if (analogSource != nullptr)
+    return analogSource(pin);
+  return pin < PIN_COUNT ? analogValues[pin] : 0;
+}
+
+void analogWrite(uint8_t pin, int value) {
+  if (pin < PIN_COUNT)
+    pwmValues[pin] = value;
+}
+
+void analogWriteRange(uint32_t range) { (void)range; }
+
+unsigned long millis() { return (unsigned long)(nowMicros() / 1000); }
+
+unsigned long micros() { return (unsigned long)nowMicros(); }
+
+void delay(unsigned long ms) {
+  if (virtualClockEnabled) {
+    virtualMicros += (uint64_t)ms * 1000;
+    return;
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(unsigned int us) { NativeHal::advanceMicros(us); }
+
+void yield() {}
+
+void noInterrupts() {}
+void interrupts() {}
+
+long random(long max) { return max > 0 ? rand() % max : 0; }
+long random(long min, long max) {
+  return max > min ? min + rand() % (max - min) : min;
+}
+void randomSeed(unsigned long seed) { srand((unsigned int)seed); }
+
+int HardwareSerial::availableForWrite() {
+  if (!serialStall)
+    return SERIAL_FIFO;
+  uint64_t now = nowMicros();
+  if (serialIdleAt <= now)
+    return SERIAL_FIFO;
+  uint64_t byteMicros = 10000000 / baud;
+  uint64_t queued = (serialIdleAt - now + byteMicros - 1) / byteMicros;
+  return queued < SERIAL_FIFO ? (int)(SERIAL_FIFO - queued) : 0;
+}
+
+// Like the core's UART driver, returns once the bytes are in the FIFO
+void HardwareSerial::transmit(size_t bytes) {
+  if (!serialStall)
+    return;
+  uint64_t byteMicros = 10000000 / baud;
+  uint64_t now = nowMicros();
+  serialIdleAt = (serialIdleAt > now ? serialIdleAt : now) + bytes * byteMicros;
+  uint64_t fits = serialIdleAt - SERIAL_FIFO * byteMicros;
+  if (serialIdleAt > SERIAL_FIFO * byteMicros && fits > now)
+    NativeHal::advanceMicros(fits - now);
+}
+
+void HardwareSerial::flush() {
+  if (!serialMuted)
+    fflush(stdout);
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  if (!serialMuted)
+    fputc(c, stdout);
+  transmit(1);
+  return 1;
+}
+
+size_t HardwareSerial::write(const uint8_t *buffer, size_t size) {
+  if (!serialMuted)
+    fwrite(buffer, 1, size, stdout);
+  transmit(size);
+  return size;
+}
+
+uint32_t EspClass::getFreeHeap() { return NativeHeap::freeBytes(); }
+
+uint32_t EspClass::getMaxFreeBlockSize() { return NativeHeap::maxFreeBlock(); }
+
+uint8_t EspClass::getHeapFragmentation() { return NativeHeap::fragmentation(); }
+
+void EspClass::getHeapStats(uint32_t *free, uint32_t *maxBlock, uint8_t *frag) {
+  if (free)
+    *free = getFreeHeap();
+  if (maxBlock)
+    *maxBlock = getMaxFreeBlockSize();
+  if (frag)
+    *frag = getHeapFragmentation();
+}
+
+uint32_t EspClass::getCycleCount() { return (uint32_t)(nowMicros() * 80); }
+
+bool EspClass::rtcUserMemoryRead(uint32_t offset, uint32_t *data,
+                                 size_t size) {
+  if (offset * 4 + size > sizeof(rtcMemory) || size % 4 != 0)
+    return false;
+  memcpy(data, &rtcMemory[offset], size);
+  return true;
+}
+
+bool EspClass::rtcUserMemoryWrite(uint32_t offset, uint32_t *data,
+                                  size_t size) {
+  if (offset * 4 + size > sizeof(rtcMemory) || size % 4 != 0)
+    return false;
+  memcpy(&rtcMemory[offset], data, size);
+  return true;
+}
+
+void EspClass::restart() { exit(0); }
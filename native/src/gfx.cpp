@@ -0,0 +1,363 @@
+#include <Adafruit_GFX.h>
+#include <Adafruit_SSD1306.h>
+
+#include "native_heap.h"
+
+namespace {
+
+// Printable ASCII of the classic 5x7 font (glcdfont.c), 5 columns per glyph
+const uint8_t font[95][5] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00}, {0x00, 0x00, 0x5F, 0x00, 0x00},
+    {0x00, 0x07, 0x00, 0x07, 0x00}, {0x14, 0x7F, 0x14, 0x7F, 0x14},
+    {0x24, 0x2A, 0x7F, 0x2A, 0x12}, {0x23, 0x13, 0x08, 0x64, 0x62},
+    {0x36, 0x49, 0x56, 0x20, 0x50}, {0x00, 0x08, 0x07, 0x03, 0x00},
+    {0x00, 0x1C, 0x22, 0x41, 0x00}, {0x00, 0x41, 0x22, 0x1C, 0x00},
+    {0x2A, 0x1C, 0x7F, 0x1C, 0x2A}, {0x08, 0x08, 0x3E, 0x08, 0x08},
+    {0x00, 0x80, 0x70, 0x30, 0x00}, {0x08, 0x08, 0x08, 0x08, 0x08},
+    {0x00, 0x00, 0x60, 0x60, 0x00}, {0x20, 0x10, 0x08, 0x04, 0x02},
+    {0x3E, 0x51, 0x49, 0x45, 0x3E}, {0x00, 0x42, 0x7F, 0x40, 0x00},
+    {0x72, 0x49, 0x49, 0x49, 0x46}, {0x21, 0x41, 0x49, 0x4D, 0x33},
+    {0x18, 0x14, 0x12, 0x7F, 0x10}, {0x27, 0x45, 0x45, 0x45, 0x39},
+    {0x3C, 0x4A, 0x49, 0x49, 0x31}, {0x41, 0x21, 0x11, 0x09, 0x07},
+    {0x36, 0x49, 0x49, 0x49, 0x36}, {0x46, 0x49, 0x49, 0x29, 0x1E},
+    {0x00, 0x00, 0x14, 0x00, 0x00}, {0x00, 0x40, 0x34, 0x00, 0x00},
+    {0x00, 0x08, 0x14, 0x22, 0x41}, {0x14, 0x14, 0x14, 0x14, 0x14},
+    {0x00, 0x41, 0x22, 0x14, 0x08}, {0x02, 0x01, 0x59, 0x09, 0x06},
+    {0x3E, 0x41, 0x5D, 0x59, 0x4E}, {0x7C, 0x12, 0x11, 0x12, 0x7C},
+    {0x7F, 0x49, 0x49, 0x49, 0x36}, {0x3E, 0x41, 0x41, 0x41, 0x22},
+    {0x7F, 0x41, 0x41, 0x41, 0x3E}, {0x7F, 0x49, 0x49, 0x49, 0x41},
+    {0x7F, 0x09, 0x09, 0x09, 0x01}, {0x3E, 0x41, 0x41, 0x51, 0x73},
+    {0x7F, 0x08, 0x08, 0x08, 0x7F}, {0x00, 0x41, 0x7F, 0x41, 0x00},
+    {0x20, 0x40, 0x41, 0x3F, 0x01}, {0x7F, 0x08, 0x14, 0x22, 0x41},
+    {0x7F, 0x40, 0x40, 0x40, 0x40}, {0x7F, 0x02, 0x1C, 0x02, 0x7F},
+    {0x7F, 0x04, 0x08, 0x10, 0x7F}, {0x3E, 0x41, 0x41, 0x41, 0x3E},
+    {0x7F, 0x09, 0x09, 0x09, 0x06}, {0x3E, 0x41, 0x51, 0x21, 0x5E},
+    {0x7F, 0x09, 0x19, 0x29, 0x46}, {0x26, 0x49, 0x49, 0x49, 0x32},
+    {0x03, 0x01, 0x7F, 0x01, 0x03}, {0x3F, 0x40, 0x40, 0x40, 0x3F},
+    {0x1F, 0x20, 0x40, 0x20, 0x1F}, {0x3F, 0x40, 0x38, 0x40, 0x3F},
+    {0x63, 0x14, 0x08, 0x14, 0x63}, {0x03, 0x04, 0x78, 0x04, 0x03},
+    {0x61, 0x59, 0x49, 0x4D, 0x43}, {0x00, 0x7F, 0x41, 0x41, 0x41},
+    {0x02, 0x04, 0x08, 0x10, 0x20}, {0x00, 0x41, 0x41, 0x41, 0x7F},
+    {0x04, 0x02, 0x01, 0x02, 0x04}, {0x40, 0x40, 0x40, 0x40, 0x40},
+    {0x00, 0x03, 0x07, 0x08, 0x00}, {0x20, 0x54, 0x54, 0x78, 0x40},
+    {0x7F, 0x28, 0x44, 0x44, 0x38}, {0x38, 0x44, 0x44, 0x44, 0x28},
+    {0x38, 0x44, 0x44, 0x28, 0x7F}, {0x38, 0x54, 0x54, 0x54, 0x18},
+    {0x00, 0x08, 0x7E, 0x09, 0x02}, {0x18, 0xA4, 0xA4, 0x9C, 0x78},
+    {0x7F, 0x08, 0x04, 0x04, 0x78}, {0x00, 0x44, 0x7D, 0x40, 0x00},
+    {0x20, 0x40, 0x40, 0x3D, 0x00}, {0x7F, 0x10, 0x28, 0x44, 0x00},
+    {0x00, 0x41, 0x7F, 0x40, 0x00}, {0x7C, 0x04, 0x78, 0x04, 0x78},
+    {0x7C, 0x08, 0x04, 0x04, 0x78}, {0x38, 0x44, 0x44, 0x44, 0x38},
+    {0xFC, 0x18, 0x24, 0x24, 0x18}, {0x18, 0x24, 0x24, 0x18, 0xFC},
+    {0x7C, 0x08, 0x04, 0x04, 0x08}, {0x48, 0x54, 0x54, 0x54, 0x24},
+    {0x04, 0x04, 0x3F, 0x44, 0x24}, {0x3C, 0x40, 0x40, 0x20, 0x7C},
+    {0x1C, 0x20, 0x40, 0x20, 0x1C}, {0x3C, 0x40, 0x30, 0x40, 0x3C},
+    {0x44, 0x28, 0x10, 0x28, 0x44}, {0x4C, 0x90, 0x90, 0x90, 0x7C},
+    {0x44, 0x64, 0x54, 0x4C, 0x44}, {0x00, 0x08, 0x36, 0x41, 0x00},
+    {0x00, 0x00, 0x77, 0x00, 0x00}, {0x00, 0x41, 0x36, 0x08, 0x00},
+    {0x02, 0x01, 0x02, 0x04, 0x02}};
+
+// Non-ASCII bytes (e.g. UTF-8 box drawing) render as a hollow box
+const uint8_t unknownGlyph[5] = {0x7F, 0x41, 0x41, 0x41, 0x7F};
+
+} // namespace
+
+// --- Adafruit_GFX ---
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h)
+    : WIDTH(w), HEIGHT(h), _width(w), _height(h), cursor_x(0), cursor_y(0),
+      textcolor(0xFFFF), textbgcolor(0xFFFF), textsize_x(1), textsize_y(1),
+      rotation(0), wrap(true), _cp437(false) {}
+
+const uint8_t *Adafruit_GFX::glyph(unsigned char c) {
+  if (c >= 0x20 && c <= 0x7E)
+    return font[c - 0x20];
+  return unknownGlyph;
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                 uint16_t color) {
+  for (int16_t i = 0; i < h; i++)
+    writePixel(x, y + i, color);
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                 uint16_t color) {
+  for (int16_t i = 0; i < w; i++)
+    writePixel(x + i, y, color);
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                            uint16_t color) {
+  for (int16_t i = x; i < x + w; i++)
+    drawFastVLine(i, y, h, color);
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color) {
+  fillRect(0, 0, _width, _height, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1,
+                            uint16_t color) {
+  int16_t dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+  int16_t dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+  int16_t err = dx + dy;
+  for (;;) {
+    writePixel(x0, y0, color);
+    if (x0 == x1 && y0 == y1)
+      break;
+    int16_t e2 = 2 * err;
+    if (e2 >= dy) {
+      err += dy;
+      x0 += sx;
+    }
+    if (e2 <= dx) {
+      err += dx;
+      y0 += sy;
+    }
+  }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h,
+                            uint16_t color) {
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y, h, color);
+  drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t bitmap[],
+                              int16_t w, int16_t h, uint16_t color) {
+  int16_t byteWidth = (w + 7) / 8;
+  for (int16_t j = 0; j < h; j++) {
+    for (int16_t i = 0; i < w; i++) {
+      if (bitmap[j * byteWidth + i / 8] & (0x80 >> (i & 7)))
+        writePixel(x + i, y + j, color);
+    }
+  }
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
+                            uint16_t color, uint16_t bg, uint8_t size) {
+  drawChar(x, y, c, color, bg, size, size);
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c,
+                            uint16_t color, uint16_t bg, uint8_t sizeX,
+                            uint8_t sizeY) {
+  if (x >= _width || y >= _height || (x + 6 * sizeX - 1) < 0 ||
+      (y + 8 * sizeY - 1) < 0)
+    return;
+
+  const uint8_t *columns = glyph(c);
+  startWrite();
+  for (int8_t i = 0; i < 5; i++) {
+    uint8_t line = columns[i];
+    for (int8_t j = 0; j < 8; j++, line >>= 1) {
+      if (line & 1) {
+        if (sizeX == 1 && sizeY == 1)
+          writePixel(x + i, y + j, color);
+        else
+          writeFillRect(x + i * sizeX, y + j * sizeY, sizeX, sizeY, color);
+      } else if (bg != color) {
+        if (sizeX == 1 && sizeY == 1)
+          writePixel(x + i, y + j, bg);
+        else
+          writeFillRect(x + i * sizeX, y + j * sizeY, sizeX, sizeY, bg);
+      }
+    }
+  }
+  if (bg != color) {
+    if (sizeX == 1 && sizeY == 1)
+      drawFastVLine(x + 5, y, 8, bg);
+    else
+      writeFillRect(x + 5 * sizeX, y, sizeX, 8 * sizeY, bg);
+  }
+  endWrite();
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+  if (c == '\n') {
+    cursor_x = 0;
+    cursor_y += textsize_y * 8;
+  } else if (c != '\r') {
+    if (wrap && ((cursor_x + textsize_x * 6) > _width)) {
+      cursor_x = 0;
+      cursor_y += textsize_y * 8;
+    }
+    drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x,
+             textsize_y);
+    cursor_x += textsize_x * 6;
+  }
+  return 1;
+}
+
+void Adafruit_GFX::getTextBounds(const char *str, int16_t x, int16_t y,
+                                 int16_t *x1, int16_t *y1, uint16_t *w,
+                                 uint16_t *h) {
+  int16_t maxX = x, maxY = y, cx = x, cy = y;
+  for (const char *p = str; *p; p++) {
+    if (*p == '\n') {
+      cx = 0;
+      cy += textsize_y * 8;
+      continue;
+    }
+    if (*p == '\r')
+      continue;
+    if (wrap && cx + textsize_x * 6 > _width) {
+      cx = 0;
+      cy += textsize_y * 8;
+    }
+    cx += textsize_x * 6;
+    if (cx - 1 > maxX)
+      maxX = cx - 1;
+    if (cy + textsize_y * 8 - 1 > maxY)
+      maxY = cy + textsize_y * 8 - 1;
+  }
+  *x1 = x;
+  *y1 = y;
+  *w = maxX >= x ? maxX - x + 1 : 0;
+  *h = maxY >= y ? maxY - y + 1 : 0;
+}
+
+// --- Adafruit_SSD1306 ---
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire *twi,
+                                   int8_t rstPin, uint32_t clkDuring,
+                                   uint32_t clkAfter)
+    : Adafruit_GFX(w, h), wire(twi ? twi : &Wire), buffer(nullptr),
+      i2caddr(0), wireClk(clkDuring), restoreClk(clkAfter), frames(0) {
+  (void)rstPin;
+}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() { NativeHeap::free(buffer); }
+
+bool Adafruit_SSD1306::begin(uint8_t switchvcc, uint8_t addr, bool reset,
+                             bool periphBegin) {
+  (void)switchvcc, (void)reset;
+  if (!buffer) {
+    buffer = (uint8_t *)NativeHeap::alloc(WIDTH * ((HEIGHT + 7) / 8));
+    if (!buffer)
+      return false;
+  }
+  clearDisplay();
+  i2caddr = addr ? addr : ((HEIGHT == 32) ? 0x3C : 0x3D);
+  if (periphBegin)
+    wire->begin();
+
+  // Same length as the library's init sequence
+  static const uint8_t init[] = {
+      SSD1306_DISPLAYOFF, 0xD5, 0x80, 0xA8, 0x3F, 0xD3, 0x00, 0x40, 0x8D,
+      0x14, SSD1306_MEMORYMODE, 0x00, 0xA1, 0xC8, 0xDA, 0x12,
+      SSD1306_SETCONTRAST, 0xCF, 0xD9, 0xF1, 0xDB, 0x40,
+      SSD1306_DISPLAYALLON_RESUME, SSD1306_NORMALDISPLAY, 0x2E,
+      SSD1306_DISPLAYON};
+  wire->setClock(wireClk);
+  commandList(init, sizeof(init));
+  wire->setClock(restoreClk);
+  return true;
+}
+
+void Adafruit_SSD1306::commandList(const uint8_t *c, uint8_t n) {
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x00);
+  uint16_t bytesOut = 1;
+  while (n--) {
+    if (bytesOut >= BUFFER_LENGTH) {
+      wire->endTransmission();
+      wire->beginTransmission(i2caddr);
+      wire->write((uint8_t)0x00);
+      bytesOut = 1;
+    }
+    wire->write(*c++);
+    bytesOut++;
+  }
+  wire->endTransmission();
+}
+
+void Adafruit_SSD1306::ssd1306_command(uint8_t c) {
+  wire->setClock(wireClk);
+  commandList(&c, 1);
+  wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::display() {
+  if (!buffer)
+    return;
+  wire->setClock(wireClk);
+  static const uint8_t addressing[] = {SSD1306_PAGEADDR, 0, 0xFF,
+                                       SSD1306_COLUMNADDR, 0};
+  commandList(addressing, sizeof(addressing));
+  uint8_t lastColumn = WIDTH - 1;
+  commandList(&lastColumn, 1);
+
+  uint16_t count = WIDTH * ((HEIGHT + 7) / 8);
+  const uint8_t *ptr = buffer;
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x40);
+  uint16_t bytesOut = 1;
+  while (count--) {
+    if (bytesOut >= BUFFER_LENGTH) {
+      wire->endTransmission();
+      wire->beginTransmission(i2caddr);
+      wire->write((uint8_t)0x40);
+      bytesOut = 1;
+    }
+    wire->write(*ptr++);
+    bytesOut++;
+  }
+  wire->endTransmission();
+  wire->setClock(restoreClk);
+  frames++;
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+  if (buffer)
+    memset(buffer, 0, WIDTH * ((HEIGHT + 7) / 8));
+}
+
+void Adafruit_SSD1306::invertDisplay(bool i) {
+  ssd1306_command(i ? SSD1306_INVERTDISPLAY : SSD1306_NORMALDISPLAY);
+}
+
+void Adafruit_SSD1306::dim(bool dim) {
+  uint8_t contrast[] = {SSD1306_SETCONTRAST, (uint8_t)(dim ? 0 : 0xCF)};
+  wire->setClock(wireClk);
+  commandList(contrast, sizeof(contrast));
+  wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (!buffer || x < 0 || x >= _width || y < 0 || y >= _height)
+    return;
+  uint8_t &cell = buffer[x + (y / 8) * WIDTH];
+  uint8_t bit = 1 << (y & 7);
+  switch (color) {
+  case SSD1306_WHITE:
+    cell |= bit;
+    break;
+  case SSD1306_BLACK:
+    cell &= ~bit;
+    break;
+  case SSD1306_INVERSE:
+    cell ^= bit;
+    break;
+  }
+}
+
+void Adafruit_SSD1306::drawFastHLine(int16_t x, int16_t y, int16_t w,
+                                     uint16_t color) {
+  for (int16_t i = 0; i < w; i++)
+    drawPixel(x + i, y, color);
+}
+
+void Adafruit_SSD1306::drawFastVLine(int16_t x, int16_t y, int16_t h,
+                                     uint16_t color) {
+  for (int16_t i = 0; i < h; i++)
+    drawPixel(x, y + i, color);
+}
+
+bool Adafruit_SSD1306::getPixel(int16_t x, int16_t y) {
+  if (!buffer || x < 0 || x >= _width || y < 0 || y >= _height)
+    return false;
+  return buffer[x + (y / 8) * WIDTH] & (1 << (y & 7));
+}
@@ -0,0 +1,355 @@
+#include "headless_display.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <string>
+
+namespace {
+
+HeadlessDisplay *active = nullptr; // the one listening on Wire
+
+const uint8_t CONTROL_DATA = 0x40;
+
+// Arguments following each command the library sends
+uint8_t argumentsOf(uint8_t command) {
+  switch (command) {
+  case SSD1306_COLUMNADDR:
+  case SSD1306_PAGEADDR:
+    return 2;
+  case SSD1306_MEMORYMODE:
+  case SSD1306_SETCONTRAST:
+  case 0xD5: // clock divide
+  case 0xA8: // multiplex
+  case 0xD3: // display offset
+  case 0x8D: // charge pump
+  case 0xDA: // COM pins
+  case 0xD9: // precharge
+  case 0xDB: // VCOMH
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+bool pixelAt(const uint8_t *pixels, int x, int y) {
+  return pixels[(y / 8) * HeadlessDisplay::PANEL_WIDTH + x] & (1 << (y % 8));
+}
+
+// GIF image data: variable-width LZW codes packed LSB first into
+// sub-blocks of at most 255 bytes
+class GifWriter {
+public:
+  explicit GifWriter(FILE *out) : out(out) {}
+
+  void image(const uint8_t *pixels, uint8_t scale) {
+    const uint16_t CLEAR = 4; // 2-bit minimum code size for 2 colours
+    const uint16_t END = 5;
+    fputc(2, out);
+    accumulator = 0;
+    used = 0;
+    reset();
+    put(CLEAR);
+    int prefix = -1;
+    int width = HeadlessDisplay::PANEL_WIDTH * scale;
+    int height = HeadlessDisplay::PANEL_PAGES * 8 * scale;
+    for (int y = 0; y < height; y++) {
+      for (int x = 0; x < width; x++) {
+        uint8_t pixel = pixelAt(pixels, x / scale, y / scale);
+        if (prefix < 0) {
+          prefix = pixel;
+          continue;
+        }
+        if (child[prefix][pixel] != 0) {
+          prefix = child[prefix][pixel];
+          continue;
+        }
+        put(prefix);
+        child[prefix][pixel] = next++;
+        // The decoder adds its entry one code later, so widen once the
+        // code after next no longer fits
+        if (next == (1u << bits) + 1 && bits < 12)
+          bits++;
+        if (next == 4096) {
+          put(CLEAR);
+          reset();
+        }
+        prefix = pixel;
+      }
+    }
+    put(prefix);
+    put(END);
+    if (used > 0) {
+      block[length++] = accumulator & 0xFF;
+      if (length == 255)
+        flushBlock();
+    }
+    flushBlock();
+    fputc(0, out); // block terminator
+  }
+
+private:
+  void reset() {
+    // Code 0 is never a child (single pixels are 0 and 1), so 0 = absent
+    memset(child, 0, sizeof(child));
+    next = 6;
+    bits = 3;
+  }
+
+  void put(uint16_t code) {
+    accumulator |= (uint32_t)code << used;
+    used += bits;
+    while (used >= 8) {
+      block[length++] = accumulator & 0xFF;
+      accumulator >>= 8;
+      used -= 8;
+      if (length == 255)
+        flushBlock();
+    }
+  }
+
+  void flushBlock() {
+    if (length == 0)
+      return;
+    fputc(length, out);
+    fwrite(block, 1, length, out);
+    length = 0;
+  }
+
+  FILE *out;
+  uint16_t child[4096][2];
+  uint16_t next = 6;
+  uint8_t bits = 3;
+  uint32_t accumulator = 0;
+  uint8_t used = 0;
+  uint8_t block[255];
+  uint8_t length = 0;
+};
+
+void putWord(FILE *out, uint16_t value) {
+  fputc(value & 0xFF, out);
+  fputc(value >> 8, out);
+}
+
+} // namespace
+
+HeadlessDisplay::HeadlessDisplay(uint8_t address, TwoWire *twi)
+    : Adafruit_SSD1306(PANEL_WIDTH, PANEL_PAGES * 8, twi, -1),
+      panelAddress(address), flusher(nullptr), bytes(0), transactions(0),
+      busMicros(0) {
+  memset(ram, 0, sizeof(ram));
+  command = 0;
+  argCount = 0;
+  columnStart = column = 0;
+  columnEnd = PANEL_WIDTH - 1;
+  pageStart = page = 0;
+  pageEnd = PANEL_PAGES - 1;
+}
+
+HeadlessDisplay::~HeadlessDisplay() { stopListening(); }
+
+void HeadlessDisplay::listen(DisplayFlusher *flusher) {
+  stopListening();
+  active = this;
+  wire->setListener(receive);
+  this->flusher = flusher;
+  if (flusher != nullptr)
+    flusher->setFrameListener(frameDone);
+}
+
+void HeadlessDisplay::stopListening() {
+  if (active != this)
+    return;
+  wire->setListener(nullptr);
+  if (flusher != nullptr)
+    flusher->setFrameListener(nullptr);
+  flusher = nullptr;
+  active = nullptr;
+}
+
+void HeadlessDisplay::receive(uint8_t address, const uint8_t *data,
+                              size_t length) {
+  HeadlessDisplay *self = active;
+  if (self == nullptr || address != self->panelAddress || length == 0)
+    return;
+  self->bytes += length + 1;
+  self->transactions++;
+  self->busMicros +=
+      TwoWire::transactionMicros(length, self->wire->getClock());
+  for (size_t i = 1; i < length; i++) {
+    if (data[0] == CONTROL_DATA)
+      self->dataByte(data[i]);
+    else
+      self->commandByte(data[i]);
+  }
+}
+
+void HeadlessDisplay::frameDone(const uint8_t *frame) {
+  (void)frame; // the panel's copy is what gets captured
+  if (active != nullptr)
+    active->captureFrame();
+}
+
+void HeadlessDisplay::commandByte(uint8_t b) {
+  if (command == 0) {
+    if (argumentsOf(b) > 0) {
+      command = b;
+      argCount = 0;
+    }
+    return;
+  }
+  args[argCount++] = b;
+  if (argCount < argumentsOf(command))
+    return;
+  if (command == SSD1306_COLUMNADDR) {
+    columnStart = column = args[0] & 0x7F;
+    columnEnd = args[1] & 0x7F;
+  } else if (command == SSD1306_PAGEADDR) {
+    pageStart = page = args[0] & 7;
+    pageEnd = args[1] & 7;
+  }
+  command = 0;
+}
+
+void HeadlessDisplay::dataByte(uint8_t b) {
+  // Horizontal addressing: along the column window, then the next page
+  ram[page][column] = b;
+  if (column++ < columnEnd)
+    return;
+  column = columnStart;
+  page = page < pageEnd ? page + 1 : pageStart;
+}
+
+bool HeadlessDisplay::showing(const uint8_t *framebuffer) const {
+  return memcmp(ram, framebuffer, FRAME_SIZE) == 0;
+}
+
+void HeadlessDisplay::captureFrame() {
+  captured.emplace_back();
+  Frame &frame = captured.back();
+  memcpy(frame.pixels, ram, FRAME_SIZE);
+  frame.bytes = bytes;
+  frame.transactions = transactions;
+  frame.busMicros = busMicros;
+  frame.atMicros = micros();
+  bytes = 0;
+  transactions = 0;
+  busMicros = 0;
+}
+
+bool HeadlessDisplay::writePbm(const char *path, size_t first,
+                               size_t count) const {
+  if (first >= captured.size())
+    return false;
+  if (count > captured.size() - first)
+    count = captured.size() - first;
+  FILE *out = fopen(path, "wb");
+  if (out == nullptr)
+    return false;
+  for (size_t i = first; i < first + count; i++) {
+    const uint8_t *pixels = captured[i].pixels;
+    fprintf(out, "P4\n%u %u\n", PANEL_WIDTH, PANEL_PAGES * 8);
+    for (int y = 0; y < PANEL_PAGES * 8; y++) {
+      for (int x = 0; x < PANEL_WIDTH; x += 8) {
+        uint8_t packed = 0;
+        for (int bit = 0; bit < 8; bit++)
+          packed |= pixelAt(pixels, x + bit, y) << (7 - bit);
+        fputc(packed, out);
+      }
+    }
+  }
+  return fclose(out) == 0;
+}
+
+size_t HeadlessDisplay::writePbmSequence(const char *prefix) const {
+  size_t written = 0;
+  for (size_t i = 0; i < captured.size(); i++) {
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "%04u.pbm", (unsigned)i);
+    if (writePbm((std::string(prefix) + suffix).c_str(), i, 1))
+      written++;
+  }
+  return written;
+}
+
+size_t HeadlessDisplay::readPbm(const char *path, uint8_t *pixels,
+                                size_t maxFrames) {
+  FILE *in = fopen(path, "rb");
+  if (in == nullptr)
+    return 0;
+  size_t frames = 0;
+  for (; frames < maxFrames; frames++, pixels += FRAME_SIZE) {
+    unsigned width = 0, height = 0;
+    bool ok = fscanf(in, " P4 %u %u", &width, &height) == 2 &&
+              width == PANEL_WIDTH && height == PANEL_PAGES * 8u &&
+              fgetc(in) != EOF; // the single whitespace before the raster
+    memset(pixels, 0, FRAME_SIZE);
+    for (unsigned y = 0; ok && y < height; y++) {
+      for (unsigned x = 0; ok && x < width; x += 8) {
+        int packed = fgetc(in);
+        ok = packed != EOF;
+        for (int bit = 0; ok && bit < 8; bit++)
+          if (packed & (0x80 >> bit))
+            pixels[(y / 8) * PANEL_WIDTH + x + bit] |= 1 << (y % 8);
+      }
+    }
+    if (!ok)
+      break;
+  }
+  fclose(in);
+  return frames;
+}
+
+bool HeadlessDisplay::writeGif(const char *path, uint8_t scale) const {
+  if (captured.empty() || scale == 0)
+    return false;
+  FILE *out = fopen(path, "wb");
+  if (out == nullptr)
+    return false;
+  uint16_t width = PANEL_WIDTH * scale;
+  uint16_t height = PANEL_PAGES * 8 * scale;
+
+  fwrite("GIF89a", 1, 6, out);
+  putWord(out, width);
+  putWord(out, height);
+  fputc(0x80, out); // global colour table of 2 entries
+  fputc(0, out);    // background colour
+  fputc(0, out);    // pixel aspect ratio
+  const uint8_t palette[] = {0x00, 0x00, 0x00, 0xFF, 0xFF, 0xFF};
+  fwrite(palette, 1, sizeof(palette), out);
+  // Loop forever
+  const uint8_t loop[] = {0x21, 0xFF, 0x0B, 'N', 'E', 'T', 'S', 'C', 'A',
+                          'P',  'E',  '2',  '.', '0', 0x03, 0x01, 0x00,
+                          0x00, 0x00};
+  fwrite(loop, 1, sizeof(loop), out);
+
+  GifWriter *writer = new GifWriter(out); // 16 KB code table
+  for (size_t i = 0; i < captured.size(); i++) {
+    // Shown until the next capture, in centiseconds (viewers treat less
+    // than 2 as "as fast as possible"); the last frame holds for a second
+    uint64_t shown = i + 1 < captured.size()
+                         ? captured[i + 1].atMicros - captured[i].atMicros
+                         : 1000000;
+    uint64_t delay = (shown + 5000) / 10000;
+    if (delay < 2)
+      delay = 2;
+    if (delay > 0xFFFF)
+      delay = 0xFFFF;
+    const uint8_t control[] = {0x21, 0xF9, 0x04, 0x00};
+    fwrite(control, 1, sizeof(control), out);
+    putWord(out, delay);
+    fputc(0, out); // no transparent colour
+    fputc(0, out);
+
+    fputc(0x2C, out);
+    putWord(out, 0);
+    putWord(out, 0);
+    putWord(out, width);
+    putWord(out, height);
+    fputc(0, out); // no local colour table, not interlaced
+    writer->image(captured[i].pixels, scale);
+  }
+  delete writer;
+  fputc(0x3B, out);
+  return fclose(out) == 0;
+}
@@ -0,0 +1,33 @@
+#include "IPAddress.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+bool IPAddress::fromString(const char *str) {
+  unsigned int parts[4];
+  char trailing;
+  if (sscanf(str, "%u.%u.%u.%u%c", &parts[0], &parts[1], &parts[2], &parts[3],
+             &trailing) != 4) {
+    return false;
+  }
+  for (int i = 0; i < 4; i++) {
+    if (parts[i] > 255)
+      return false;
+  }
+  *this = IPAddress(parts[0], parts[1], parts[2], parts[3]);
+  return true;
+}
+
+String IPAddress::toString() const {
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", (*this)[0], (*this)[1],
+           (*this)[2], (*this)[3]);
+  return String(buffer);
+}
+
+size_t IPAddress::printTo(Print &p) const {
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u", (*this)[0], (*this)[1],
+           (*this)[2], (*this)[3]);
+  return p.print(buffer);
+}
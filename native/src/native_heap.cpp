@@ -0,0 +1,210 @@
+#include "native_heap.h"
+
+#include <atomic>
+#include <math.h>
+#include <new>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+// Block header; size includes the header and is a multiple of 8
+struct Block {
+  uint32_t size;
+  uint32_t used;
+};
+
+alignas(8) uint8_t heap[NativeHeap::HEAP_SIZE];
+bool initialized = false;
+
+std::atomic<uint64_t> allocations(0);
+std::atomic<uint64_t> frees(0);
+std::atomic<uint64_t> bytesAllocated(0);
+
+Block *blockAt(size_t offset) { return (Block *)(heap + offset); }
+
+void init() {
+  if (initialized)
+    return;
+  Block *first = blockAt(0);
+  first->size = NativeHeap::HEAP_SIZE;
+  first->used = 0;
+  initialized = true;
+}
+
+bool owns(void *ptr) {
+  return (uint8_t *)ptr >= heap && (uint8_t *)ptr < heap + sizeof(heap);
+}
+
+// Merges runs of free blocks starting at `offset`
+void coalesce(size_t offset) {
+  Block *block = blockAt(offset);
+  while (offset + block->size < NativeHeap::HEAP_SIZE) {
+    Block *next = blockAt(offset + block->size);
+    if (next->used)
+      break;
+    block->size += next->size;
+  }
+}
+
+size_t blockSizeFor(size_t size) {
+  return ((size + sizeof(Block) + 7) / 8) * 8;
+}
+
+} // namespace
+
+namespace NativeHeap {
+
+void *alloc(size_t size) {
+  init();
+  if (size == 0)
+    size = 1;
+  size_t needed = blockSizeFor(size);
+
+  for (size_t offset = 0; offset < HEAP_SIZE; offset += blockAt(offset)->size) {
+    Block *block = blockAt(offset);
+    if (block->used)
+      continue;
+    coalesce(offset);
+    if (block->size < needed)
+      continue;
+
+    // Split if the remainder can hold a header plus something
+    if (block->size - needed >= sizeof(Block) + 8) {
+      Block *rest = blockAt(offset + needed);
+      rest->size = block->size - needed;
+      rest->used = 0;
+      block->size = needed;
+    }
+    block->used = 1;
+    allocations++;
+    bytesAllocated += size;
+    return heap + offset + sizeof(Block);
+  }
+  return nullptr;
+}
+
+void free(void *ptr) {
+  if (ptr == nullptr || !owns(ptr))
+    return;
+  size_t offset = (uint8_t *)ptr - heap - sizeof(Block);
+  blockAt(offset)->used = 0;
+  coalesce(offset);
+  frees++;
+}
+
+void *realloc(void *ptr, size_t size) {
+  if (ptr == nullptr)
+    return alloc(size);
+  if (!owns(ptr))
+    return nullptr;
+
+  size_t offset = (uint8_t *)ptr - heap - sizeof(Block);
+  Block *block = blockAt(offset);
+  size_t needed = blockSizeFor(size);
+
+  // Grow in place into a free neighbour when possible
+  if (block->size < needed && offset + block->size < HEAP_SIZE) {
+    Block *next = blockAt(offset + block->size);
+    if (!next->used) {
+      coalesce(offset + block->size);
+      if (block->size + next->size >= needed) {
+        block->size += next->size;
+      }
+    }
+  }
+  if (block->size >= needed) {
+    if (block->size - needed >= sizeof(Block) + 8) {
+      Block *rest = blockAt(offset + needed);
+      rest->size = block->size - needed;
+      rest->used = 0;
+      block->size = needed;
+      coalesce(offset + needed);
+    }
+    bytesAllocated += size;
+    return ptr;
+  }
+
+  void *moved = alloc(size);
+  if (moved == nullptr)
+    return nullptr;
+  memcpy(moved, ptr, block->size - sizeof(Block));
+  free(ptr);
+  return moved;
+}
+
+uint32_t freeBytes() {
+  init();
+  uint32_t total = 0;
+  for (size_t offset = 0; offset < HEAP_SIZE; offset += blockAt(offset)->size) {
+    Block *block = blockAt(offset);
+    if (!block->used)
+      total += block->size - sizeof(Block);
+  }
+  return total;
+}
+
+uint32_t maxFreeBlock() {
+  init();
+  uint32_t largest = 0;
+  for (size_t offset = 0; offset < HEAP_SIZE; offset += blockAt(offset)->size) {
+    Block *block = blockAt(offset);
+    if (block->used)
+      continue;
+    coalesce(offset);
+    if (block->size - sizeof(Block) > largest)
+      largest = block->size - sizeof(Block);
+  }
+  return largest;
+}
+
+uint8_t fragmentation() {
+  init();
+  double sumSquares = 0;
+  double total = 0;
+  for (size_t offset = 0; offset < HEAP_SIZE; offset += blockAt(offset)->size) {
+    Block *block = blockAt(offset);
+    if (block->used)
+      continue;
+    coalesce(offset);
+    double size = block->size - sizeof(Block);
+    sumSquares += size * size;
+    total += size;
+  }
+  if (total == 0)
+    return 0;
+  return (uint8_t)(100 - (100 * sqrt(sumSquares)) / total);
+}
+
+Stats stats() {
+  Stats s;
+  s.allocations = allocations;
+  s.frees = frees;
+  s.bytesAllocated = bytesAllocated;
+  return s;
+}
+
+} // namespace NativeHeap
+
+// Count host allocations too so benchmarks can report allocations/op
+void *operator new(size_t size) {
+  allocations++;
+  bytesAllocated += size;
+  void *ptr = malloc(size ? size : 1);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void *operator new[](size_t size) { return operator new(size); }
+
+void operator delete(void *ptr) noexcept {
+  if (ptr != nullptr) {
+    frees++;
+    ::free(ptr);
+  }
+}
+
+void operator delete[](void *ptr) noexcept { operator delete(ptr); }
+void operator delete(void *ptr, size_t) noexcept { operator delete(ptr); }
+void operator delete[](void *ptr, size_t) noexcept { operator delete(ptr); }
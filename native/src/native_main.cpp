@@ -0,0 +1,50 @@
+// Entry point for the host build: runs the sketch's setup() once and then
+// loop() until interrupted, or for --run-for <ms> if given. With
+// --replay FILE it feeds a session recorded on the board to the sketch
+// (--speed N scales time, --speed max runs it on the virtual clock as fast
+// as possible), prints a latency and heap report and exits.
+
+#include <Arduino.h>
+
+#include "native_hal.h"
+#include "native_replay.h"
+
+int main(int argc, char **argv) {
+  unsigned long runFor = 0;
+  const char *replay = nullptr;
+  double speed = 1;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--run-for") == 0 && i + 1 < argc)
+      runFor = strtoul(argv[++i], nullptr, 10);
+    else if (strcmp(argv[i], "--virtual-clock") == 0)
+      NativeHal::useVirtualClock(true);
+    else if (strcmp(argv[i], "--quiet") == 0)
+      NativeHal::muteSerial(true);
+    else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+      replay = argv[++i];
+    else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc)
+      speed = strcmp(argv[++i], "max") == 0 ? 0 : atof(argv[i]);
+  }
+
+  setbuf(stdout, nullptr);
+  if (replay != nullptr) {
+    if (!NativeReplay::load(replay))
+      return 2;
+    NativeReplay::setSpeed(speed);
+    if (speed <= 0)
+      NativeHal::useVirtualClock(true);
+  }
+
+  setup();
+  if (replay != nullptr) {
+    while (NativeReplay::poll())
+      loop();
+    return NativeReplay::printReport(stderr) == 0 ? 0 : 1;
+  }
+
+  unsigned long start = millis();
+  while (runFor == 0 || millis() - start < runFor) {
+    loop();
+  }
+  return 0;
+}
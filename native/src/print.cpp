@@ -0,0 +1,141 @@
+#include "Print.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+size_t Print::write(const uint8_t *buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    if (write(*buffer++))
+      n++;
+    else
+      break;
+  }
+  return n;
+}
+
+size_t Print::write(const char *str) {
+  if (str == nullptr)
+    return 0;
+  return write((const uint8_t *)str, strlen(str));
+}
+
+size_t Print::vprintf(const char *format, va_list args) {
+  char stackBuffer[64];
+  va_list copy;
+  va_copy(copy, args);
+  int length = vsnprintf(stackBuffer, sizeof(stackBuffer), format, copy);
+  va_end(copy);
+  if (length < 0)
+    return 0;
+  if ((size_t)length < sizeof(stackBuffer))
+    return write((const uint8_t *)stackBuffer, length);
+
+  char *buffer = (char *)malloc(length + 1);
+  if (buffer == nullptr)
+    return 0;
+  vsnprintf(buffer, length + 1, format, args);
+  size_t n = write((const uint8_t *)buffer, length);
+  free(buffer);
+  return n;
+}
+
+size_t Print::printf(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  size_t n = vprintf(format, args);
+  va_end(args);
+  return n;
+}
+
+size_t Print::printf_P(const char *format, ...) {
+  va_list args;
+  va_start(args, format);
+  size_t n = vprintf(format, args);
+  va_end(args);
+  return n;
+}
+
+size_t Print::printNumber(unsigned long long value, int base) {
+  char buffer[66];
+  char *p = buffer + sizeof(buffer) - 1;
+  *p = 0;
+  if (base < 2)
+    base = 10;
+  do {
+    int digit = value % base;
+    *--p = digit < 10 ? '0' + digit : 'A' + digit - 10;
+    value /= base;
+  } while (value);
+  return write(p);
+}
+
+size_t Print::print(const __FlashStringHelper *str) {
+  return write(reinterpret_cast<const char *>(str));
+}
+size_t Print::print(const String &str) {
+  return write((const uint8_t *)str.c_str(), str.length());
+}
+size_t Print::print(const char *str) { return write(str); }
+size_t Print::print(char c) { return write((uint8_t)c); }
+size_t Print::print(unsigned char value, int base) {
+  return printNumber(value, base);
+}
+size_t Print::print(int value, int base) {
+  return print((long long)value, base);
+}
+size_t Print::print(unsigned int value, int base) {
+  return printNumber(value, base);
+}
+size_t Print::print(long value, int base) {
+  return print((long long)value, base);
+}
+size_t Print::print(unsigned long value, int base) {
+  return printNumber(value, base);
+}
+size_t Print::print(long long value, int base) {
+  if (base == 10 && value < 0) {
+    size_t n = write('-');
+    return n + printNumber((unsigned long long)(-value), base);
+  }
+  return printNumber((unsigned long long)value, base);
+}
+size_t Print::print(unsigned long long value, int base) {
+  return printNumber(value, base);
+}
+size_t Print::print(double value, int digits) {
+  char buffer[64];
+  snprintf(buffer, sizeof(buffer), "%.*f", digits, value);
+  return write(buffer);
+}
+size_t Print::print(const Printable &printable) {
+  return printable.printTo(*this);
+}
+
+size_t Print::println() { return write("\r\n"); }
+
+#define PRINTLN(type)                                                          \
+  size_t Print::println(type value) {                                          \
+    size_t n = print(value);                                                   \
+    return n + println();                                                      \
+  }
+#define PRINTLN_BASE(type)                                                     \
+  size_t Print::println(type value, int base) {                                \
+    size_t n = print(value, base);                                             \
+    return n + println();                                                      \
+  }
+
+PRINTLN(const __FlashStringHelper *)
+PRINTLN(const String &)
+PRINTLN(const char *)
+PRINTLN(char)
+PRINTLN(const Printable &)
+PRINTLN_BASE(unsigned char)
+PRINTLN_BASE(int)
+PRINTLN_BASE(unsigned int)
+PRINTLN_BASE(long)
+PRINTLN_BASE(unsigned long)
+PRINTLN_BASE(long long)
+PRINTLN_BASE(unsigned long long)
+PRINTLN_BASE(double)
@@ -0,0 +1,575 @@
+#include "native_replay.h"
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h>
+#include <WebSocketsServer.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "native_hal.h"
+#include "native_heap.h"
+
+namespace {
+
+// Record kinds and chunk layout, as written by SessionRecorder
+enum Kind : uint8_t { HTTP_REQUEST = 1, WS_EVENT, SENSOR_SAMPLE };
+const size_t CHUNK_HEADER = 14;
+const uint8_t VERSION = 1;
+
+const uint16_t HTTP_PORT = 80;
+const size_t CONNECTIONS_PER_CLIENT = 4; // browsers open up to six
+// With the virtual clock, time only moves past a response still being
+// waited for (a long poll) after this many polls without progress
+const int IDLE_POLLS = 3;
+
+const char *METHOD_NAMES[] = {"GET", "GET",   "HEAD",   "POST",
+                              "PUT", "PATCH", "DELETE", "OPTIONS"};
+
+struct Event {
+  uint64_t at; // µs since the first recorded event
+  uint8_t kind;
+  // HTTP_REQUEST
+  uint32_t ip;
+  bool head;
+  std::string route;
+  std::string request;
+  // WS_EVENT
+  uint8_t client;
+  uint8_t type;
+  std::string payload;
+  // SENSOR_SAMPLE
+  uint8_t pin;
+  int value;
+};
+
+struct Pending {
+  size_t event;
+  double dueAt; // host s; latency is measured from here
+  bool retried;
+};
+
+struct Connection {
+  int fd;
+  uint32_t ip;
+  bool busy;
+  bool reused; // has carried a request before
+  Pending current;
+  std::string response;
+};
+
+struct RouteStats {
+  std::vector<double> latencies; // ms
+  uint32_t failures = 0;
+};
+
+const char *sourcePath = "";
+std::vector<Event> events;
+size_t nextEvent = 0;
+uint32_t droppedOnDevice = 0;
+double speed = 1;
+
+std::vector<Connection> connections;
+std::map<uint32_t, std::deque<Pending>> waiting; // per client address
+std::map<std::string, RouteStats> routes;
+
+bool started = false;
+std::chrono::steady_clock::time_point hostStart;
+uint64_t sessionNow = 0; // µs of replayed time
+uint32_t lastMicros = 0;
+int idlePolls = 0;
+
+uint32_t webSocketEvents = 0;
+uint32_t webSocketMissed = 0;
+uint32_t samples = 0;
+
+uint32_t heapStart = 0;
+uint32_t heapLowest = 0;
+uint32_t blockStart = 0;
+uint32_t blockLowest = 0;
+uint8_t fragmentationPeak = 0;
+NativeHeap::Stats allocStart;
+
+double hostSeconds() {
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       hostStart)
+      .count();
+}
+
+uint32_t readLE(const uint8_t *p, size_t bytes) {
+  uint32_t value = 0;
+  for (size_t i = 0; i < bytes; i++)
+    value |= (uint32_t)p[i] << (8 * i);
+  return value;
+}
+
+// Cursor over one record; reads past the end leave it failed
+struct Reader {
+  const uint8_t *p;
+  const uint8_t *end;
+  bool ok = true;
+
+  uint8_t byte() {
+    if (p >= end) {
+      ok = false;
+      return 0;
+    }
+    return *p++;
+  }
+  uint32_t varint() {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+      uint8_t b = byte();
+      value |= (uint32_t)(b & 0x7f) << shift;
+      if (!(b & 0x80))
+        return value;
+    }
+    ok = false;
+    return value;
+  }
+  std::string text() {
+    uint32_t length = varint();
+    if (!ok || (size_t)(end - p) < length) {
+      ok = false;
+      return std::string();
+    }
+    std::string value((const char *)p, length);
+    p += length;
+    return value;
+  }
+};
+
+bool parseRecord(uint8_t kind, Reader &r, Event &event) {
+  event.kind = kind;
+  switch (kind) {
+  case HTTP_REQUEST: {
+    event.ip = r.varint();
+    uint8_t method = r.byte();
+    bool form = r.byte() != 0;
+    std::string path = r.text();
+    std::string query = r.text();
+    std::string body = r.text();
+    if (method >= sizeof(METHOD_NAMES) / sizeof(METHOD_NAMES[0]))
+      method = HTTP_GET;
+    event.head = method == HTTP_HEAD;
+    event.route = std::string(METHOD_NAMES[method]) + " " + path;
+    event.request = std::string(METHOD_NAMES[method]) + " " + path;
+    if (!query.empty())
+      event.request += "?" + query;
+    event.request += " HTTP/1.1\r\nHost: replay\r\n";
+    if (form)
+      event.request += "Content-Type: application/x-www-form-urlencoded\r\n";
+    if (!body.empty() || method == HTTP_POST)
+      event.request += "Content-Length: " + std::to_string(body.size()) +
+                       "\r\n";
+    event.request += "\r\n" + body;
+    break;
+  }
+  case WS_EVENT:
+    event.client = r.byte();
+    event.type = r.byte();
+    event.payload = r.text();
+    break;
+  case SENSOR_SAMPLE: {
+    event.pin = r.byte();
+    uint32_t zigzag = r.varint();
+    event.value = (int)(zigzag >> 1) ^ -(int)(zigzag & 1);
+    break;
+  }
+  default:
+    return false; // newer recorder; skipped
+  }
+  return r.ok;
+}
+
+// Request complete: status code and whether the connection stays open
+bool responseDone(const Connection &c, bool closed, bool head, int *code,
+                  bool *keepAlive) {
+  const std::string &r = c.response;
+  size_t headerEnd = r.find("\r\n\r\n");
+  if (headerEnd == std::string::npos)
+    return false;
+  *code = r.size() > 12 ? atoi(r.c_str() + 9) : 0;
+
+  std::string headers = r.substr(0, headerEnd + 2);
+  std::transform(headers.begin(), headers.end(), headers.begin(), ::tolower);
+  *keepAlive = !closed && headers.compare(0, 8, "http/1.0") != 0 &&
+               headers.find("\r\nconnection: close\r\n") == std::string::npos;
+
+  size_t bodyStart = headerEnd + 4;
+  if (head || *code == 204 || *code == 304 || *code < 200)
+    return true;
+  size_t at = headers.find("\r\ncontent-length:");
+  if (at != std::string::npos)
+    return r.size() - bodyStart >= strtoul(headers.c_str() + at + 17,
+                                           nullptr, 10);
+  if (headers.find("\r\ntransfer-encoding: chunked\r\n") != std::string::npos)
+    return r.size() >= 5 && r.compare(r.size() - 5, 5, "0\r\n\r\n") == 0;
+  return closed; // body runs to the end of the connection
+}
+
+void closeConnection(Connection &c) {
+  if (c.fd >= 0)
+    close(c.fd);
+  c.fd = -1;
+  c.busy = false;
+}
+
+int openSocket() {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(NativeHal::hostPort(HTTP_PORT));
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (connect(fd, (sockaddr *)&addr, sizeof(addr)) < 0) {
+    close(fd);
+    return -1;
+  }
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  return fd;
+}
+
+void fail(const Pending &pending) {
+  routes[events[pending.event].route].failures++;
+}
+
+bool send(Connection &c, const Pending &pending) {
+  const std::string &request = events[pending.event].request;
+  c.busy = true;
+  c.current = pending;
+  c.response.clear();
+  return write(c.fd, request.data(), request.size()) ==
+         (ssize_t)request.size();
+}
+
+// Starts the request on an idle connection of its client, or a new one
+// while the client has fewer than CONNECTIONS_PER_CLIENT
+bool dispatch(uint32_t ip, const Pending &pending) {
+  size_t open = 0;
+  Connection *idle = nullptr;
+  for (Connection &c : connections) {
+    if (c.fd < 0 || c.ip != ip)
+      continue;
+    open++;
+    if (!c.busy && idle == nullptr)
+      idle = &c;
+  }
+  if (idle == nullptr) {
+    if (open >= CONNECTIONS_PER_CLIENT)
+      return false;
+    Connection fresh = {};
+    fresh.fd = openSocket();
+    fresh.ip = ip;
+    if (fresh.fd < 0) {
+      fail(pending);
+      return true;
+    }
+    connections.push_back(fresh);
+    idle = &connections.back();
+  }
+  if (!send(*idle, pending)) {
+    fail(pending);
+    closeConnection(*idle);
+  }
+  idle->reused = true;
+  return true;
+}
+
+void finish(Connection &c, int code) {
+  RouteStats &stats = routes[events[c.current.event].route];
+  if (code == 0)
+    stats.failures++;
+  else
+    stats.latencies.push_back((hostSeconds() - c.current.dueAt) * 1000);
+  c.busy = false;
+}
+
+// Reads what the server sent; true if any connection made progress
+bool collect() {
+  bool progress = false;
+  char buffer[4096];
+  for (Connection &c : connections) {
+    if (c.fd < 0)
+      continue;
+    bool closed = false;
+    for (;;) {
+      ssize_t n = recv(c.fd, buffer, sizeof(buffer), 0);
+      if (n > 0) {
+        c.response.append(buffer, n);
+        progress = true;
+        continue;
+      }
+      closed = n == 0 || (errno != EAGAIN && errno != EWOULDBLOCK);
+      break;
+    }
+    if (!c.busy) {
+      if (closed)
+        closeConnection(c); // idle keep-alive timed out
+      continue;
+    }
+
+    int code = 0;
+    bool keepAlive = false;
+    bool head = events[c.current.event].head;
+    if (responseDone(c, closed, head, &code, &keepAlive)) {
+      finish(c, code);
+      progress = true;
+      if (!keepAlive)
+        closeConnection(c);
+    } else if (closed) {
+      // A keep-alive connection closed under a new request: send it again
+      // once on a fresh one, as browsers do
+      Pending pending = c.current;
+      bool retry = c.response.empty() && c.reused && !pending.retried;
+      closeConnection(c);
+      if (retry) {
+        pending.retried = true;
+        waiting[c.ip].push_front(pending);
+      } else {
+        fail(pending);
+      }
+      progress = true;
+    }
+  }
+  connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                   [](const Connection &c) {
+                                     return c.fd < 0;
+                                   }),
+                    connections.end());
+  return progress;
+}
+
+void inject(size_t index) {
+  const Event &event = events[index];
+  switch (event.kind) {
+  case HTTP_REQUEST: {
+    double dueAt = speed > 0 ? event.at / 1e6 / speed : hostSeconds();
+    waiting[event.ip].push_back({index, dueAt, false});
+    break;
+  }
+  case WS_EVENT: {
+    WebSocketsServer *server = WebSocketsServer::running();
+    if (server == nullptr) {
+      webSocketMissed++;
+      break;
+    }
+    server->injectEvent(event.client, (WStype_t)event.type,
+                        event.payload.data(), event.payload.size());
+    webSocketEvents++;
+    break;
+  }
+  case SENSOR_SAMPLE:
+    NativeHal::setAnalogValue(event.pin, event.value);
+    samples++;
+    break;
+  }
+}
+
+void sampleHeap() {
+  heapLowest = std::min(heapLowest, NativeHeap::freeBytes());
+  blockLowest = std::min(blockLowest, NativeHeap::maxFreeBlock());
+  fragmentationPeak =
+      std::max(fragmentationPeak, NativeHeap::fragmentation());
+}
+
+double percentile(std::vector<double> &values, double p) {
+  if (values.empty())
+    return 0;
+  size_t at = (size_t)(p * (values.size() - 1) + 0.5);
+  std::nth_element(values.begin(), values.begin() + at, values.end());
+  return values[at];
+}
+
+} // namespace
+
+namespace NativeReplay {
+
+bool load(const char *path) {
+  FILE *f = fopen(path, "rb");
+  if (f == nullptr) {
+    fprintf(stderr, "replay: cannot open %s\n", path);
+    return false;
+  }
+  std::vector<uint8_t> data;
+  uint8_t buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+    data.insert(data.end(), buffer, buffer + n);
+  fclose(f);
+  sourcePath = path;
+
+  // Chunks from successive /api/record polls, appended
+  bool first = true;
+  uint64_t clock = 0;
+  uint64_t origin = 0;
+  size_t at = 0;
+  while (data.size() - at >= CHUNK_HEADER) {
+    const uint8_t *chunk = data.data() + at;
+    size_t length = readLE(chunk + 12, 2);
+    if (chunk[0] != 'W' || chunk[1] != 'R' || chunk[2] != VERSION ||
+        data.size() - at - CHUNK_HEADER < length) {
+      fprintf(stderr, "replay: %s: damaged chunk at byte %zu\n", path, at);
+      return false;
+    }
+    uint32_t base = readLE(chunk + 4, 4);
+    droppedOnDevice = readLE(chunk + 8, 4);
+    if (first) {
+      clock = base;
+    } else {
+      uint64_t previous = clock;
+      clock = (clock & ~0xffffffffULL) | base;
+      if (clock + (1ULL << 31) < previous)
+        clock += 1ULL << 32; // micros() wrapped between polls
+    }
+
+    const uint8_t *p = chunk + CHUNK_HEADER;
+    const uint8_t *end = p + length;
+    while (p < end) {
+      Reader header = {p, end};
+      uint8_t kind = header.byte();
+      uint32_t size = header.varint();
+      if (!header.ok || (size_t)(end - header.p) < size) {
+        fprintf(stderr, "replay: %s: damaged record\n", path);
+        return false;
+      }
+      Reader r = {header.p, header.p + size};
+      p = header.p + size;
+      clock += r.varint();
+      if (first) {
+        origin = clock;
+        first = false;
+      }
+      Event event = {};
+      event.at = clock - origin;
+      if (parseRecord(kind, r, event))
+        events.push_back(event);
+    }
+    at += CHUNK_HEADER + length;
+  }
+  if (events.empty()) {
+    fprintf(stderr, "replay: %s holds no events\n", path);
+    return false;
+  }
+  return true;
+}
+
+void setSpeed(double value) { speed = value; }
+
+bool poll() {
+  if (!started) {
+    started = true;
+    hostStart = std::chrono::steady_clock::now();
+    lastMicros = micros();
+    heapStart = heapLowest = NativeHeap::freeBytes();
+    blockStart = blockLowest = NativeHeap::maxFreeBlock();
+    allocStart = NativeHeap::stats();
+  }
+  uint32_t now = micros();
+  sessionNow += now - lastMicros;
+  lastMicros = now;
+  double replayed = speed > 0 ? hostSeconds() * speed * 1e6 : sessionNow;
+
+  bool injected = false;
+  while (nextEvent < events.size() && events[nextEvent].at <= replayed) {
+    inject(nextEvent++);
+    injected = true;
+  }
+
+  for (auto &entry : waiting) {
+    std::deque<Pending> &queue = entry.second;
+    while (!queue.empty() && dispatch(entry.first, queue.front()))
+      queue.pop_front();
+  }
+  bool progress = collect();
+  sampleHeap();
+
+  bool busy = false;
+  for (const Connection &c : connections)
+    busy |= c.busy;
+  for (const auto &entry : waiting)
+    busy |= !entry.second.empty();
+  if (!busy && !injected && nextEvent == events.size())
+    return false; // loop() has seen the last event
+
+  // As fast as possible: skip the recorded gaps
+  if (speed <= 0 && NativeHal::virtualClock()) {
+    idlePolls = progress ? 0 : idlePolls + 1;
+    if (!busy && nextEvent < events.size())
+      NativeHal::advanceMicros(events[nextEvent].at - sessionNow);
+    else if (busy && idlePolls >= IDLE_POLLS)
+      NativeHal::advanceMicros(1000);
+  }
+  return true;
+}
+
+int printReport(FILE *out) {
+  double wall = hostSeconds();
+  double session = events.empty() ? 0 : events.back().at / 1e6;
+  fprintf(out, "Replay of %s: %zu events over %.1f s, replayed in %.2f s",
+          sourcePath, events.size(), session, wall);
+  if (wall > 0)
+    fprintf(out, " (%.1fx)", session / wall);
+  fprintf(out, "\n");
+
+  uint32_t requests = 0;
+  uint32_t failures = 0;
+  std::vector<double> all;
+  fprintf(out, "\n%-32s %7s %6s %8s %8s %8s %8s\n", "route", "count",
+          "failed", "p50 ms", "p90 ms", "p99 ms", "max ms");
+  for (auto &entry : routes) {
+    RouteStats &stats = entry.second;
+    std::vector<double> &l = stats.latencies;
+    requests += l.size() + stats.failures;
+    failures += stats.failures;
+    all.insert(all.end(), l.begin(), l.end());
+    fprintf(out, "%-32s %7zu %6u %8.2f %8.2f %8.2f %8.2f\n",
+            entry.first.c_str(), l.size() + stats.failures, stats.failures,
+            percentile(l, 0.5), percentile(l, 0.9), percentile(l, 0.99),
+            l.empty() ? 0 : *std::max_element(l.begin(), l.end()));
+  }
+  fprintf(out, "%-32s %7u %6u %8.2f %8.2f %8.2f %8.2f\n", "all", requests,
+          failures, percentile(all, 0.5), percentile(all, 0.9),
+          percentile(all, 0.99),
+          all.empty() ? 0 : *std::max_element(all.begin(), all.end()));
+
+  fprintf(out, "\nWebSocket events: %u", webSocketEvents);
+  if (webSocketMissed)
+    fprintf(out, " (%u skipped, no WebSocketsServer running)",
+            webSocketMissed);
+  fprintf(out, "\nSensor samples: %u\n", samples);
+
+  NativeHeap::Stats allocs = NativeHeap::stats();
+  uint64_t allocations = allocs.allocations - allocStart.allocations;
+  fprintf(out,
+          "Heap: free %u -> %u (lowest %u), largest block %u -> %u "
+          "(lowest %u), fragmentation peak %u%%\n",
+          heapStart, NativeHeap::freeBytes(), heapLowest, blockStart,
+          NativeHeap::maxFreeBlock(), blockLowest, fragmentationPeak);
+  fprintf(out, "Allocations: %llu (%.1f per request), %llu bytes\n",
+          (unsigned long long)allocations,
+          requests ? (double)allocations / requests : 0.0,
+          (unsigned long long)(allocs.bytesAllocated -
+                               allocStart.bytesAllocated));
+  if (droppedOnDevice)
+    fprintf(out, "Warning: %u records were dropped while recording\n",
+            droppedOnDevice);
+  return failures;
+}
+
+} // namespace NativeReplay
@@ -0,0 +1,456 @@
+#include <ESP8266WebServer.h>
+
+#include <ctype.h>
+#include <unistd.h>
+
+namespace {
+
+const char *statusText(int code) {
+  switch (code) {
+  case 200:
+    return "OK";
+  case 204:
+    return "No Content";
+  case 304:
+    return "Not Modified";
+  case 400:
+    return "Bad Request";
+  case 404:
+    return "Not Found";
+  case 405:
+    return "Method Not Allowed";
+  case 429:
+    return "Too Many Requests";
+  case 500:
+    return "Internal Server Error";
+  case 503:
+    return "Service Unavailable";
+  default:
+    return "";
+  }
+}
+
+HTTPMethod parseMethod(const char *method, size_t length) {
+  struct {
+    const char *name;
+    HTTPMethod method;
+  } methods[] = {{"GET", HTTP_GET},       {"HEAD", HTTP_HEAD},
+                 {"POST", HTTP_POST},     {"PUT", HTTP_PUT},
+                 {"PATCH", HTTP_PATCH},   {"DELETE", HTTP_DELETE},
+                 {"OPTIONS", HTTP_OPTIONS}};
+  for (auto &m : methods) {
+    if (strlen(m.name) == length && memcmp(m.name, method, length) == 0)
+      return m.method;
+  }
+  return HTTP_ANY;
+}
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+String urlDecode(const char *text, size_t length) {
+  String decoded;
+  decoded.reserve(length);
+  for (size_t i = 0; i < length; i++) {
+    char c = text[i];
+    if (c == '+') {
+      decoded += ' ';
+    } else if (c == '%' && i + 2 < length && hexValue(text[i + 1]) >= 0 &&
+               hexValue(text[i + 2]) >= 0) {
+      decoded += (char)(hexValue(text[i + 1]) * 16 + hexValue(text[i + 2]));
+      i += 2;
+    } else {
+      decoded += c;
+    }
+  }
+  return decoded;
+}
+
+} // namespace
+
+ESP8266WebServer::ESP8266WebServer(int port) : server(port) {
+  requestBuffer[0] = 0;
+}
+
+void ESP8266WebServer::begin() { server.begin(); }
+
+void ESP8266WebServer::close() {
+  currentClient.stop();
+  server.close();
+}
+
+void ESP8266WebServer::on(const String &uri, THandlerFunction handler) {
+  on(uri, HTTP_ANY, handler);
+}
+
+void ESP8266WebServer::on(const String &uri, HTTPMethod method,
+                          THandlerFunction handler) {
+  routes.push_back(Route{uri, method, handler});
+}
+
+void ESP8266WebServer::onNotFound(THandlerFunction handler) {
+  notFoundHandler = handler;
+}
+
+void ESP8266WebServer::handleClient() {
+  WiFiClient client = server.accept();
+  if (!client)
+    return;
+
+  currentClient = client;
+  if (readRequest())
+    dispatch();
+  else
+    send(400, "text/plain", "Bad Request");
+
+  currentClient.stop();
+  resetRequest();
+}
+
+bool ESP8266WebServer::readRequest() {
+  size_t length = 0;
+  size_t expected = 0;
+  size_t headerEnd = 0;
+  unsigned long start = millis();
+
+  // Block until the whole request is in, like the core's timed reads
+  while (millis() - start < HTTP_MAX_DATA_WAIT) {
+    int available = currentClient.available();
+    if (available <= 0) {
+      if (!currentClient.connected())
+        break;
+      usleep(100);
+      continue;
+    }
+    size_t room = MAX_REQUEST - length;
+    if (room == 0)
+      return false;
+    int n = currentClient.read((uint8_t *)requestBuffer + length,
+                               (size_t)available < room ? available : room);
+    if (n <= 0)
+      continue;
+    length += n;
+    requestBuffer[length] = 0;
+
+    if (headerEnd == 0) {
+      char *end = strstr(requestBuffer, "\r\n\r\n");
+      if (end == nullptr)
+        continue;
+      headerEnd = end - requestBuffer + 4;
+      const char *cl = strcasestr(requestBuffer, "\r\nContent-Length:");
+      expected = headerEnd;
+      if (cl != nullptr && cl < end)
+        expected += strtoul(cl + 17, nullptr, 10);
+    }
+    if (length >= expected)
+      return parseRequest(requestBuffer, length);
+  }
+  return false;
+}
+
+bool ESP8266WebServer::parseRequest(const char *request, size_t length) {
+  const char *lineEnd = strstr(request, "\r\n");
+  if (lineEnd == nullptr)
+    return false;
+
+  const char *space1 = (const char *)memchr(request, ' ', lineEnd - request);
+  if (space1 == nullptr)
+    return false;
+  const char *space2 =
+      (const char *)memchr(space1 + 1, ' ', lineEnd - space1 - 1);
+  if (space2 == nullptr)
+    return false;
+
+  currentMethod = parseMethod(request, space1 - request);
+  http10 = strncmp(space2 + 1, "HTTP/1.0", 8) == 0;
+
+  const char *path = space1 + 1;
+  const char *query = (const char *)memchr(path, '?', space2 - path);
+  if (query != nullptr) {
+    currentUri = String(path, query - path);
+    parseArgs(query + 1, space2 - query - 1);
+  } else {
+    currentUri = String(path, space2 - path);
+  }
+
+  // Headers
+  const char *line = lineEnd + 2;
+  const char *headersEnd = strstr(request, "\r\n\r\n");
+  while (line < headersEnd && headerCount < MAX_HEADERS) {
+    const char *end = strstr(line, "\r\n");
+    const char *colon = (const char *)memchr(line, ':', end - line);
+    if (colon != nullptr) {
+      const char *value = colon + 1;
+      while (value < end && *value == ' ')
+        value++;
+      headerNames[headerCount] = String(line, colon - line);
+      headerValues[headerCount] = String(value, end - value);
+      headerCount++;
+    }
+    line = end + 2;
+  }
+
+  const char *body = headersEnd + 4;
+  size_t bodyLength = request + length - body;
+  if (bodyLength > 0) {
+    if (header("Content-Type").startsWith("application/x-www-form-urlencoded"))
+      parseArgs(body, bodyLength);
+    if (argCount < MAX_ARGS) {
+      argNames[argCount] = "plain";
+      argValues[argCount] = String(body, bodyLength);
+      argCount++;
+    }
+  }
+  return true;
+}
+
+void ESP8266WebServer::parseArgs(const char *query, size_t length) {
+  const char *end = query + length;
+  while (query < end && argCount < MAX_ARGS) {
+    const char *amp = (const char *)memchr(query, '&', end - query);
+    if (amp == nullptr)
+      amp = end;
+    const char *eq = (const char *)memchr(query, '=', amp - query);
+    if (eq != nullptr) {
+      argNames[argCount] = urlDecode(query, eq - query);
+      argValues[argCount] = urlDecode(eq + 1, amp - eq - 1);
+    } else {
+      argNames[argCount] = urlDecode(query, amp - query);
+      argValues[argCount] = "";
+    }
+    argCount++;
+    query = amp + 1;
+  }
+}
+
+void ESP8266WebServer::dispatch() {
+  for (Route &route : routes) {
+    if ((route.method == HTTP_ANY || route.method == currentMethod) &&
+        route.uri == currentUri) {
+      route.handler();
+      return;
+    }
+  }
+  if (notFoundHandler)
+    notFoundHandler();
+  else
+    send(404, "text/plain", String("Not found: ") + currentUri);
+}
+
+void ESP8266WebServer::resetRequest() {
+  for (int i = 0; i < argCount; i++) {
+    argNames[i] = "";
+    argValues[i] = "";
+  }
+  for (int i = 0; i < headerCount; i++) {
+    headerNames[i] = "";
+    headerValues[i] = "";
+  }
+  argCount = 0;
+  headerCount = 0;
+  currentUri = "";
+  pendingHeaders = "";
+  contentLength = CONTENT_LENGTH_NOT_SET;
+  chunked = false;
+  headersSent = false;
+  http10 = false;
+}
+
+String ESP8266WebServer::arg(const String &name) const {
+  for (int i = 0; i < argCount; i++) {
+    if (argNames[i] == name)
+      return argValues[i];
+  }
+  return String();
+}
+
+String ESP8266WebServer::arg(int index) const {
+  return index < argCount ? argValues[index] : String();
+}
+
+String ESP8266WebServer::argName(int index) const {
+  return index < argCount ? argNames[index] : String();
+}
+
+bool ESP8266WebServer::hasArg(const String &name) const {
+  for (int i = 0; i < argCount; i++) {
+    if (argNames[i] == name)
+      return true;
+  }
+  return false;
+}
+
+String ESP8266WebServer::header(const String &name) const {
+  for (int i = 0; i < headerCount; i++) {
+    if (headerNames[i].equalsIgnoreCase(name))
+      return headerValues[i];
+  }
+  return String();
+}
+
+String ESP8266WebServer::header(int index) const {
+  return index < headerCount ? headerValues[index] : String();
+}
+
+String ESP8266WebServer::headerName(int index) const {
+  return index < headerCount ? headerNames[index] : String();
+}
+
+bool ESP8266WebServer::hasHeader(const String &name) const {
+  for (int i = 0; i < headerCount; i++) {
+    if (headerNames[i].equalsIgnoreCase(name))
+      return true;
+  }
+  return false;
+}
+
+void ESP8266WebServer::sendHeader(const String &name, const String &value,
+                                  bool first) {
+  String line = name + ": " + value + "\r\n";
+  if (first)
+    pendingHeaders = line + pendingHeaders;
+  else
+    pendingHeaders += line;
+}
+
+void ESP8266WebServer::writeRaw(const char *data, size_t length) {
+  responseBytes += length;
+  if (capturing)
+    return;
+  currentClient.write((const uint8_t *)data, length);
+}
+
+void ESP8266WebServer::writeHeaders(int code, const char *contentType,
+                                    size_t length) {
+  responseCode = code;
+  if (contentLength != CONTENT_LENGTH_NOT_SET)
+    length = contentLength;
+
+  char head[256];
+  int n = snprintf(head, sizeof(head), "HTTP/1.%d %d %s\r\n", http10 ? 0 : 1,
+                   code, statusText(code));
+  if (contentType != nullptr)
+    n += snprintf(head + n, sizeof(head) - n, "Content-Type: %s\r\n",
+                  contentType);
+  if (length == CONTENT_LENGTH_UNKNOWN) {
+    chunked = !http10;
+    if (chunked)
+      n += snprintf(head + n, sizeof(head) - n,
+                    "Transfer-Encoding: chunked\r\n");
+  } else {
+    n += snprintf(head + n, sizeof(head) - n, "Content-Length: %zu\r\n",
+                  length);
+  }
+  writeRaw(head, n);
+  writeRaw(pendingHeaders.c_str(), pendingHeaders.length());
+  writeRaw("Connection: close\r\n\r\n", 21);
+  headersSent = true;
+}
+
+void ESP8266WebServer::send(int code, const char *contentType,
+                            const String &content) {
+  send(code, contentType, content.c_str(), content.length());
+}
+
+void ESP8266WebServer::send(int code, const String &contentType,
+                            const String &content) {
+  send(code, contentType.c_str(), content.c_str(), content.length());
+}
+
+void ESP8266WebServer::send(int code, const char *contentType,
+                            const char *content) {
+  send(code, contentType, content, content ? strlen(content) : 0);
+}
+
+void ESP8266WebServer::send(int code, const char *contentType,
+                            const char *content, size_t length) {
+  writeHeaders(code, contentType, length);
+  if (length > 0 && length != CONTENT_LENGTH_UNKNOWN &&
+      currentMethod != HTTP_HEAD)
+    sendContent(content, length);
+}
+
+void ESP8266WebServer::send_P(int code, PGM_P contentType, PGM_P content) {
+  send(code, contentType, content);
+}
+
+void ESP8266WebServer::send_P(int code, PGM_P contentType, PGM_P content,
+                              size_t length) {
+  send(code, contentType, content, length);
+}
+
+void ESP8266WebServer::sendContent(const String &content) {
+  sendContent(content.c_str(), content.length());
+}
+
+void ESP8266WebServer::sendContent(const char *content, size_t length) {
+  if (capturing)
+    captureBody.append(content, length);
+  if (chunked) {
+    char size[16];
+    int n = snprintf(size, sizeof(size), "%zx\r\n", length);
+    writeRaw(size, n);
+    writeRaw(content, length);
+    writeRaw("\r\n", 2);
+  } else {
+    writeRaw(content, length);
+  }
+}
+
+void ESP8266WebServer::sendContent_P(PGM_P content) {
+  sendContent(content, strlen(content));
+}
+
+void ESP8266WebServer::sendContent_P(PGM_P content, size_t length) {
+  sendContent(content, length);
+}
+
+void ESP8266WebServer::simulateHeader(const char *name, const char *value) {
+  if (headerCount < MAX_HEADERS) {
+    headerNames[headerCount] = name;
+    headerValues[headerCount] = value;
+    headerCount++;
+  }
+}
+
+const std::string &ESP8266WebServer::simulateRequest(HTTPMethod method,
+                                                     const char *uri,
+                                                     const char *body,
+                                                     int *code,
+                                                     size_t *bytes) {
+  capturing = true;
+  captureBody.clear();
+  responseCode = 0;
+  responseBytes = 0;
+
+  currentMethod = method;
+  const char *query = strchr(uri, '?');
+  if (query != nullptr) {
+    currentUri = String(uri, query - uri);
+    parseArgs(query + 1, strlen(query + 1));
+  } else {
+    currentUri = uri;
+  }
+  if (body != nullptr && argCount < MAX_ARGS) {
+    argNames[argCount] = "plain";
+    argValues[argCount] = body;
+    argCount++;
+  }
+
+  dispatch();
+
+  if (code != nullptr)
+    *code = responseCode;
+  if (bytes != nullptr)
+    *bytes = responseBytes;
+  resetRequest();
+  capturing = false;
+  return captureBody;
+}
@@ -0,0 +1,41 @@
+#include <WebSocketsServer.h>
+
+WebSocketsServer *WebSocketsServer::started = nullptr;
+
+bool WebSocketsServer::sendTXT(uint8_t num, const char *payload,
+                               size_t length) {
+  (void)num;
+  if (length == 0 && payload != nullptr)
+    length = strlen(payload);
+  sent++;
+  sentBytes += length;
+  return true;
+}
+
+bool WebSocketsServer::broadcastTXT(const char *payload, size_t length) {
+  if (length == 0 && payload != nullptr)
+    length = strlen(payload);
+  sent += clients;
+  sentBytes += (uint64_t)length * clients;
+  return true;
+}
+
+void WebSocketsServer::injectEvent(uint8_t num, WStype_t type,
+                                   const char *payload, size_t length) {
+  if (type == WStype_CONNECTED && clients < WEBSOCKETS_SERVER_CLIENT_MAX)
+    clients++;
+  else if (type == WStype_DISCONNECTED && clients > 0)
+    clients--;
+
+  if (!eventHandler)
+    return;
+
+  // The library hands out a NUL-terminated mutable copy
+  char buffer[512];
+  if (length >= sizeof(buffer))
+    length = sizeof(buffer) - 1;
+  if (payload != nullptr)
+    memcpy(buffer, payload, length);
+  buffer[length] = 0;
+  eventHandler(num, type, (uint8_t *)buffer, length);
+}
@@ -0,0 +1,356 @@
+#include <ESP8266WiFi.h>
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "native_hal.h"
+
+ESP8266WiFiClass WiFi;
+
+namespace {
+
+uint32_t fullConnectMs = 1500;
+uint32_t cachedConnectMs = 120;
+
+void setNonBlocking(int fd) {
+  int flags = fcntl(fd, F_GETFL, 0);
+  fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+}
+
+void ignoreSigpipe() {
+  static bool done = false;
+  if (!done) {
+    signal(SIGPIPE, SIG_IGN);
+    done = true;
+  }
+}
+
+} // namespace
+
+namespace NativeHal {
+
+void setWiFiConnectLatency(uint32_t fullMs, uint32_t cachedMs) {
+  fullConnectMs = fullMs;
+  cachedConnectMs = cachedMs;
+}
+
+} // namespace NativeHal
+
+bool ESP8266WiFiClass::mode(WiFiMode_t mode) {
+  currentMode = mode;
+  return true;
+}
+
+wl_status_t ESP8266WiFiClass::begin(const char *ssid, const char *password,
+                                    int32_t channel, const uint8_t *bssid,
+                                    bool connect) {
+  (void)password;
+  strncpy(this->ssid, ssid ? ssid : "", sizeof(this->ssid) - 1);
+  if (currentMode == WIFI_OFF || currentMode == WIFI_AP)
+    currentMode = (WiFiMode_t)(currentMode | WIFI_STA);
+
+  // Channel + BSSID skip the scan, a static IP skips DHCP
+  bool cached = channel != 0 && bssid != nullptr && staticIP.isSet();
+  bool channelMatches = channel == 0 || channel == currentChannel;
+  bool bssidMatches = bssid == nullptr || memcmp(bssid, this->bssid, 6) == 0;
+
+  connecting = connect && !failNextConnect && channelMatches && bssidMatches;
+  failNextConnect = false;
+  connectAt = millis() + (cached ? cachedConnectMs : fullConnectMs);
+  return WL_DISCONNECTED;
+}
+
+bool ESP8266WiFiClass::config(IPAddress ip, IPAddress gateway,
+                              IPAddress subnet, IPAddress dns1,
+                              IPAddress dns2) {
+  (void)dns2;
+  staticIP = ip;
+  staticGateway = gateway;
+  staticSubnet = subnet;
+  staticDNS = dns1;
+  return true;
+}
+
+bool ESP8266WiFiClass::disconnect(bool wifiOff) {
+  connecting = false;
+  if (wifiOff)
+    currentMode = WIFI_OFF;
+  return true;
+}
+
+bool ESP8266WiFiClass::reconnect() {
+  connecting = true;
+  connectAt = millis() + fullConnectMs;
+  return true;
+}
+
+wl_status_t ESP8266WiFiClass::status() {
+  if (!connecting)
+    return WL_DISCONNECTED;
+  return millis() >= connectAt ? WL_CONNECTED : WL_DISCONNECTED;
+}
+
+IPAddress ESP8266WiFiClass::localIP() {
+  if (status() != WL_CONNECTED)
+    return IPAddress();
+  return staticIP.isSet() ? staticIP : IPAddress(192, 168, 1, 100);
+}
+
+IPAddress ESP8266WiFiClass::gatewayIP() {
+  if (status() != WL_CONNECTED)
+    return IPAddress();
+  return staticIP.isSet() ? staticGateway : IPAddress(192, 168, 1, 1);
+}
+
+IPAddress ESP8266WiFiClass::subnetMask() {
+  if (status() != WL_CONNECTED)
+    return IPAddress();
+  return staticIP.isSet() ? staticSubnet : IPAddress(255, 255, 255, 0);
+}
+
+IPAddress ESP8266WiFiClass::dnsIP(uint8_t index) {
+  (void)index;
+  if (status() != WL_CONNECTED)
+    return IPAddress();
+  return staticIP.isSet() ? staticDNS : IPAddress(192, 168, 1, 1);
+}
+
+String ESP8266WiFiClass::macAddress() { return String("5C:CF:7F:00:00:01"); }
+
+int32_t ESP8266WiFiClass::RSSI() {
+  return status() == WL_CONNECTED ? -58 : 31;
+}
+
+int32_t ESP8266WiFiClass::channel() { return currentChannel; }
+
+uint8_t *ESP8266WiFiClass::BSSID() {
+  return status() == WL_CONNECTED ? bssid : nullptr;
+}
+
+String ESP8266WiFiClass::BSSIDstr() {
+  char buffer[18];
+  snprintf(buffer, sizeof(buffer), "%02X:%02X:%02X:%02X:%02X:%02X", bssid[0],
+           bssid[1], bssid[2], bssid[3], bssid[4], bssid[5]);
+  return String(buffer);
+}
+
+bool ESP8266WiFiClass::softAP(const char *ssid, const char *password,
+                              int channel, int hidden, int maxConnections) {
+  (void)password, (void)hidden, (void)maxConnections;
+  strncpy(this->ssid, ssid ? ssid : "", sizeof(this->ssid) - 1);
+  currentChannel = channel;
+  currentMode = (WiFiMode_t)(currentMode | WIFI_AP);
+  return true;
+}
+
+IPAddress ESP8266WiFiClass::softAPIP() { return IPAddress(192, 168, 4, 1); }
+
+// --- WiFiClient ---
+
+WiFiClient::Context::~Context() {
+  if (fd >= 0)
+    ::close(fd);
+}
+
+WiFiClient::WiFiClient(int fd) {
+  if (fd >= 0) {
+    context = std::make_shared<Context>();
+    context->fd = fd;
+    context->peerClosed = false;
+    setNonBlocking(fd);
+  }
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+  ignoreSigpipe();
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return 0;
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = (uint32_t)ip;
+  if (::connect(fd, (sockaddr *)&addr, sizeof(addr)) < 0) {
+    ::close(fd);
+    return 0;
+  }
+  *this = WiFiClient(fd);
+  return 1;
+}
+
+int WiFiClient::connect(const char *host, uint16_t port) {
+  IPAddress ip;
+  if (!ip.fromString(host))
+    ip = IPAddress(127, 0, 0, 1);
+  return connect(ip, port);
+}
+
+uint8_t WiFiClient::connected() {
+  if (!context || context->fd < 0)
+    return 0;
+  if (available() > 0)
+    return 1;
+  return context->peerClosed ? 0 : 1;
+}
+
+int WiFiClient::available() {
+  if (!context || context->fd < 0)
+    return 0;
+  int count = 0;
+  if (ioctl(context->fd, FIONREAD, &count) < 0)
+    return 0;
+  if (count == 0 && !context->peerClosed) {
+    char probe;
+    ssize_t n = recv(context->fd, &probe, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0 || (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK))
+      context->peerClosed = true;
+  }
+  return count;
+}
+
+int WiFiClient::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t *buffer, size_t size) {
+  if (!context || context->fd < 0)
+    return -1;
+  ssize_t n = recv(context->fd, buffer, size, MSG_DONTWAIT);
+  if (n == 0)
+    context->peerClosed = true;
+  return n > 0 ? (int)n : -1;
+}
+
+int WiFiClient::peek() {
+  if (!context || context->fd < 0)
+    return -1;
+  uint8_t c;
+  ssize_t n = recv(context->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+  return n == 1 ? c : -1;
+}
+
+size_t WiFiClient::write(uint8_t c) { return write(&c, 1); }
+
+size_t WiFiClient::write(const uint8_t *buffer, size_t size) {
+  if (!context || context->fd < 0)
+    return 0;
+  size_t sent = 0;
+  unsigned long start = millis();
+  while (sent < size) {
+    ssize_t n = send(context->fd, buffer + sent, size - sent, MSG_NOSIGNAL);
+    if (n > 0) {
+      sent += n;
+      continue;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) &&
+        millis() - start < timeout) {
+      usleep(100);
+      continue;
+    }
+    context->peerClosed = true;
+    break;
+  }
+  return sent;
+}
+
+void WiFiClient::stop() {
+  if (context && context->fd >= 0) {
+    ::close(context->fd);
+    context->fd = -1;
+  }
+  context.reset();
+}
+
+void WiFiClient::setNoDelay(bool noDelay) {
+  if (!context || context->fd < 0)
+    return;
+  int flag = noDelay ? 1 : 0;
+  setsockopt(context->fd, IPPROTO_TCP, TCP_NODELAY, &flag, sizeof(flag));
+}
+
+IPAddress WiFiClient::remoteIP() {
+  if (!context || context->fd < 0)
+    return IPAddress();
+  sockaddr_in addr;
+  socklen_t length = sizeof(addr);
+  if (getpeername(context->fd, (sockaddr *)&addr, &length) < 0)
+    return IPAddress();
+  return IPAddress((uint32_t)addr.sin_addr.s_addr);
+}
+
+uint16_t WiFiClient::remotePort() {
+  if (!context || context->fd < 0)
+    return 0;
+  sockaddr_in addr;
+  socklen_t length = sizeof(addr);
+  if (getpeername(context->fd, (sockaddr *)&addr, &length) < 0)
+    return 0;
+  return ntohs(addr.sin_port);
+}
+
+// --- WiFiServer ---
+
+void WiFiServer::begin() { begin(port); }
+
+void WiFiServer::begin(uint16_t port) {
+  ignoreSigpipe();
+  close();
+  this->port = port;
+  fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return;
+  int reuse = 1;
+  setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(NativeHal::hostPort(port));
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (bind(fd, (sockaddr *)&addr, sizeof(addr)) < 0 || listen(fd, 64) < 0) {
+    fprintf(stderr, "WiFiServer: cannot listen on 127.0.0.1:%u\n",
+            NativeHal::hostPort(port));
+    ::close(fd);
+    fd = -1;
+    return;
+  }
+  setNonBlocking(fd);
+}
+
+bool WiFiServer::hasClient() {
+  if (pendingFd >= 0)
+    return true;
+  if (fd < 0)
+    return false;
+  pendingFd = ::accept(fd, nullptr, nullptr);
+  return pendingFd >= 0;
+}
+
+WiFiClient WiFiServer::accept() {
+  if (!hasClient())
+    return WiFiClient();
+  WiFiClient client(pendingFd);
+  pendingFd = -1;
+  client.setNoDelay(noDelay);
+  return client;
+}
+
+void WiFiServer::close() {
+  if (pendingFd >= 0) {
+    ::close(pendingFd);
+    pendingFd = -1;
+  }
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+}
@@ -0,0 +1,53 @@
+#include <Wire.h>
+
+#include "native_hal.h"
+
+TwoWire Wire;
+
+namespace {
+bool stall = false;
+}
+
+namespace NativeHal {
+void stallOnI2C(bool enabled) { stall = enabled; }
+} // namespace NativeHal
+
+uint32_t TwoWire::transactionMicros(size_t bytes, uint32_t clock) {
+  // Address byte + payload, 9 clocks per byte (8 data + ACK), plus
+  // start/stop conditions
+  uint64_t bits = (uint64_t)(bytes + 1) * 9 + 2;
+  return (uint32_t)((bits * 1000000 + clock - 1) / clock);
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  target = address;
+  pending = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (pending >= BUFFER_LENGTH)
+    return 0;
+  this->data[pending++] = data;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t *data, size_t length) {
+  size_t n = 0;
+  while (n < length && write(data[n]))
+    n++;
+  return n;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  uint32_t us = transactionMicros(pending, clock);
+  totalBytes += pending + 1;
+  totalTransactions++;
+  totalBusMicros += us;
+  if (listener != nullptr)
+    listener(target, data, pending);
+  pending = 0;
+  if (stall)
+    NativeHal::advanceMicros(us);
+  return 0;
+}
@@ -0,0 +1,406 @@
+#include "WString.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "native_heap.h"
+
+String::String(const char *cstr)
+    : heapBuffer(nullptr), heapCapacity(0), len(0) {
+  sso[0] = 0;
+  if (cstr)
+    copy(cstr, strlen(cstr));
+}
+
+String::String(const char *cstr, size_t length)
+    : heapBuffer(nullptr), heapCapacity(0), len(0) {
+  sso[0] = 0;
+  if (cstr)
+    copy(cstr, length);
+}
+
+String::String(const __FlashStringHelper *str)
+    : String(reinterpret_cast<const char *>(str)) {}
+
+String::String(const String &other)
+    : heapBuffer(nullptr), heapCapacity(0), len(0) {
+  sso[0] = 0;
+  copy(other.buffer(), other.len);
+}
+
+String::String(String &&other) noexcept
+    : heapBuffer(other.heapBuffer), heapCapacity(other.heapCapacity),
+      len(other.len) {
+  memcpy(sso, other.sso, sizeof(sso));
+  other.heapBuffer = nullptr;
+  other.heapCapacity = 0;
+  other.len = 0;
+  other.sso[0] = 0;
+}
+
+String::String(char c) : heapBuffer(nullptr), heapCapacity(0), len(0) {
+  sso[0] = 0;
+  copy(&c, 1);
+}
+
+static void formatInteger(char *out, size_t size, unsigned long long value,
+                          bool negative, unsigned char base) {
+  char digits[66];
+  int pos = 0;
+  do {
+    int digit = value % base;
+    digits[pos++] = digit < 10 ? '0' + digit : 'a' + digit - 10;
+    value /= base;
+  } while (value);
+  size_t i = 0;
+  if (negative && i + 1 < size)
+    out[i++] = '-';
+  while (pos && i + 1 < size)
+    out[i++] = digits[--pos];
+  out[i] = 0;
+}
+
+#define STRING_FROM_SIGNED(type)                                               \
+  String::String(type value, unsigned char base)                               \
+      : heapBuffer(nullptr), heapCapacity(0), len(0) {                         \
+    sso[0] = 0;                                                                \
+    char buf[68];                                                              \
+    bool negative = base == 10 && value < 0;                                   \
+    unsigned long long magnitude =                                             \
+        negative ? (unsigned long long)(-(long long)value)                     \
+                 : (unsigned long long)value;                                  \
+    formatInteger(buf, sizeof(buf), magnitude, negative, base);                \
+    copy(buf, strlen(buf));                                                    \
+  }
+
+#define STRING_FROM_UNSIGNED(type)                                             \
+  String::String(type value, unsigned char base)                               \
+      : heapBuffer(nullptr), heapCapacity(0), len(0) {                         \
+    sso[0] = 0;                                                                \
+    char buf[68];                                                              \
+    formatInteger(buf, sizeof(buf), value, false, base);                       \
+    copy(buf, strlen(buf));                                                    \
+  }
+
+STRING_FROM_UNSIGNED(unsigned char)
+STRING_FROM_SIGNED(int)
+STRING_FROM_UNSIGNED(unsigned int)
+STRING_FROM_SIGNED(long)
+STRING_FROM_UNSIGNED(unsigned long)
+STRING_FROM_SIGNED(long long)
+STRING_FROM_UNSIGNED(unsigned long long)
+
+String::String(float value, unsigned char decimals)
+    : String((double)value, decimals) {}
+
+String::String(double value, unsigned char decimals)
+    : heapBuffer(nullptr), heapCapacity(0), len(0) {
+  sso[0] = 0;
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", decimals, value);
+  copy(buf, strlen(buf));
+}
+
+String::~String() { NativeHeap::free(heapBuffer); }
+
+String &String::operator=(const String &other) {
+  if (this != &other)
+    copy(other.buffer(), other.len);
+  return *this;
+}
+
+String &String::operator=(String &&other) noexcept {
+  if (this != &other) {
+    NativeHeap::free(heapBuffer);
+    heapBuffer = other.heapBuffer;
+    heapCapacity = other.heapCapacity;
+    len = other.len;
+    memcpy(sso, other.sso, sizeof(sso));
+    other.heapBuffer = nullptr;
+    other.heapCapacity = 0;
+    other.len = 0;
+    other.sso[0] = 0;
+  }
+  return *this;
+}
+
+String &String::operator=(const char *cstr) {
+  if (cstr)
+    copy(cstr, strlen(cstr));
+  else
+    invalidate();
+  return *this;
+}
+
+String &String::operator=(const __FlashStringHelper *str) {
+  return *this = reinterpret_cast<const char *>(str);
+}
+
+void String::invalidate() {
+  NativeHeap::free(heapBuffer);
+  heapBuffer = nullptr;
+  heapCapacity = 0;
+  len = 0;
+  sso[0] = 0;
+}
+
+bool String::reserve(size_t size) {
+  if (size <= capacity())
+    return true;
+  if (isSSO()) {
+    char *buf = (char *)NativeHeap::alloc(size + 1);
+    if (!buf)
+      return false;
+    memcpy(buf, sso, len + 1);
+    heapBuffer = buf;
+  } else {
+    char *buf = (char *)NativeHeap::realloc(heapBuffer, size + 1);
+    if (!buf)
+      return false;
+    heapBuffer = buf;
+  }
+  heapCapacity = size;
+  return true;
+}
+
+String &String::copy(const char *cstr, size_t length) {
+  if (!reserve(length)) {
+    invalidate();
+    return *this;
+  }
+  memmove(wbuffer(), cstr, length);
+  len = length;
+  wbuffer()[len] = 0;
+  return *this;
+}
+
+bool String::concat(const char *cstr, size_t length) {
+  if (!cstr)
+    return false;
+  if (length == 0)
+    return true;
+  size_t newLength = len + length;
+  if (newLength > capacity()) {
+    // Grow geometrically like the core does for repeated +=
+    size_t grow = capacity() * 3 / 2;
+    if (!reserve(newLength > grow ? newLength : grow) && !reserve(newLength))
+      return false;
+  }
+  memmove(wbuffer() + len, cstr, length);
+  len = newLength;
+  wbuffer()[len] = 0;
+  return true;
+}
+
+bool String::concat(const String &str) {
+  if (&str == this) {
+    String copyOf(str);
+    return concat(copyOf.buffer(), copyOf.len);
+  }
+  return concat(str.buffer(), str.len);
+}
+
+bool String::concat(const char *cstr) {
+  return cstr ? concat(cstr, strlen(cstr)) : false;
+}
+
+bool String::concat(const __FlashStringHelper *str) {
+  return concat(reinterpret_cast<const char *>(str));
+}
+
+bool String::concat(char c) { return concat(&c, 1); }
+bool String::concat(int value) { return concat(String(value)); }
+bool String::concat(unsigned int value) { return concat(String(value)); }
+bool String::concat(long value) { return concat(String(value)); }
+bool String::concat(unsigned long value) { return concat(String(value)); }
+bool String::concat(long long value) { return concat(String(value)); }
+bool String::concat(unsigned long long value) {
+  return concat(String(value));
+}
+bool String::concat(double value) { return concat(String(value)); }
+
+bool String::equals(const String &other) const {
+  return len == other.len && memcmp(buffer(), other.buffer(), len) == 0;
+}
+
+bool String::equals(const char *cstr) const {
+  return cstr && strcmp(buffer(), cstr) == 0;
+}
+
+bool String::equalsIgnoreCase(const String &other) const {
+  return len == other.len && strncasecmp(buffer(), other.buffer(), len) == 0;
+}
+
+bool String::operator<(const String &other) const {
+  return strcmp(buffer(), other.buffer()) < 0;
+}
+
+bool String::startsWith(const String &prefix) const {
+  return startsWith(prefix, 0);
+}
+
+bool String::startsWith(const String &prefix, unsigned int offset) const {
+  if (offset + prefix.len > len)
+    return false;
+  return memcmp(buffer() + offset, prefix.buffer(), prefix.len) == 0;
+}
+
+bool String::endsWith(const String &suffix) const {
+  if (suffix.len > len)
+    return false;
+  return memcmp(buffer() + len - suffix.len, suffix.buffer(), suffix.len) == 0;
+}
+
+char String::charAt(unsigned int index) const {
+  return index < len ? buffer()[index] : 0;
+}
+
+void String::setCharAt(unsigned int index, char c) {
+  if (index < len)
+    wbuffer()[index] = c;
+}
+
+char &String::operator[](unsigned int index) {
+  static char dummy;
+  if (index >= len) {
+    dummy = 0;
+    return dummy;
+  }
+  return wbuffer()[index];
+}
+
+int String::indexOf(char c, unsigned int from) const {
+  if (from >= len)
+    return -1;
+  const char *found = (const char *)memchr(buffer() + from, c, len - from);
+  return found ? (int)(found - buffer()) : -1;
+}
+
+int String::indexOf(const char *str, unsigned int from) const {
+  if (!str || from > len)
+    return -1;
+  const char *found = strstr(buffer() + from, str);
+  return found ? (int)(found - buffer()) : -1;
+}
+
+int String::indexOf(const String &str, unsigned int from) const {
+  return indexOf(str.c_str(), from);
+}
+
+int String::lastIndexOf(char c) const {
+  const char *found = strrchr(buffer(), c);
+  return found ? (int)(found - buffer()) : -1;
+}
+
+int String::lastIndexOf(const String &str) const {
+  int last = -1;
+  int pos = indexOf(str);
+  while (pos >= 0) {
+    last = pos;
+    pos = indexOf(str, pos + 1);
+  }
+  return last;
+}
+
+String String::substring(unsigned int left) const {
+  return substring(left, len);
+}
+
+String String::substring(unsigned int left, unsigned int right) const {
+  if (left > right) {
+    unsigned int tmp = left;
+    left = right;
+    right = tmp;
+  }
+  if (left >= len)
+    return String();
+  if (right > len)
+    right = len;
+  return String(buffer() + left, right - left);
+}
+
+void String::replace(const String &find, const String &replace) {
+  if (find.len == 0)
+    return;
+  String result;
+  unsigned int pos = 0;
+  int found;
+  while ((found = indexOf(find, pos)) >= 0) {
+    result.concat(buffer() + pos, found - pos);
+    result.concat(replace);
+    pos = found + find.len;
+  }
+  result.concat(buffer() + pos, len - pos);
+  *this = static_cast<String &&>(result);
+}
+
+void String::remove(unsigned int index) { remove(index, (unsigned int)-1); }
+
+void String::remove(unsigned int index, unsigned int count) {
+  if (index >= len)
+    return;
+  if (count > len - index)
+    count = len - index;
+  memmove(wbuffer() + index, buffer() + index + count, len - index - count);
+  len -= count;
+  wbuffer()[len] = 0;
+}
+
+void String::toLowerCase() {
+  for (char &c : *this)
+    c = tolower((unsigned char)c);
+}
+
+void String::toUpperCase() {
+  for (char &c : *this)
+    c = toupper((unsigned char)c);
+}
+
+void String::trim() {
+  unsigned int start = 0;
+  while (start < len && isspace((unsigned char)buffer()[start]))
+    start++;
+  unsigned int stop = len;
+  while (stop > start && isspace((unsigned char)buffer()[stop - 1]))
+    stop--;
+  if (start > 0 || stop < len)
+    *this = substring(start, stop);
+}
+
+long String::toInt() const { return atol(buffer()); }
+float String::toFloat() const { return (float)atof(buffer()); }
+double String::toDouble() const { return atof(buffer()); }
+
+String operator+(const String &lhs, const String &rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String &lhs, const char *rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const char *lhs, const String &rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String &lhs, char rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String &lhs, int rhs) { return lhs + String(rhs); }
+String operator+(const String &lhs, unsigned int rhs) {
+  return lhs + String(rhs);
+}
+String operator+(const String &lhs, long rhs) { return lhs + String(rhs); }
+String operator+(const String &lhs, unsigned long rhs) {
+  return lhs + String(rhs);
+}
@@ -0,0 +1,244 @@
+#include "analog_bindings.h"
+#include "workshop_strings.h"
+
+namespace {
+
+const uint16_t LINEAR_POINTS[] PROGMEM = {
+    0, 64, 128, 192, 256, 320, 384, 448, 512, 576, 640, 704, 768, 832, 896,
+    960, 1023};
+const uint16_t INVERTED_POINTS[] PROGMEM = {
+    1023, 959, 895, 831, 767, 703, 639, 575, 511,
+    447,  383, 319, 255, 191, 127, 63,  0};
+// 1023 * (i / 16)^2.2
+const uint16_t GAMMA_POINTS[] PROGMEM = {0,   2,   11,  26,  48,  79,
+                                         118, 166, 223, 288, 364, 449,
+                                         543, 648, 763, 888, 1023};
+
+const uint16_t *const PRESETS[] = {LINEAR_POINTS, GAMMA_POINTS,
+                                   INVERTED_POINTS};
+
+// Indexed by Mode and Curve
+const char *const MODE_NAMES[] = {Text::BINDING_OFF_P, Text::BINDING_LEVEL_P,
+                                  Text::BINDING_SWITCH_P};
+const char *const CURVE_NAMES[] = {Text::CURVE_LINEAR_P, Text::CURVE_GAMMA_P,
+                                   Text::CURVE_INVERTED_P,
+                                   Text::CURVE_CUSTOM_P};
+
+template <typename T, size_t N>
+bool lookupName(const char *const (&names)[N], const char *name, T &value) {
+  for (size_t i = 0; i < N; i++) {
+    if (strcmp_P(name, names[i]) == 0) {
+      value = (T)i;
+      return true;
+    }
+  }
+  return false;
+}
+
+} // namespace
+
+AnalogBindings::AnalogBindings()
+    : handler(nullptr), handlerContext(nullptr), sampleHandler(nullptr),
+      sampleContext(nullptr), eventBus(nullptr),
+      period(WORKSHOP_BINDING_PERIOD_US), lastSample(0), sampled(0),
+      worst(0) {
+  for (Binding &binding : table)
+    binding.mode = MODE_OFF;
+}
+
+void AnalogBindings::begin() { analogWriteRange(OUTPUT_MAX); }
+
+void AnalogBindings::setOutputHandler(OutputHandler handler, void *context) {
+  this->handler = handler;
+  handlerContext = context;
+}
+
+void AnalogBindings::setSampleHandler(SampleHandler handler, void *context) {
+  sampleHandler = handler;
+  sampleContext = context;
+}
+
+AnalogBindings::Binding *AnalogBindings::slotFor(uint8_t output) {
+  Binding *empty = nullptr;
+  for (Binding &binding : table) {
+    if (binding.mode != MODE_OFF && binding.output == output)
+      return &binding;
+    if (binding.mode == MODE_OFF && empty == nullptr)
+      empty = &binding;
+  }
+  return empty;
+}
+
+bool AnalogBindings::bindLevel(uint8_t output, uint8_t input, Curve curve) {
+  Binding *binding = slotFor(output);
+  if (handler == nullptr || binding == nullptr || curve >= CURVE_CUSTOM)
+    return false;
+  binding->mode = MODE_LEVEL;
+  binding->output = output;
+  binding->input = input;
+  binding->curve = curve;
+  binding->reading = 0;
+  binding->written = -1;
+  memcpy_P(binding->points, PRESETS[curve], sizeof(binding->points));
+  return true;
+}
+
+bool AnalogBindings::bindSwitch(uint8_t output, uint8_t input, uint16_t onAt,
+                                uint16_t offAt) {
+  Binding *binding = slotFor(output);
+  if (handler == nullptr || binding == nullptr || offAt >= onAt ||
+      onAt > INPUT_MAX)
+    return false;
+  binding->mode = MODE_SWITCH;
+  binding->output = output;
+  binding->input = input;
+  binding->onAt = onAt;
+  binding->offAt = offAt;
+  binding->reading = 0;
+  binding->written = -1;
+  return true;
+}
+
+bool AnalogBindings::setCurve(uint8_t output, const uint16_t *points) {
+  Binding *binding = slotFor(output);
+  if (binding == nullptr || binding->mode != MODE_LEVEL)
+    return false;
+  for (uint8_t i = 0; i < CURVE_POINTS; i++) {
+    if (points[i] > OUTPUT_MAX)
+      return false;
+  }
+  memcpy(binding->points, points, sizeof(binding->points));
+  binding->curve = CURVE_CUSTOM;
+  binding->written = -1;
+  return true;
+}
+
+bool AnalogBindings::unbind(uint8_t output) {
+  Binding *binding = slotFor(output);
+  if (binding == nullptr || binding->mode == MODE_OFF)
+    return false;
+  binding->mode = MODE_OFF;
+  return true;
+}
+
+const AnalogBindings::Binding *AnalogBindings::find(uint8_t output) const {
+  for (const Binding &binding : table) {
+    if (binding.mode != MODE_OFF && binding.output == output)
+      return &binding;
+  }
+  return nullptr;
+}
+
+uint8_t AnalogBindings::count() const {
+  uint8_t bound = 0;
+  for (const Binding &binding : table)
+    bound += binding.mode != MODE_OFF;
+  return bound;
+}
+
+void AnalogBindings::tick() {
+  uint32_t now = micros();
+  if (now - lastSample < period)
+    return;
+  lastSample = now;
+  for (uint8_t i = 0; i < MAX_BINDINGS; i++) {
+    if (table[i].mode == MODE_OFF)
+      continue;
+    // Each input once, by its first binding
+    bool seen = false;
+    for (uint8_t j = 0; j < i && !seen; j++)
+      seen = table[j].mode != MODE_OFF && table[j].input == table[i].input;
+    if (seen)
+      continue;
+    uint32_t start = micros();
+    uint16_t reading = analogRead(table[i].input);
+    update(table[i].input, reading);
+    uint32_t elapsed = micros() - start;
+    if (elapsed > worst)
+      worst = elapsed;
+    sampled++;
+    // After the outputs, so listeners do not add to the latency
+    if (sampleHandler != nullptr)
+      sampleHandler(sampleContext, table[i].input, reading);
+    if (eventBus != nullptr)
+      eventBus->publish(SampleReady{table[i].input, reading});
+  }
+}
+
+void AnalogBindings::update(uint8_t input, uint16_t reading) {
+  for (Binding &binding : table) {
+    if (binding.mode != MODE_OFF && binding.input == input)
+      apply(binding, reading);
+  }
+}
+
+void AnalogBindings::apply(Binding &binding, uint16_t reading) {
+  binding.reading = reading;
+  uint16_t value;
+  if (binding.mode == MODE_LEVEL) {
+    value = curveValue(binding.points, reading);
+  } else {
+    // Between the thresholds the output stays as it was
+    bool on = binding.written > 0;
+    if (reading >= binding.onAt)
+      on = true;
+    else if (reading <= binding.offAt)
+      on = false;
+    value = on ? OUTPUT_MAX : 0;
+  }
+  if ((int16_t)value == binding.written)
+    return;
+  binding.written = value;
+  if (handler != nullptr)
+    handler(handlerContext, binding, value);
+}
+
+uint16_t AnalogBindings::curveValue(const uint16_t *points, uint16_t input) {
+  uint32_t x = input < INPUT_MAX ? input : INPUT_MAX;
+  x += x >> 9; // 0..1023 onto the points' 0..1024
+  uint8_t segment = x >> 6;
+  if (segment >= CURVE_POINTS - 1)
+    return points[CURVE_POINTS - 1];
+  int32_t from = points[segment];
+  int32_t to = points[segment + 1];
+  return from + (to - from) * (int32_t)(x & 63) / 64;
+}
+
+bool AnalogBindings::modeFromName(const char *name, Mode &mode) {
+  return lookupName(MODE_NAMES, name, mode);
+}
+
+bool AnalogBindings::curveFromName(const char *name, Curve &curve) {
+  return lookupName(CURVE_NAMES, name, curve);
+}
+
+void AnalogBindings::printJSON(Print &out) const {
+  out.printf_P(Text::FMT_JSON_BINDINGS.p(), (unsigned long)period,
+               (unsigned long)sampled, (unsigned long)worst);
+  bool first = true;
+  for (const Binding &binding : table) {
+    if (binding.mode == MODE_OFF)
+      continue;
+    if (!first)
+      out.print(Text::JSON_COMMA);
+    first = false;
+    out.printf_P(Text::FMT_JSON_BINDING.p(), binding.output, binding.input,
+                 binding.reading, binding.written);
+    out.print(FPSTR(MODE_NAMES[binding.mode]));
+    if (binding.mode == MODE_SWITCH) {
+      out.printf_P(Text::FMT_JSON_BINDING_SWITCH.p(), binding.onAt,
+                   binding.offAt);
+      continue;
+    }
+    out.print(Text::JSON_BINDING_CURVE);
+    out.print(FPSTR(CURVE_NAMES[binding.curve]));
+    out.print(Text::JSON_BINDING_POINTS);
+    for (uint8_t i = 0; i < CURVE_POINTS; i++) {
+      if (i)
+        out.print(Text::JSON_COMMA);
+      out.print(binding.points[i]);
+    }
+    out.print(Text::JSON_ARRAY_OBJECT_CLOSE);
+  }
+  out.print(Text::JSON_ARRAY_OBJECT_CLOSE);
+}
@@ -0,0 +1,124 @@
+#ifndef ANALOG_BINDINGS_H
+#define ANALOG_BINDINGS_H
+
+#include <Arduino.h>
+
+#include "event_bus.h"
+
+// Bindings held at once. Override with -DWORKSHOP_BINDINGS=...
+#ifndef WORKSHOP_BINDINGS
+#define WORKSHOP_BINDINGS 4
+#endif
+
+// Input sampling period (us). Reading the ADC much more often than every
+// few ms starves the ESP8266's Wi-Fi and drops the connection, so keep it
+// in the milliseconds.
+#ifndef WORKSHOP_BINDING_PERIOD_US
+#define WORKSHOP_BINDING_PERIOD_US 5000
+#endif
+
+// Maps analog inputs straight to outputs on the device, so turning a pot
+// moves an LED without a browser round trip. A binding either sets a
+// level (PWM brightness) through a 17-point curve, or switches an output
+// on above one threshold and off below a lower one. tick() reads each
+// bound input once a period is up and writes the outputs that changed in
+// the same call. It only runs when loop() calls it, so a change at the
+// input reaches the LED within one period plus the longest gap between
+// calls: a display frame, an animation frame wait or a slow client's
+// response all add to it. The table and curves are fixed arrays; nothing
+// allocates.
+class AnalogBindings {
+public:
+  static const uint8_t MAX_BINDINGS = WORKSHOP_BINDINGS;
+  static const uint8_t CURVE_POINTS = 17; // at inputs 0, 64, ... 1024
+  static const uint16_t INPUT_MAX = 1023;
+  static const uint16_t OUTPUT_MAX = 1023; // PWM range, see begin()
+
+  enum Mode : uint8_t { MODE_OFF, MODE_LEVEL, MODE_SWITCH };
+  enum Curve : uint8_t {
+    CURVE_LINEAR,
+    CURVE_GAMMA, // perceived brightness about linear in the input
+    CURVE_INVERTED,
+    CURVE_CUSTOM
+  };
+
+  struct Binding {
+    Mode mode;
+    uint8_t output; // the id the output handler knows it by
+    uint8_t input;  // analog pin
+    Curve curve;
+    uint16_t onAt; // switch: on at or above
+    uint16_t offAt; // switch: off at or below
+    uint16_t reading;
+    int16_t written; // last output value, -1 before the first
+    uint16_t points[CURVE_POINTS];
+  };
+
+  // Writes one output: a level 0..OUTPUT_MAX, or 0 / OUTPUT_MAX for a
+  // switch. Required: outputs are ids, not pins, so only the handler
+  // knows where they go.
+  typedef void (*OutputHandler)(void *context, const Binding &binding,
+                                uint16_t value);
+  // Gets every reading tick() takes, after its outputs, in the same
+  // context as tick()
+  typedef void (*SampleHandler)(void *context, uint8_t input,
+                                uint16_t reading);
+
+  AnalogBindings();
+
+  // Sets the PWM range to OUTPUT_MAX
+  void begin();
+  void setOutputHandler(OutputHandler handler, void *context);
+  void setSampleHandler(SampleHandler handler, void *context);
+  void setPeriodMicros(uint32_t us) { period = us; }
+  // Publishes a SampleReady for every reading tick() takes
+  void attachBus(EventBus &bus) { eventBus = &bus; }
+
+  // Each replaces any binding of the same output; false when there is no
+  // output handler, the table is full or the arguments are out of range
+  bool bindLevel(uint8_t output, uint8_t input, Curve curve = CURVE_LINEAR);
+  bool bindSwitch(uint8_t output, uint8_t input, uint16_t onAt,
+                  uint16_t offAt);
+  // CURVE_POINTS outputs for a level binding, makes its curve CURVE_CUSTOM
+  bool setCurve(uint8_t output, const uint16_t *points);
+  // The output keeps its last value; false if it was not bound
+  bool unbind(uint8_t output);
+  const Binding *find(uint8_t output) const;
+  uint8_t count() const;
+
+  // Samples every bound input when a period is up; cheap otherwise
+  void tick();
+  // Runs the bindings of `input` on a reading taken elsewhere
+  void update(uint8_t input, uint16_t reading);
+
+  // Piecewise linear through the points, for inputs 0..INPUT_MAX
+  static uint16_t curveValue(const uint16_t *points, uint16_t input);
+  // "off" / "level" / "switch" and "linear" / "gamma" / "inverted" /
+  // "custom", as printJSON() writes them
+  static bool modeFromName(const char *name, Mode &mode);
+  static bool curveFromName(const char *name, Curve &curve);
+
+  uint32_t samples() const { return sampled; }
+  // Longest time from reading an input to its last output written
+  uint32_t worstMicros() const { return worst; }
+
+  // {"period_us":..,"samples":..,"worst_us":..,"bindings":[..]}
+  void printJSON(Print &out) const;
+
+private:
+  Binding *slotFor(uint8_t output);
+  void apply(Binding &binding, uint16_t reading);
+
+  Binding table[MAX_BINDINGS];
+  OutputHandler handler;
+  void *handlerContext;
+  SampleHandler sampleHandler;
+  void *sampleContext;
+  EventBus *eventBus;
+  uint32_t period;
+  uint32_t lastSample;
+  uint32_t sampled;
+  uint32_t worst;
+};
+
+#endif
@@ -0,0 +1,129 @@
+#include "boot_trace.h"
+#include "workshop_strings.h"
+
+BootTrace::BootTrace() {
+  count = 0;
+  openDepth = 0;
+  lastMarkUs = 0;
+  readyUs = 0;
+  budgetMs = WORKSHOP_BOOT_BUDGET_MS;
+  dropped = 0;
+}
+
+void BootTrace::beginPhase(const char *name, uint32_t budgetMs) {
+  if (isReady())
+    return;
+
+  // Still count nesting so endPhase() stays balanced when full
+  if (count >= MAX_PHASES || openDepth >= MAX_DEPTH) {
+    dropped++;
+    if (openDepth < MAX_DEPTH)
+      openStack[openDepth++] = -1;
+    return;
+  }
+
+  BootPhase &phase = phases[count];
+  phase.name = name;
+  phase.startUs = micros();
+  phase.durationUs = 0;
+  phase.budgetUs = budgetMs * 1000;
+  phase.depth = openDepth;
+  openStack[openDepth++] = count++;
+}
+
+void BootTrace::endPhase() {
+  if (openDepth == 0)
+    return;
+
+  int index = openStack[--openDepth];
+  if (index < 0)
+    return;
+
+  uint32_t now = micros();
+  phases[index].durationUs = now - phases[index].startUs;
+  if (openDepth == 0)
+    lastMarkUs = now;
+}
+
+void BootTrace::mark(const char *name, uint32_t budgetMs) {
+  if (isReady())
+    return;
+  if (count >= MAX_PHASES) {
+    dropped++;
+    return;
+  }
+
+  uint32_t now = micros();
+  BootPhase &phase = phases[count++];
+  phase.name = name;
+  phase.startUs = lastMarkUs;
+  phase.durationUs = now - lastMarkUs;
+  phase.budgetUs = budgetMs * 1000;
+  phase.depth = 0;
+  lastMarkUs = now;
+}
+
+void BootTrace::ready(Print &out) {
+  if (isReady())
+    return;
+  readyUs = micros();
+  printReport(out);
+}
+
+uint32_t BootTrace::timeToReadyMs() const {
+  return (isReady() ? readyUs : micros()) / 1000;
+}
+
+bool BootTrace::overBudget() const {
+  return budgetMs != 0 && timeToReadyMs() > budgetMs;
+}
+
+void BootTrace::printReport(Print &out) const {
+  out.println(Text::BOOT_HEADER);
+  out.println(Text::BOOT_COLUMNS);
+  for (int i = 0; i < count; i++) {
+    const BootPhase &phase = phases[i];
+    bool slow = phase.budgetUs != 0 && phase.durationUs > phase.budgetUs;
+    out.printf_P(Text::FMT_BOOT_ROW.p(), (unsigned long)phase.startUs / 1000,
+                 (unsigned long)phase.durationUs / 1000);
+    for (int d = 0; d < phase.depth; d++) {
+      out.print(Text::BOOT_INDENT);
+    }
+    out.print(FPSTR(phase.name));
+    if (slow) {
+      out.printf_P(Text::FMT_BOOT_PHASE_OVER.p(),
+                   (unsigned long)phase.budgetUs / 1000);
+    }
+    out.println();
+  }
+  if (dropped) {
+    out.printf_P(Text::FMT_BOOT_DROPPED.p(), dropped);
+  }
+  out.printf_P(Text::FMT_BOOT_TOTAL.p(), (unsigned long)timeToReadyMs(),
+               (unsigned long)budgetMs);
+  if (overBudget()) {
+    out.print(Text::BOOT_OVER_BUDGET);
+  }
+  out.println();
+  out.println(Text::BOOT_FOOTER);
+}
+
+void BootTrace::printJSON(Print &out) const {
+  out.print(Text::JSON_BOOT_READY);
+  out.print(Text::jsonBool(isReady()));
+  out.printf_P(Text::FMT_JSON_BOOT_TIMES.p(), (unsigned long)timeToReadyMs(),
+               (unsigned long)budgetMs);
+  out.print(Text::jsonBool(overBudget()));
+  out.printf_P(Text::FMT_JSON_BOOT_DROPPED.p(), dropped);
+  for (int i = 0; i < count; i++) {
+    const BootPhase &phase = phases[i];
+    if (i)
+      out.print(Text::JSON_COMMA);
+    out.print(Text::JSON_BOOT_PHASE_NAME);
+    out.print(FPSTR(phase.name));
+    out.printf_P(Text::FMT_JSON_BOOT_PHASE.p(), phase.depth,
+                 (unsigned long)phase.startUs, (unsigned long)phase.durationUs,
+                 (unsigned long)phase.budgetUs);
+  }
+  out.print(Text::JSON_ARRAY_OBJECT_CLOSE);
+}
@@ -0,0 +1,73 @@
+#ifndef BOOT_TRACE_H
+#define BOOT_TRACE_H
+
+#include <Arduino.h>
+
+// Time-to-ready budget; override with -DWORKSHOP_BOOT_BUDGET_MS=...
+#ifndef WORKSHOP_BOOT_BUDGET_MS
+#define WORKSHOP_BOOT_BUDGET_MS 1000
+#endif
+
+struct BootPhase {
+  PGM_P name;          // flash (PSTR/Text::) or static RAM string
+  uint32_t startUs;    // micros() since boot
+  uint32_t durationUs; // 0 while still open
+  uint32_t budgetUs;   // 0 = no per-phase budget
+  uint8_t depth;       // nesting level (setupWiFi inside start(), ...)
+};
+
+// Fixed-size record of where boot time goes. Library setup helpers open
+// nested phases with Scope; sketch code brackets its own steps with mark().
+class BootTrace {
+public:
+  static const int MAX_PHASES = 24;
+  static const int MAX_DEPTH = 4;
+
+  BootTrace();
+
+  // Opens a phase nested in the currently open one
+  void beginPhase(const char *name, uint32_t budgetMs = 0);
+  void endPhase();
+
+  // Records a top-level phase covering everything since the previous mark
+  // (or since boot), e.g. mark(PSTR("Serial.begin")) right after
+  // Serial.begin()
+  void mark(const char *name, uint32_t budgetMs = 0);
+
+  // Stops the clock, prints the summary table once
+  void ready(Print &out);
+
+  void setBudget(uint32_t ms) { budgetMs = ms; }
+  uint32_t budget() const { return budgetMs; }
+  bool isReady() const { return readyUs != 0; }
+  uint32_t timeToReadyMs() const;
+  bool overBudget() const;
+
+  void printReport(Print &out) const;
+  void printJSON(Print &out) const;
+
+  // RAII helper for library functions
+  class Scope {
+  public:
+    Scope(BootTrace &trace, const char *name, uint32_t budgetMs = 0)
+        : trace(trace) {
+      trace.beginPhase(name, budgetMs);
+    }
+    ~Scope() { trace.endPhase(); }
+
+  private:
+    BootTrace &trace;
+  };
+
+private:
+  BootPhase phases[MAX_PHASES];
+  int count;
+  int openStack[MAX_DEPTH];
+  int openDepth;
+  uint32_t lastMarkUs;
+  uint32_t readyUs;
+  uint32_t budgetMs;
+  uint16_t dropped;
+};
+
+#endif
@@ -0,0 +1,197 @@
+#include "display_flusher.h"
+#include "event_trace.h"
+
+namespace {
+
+const uint8_t COMMANDS = 0x00; // control byte: command stream follows
+const uint8_t DATA = 0x40;     // control byte: GDDRAM data follows
+const uint8_t PAGEADDR = 0x22;
+const uint8_t COLUMNADDR = 0x21;
+const size_t ADDRESS_BYTES = 7;
+
+} // namespace
+
+DisplayFlusher::DisplayFlusher() {
+  wire = nullptr;
+  back = nullptr;
+  address = 0;
+  frameListener = nullptr;
+  memset(front, 0, sizeof(front));
+  dirty = 0;
+  memset(spanFirst, 0, sizeof(spanFirst));
+  memset(spanLast, 0, sizeof(spanLast));
+  page = 0;
+  column = 0;
+  addressed = false;
+  sending = false;
+  waiting = false;
+  unknown = true;
+  clock = WORKSHOP_I2C_CLOCK;
+  restoreClock = 100000;
+  budget = WORKSHOP_DISPLAY_TICK_US;
+  sent = 0;
+  replaced = 0;
+  worstTick = 0;
+  busBytes = 0;
+}
+
+void DisplayFlusher::attach(TwoWire *wire, uint8_t address,
+                            const uint8_t *back) {
+  this->wire = wire;
+  this->address = address;
+  this->back = back;
+  sending = false;
+  waiting = false;
+  unknown = true;
+}
+
+void DisplayFlusher::setBusSpeed(uint32_t hz, uint32_t restoreHz) {
+  clock = hz;
+  restoreClock = restoreHz;
+}
+
+uint32_t DisplayFlusher::transferMicros(size_t bytes, uint32_t hz) {
+  // 9 clocks per byte (8 data + ACK) including the address byte, plus
+  // start and stop
+  uint32_t bits = (uint32_t)(bytes + 1) * 9 + 2;
+  return (uint32_t)(((uint64_t)bits * 1000000 + hz - 1) / hz);
+}
+
+void DisplayFlusher::present() {
+  if (back == nullptr)
+    return;
+  if (sending) {
+    if (waiting)
+      replaced++;
+    waiting = true;
+    return;
+  }
+  latch();
+}
+
+void DisplayFlusher::latch() {
+  waiting = false;
+  dirty = 0;
+  for (uint8_t p = 0; p < PAGES; p++) {
+    const uint8_t *from = back + p * WIDTH;
+    uint8_t *to = front + p * WIDTH;
+    // Columns first..last differ; only that span goes on the bus
+    uint8_t first = 0;
+    uint8_t last = WIDTH - 1;
+    if (!unknown) {
+      while (first < WIDTH && from[first] == to[first])
+        first++;
+      if (first == WIDTH)
+        continue;
+      while (from[last] == to[last])
+        last--;
+    }
+    memcpy(to + first, from + first, last - first + 1);
+    spanFirst[p] = first;
+    spanLast[p] = last;
+    dirty |= 1 << p;
+  }
+  unknown = false;
+
+  unsigned pages = 0;
+  for (uint8_t bits = dirty; bits != 0; bits &= bits - 1)
+    pages++;
+  TRACE(DISPLAY_FLUSH, pages);
+  if (dirty == 0) {
+    // Nothing differs from the panel: done without touching the bus
+    completed();
+    return;
+  }
+  page = 0;
+  sending = true;
+  nextPage();
+  addressed = false;
+}
+
+void DisplayFlusher::nextPage() {
+  while (page < PAGES && !(dirty & (1 << page)))
+    page++;
+  if (page < PAGES) {
+    column = spanFirst[page];
+    return;
+  }
+  sending = false;
+  completed();
+}
+
+void DisplayFlusher::completed() {
+  sent++;
+  TRACE(DISPLAY_FLUSHED);
+  if (frameListener != nullptr)
+    frameListener(front);
+}
+
+bool DisplayFlusher::tick() {
+  if (!sending && waiting)
+    latch();
+  if (!sending)
+    return false;
+
+  uint32_t start = micros();
+  uint32_t spent = 0;
+  wire->setClock(clock);
+  while (sending) {
+    size_t length = spanLast[page] - column + 1;
+    if (length > CHUNK)
+      length = CHUNK;
+    uint32_t cost = transferMicros(length + 1, clock);
+    if (!addressed)
+      cost += transferMicros(ADDRESS_BYTES, clock);
+    if (spent > 0 && spent + cost > budget)
+      break;
+    if (!addressed)
+      sendAddress(page);
+    sendData(front + page * WIDTH + column, length);
+    spent += cost;
+    column += length;
+    if (column > spanLast[page]) {
+      dirty &= ~(1 << page);
+      uint8_t done = page++;
+      nextPage();
+      // The panel wrapped to the start of the same span one page down
+      addressed = sending && page == done + 1 &&
+                  spanFirst[page] == spanFirst[done] &&
+                  spanLast[page] == spanLast[done];
+    }
+  }
+  wire->setClock(restoreClock);
+
+  uint32_t took = micros() - start;
+  if (took > worstTick)
+    worstTick = took;
+  return isBusy();
+}
+
+void DisplayFlusher::finish() {
+  while (tick()) {
+  }
+}
+
+void DisplayFlusher::sendAddress(uint8_t page) {
+  // Pages page..7 over the page's span: horizontal mode then walks the
+  // window without further addressing while the next pages share it
+  wire->beginTransmission(address);
+  wire->write(COMMANDS);
+  wire->write(PAGEADDR);
+  wire->write(page);
+  wire->write((uint8_t)(PAGES - 1));
+  wire->write(COLUMNADDR);
+  wire->write(spanFirst[page]);
+  wire->write(spanLast[page]);
+  wire->endTransmission();
+  busBytes += ADDRESS_BYTES + 1;
+  addressed = true;
+}
+
+void DisplayFlusher::sendData(const uint8_t *data, size_t length) {
+  wire->beginTransmission(address);
+  wire->write(DATA);
+  wire->write(data, length);
+  wire->endTransmission();
+  busBytes += length + 2;
+}
@@ -0,0 +1,111 @@
+#ifndef DISPLAY_FLUSHER_H
+#define DISPLAY_FLUSHER_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+// I2C clock while the panel is written (Hz)
+#ifndef WORKSHOP_I2C_CLOCK
+#define WORKSHOP_I2C_CLOCK 400000
+#endif
+
+// Bus time one tick() may spend (us); at least one transaction always goes
+#ifndef WORKSHOP_DISPLAY_TICK_US
+#define WORKSHOP_DISPLAY_TICK_US 1000
+#endif
+
+// Framebuffer bytes per I2C transaction
+#ifndef WORKSHOP_DISPLAY_CHUNK
+#define WORKSHOP_DISPLAY_CHUNK 32
+#endif
+
+// Sends a 128x64 SSD1306 framebuffer in small transactions spread over
+// loop iterations instead of one ~25 ms display() call. The driver's
+// buffer is the back buffer everything draws into; present() copies it
+// into the front buffer here, which tick() then writes out. The front
+// buffer never changes while it is on the bus, and a frame presented in
+// the meantime waits until the current one is complete (only the newest
+// waits), so the panel is always written one whole frame at a time.
+// Of each page only the span from the first to the last changed column
+// is sent; unchanged pages are skipped.
+//
+// Needs the panel in horizontal addressing mode, as
+// Adafruit_SSD1306::begin() leaves it. Frames are copied when present()
+// is called or, for one that had to wait, by tick(): do not call tick()
+// (handleClient()) halfway through drawing a frame.
+class DisplayFlusher {
+public:
+  static const uint8_t WIDTH = 128;
+  static const uint8_t PAGES = 8;
+  static const size_t FRAME_SIZE = WIDTH * PAGES;
+  static const size_t CHUNK = WORKSHOP_DISPLAY_CHUNK;
+  static_assert(CHUNK > 0 && CHUNK < BUFFER_LENGTH,
+                "chunk and control byte fit the Wire buffer"); // flash-ok
+
+  // Told when a frame is completely on the panel (`frame` is the front
+  // buffer); host tools capture frames through it
+  typedef void (*FrameListener)(const uint8_t *frame);
+
+  DisplayFlusher();
+
+  // `back` is the driver's framebuffer (getBuffer() after begin())
+  void attach(TwoWire *wire, uint8_t address, const uint8_t *back);
+  bool isAttached() const { return back != nullptr; }
+
+  // Clock while writing the panel and the one restored afterwards for
+  // other devices on the bus (Adafruit_SSD1306's clkDuring/clkAfter)
+  void setBusSpeed(uint32_t hz, uint32_t restoreHz = 100000);
+  uint32_t busSpeed() const { return clock; }
+  void setTickBudget(uint32_t us) { budget = us; }
+  uint32_t tickBudget() const { return budget; }
+
+  // Hands the back buffer over as the next frame; returns at once
+  void present();
+  // Writes transactions until the tick budget is used up; true while a
+  // frame is still being sent or waiting
+  bool tick();
+  // Sends the frame in flight and any waiting one before returning, for
+  // callers that delay() instead of running the loop
+  void finish();
+  bool isBusy() const { return sending || waiting; }
+  void setFrameListener(FrameListener listener) { frameListener = listener; }
+
+  uint32_t frames() const { return sent; }         // completed
+  uint32_t superseded() const { return replaced; } // replaced while waiting
+  uint32_t worstTickMicros() const { return worstTick; }
+  uint32_t bytesSent() const { return busBytes; }
+
+  // Bus time of one transaction carrying `bytes` after the address byte
+  static uint32_t transferMicros(size_t bytes, uint32_t hz);
+
+private:
+  void latch();
+  void sendAddress(uint8_t page);
+  void sendData(const uint8_t *data, size_t length);
+  void nextPage();
+  void completed();
+
+  TwoWire *wire;
+  const uint8_t *back;
+  uint8_t address;
+  FrameListener frameListener;
+  uint8_t front[FRAME_SIZE];
+  uint8_t dirty; // one bit per page still to send
+  uint8_t spanFirst[PAGES]; // changed columns of each page
+  uint8_t spanLast[PAGES];
+  uint8_t page; // page being sent
+  uint8_t column;
+  bool addressed; // panel pointer already at page/column
+  bool sending;
+  bool waiting;   // a newer frame is in the back buffer
+  bool unknown;   // panel contents unknown (first frame)
+  uint32_t clock;
+  uint32_t restoreClock;
+  uint32_t budget;
+  uint32_t sent;
+  uint32_t replaced;
+  uint32_t worstTick;
+  uint32_t busBytes;
+};
+
+#endif
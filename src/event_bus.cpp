@@ -0,0 +1,91 @@
+#include "event_bus.h"
+
+EventBus::EventBus() : events(0), deliveries(0) {
+  for (Subscriber &subscriber : table) {
+    subscriber.handler = nullptr;
+    subscriber.context = nullptr;
+    subscriber.types = 0;
+  }
+  for (uint32_t &mask : listeners)
+    mask = 0;
+}
+
+int8_t EventBus::subscribe(uint8_t types, Handler handler, void *context) {
+  if (handler == nullptr)
+    return -1;
+  for (uint8_t i = 0; i < MAX_SUBSCRIBERS; i++) {
+    Subscriber &subscriber = table[i];
+    if (subscriber.handler != nullptr)
+      continue;
+    subscriber.handler = handler;
+    subscriber.context = context;
+    subscriber.types = types;
+    for (uint8_t type = 0; type < BUS_EVENT_TYPES; type++) {
+      if (types & busMask((BusEventType)type))
+        listeners[type] |= 1UL << i;
+    }
+    return i;
+  }
+  return -1;
+}
+
+void EventBus::unsubscribe(int8_t id) {
+  if (id < 0 || id >= MAX_SUBSCRIBERS)
+    return;
+  for (uint32_t &mask : listeners)
+    mask &= ~(1UL << id);
+  table[id].handler = nullptr;
+  table[id].types = 0;
+}
+
+uint8_t EventBus::subscribers() const {
+  uint8_t count = 0;
+  for (const Subscriber &subscriber : table)
+    count += subscriber.handler != nullptr;
+  return count;
+}
+
+void EventBus::publish(const LedChanged &led) {
+  BusEvent event;
+  event.type = BUS_LED_CHANGED;
+  event.led = led;
+  dispatch(event);
+}
+
+void EventBus::publish(const SampleReady &sample) {
+  BusEvent event;
+  event.type = BUS_SAMPLE_READY;
+  event.sample = sample;
+  dispatch(event);
+}
+
+void EventBus::publish(const WiFiState &wifi) {
+  BusEvent event;
+  event.type = BUS_WIFI_STATE;
+  event.wifi = wifi;
+  dispatch(event);
+}
+
+void EventBus::publish(const ClientEvent &client) {
+  BusEvent event;
+  event.type = BUS_CLIENT;
+  event.client = client;
+  dispatch(event);
+}
+
+void EventBus::dispatch(BusEvent &event) {
+  events++;
+  uint32_t pending = listeners[event.type];
+  if (pending == 0)
+    return;
+  event.at = micros();
+  while (pending != 0) {
+    uint8_t i = __builtin_ctz(pending);
+    pending &= pending - 1;
+    // Unsubscribed by an earlier handler of this event
+    if ((listeners[event.type] & (1UL << i)) == 0)
+      continue;
+    deliveries++;
+    table[i].handler(table[i].context, event);
+  }
+}
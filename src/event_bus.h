@@ -0,0 +1,102 @@
+#ifndef EVENT_BUS_H
+#define EVENT_BUS_H
+
+#include <Arduino.h>
+
+// Subscribers held at once, at most 32. Override with
+// -DWORKSHOP_BUS_SUBSCRIBERS=...
+#ifndef WORKSHOP_BUS_SUBSCRIBERS
+#define WORKSHOP_BUS_SUBSCRIBERS 8
+#endif
+
+enum BusEventType : uint8_t {
+  BUS_LED_CHANGED,
+  BUS_SAMPLE_READY,
+  BUS_WIFI_STATE,
+  BUS_CLIENT,
+  BUS_EVENT_TYPES
+};
+
+// Subscription masks: busMask(BUS_LED_CHANGED) | busMask(BUS_WIFI_STATE)
+constexpr uint8_t busMask(BusEventType type) { return 1 << type; }
+
+// Payloads, one per type
+struct LedChanged {
+  uint8_t led;
+  bool on;
+};
+struct SampleReady {
+  uint8_t input; // analog pin
+  int32_t value;
+};
+struct WiFiState {
+  bool connected;
+  uint8_t status; // wl_status_t
+};
+// A client took (connected) or gave up a connection slot
+struct ClientEvent {
+  uint8_t slot;
+  bool connected;
+  uint32_t ip;
+};
+
+struct BusEvent {
+  BusEventType type;
+  uint32_t at; // micros() when published
+  union {
+    LedChanged led;
+    SampleReady sample;
+    WiFiState wifi;
+    ClientEvent client;
+  };
+};
+
+// Publish/subscribe between the code that owns a piece of state and the
+// code that shows or sends it. Each subscriber names the event types it
+// wants and is called for those only, synchronously, in subscription
+// order. Subscribers live in a fixed table and events are passed by
+// reference, so publishing never allocates; with nobody subscribed to a
+// type it costs a load and a branch.
+//
+// Handlers may publish (keep it acyclic) and may unsubscribe anyone; a
+// subscriber removed during dispatch gets nothing more. Loop context only,
+// not ISRs.
+class EventBus {
+public:
+  static const uint8_t MAX_SUBSCRIBERS = WORKSHOP_BUS_SUBSCRIBERS;
+  static_assert(MAX_SUBSCRIBERS <= 32, "one bit each"); // flash-ok
+
+  typedef void (*Handler)(void *context, const BusEvent &event);
+
+  EventBus();
+
+  // Calls `handler` with the events whose busMask() is in `types`;
+  // returns the subscription id, or -1 when the table is full
+  int8_t subscribe(uint8_t types, Handler handler, void *context = nullptr);
+  void unsubscribe(int8_t id);
+  uint8_t subscribers() const;
+
+  void publish(const LedChanged &led);
+  void publish(const SampleReady &sample);
+  void publish(const WiFiState &wifi);
+  void publish(const ClientEvent &client);
+
+  uint32_t published() const { return events; }
+  uint32_t delivered() const { return deliveries; }
+
+private:
+  struct Subscriber {
+    Handler handler;
+    void *context;
+    uint8_t types;
+  };
+
+  void dispatch(BusEvent &event);
+
+  Subscriber table[MAX_SUBSCRIBERS];
+  uint32_t listeners[BUS_EVENT_TYPES]; // bit i: table[i] wants the type
+  uint32_t events;
+  uint32_t deliveries;
+};
+
+#endif
@@ -0,0 +1,159 @@
+#include "event_trace.h"
+#include "workshop_strings.h"
+
+EventTrace workshopTrace;
+
+namespace {
+
+size_t putVarint(uint8_t *out, uint64_t value) {
+  size_t n = 0;
+  while (value >= 0x80) {
+    out[n++] = (uint8_t)value | 0x80;
+    value >>= 7;
+  }
+  out[n++] = (uint8_t)value;
+  return n;
+}
+
+void putLE(uint8_t *out, uint32_t value, size_t bytes) {
+  for (size_t i = 0; i < bytes; i++)
+    out[i] = value >> (8 * i);
+}
+
+char hexDigit(uint8_t value) {
+  return value < 10 ? '0' + value : 'a' + value - 10;
+}
+
+} // namespace
+
+EventTrace::EventTrace() {
+  head = 0;
+  tail = 0;
+  lastTime = 0;
+  tailTime = 0;
+  lost = 0;
+  drops = 0;
+  enabled = true;
+}
+
+void EventTrace::put(Record &r, const char *text) {
+  size_t room = MAX_ARGS - r.length;
+  if (room == 0)
+    return;
+  size_t n = text != nullptr ? strnlen(text, MAX_TEXT) : 0;
+  if (n > room - 1)
+    n = room - 1;
+  r.args[r.length++] = n;
+  memcpy(r.args + r.length, text, n);
+  r.length += n;
+}
+
+void EventTrace::put(Record &r, const __FlashStringHelper *text) {
+  PGM_P p = reinterpret_cast<PGM_P>(text);
+  size_t room = MAX_ARGS - r.length;
+  if (room == 0)
+    return;
+  size_t n = p != nullptr ? strnlen_P(p, MAX_TEXT) : 0;
+  if (n > room - 1)
+    n = room - 1;
+  r.args[r.length++] = n;
+  memcpy_P(r.args + r.length, p, n);
+  r.length += n;
+}
+
+void EventTrace::putNumber(Record &r, int64_t value) {
+  if (MAX_ARGS - r.length < 10)
+    return; // cut; the decoder shows the missing arguments as '?'
+  uint64_t zigzag = ((uint64_t)value << 1) ^ (uint64_t)(value >> 63);
+  r.length += putVarint(r.args + r.length, zigzag);
+}
+
+void EventTrace::commit(TraceEvent event, Record &r) {
+  if (lost > 0) {
+    // The DROPPED event goes first, at the time of the event that found
+    // room again
+    uint8_t count[10];
+    size_t n = putVarint(count, (uint64_t)lost << 1);
+    if (!store(TRACE_DROPPED, r.time, count, n)) {
+      lost++;
+      drops++;
+      return;
+    }
+    lost = 0;
+  }
+  if (!store(event, r.time, r.args, r.length)) {
+    lost++;
+    drops++;
+  }
+}
+
+bool EventTrace::store(uint8_t event, uint32_t time, const uint8_t *args,
+                       size_t length) {
+  uint8_t delta[5];
+  size_t deltaLength = putVarint(delta, time - lastTime);
+  size_t total = 2 + deltaLength + length;
+  if (CAPACITY - (head - tail) < total)
+    return false;
+
+  uint32_t at = head;
+  ring[at++ & MASK] = event;
+  ring[at++ & MASK] = total - 2;
+  for (size_t i = 0; i < deltaLength; i++)
+    ring[at++ & MASK] = delta[i];
+  for (size_t i = 0; i < length; i++)
+    ring[at++ & MASK] = args[i];
+  lastTime = time;
+  head = at; // publishes the event to read()
+  return true;
+}
+
+size_t EventTrace::read(uint8_t *out, size_t size) {
+  if (size < CHUNK_HEADER)
+    return 0;
+
+  out[0] = 'W';
+  out[1] = 'T';
+  out[2] = VERSION;
+  out[3] = TRACE_EVENT_COUNT;
+  putLE(out + 4, tailTime, 4);
+  putLE(out + 8, drops, 4);
+
+  size_t length = CHUNK_HEADER;
+  uint32_t end = head;
+  while (tail != end) {
+    size_t total = 2 + ring[(tail + 1) & MASK];
+    if (size - length < total)
+      break;
+    for (size_t i = 0; i < total; i++)
+      out[length + i] = ring[(tail + i) & MASK];
+
+    // Keep the time of the last event read as the next chunk's base
+    uint32_t delta = 0;
+    for (size_t i = 0; i < 5; i++) {
+      uint8_t b = out[length + 2 + i];
+      delta |= (uint32_t)(b & 0x7f) << (7 * i);
+      if (!(b & 0x80))
+        break;
+    }
+    tailTime += delta;
+    length += total;
+    tail += total;
+  }
+  putLE(out + 12, length - CHUNK_HEADER, 2);
+  return length;
+}
+
+void EventTrace::dump(Print &out) {
+  uint8_t chunk[CHUNK_HEADER + 2 * MAX_RECORD];
+  char line[2 * sizeof(chunk)];
+  do {
+    size_t n = read(chunk, sizeof(chunk));
+    for (size_t i = 0; i < n; i++) {
+      line[2 * i] = hexDigit(chunk[i] >> 4);
+      line[2 * i + 1] = hexDigit(chunk[i] & 0x0f);
+    }
+    out.print(Text::TRACE_HEX_PREFIX);
+    out.write((const uint8_t *)line, 2 * n);
+    out.println();
+  } while (queued() > 0);
+}
@@ -0,0 +1,118 @@
+#ifndef EVENT_TRACE_H
+#define EVENT_TRACE_H
+
+#include <Arduino.h>
+#include <type_traits>
+
+#include "trace_events.h"
+
+// -DWORKSHOP_TRACE=0 compiles every TRACE() call away
+#ifndef WORKSHOP_TRACE
+#define WORKSHOP_TRACE 1
+#endif
+
+// Bytes of queued events, a power of two
+#ifndef WORKSHOP_TRACE_SIZE
+#if WORKSHOP_TRACE
+#define WORKSHOP_TRACE_SIZE 1024
+#else
+#define WORKSHOP_TRACE_SIZE 64
+#endif
+#endif
+
+// Binary event trace. Each event is stored as its ID, the microseconds
+// since the previous event and its arguments as varints or short text, so
+// recording one costs a few stores and no formatting. Events that do not
+// fit are counted and reported by a DROPPED event once there is room.
+// read() and dump() hand out the queue as self-contained chunks that
+// tools/trace_decode.py turns into text or a Chrome trace:
+//
+//   "WT" version events base(u32) dropped(u32) length(u16) records...
+//   record: id, length of the rest, delta (varint), arguments
+//
+// Numbers are little-endian; integer arguments are zigzag varints, text
+// is a length byte and the bytes. One writer (loop() code, not ISRs).
+class EventTrace {
+public:
+  static const size_t CAPACITY = WORKSHOP_TRACE_SIZE;
+  static const size_t MAX_RECORD = 48; // arguments past this are cut
+  static const size_t MAX_TEXT = 24;   // per %s argument
+  static const size_t CHUNK_HEADER = 14;
+  static const uint8_t VERSION = 1;
+
+  EventTrace();
+
+  template <typename... Args>
+  void record(TraceEvent event, const Args &...args) {
+    if (!enabled)
+      return;
+    Record r;
+    r.time = micros();
+    r.length = 0;
+    putArgs(r, args...);
+    commit(event, r);
+  }
+
+  // Moves whole events into `out` as one chunk and returns its length;
+  // 0 if `size` cannot hold the header
+  size_t read(uint8_t *out, size_t size);
+  // Bytes read() needs to return everything queued in one chunk
+  size_t chunkSize() const { return CHUNK_HEADER + queued(); }
+  // Writes the queue as hex lines prefixed "#wtr ", which the decoder
+  // picks out of a serial capture
+  void dump(Print &out);
+
+  void setEnabled(bool on) { enabled = on; }
+  bool isEnabled() const { return enabled; }
+  size_t queued() const { return head - tail; }
+  uint32_t dropped() const { return drops; }
+
+private:
+  static const uint32_t MASK = CAPACITY - 1;
+  static_assert((CAPACITY & MASK) == 0, "power of two"); // flash-ok
+  static const size_t MAX_ARGS = MAX_RECORD - 7; // id, length, delta
+
+  struct Record {
+    uint32_t time;
+    uint8_t length;
+    uint8_t args[MAX_ARGS];
+  };
+
+  void commit(TraceEvent event, Record &r);
+  bool store(uint8_t event, uint32_t time, const uint8_t *args,
+             size_t length);
+
+  void putArgs(Record &) {}
+  template <typename Arg, typename... Rest>
+  void putArgs(Record &r, const Arg &arg, const Rest &...rest) {
+    put(r, arg);
+    putArgs(r, rest...);
+  }
+  template <typename T, typename std::enable_if<
+                            std::is_integral<T>::value, int>::type = 0>
+  void put(Record &r, T value) {
+    putNumber(r, (int64_t)value);
+  }
+  void put(Record &r, const char *text);
+  void put(Record &r, const __FlashStringHelper *text);
+  void putNumber(Record &r, int64_t value);
+
+  uint8_t ring[CAPACITY];
+  volatile uint32_t head; // end of the last stored event (writer)
+  volatile uint32_t tail; // start of the oldest unread event (reader)
+  uint32_t lastTime;      // micros() of the last stored event
+  uint32_t tailTime;      // micros() of the event before tail
+  uint32_t lost;          // dropped since the last DROPPED event
+  uint32_t drops;
+  bool enabled;
+};
+
+extern EventTrace workshopTrace;
+
+#if WORKSHOP_TRACE
+#define TRACE(event, ...) workshopTrace.record(TRACE_##event, ##__VA_ARGS__)
+#else
+#define TRACE(...) ((void)0)
+#endif
+
+#endif
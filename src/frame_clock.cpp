@@ -0,0 +1,69 @@
+#include "frame_clock.h"
+#include "event_trace.h"
+
+FrameClock::FrameClock(uint16_t fps) {
+  setFps(fps);
+  restart();
+}
+
+void FrameClock::setFps(uint16_t fps) {
+  period = 1000000UL / (fps > 0 ? fps : 1);
+}
+
+void FrameClock::setPeriodMs(uint32_t ms) {
+  period = (ms > 0 ? ms : 1) * 1000UL;
+}
+
+void FrameClock::restart() {
+  started = micros();
+  due = started;
+  shown = 0;
+  skipped = 0;
+  worstWork = 0;
+}
+
+void FrameClock::waitUntil(uint32_t deadline) {
+  // Render plus flush of the frame that is up now
+  uint32_t now = micros();
+  uint32_t work = now - due;
+  if ((int32_t)work > 0 && work > worstWork)
+    worstWork = work;
+
+  int32_t remaining = (int32_t)(deadline - now);
+  if (remaining >= 1000)
+    delay(remaining / 1000);
+  remaining = (int32_t)(deadline - micros());
+  if (remaining > 0)
+    delayMicroseconds(remaining);
+  due = deadline;
+  shown++;
+}
+
+uint32_t FrameClock::frame() {
+  uint32_t deadline = due + period;
+  uint32_t late = micros() - deadline;
+  uint32_t missed = 0;
+  if ((int32_t)late >= (int32_t)period) {
+    // Whole periods behind: drop them and take the latest slot
+    missed = late / period;
+    deadline += missed * period;
+    skipped += missed;
+    TRACE(FRAMES_DROPPED, missed);
+  }
+  waitUntil(deadline);
+  return missed + 1;
+}
+
+uint32_t FrameClock::advance(uint32_t step, uint32_t last) {
+  uint32_t steps = frame();
+  if (step >= last)
+    return last + 1;
+  return last - step > steps ? step + steps : last;
+}
+
+void FrameClock::hold(uint32_t ms) { waitUntil(due + ms * 1000UL); }
+
+float FrameClock::achievedFps() const {
+  uint32_t elapsed = due - started;
+  return elapsed > 0 ? shown * 1000000.0f / elapsed : 0;
+}
@@ -0,0 +1,55 @@
+#ifndef FRAME_CLOCK_H
+#define FRAME_CLOCK_H
+
+#include <Arduino.h>
+
+// Keeps blocking animations on schedule. Frames are due at fixed times
+// counted from the previous frame's due time, not from when drawing
+// finished, so render and flush time no longer stretch an animation.
+// An animation that falls more than a whole period behind (a slow bus,
+// a long request) skips the frames it missed instead of playing them
+// late; the caller is told how many to step over.
+//
+//   FrameClock clock(10);
+//   for (int step = 0; step <= 20; step = clock.advance(step, 20))
+//     drawStep(step); // and flush
+//   clock.hold(1000); // last frame stays up for one second
+//
+// Waiting is delay(), so Wi-Fi keeps running as it did before.
+class FrameClock {
+public:
+  explicit FrameClock(uint16_t fps = 30);
+
+  void setFps(uint16_t fps);
+  void setPeriodMs(uint32_t ms);
+  // Schedule starts now, statistics cleared
+  void restart();
+
+  // Waits until the next frame is due; returns the frames to step: 1 on
+  // schedule, more after skipping
+  uint32_t frame();
+  // frame() for a sequence of steps 0..last: the step to draw next, at
+  // most `last`, or last + 1 once `last` has been up for a period
+  uint32_t advance(uint32_t step, uint32_t last);
+  // Keeps the current frame up until `ms` after it was due
+  void hold(uint32_t ms);
+
+  uint32_t frames() const { return shown; }
+  uint32_t dropped() const { return skipped; }
+  // Frames per second since restart()
+  float achievedFps() const;
+  // Longest time spent drawing and flushing one frame
+  uint32_t worstFrameMicros() const { return worstWork; }
+
+private:
+  void waitUntil(uint32_t deadline);
+
+  uint32_t period; // us
+  uint32_t started;
+  uint32_t due;    // when the current frame was due
+  uint32_t shown;
+  uint32_t skipped;
+  uint32_t worstWork;
+};
+
+#endif
@@ -0,0 +1,154 @@
+#include "glyph_cache.h"
+
+namespace {
+
+const uint8_t GLYPH_COLUMNS = 5; // drawn columns; the 6th is spacing
+const uint8_t ADVANCE = 6;
+const uint8_t LINE = 8;
+
+// Captures drawChar() output in page format
+class GlyphRaster : public Adafruit_GFX {
+public:
+  GlyphRaster(uint8_t *out, uint8_t size)
+      : Adafruit_GFX(GLYPH_COLUMNS * size, LINE * size), out(out),
+        columns(GLYPH_COLUMNS * size) {}
+
+  void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+    if (color == 0 || x < 0 || y < 0 || x >= width() || y >= height())
+      return;
+    out[(y / LINE) * columns + x] |= 1 << (y % LINE);
+  }
+
+private:
+  uint8_t *out;
+  uint8_t columns;
+};
+
+} // namespace
+
+GlyphCache::GlyphCache() {
+  cacheHits = 0;
+  cacheMisses = 0;
+  flushes = 0;
+  clear();
+}
+
+void GlyphCache::clear() {
+  memset(slots, 0, sizeof(slots));
+  poolUsed = 0;
+  slotsUsed = 0;
+}
+
+const uint8_t *GlyphCache::find(char c, uint8_t size) {
+  uint8_t start = ((uint8_t)c * 7 + size) % SLOTS;
+  for (uint8_t i = 0; i < SLOTS; i++) {
+    Slot &slot = slots[(start + i) % SLOTS];
+    if (slot.size == 0)
+      break;
+    if (slot.c == (uint8_t)c && slot.size == size) {
+      cacheHits++;
+      return pool + slot.offset;
+    }
+  }
+
+  cacheMisses++;
+  size_t bytes = (size_t)GLYPH_COLUMNS * size * size;
+  if (bytes > CAPACITY)
+    return nullptr;
+  // Keep the table under 3/4 full so probes stay short
+  if (poolUsed + bytes > CAPACITY || slotsUsed >= SLOTS * 3 / 4) {
+    clear();
+    flushes++;
+  }
+
+  uint8_t *glyph = pool + poolUsed;
+  memset(glyph, 0, bytes);
+  GlyphRaster raster(glyph, size);
+  raster.drawChar(0, 0, c, 1, 1, size);
+
+  uint8_t at = start;
+  while (slots[at].size != 0)
+    at = (at + 1) % SLOTS;
+  slots[at].offset = poolUsed;
+  slots[at].c = c;
+  slots[at].size = size;
+  poolUsed += bytes;
+  slotsUsed++;
+  return glyph;
+}
+
+void GlyphCache::write(Adafruit_SSD1306 &display, int16_t &x, int16_t &y,
+                       char c, uint8_t size) {
+  // Cursor rules of Adafruit_GFX::write()
+  if (c == '\n') {
+    x = 0;
+    y += LINE * size;
+    return;
+  }
+  if (c == '\r')
+    return;
+  if (x + ADVANCE * size > display.width()) {
+    x = 0;
+    y += LINE * size;
+  }
+
+  const uint8_t *glyph = nullptr;
+  if (x >= 0 && y >= 0 && size <= MAX_SIZE && display.getRotation() == 0)
+    glyph = find(c, size);
+  if (glyph != nullptr) {
+    blit(display, x, y, glyph, GLYPH_COLUMNS * size, size);
+  } else {
+    display.drawChar(x, y, c, SSD1306_WHITE, SSD1306_WHITE, size);
+  }
+  x += ADVANCE * size;
+}
+
+void GlyphCache::print(Adafruit_SSD1306 &display, const char *text,
+                       uint8_t size, size_t length) {
+  int16_t x = display.getCursorX();
+  int16_t y = display.getCursorY();
+  for (size_t i = 0; i < length && text[i] != '\0'; i++)
+    write(display, x, y, text[i], size);
+  display.setCursor(x, y);
+}
+
+void GlyphCache::print(Adafruit_SSD1306 &display,
+                       const __FlashStringHelper *text, uint8_t size,
+                       size_t length) {
+  PGM_P p = (PGM_P)text;
+  int16_t x = display.getCursorX();
+  int16_t y = display.getCursorY();
+  for (size_t i = 0; i < length; i++) {
+    char c = pgm_read_byte(p + i);
+    if (c == '\0')
+      break;
+    write(display, x, y, c, size);
+  }
+  display.setCursor(x, y);
+}
+
+void GlyphCache::blit(Adafruit_SSD1306 &display, int16_t x, int16_t y,
+                      const uint8_t *pages, uint8_t width,
+                      uint8_t pageCount) {
+  uint8_t *buffer = display.getBuffer();
+  int16_t screenWidth = display.width();
+  int16_t screenPages = display.height() / LINE;
+  if (buffer == nullptr || x < 0 || y < 0 || x >= screenWidth)
+    return;
+  uint8_t columns = min((int16_t)width, (int16_t)(screenWidth - x));
+
+  // A sprite at y straddles two framebuffer pages per source page
+  uint8_t shift = y % LINE;
+  int16_t row = y / LINE;
+  for (uint8_t p = 0; p < pageCount && row < screenPages; p++, row++) {
+    const uint8_t *from = pages + p * width;
+    uint8_t *to = buffer + row * screenWidth + x;
+    for (uint8_t i = 0; i < columns; i++)
+      to[i] |= from[i] << shift;
+    if (shift != 0 && row + 1 < screenPages) {
+      to += screenWidth;
+      for (uint8_t i = 0; i < columns; i++)
+        to[i] |= from[i] >> (LINE - shift);
+    }
+  }
+}
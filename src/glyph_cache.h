@@ -0,0 +1,70 @@
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+
+// Bytes of rendered glyphs kept; 0 draws everything through GFX
+#ifndef WORKSHOP_GLYPH_CACHE
+#define WORKSHOP_GLYPH_CACHE 1024
+#endif
+
+// Text for the SSD1306 framebuffer from pre-rendered glyphs. The first
+// time a character is needed at a text size, Adafruit_GFX's drawChar()
+// rasterizes it once into SSD1306 page format - a byte per column per
+// 8-pixel page, top pixel in bit 0, exactly the framebuffer layout - so
+// every later draw is a shifted OR of bytes instead of up to 35 fillRect()
+// calls. A 5x7 glyph is 5 bytes at size 1, 20 at size 2 and 45 at size 3.
+// When the pool is full it is emptied and refilled with what is drawn
+// next; animations reuse a handful of characters per phase.
+//
+// Output matches print() with white text on a transparent background,
+// text wrap on and rotation 0, the settings the library draws with;
+// anything else (and negative coordinates) goes through GFX.
+class GlyphCache {
+public:
+  static const size_t CAPACITY = WORKSHOP_GLYPH_CACHE;
+  static const uint8_t SLOTS = 64;    // glyphs indexed at once
+  static const uint8_t MAX_SIZE = 4;  // larger text is not cached
+
+  GlyphCache();
+
+  // Draws at the display's cursor like print() and moves the cursor;
+  // at most `length` characters
+  void print(Adafruit_SSD1306 &display, const char *text, uint8_t size,
+             size_t length = SIZE_MAX);
+  void print(Adafruit_SSD1306 &display, const __FlashStringHelper *text,
+             uint8_t size, size_t length = SIZE_MAX);
+
+  // ORs a page-format sprite (`pageCount` rows of `width` bytes) into the
+  // framebuffer at any y >= 0, clipped at the right and bottom edges
+  static void blit(Adafruit_SSD1306 &display, int16_t x, int16_t y,
+                   const uint8_t *pages, uint8_t width, uint8_t pageCount);
+
+  void clear();
+  size_t used() const { return poolUsed; }
+  uint32_t hits() const { return cacheHits; }
+  uint32_t misses() const { return cacheMisses; }
+  uint32_t evictions() const { return flushes; }
+
+private:
+  struct Slot {
+    uint16_t offset;
+    uint8_t c;
+    uint8_t size; // 0 = empty
+  };
+
+  void write(Adafruit_SSD1306 &display, int16_t &x, int16_t &y, char c,
+             uint8_t size);
+  const uint8_t *find(char c, uint8_t size);
+
+  uint8_t pool[CAPACITY > 0 ? CAPACITY : 1];
+  Slot slots[SLOTS];
+  size_t poolUsed;
+  uint8_t slotsUsed;
+  uint32_t cacheHits;
+  uint32_t cacheMisses;
+  uint32_t flushes;
+};
+
+#endif
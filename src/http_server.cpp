@@ -0,0 +1,1086 @@
+#include "http_server.h"
+#include "event_trace.h"
+#include "log_buffer.h"
+#include "session_recorder.h"
+#include "workshop_strings.h"
+
+namespace {
+
+HTTPMethod parseMethod(const char *name) {
+  if (strcmp_P(name, Text::HTTP_METHOD_GET.p()) == 0)
+    return HTTP_GET;
+  if (strcmp_P(name, Text::HTTP_METHOD_POST.p()) == 0)
+    return HTTP_POST;
+  if (strcmp_P(name, Text::HTTP_METHOD_HEAD.p()) == 0)
+    return HTTP_HEAD;
+  if (strcmp_P(name, Text::HTTP_METHOD_PUT.p()) == 0)
+    return HTTP_PUT;
+  if (strcmp_P(name, Text::HTTP_METHOD_PATCH.p()) == 0)
+    return HTTP_PATCH;
+  if (strcmp_P(name, Text::HTTP_METHOD_DELETE.p()) == 0)
+    return HTTP_DELETE;
+  if (strcmp_P(name, Text::HTTP_METHOD_OPTIONS.p()) == 0)
+    return HTTP_OPTIONS;
+  return HTTP_ANY; // unknown
+}
+
+PGM_P methodName(HTTPMethod method) {
+  switch (method) {
+  case HTTP_HEAD:
+    return Text::HTTP_METHOD_HEAD.p();
+  case HTTP_POST:
+    return Text::HTTP_METHOD_POST.p();
+  case HTTP_PUT:
+    return Text::HTTP_METHOD_PUT.p();
+  case HTTP_PATCH:
+    return Text::HTTP_METHOD_PATCH.p();
+  case HTTP_DELETE:
+    return Text::HTTP_METHOD_DELETE.p();
+  case HTTP_OPTIONS:
+    return Text::HTTP_METHOD_OPTIONS.p();
+  default:
+    return Text::HTTP_METHOD_GET.p();
+  }
+}
+
+PGM_P reasonPhrase(int code) {
+  switch (code) {
+  case 200:
+    return Text::REASON_200.p();
+  case 204:
+    return Text::REASON_204.p();
+  case 304:
+    return Text::REASON_304.p();
+  case 400:
+    return Text::REASON_400.p();
+  case 404:
+    return Text::REASON_404.p();
+  case 408:
+    return Text::REASON_408.p();
+  case 413:
+    return Text::REASON_413.p();
+  case 414:
+    return Text::REASON_414.p();
+  case 429:
+    return Text::REASON_429.p();
+  case 500:
+    return Text::REASON_500.p();
+  case 503:
+    return Text::REASON_503.p();
+  default:
+    return nullptr;
+  }
+}
+
+size_t formatDecimal(char *out, uint32_t value) {
+  char digits[10];
+  size_t count = 0;
+  do {
+    digits[count++] = '0' + value % 10;
+    value /= 10;
+  } while (value != 0);
+  for (size_t i = 0; i < count; i++)
+    out[i] = digits[count - 1 - i];
+  return count;
+}
+
+// Either side may be in flash
+bool sameText(PGM_P a, PGM_P b, bool ignoreCase) {
+  for (;; a++, b++) {
+    char ca = pgm_read_byte(a);
+    char cb = pgm_read_byte(b);
+    if (ignoreCase ? tolower(ca) != tolower(cb) : ca != cb)
+      return false;
+    if (ca == 0)
+      return true;
+  }
+}
+
+int hexValue(char c) {
+  if (c >= '0' && c <= '9')
+    return c - '0';
+  if (c >= 'a' && c <= 'f')
+    return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F')
+    return c - 'A' + 10;
+  return -1;
+}
+
+size_t urlDecodeTo(const char *text, size_t length, char *out, size_t size) {
+  size_t n = 0;
+  for (size_t i = 0; i < length && n + 1 < size; i++) {
+    char c = text[i];
+    if (c == '+') {
+      c = ' ';
+    } else if (c == '%' && i + 2 < length && hexValue(text[i + 1]) >= 0 &&
+               hexValue(text[i + 2]) >= 0) {
+      c = (char)(hexValue(text[i + 1]) * 16 + hexValue(text[i + 2]));
+      i += 2;
+    }
+    out[n++] = c;
+  }
+  out[n] = 0;
+  return n;
+}
+
+String urlDecode(const char *text, size_t length) {
+  String decoded;
+  decoded.reserve(length);
+  for (size_t i = 0; i < length; i++) {
+    char c = text[i];
+    if (c == '+') {
+      decoded += ' ';
+    } else if (c == '%' && i + 2 < length && hexValue(text[i + 1]) >= 0 &&
+               hexValue(text[i + 2]) >= 0) {
+      decoded += (char)(hexValue(text[i + 1]) * 16 + hexValue(text[i + 2]));
+      i += 2;
+    } else {
+      decoded += c;
+    }
+  }
+  return decoded;
+}
+
+} // namespace
+
+HttpServer::HttpServer(uint16_t port) : listener(port) {
+  for (Connection &c : slots) {
+    c.open = false;
+    c.requestsServed = 0;
+    c.lastActivity = 0;
+    c.requestStart = 0;
+    resetRequest(c);
+  }
+  for (Parked &p : parked) {
+    p.open = false;
+    p.woken = false;
+  }
+  routeCount = 0;
+  collectedCount = 0;
+  requestArena = nullptr;
+  rateLimiter = nullptr;
+  eventBus = nullptr;
+
+  current = nullptr;
+  responseCode = 0;
+  contentLength = CONTENT_LENGTH_NOT_SET;
+  chunked = false;
+  chunkedDone = false;
+  closeAfterResponse = false;
+  parking = nullptr;
+  responseBytes = 0;
+  extraLength = 0;
+  txLength = 0;
+
+  served = 0;
+  accepted = 0;
+
+#ifdef WORKSHOP_NATIVE
+  simulated.open = false;
+  resetRequest(simulated);
+#endif
+}
+
+void HttpServer::begin() {
+  listener.begin();
+  listener.setNoDelay(true);
+}
+
+void HttpServer::close() {
+  for (Connection &c : slots) {
+    if (c.open)
+      drop(c);
+  }
+  for (Parked &p : parked) {
+    if (p.open) {
+      announce(p.client, MAX_CLIENTS, false);
+      p.client.stop();
+    }
+    p.open = false;
+  }
+  listener.close();
+}
+
+void HttpServer::on(const String &uri, THandlerFunction handler) {
+  on(uri, HTTP_ANY, handler);
+}
+
+void HttpServer::on(const String &uri, HTTPMethod method,
+                    THandlerFunction handler) {
+  if (routeCount == MAX_ROUTES) {
+    LOG_WARN(Text::HTTP_ROUTES_FULL, uri);
+    return;
+  }
+  Route &route = routes[routeCount++];
+  route.uri = uri;
+  route.method = method;
+  route.handler = handler;
+}
+
+void HttpServer::onNotFound(THandlerFunction handler) {
+  notFoundHandler = handler;
+}
+
+void HttpServer::collectHeaders(const char *headerKeys[], size_t count) {
+  collectedCount = 0;
+  for (size_t i = 0; i < count && i < MAX_COLLECTED_HEADERS; i++)
+    collected[collectedCount++] = headerKeys[i];
+}
+
+uint8_t HttpServer::openConnections() const {
+  uint8_t count = 0;
+  for (const Connection &c : slots) {
+    if (c.open)
+      count++;
+  }
+  return count;
+}
+
+uint8_t HttpServer::parkedRequests() const {
+  uint8_t count = 0;
+  for (const Parked &p : parked) {
+    if (p.open)
+      count++;
+  }
+  return count;
+}
+
+// --- Connections ---
+
+void HttpServer::handleClient() {
+  acceptClients();
+  for (Connection &c : slots) {
+    if (c.open)
+      service(c);
+  }
+  serviceParked();
+}
+
+void HttpServer::acceptClients() {
+  while (listener.hasClient()) {
+    Connection *slot = freeSlot();
+    if (slot == nullptr)
+      return; // stays in the backlog until a slot frees up
+
+    slot->client = listener.accept();
+    if (!slot->client)
+      return;
+    slot->client.setNoDelay(true);
+    slot->open = true;
+    slot->requestsServed = 0;
+    slot->lastActivity = millis();
+    resetRequest(*slot);
+    accepted++;
+    announce(slot->client, slotIndex(*slot), true);
+  }
+}
+
+HttpServer::Connection *HttpServer::freeSlot() {
+  Connection *oldestIdle = nullptr;
+  for (Connection &c : slots) {
+    if (!c.open)
+      return &c;
+    bool idle = c.state == REQUEST_LINE && c.lineLength == 0 &&
+                c.client.available() == 0;
+    if (idle && (oldestIdle == nullptr ||
+                 (long)(c.lastActivity - oldestIdle->lastActivity) < 0))
+      oldestIdle = &c;
+  }
+
+  // A waiting keep-alive connection gives way to a new client
+  if (oldestIdle != nullptr)
+    drop(*oldestIdle);
+  return oldestIdle;
+}
+
+void HttpServer::service(Connection &c) {
+  uint8_t chunk[READ_CHUNK];
+  size_t budget = READ_BUDGET;
+
+  // Only what has already arrived; the rest is picked up on a later call
+  while (c.open && budget > 0) {
+    int available = c.client.available();
+    if (available <= 0)
+      break;
+    size_t want = (size_t)available < sizeof(chunk) ? available : sizeof(chunk);
+    if (want > budget)
+      want = budget;
+    int n = c.client.read(chunk, want);
+    if (n <= 0)
+      break;
+    budget -= n;
+    c.lastActivity = millis();
+    feed(c, chunk, n);
+  }
+  if (!c.open)
+    return;
+
+  if (!c.client.connected()) {
+    drop(c);
+    return;
+  }
+
+  unsigned long now = millis();
+  bool idle = c.state == REQUEST_LINE && c.lineLength == 0;
+  if (idle && now - c.lastActivity >= WORKSHOP_HTTP_IDLE_TIMEOUT_MS)
+    drop(c);
+  else if (!idle && now - c.requestStart >= WORKSHOP_HTTP_REQUEST_TIMEOUT_MS)
+    reject(c, 408);
+}
+
+void HttpServer::drop(Connection &c) {
+  uint8_t slot = slotIndex(c);
+  if (slot < MAX_CLIENTS)
+    announce(c.client, slot, false);
+  c.client.stop();
+  c.open = false;
+  resetRequest(c);
+}
+
+void HttpServer::announce(WiFiClient &client, uint8_t slot, bool connected) {
+  if (eventBus != nullptr)
+    eventBus->publish(
+        ClientEvent{slot, connected, (uint32_t)client.remoteIP()});
+}
+
+void HttpServer::resetRequest(Connection &c) {
+  c.state = REQUEST_LINE;
+  c.method = HTTP_GET;
+  c.http10 = false;
+  c.keepAlive = true;
+  c.formBody = false;
+  c.lineOverflow = false;
+  c.lineLength = 0;
+  c.pathLength = 0;
+  c.queryLength = 0;
+  c.headerLength = 0;
+  c.bodyExpected = 0;
+  c.bodyLength = 0;
+  c.target[0] = 0;
+  c.target[1] = 0;
+  c.body[0] = 0;
+}
+
+// --- Incremental parser ---
+
+void HttpServer::feed(Connection &c, const uint8_t *data, size_t length) {
+  size_t i = 0;
+  while (i < length && c.open) {
+    if (c.state == BODY) {
+      size_t take = c.bodyExpected - c.bodyLength;
+      if (take > length - i)
+        take = length - i;
+      memcpy(c.body + c.bodyLength, data + i, take);
+      c.bodyLength += take;
+      i += take;
+      if (c.bodyLength == c.bodyExpected)
+        finishRequest(c);
+      continue;
+    }
+
+    char ch = data[i++];
+    if (ch == '\n') {
+      endLine(c);
+    } else if (ch != '\r') {
+      if (c.state == REQUEST_LINE && c.lineLength == 0)
+        c.requestStart = millis();
+      if (c.lineLength < LINE_SIZE - 1)
+        c.line[c.lineLength++] = ch;
+      else
+        c.lineOverflow = true;
+    }
+  }
+}
+
+void HttpServer::endLine(Connection &c) {
+  c.line[c.lineLength] = 0;
+  size_t length = c.lineLength;
+  bool overflow = c.lineOverflow;
+  c.lineLength = 0;
+  c.lineOverflow = false;
+
+  if (c.state == REQUEST_LINE) {
+    if (length == 0)
+      return; // blank line between pipelined requests
+    if (overflow)
+      reject(c, 414);
+    else if (!parseRequestLine(c))
+      reject(c, 400);
+    else
+      c.state = HEADERS;
+    return;
+  }
+
+  if (length > 0) {
+    parseHeader(c); // an overlong value is cut, the name is intact
+    return;
+  }
+
+  // Blank line: end of headers
+  if (c.bodyExpected > BODY_SIZE)
+    reject(c, 413);
+  else if (c.bodyExpected > 0)
+    c.state = BODY;
+  else
+    finishRequest(c);
+}
+
+bool HttpServer::parseRequestLine(Connection &c) {
+  char *space1 = strchr(c.line, ' ');
+  if (space1 == nullptr)
+    return false;
+  *space1 = 0;
+  char *target = space1 + 1;
+  char *space2 = strchr(target, ' ');
+  if (space2 == nullptr || space2 == target)
+    return false;
+  *space2 = 0;
+
+  const char *version = space2 + 1;
+  size_t prefix = Text::HTTP_VERSION_1.length();
+  if (strncmp_P(version, Text::HTTP_VERSION_1.p(), prefix) != 0)
+    return false;
+  c.http10 = version[prefix] == '0';
+  c.keepAlive = !c.http10;
+
+  c.method = parseMethod(c.line);
+  if (c.method == HTTP_ANY)
+    return false;
+
+  // The line buffer is reused for headers, so keep the target separately
+  size_t length = space2 - target;
+  memcpy(c.target, target, length);
+  c.target[length] = 0;
+  c.target[length + 1] = 0;
+  char *query = (char *)memchr(c.target, '?', length);
+  if (query != nullptr) {
+    *query = 0;
+    c.pathLength = query - c.target;
+    c.queryLength = length - c.pathLength - 1;
+  } else {
+    c.pathLength = length;
+    c.queryLength = 0;
+  }
+  return true;
+}
+
+void HttpServer::parseHeader(Connection &c) {
+  char *colon = strchr(c.line, ':');
+  if (colon == nullptr)
+    return;
+  *colon = 0;
+  char *value = colon + 1;
+  while (*value == ' ' || *value == '\t')
+    value++;
+  size_t valueLength = strlen(value);
+  while (valueLength > 0 && value[valueLength - 1] == ' ')
+    value[--valueLength] = 0;
+
+  const char *name = c.line;
+  if (strcasecmp_P(name, Text::HTTP_CONTENT_LENGTH.p()) == 0) {
+    c.bodyExpected = strtoul(value, nullptr, 10);
+  } else if (strcasecmp_P(name, Text::HTTP_CONNECTION.p()) == 0) {
+    if (strcasecmp_P(value, Text::HTTP_CLOSE.p()) == 0)
+      c.keepAlive = false;
+    else if (strcasecmp_P(value, Text::HTTP_KEEP_ALIVE.p()) == 0)
+      c.keepAlive = true;
+  } else if (strcasecmp_P(name, Text::HTTP_CONTENT_TYPE.p()) == 0) {
+    c.formBody = strncasecmp_P(value, Text::MIME_FORM.p(),
+                               Text::MIME_FORM.length()) == 0;
+  }
+
+  for (uint8_t i = 0; i < collectedCount; i++) {
+    if (!sameText(name, collected[i], true))
+      continue;
+    if (c.headerLength + valueLength + 2 > HEADER_SIZE)
+      return; // no room; header() reports it missing
+    char *entry = c.headers + c.headerLength;
+    entry[0] = (char)i;
+    memcpy(entry + 1, value, valueLength + 1);
+    c.headerLength += valueLength + 2;
+    return;
+  }
+}
+
+void HttpServer::finishRequest(Connection &c) {
+  c.body[c.bodyLength] = 0;
+
+  TRACE(HTTP_REQUEST, FPSTR(methodName(c.method)), c.target,
+        slotIndex(c));
+  RECORD_HTTP((uint32_t)c.client.remoteIP(), c.method, c.formBody, c.target,
+              c.queryLength > 0 ? c.target + c.pathLength + 1 : nullptr,
+              c.body, c.bodyLength);
+  beginResponse(c);
+  dispatch();
+
+  if (parking != nullptr) {
+    // The client waits in the park table; the slot is free again
+    Parked &p = *parking;
+    parking = nullptr;
+    TRACE(HTTP_PARKED, p.tag);
+    p.client = c.client;
+    p.http10 = c.http10;
+    p.keepAlive = c.keepAlive;
+    p.method = c.method;
+    current = nullptr;
+    if (requestArena != nullptr)
+      requestArena->reset();
+    c.client = WiFiClient();
+    c.open = false;
+    resetRequest(c);
+    return;
+  }
+  endResponse(c);
+}
+
+void HttpServer::beginResponse(Connection &c) {
+  current = &c;
+  responseCode = 0;
+  contentLength = CONTENT_LENGTH_NOT_SET;
+  chunked = false;
+  chunkedDone = false;
+  closeAfterResponse = !c.keepAlive;
+  parking = nullptr;
+  responseBytes = 0;
+  extraLength = 0;
+  txLength = 0;
+}
+
+void HttpServer::endResponse(Connection &c) {
+  if (chunked && !chunkedDone)
+    txAppend(Text::HTTP_LAST_CHUNK.p(), Text::HTTP_LAST_CHUNK.length());
+  txFlush();
+  TRACE(HTTP_RESPONSE, responseCode, responseBytes);
+
+  // A handler that sent nothing gets the connection closed, as with the
+  // core server
+  bool keep = !closeAfterResponse && responseCode != 0;
+  current = nullptr;
+  served++;
+  c.requestsServed++;
+  if (requestArena != nullptr)
+    requestArena->reset();
+
+  resetRequest(c);
+  if (!keep)
+    drop(c);
+}
+
+uint8_t HttpServer::slotIndex(const Connection &c) const {
+  for (uint8_t i = 0; i < MAX_CLIENTS; i++) {
+    if (&slots[i] == &c)
+      return i;
+  }
+  return MAX_CLIENTS; // simulated request
+}
+
+bool HttpServer::park(uint32_t tag, unsigned long timeoutMs) {
+  if (current == nullptr || responseCode != 0)
+    return false;
+#ifdef WORKSHOP_NATIVE
+  if (current == &simulated)
+    return false; // no socket to hold open
+#endif
+  for (Parked &p : parked) {
+    if (p.open)
+      continue;
+    p.open = true;
+    p.woken = false;
+    p.tag = tag;
+    p.deadline = millis() + timeoutMs;
+    parking = &p;
+    return true;
+  }
+  return false;
+}
+
+void HttpServer::wakeParked() {
+  for (Parked &p : parked)
+    p.woken = p.open;
+}
+
+void HttpServer::serviceParked() {
+  unsigned long now = millis();
+  for (Parked &p : parked) {
+    if (!p.open)
+      continue;
+    if (!p.client.connected()) {
+      announce(p.client, MAX_CLIENTS, false);
+      p.client.stop();
+      p.open = false;
+      continue;
+    }
+    bool timedOut = (long)(now - p.deadline) >= 0;
+    if (p.woken || timedOut)
+      resume(p, timedOut);
+  }
+}
+
+void HttpServer::resume(Parked &p, bool timedOut) {
+  Connection *slot = freeSlot();
+  if (slot == nullptr)
+    return; // every slot is mid-request; retried on the next call
+
+  Connection &c = *slot;
+  c.client = p.client;
+  c.open = true;
+  c.requestsServed = 0;
+  c.lastActivity = millis();
+  resetRequest(c);
+  c.http10 = p.http10;
+  c.keepAlive = p.keepAlive;
+  c.method = p.method;
+  p.client = WiFiClient();
+  p.open = false;
+
+  TRACE(HTTP_RESUMED, p.tag, timedOut);
+  beginResponse(c);
+  if (resumeHandler)
+    resumeHandler(p.tag, timedOut);
+  endResponse(c);
+}
+
+void HttpServer::reject(Connection &c, int code) {
+  current = &c;
+  contentLength = CONTENT_LENGTH_NOT_SET;
+  chunked = false;
+  closeAfterResponse = true;
+  responseBytes = 0;
+  extraLength = 0;
+  txLength = 0;
+  writeHeaders(code, nullptr, 0);
+  txFlush();
+  current = nullptr;
+  TRACE(HTTP_REJECTED, code, slotIndex(c));
+  drop(c);
+}
+
+void HttpServer::dispatch() {
+  const Connection &c = *current;
+  if (!admit())
+    return;
+  for (uint8_t i = 0; i < routeCount; i++) {
+    Route &route = routes[i];
+    if ((route.method == HTTP_ANY || route.method == c.method) &&
+        strcmp(route.uri.c_str(), c.target) == 0) {
+      route.handler();
+      return;
+    }
+  }
+  if (notFoundHandler)
+    notFoundHandler();
+  else
+    send_P(404, Text::MIME_PLAIN.p(), Text::HTTP_NOT_FOUND.p());
+}
+
+bool HttpServer::admit() {
+  if (rateLimiter == nullptr)
+    return true;
+  Connection &c = *current;
+  uint32_t ip = c.client.remoteIP();
+  if (ip == 0)
+    return true; // no peer address (simulated request)
+
+  bool read = c.method == HTTP_GET || c.method == HTTP_HEAD ||
+              c.method == HTTP_OPTIONS;
+  unsigned long retryMs = 0;
+  if (rateLimiter->admit(ip, read ? RATE_READ : RATE_WRITE, millis(),
+                         &retryMs))
+    return true;
+
+  char seconds[12];
+  seconds[formatDecimal(seconds, (retryMs + 999) / 1000)] = 0;
+  sendHeader_P(Text::HTTP_RETRY_AFTER.p(), seconds);
+  send_P(429, Text::MIME_JSON.p(), Text::JSON_ERROR_RATE_LIMITED.p());
+  return false;
+}
+
+// --- Request accessors ---
+
+const char *HttpServer::path() const {
+  return current != nullptr ? current->target : "";
+}
+
+HTTPMethod HttpServer::method() const {
+  return current != nullptr ? current->method : HTTP_GET;
+}
+
+WiFiClient &HttpServer::client() {
+  static WiFiClient none;
+  return current != nullptr ? current->client : none;
+}
+
+const char *HttpServer::body() const {
+  return current != nullptr ? current->body : "";
+}
+
+size_t HttpServer::bodyLength() const {
+  return current != nullptr ? current->bodyLength : 0;
+}
+
+// Looks up an argument by name, or by position when `name` is null. Query
+// arguments come first, then form fields, then the raw body as "plain".
+// Values are returned undecoded; a null key marks the raw body.
+bool HttpServer::findArg(int index, const char *name, const char **value,
+                         size_t *valueLength, const char **key,
+                         size_t *keyLength) const {
+  if (current == nullptr)
+    return false;
+  const Connection &c = *current;
+  const char *sources[2] = {c.target + c.pathLength + 1, c.body};
+  size_t lengths[2] = {c.queryLength, c.formBody ? c.bodyLength : 0};
+  size_t nameLength = name != nullptr ? strlen_P(name) : 0;
+
+  int position = 0;
+  for (int s = 0; s < 2; s++) {
+    const char *p = sources[s];
+    const char *end = p + lengths[s];
+    while (p < end) {
+      const char *amp = (const char *)memchr(p, '&', end - p);
+      if (amp == nullptr)
+        amp = end;
+      const char *eq = (const char *)memchr(p, '=', amp - p);
+      size_t length = (eq != nullptr ? eq : amp) - p;
+      if (length > 0) {
+        bool match = name != nullptr ? length == nameLength &&
+                                           memcmp_P(p, name, length) == 0
+                                     : position == index;
+        if (match) {
+          *value = eq != nullptr ? eq + 1 : amp;
+          *valueLength = amp - *value;
+          if (key != nullptr) {
+            *key = p;
+            *keyLength = length;
+          }
+          return true;
+        }
+        position++;
+      }
+      p = amp + 1;
+    }
+  }
+
+  if (c.bodyLength == 0)
+    return false;
+  bool match = name != nullptr ? sameText(name, Text::ARG_PLAIN.p(), false)
+                               : position == index;
+  if (!match)
+    return false;
+  *value = c.body;
+  *valueLength = c.bodyLength;
+  if (key != nullptr) {
+    *key = nullptr;
+    *keyLength = 0;
+  }
+  return true;
+}
+
+String HttpServer::arg(const String &name) const {
+  const char *value, *key;
+  size_t length, keyLength;
+  if (!findArg(0, name.c_str(), &value, &length, &key, &keyLength))
+    return String();
+  return key != nullptr ? urlDecode(value, length) : String(value);
+}
+
+String HttpServer::arg(int index) const {
+  const char *value, *key;
+  size_t length, keyLength;
+  if (!findArg(index, nullptr, &value, &length, &key, &keyLength))
+    return String();
+  return key != nullptr ? urlDecode(value, length) : String(value);
+}
+
+String HttpServer::argName(int index) const {
+  const char *value, *key;
+  size_t length, keyLength;
+  if (!findArg(index, nullptr, &value, &length, &key, &keyLength))
+    return String();
+  if (key == nullptr)
+    return String(Text::ARG_PLAIN);
+  return urlDecode(key, keyLength);
+}
+
+int HttpServer::copyArg(PGM_P name, char *buffer, size_t size) const {
+  const char *value, *key;
+  size_t length, keyLength;
+  if (size == 0 || !findArg(0, name, &value, &length, &key, &keyLength))
+    return -1;
+  if (key == nullptr) {
+    length = length < size - 1 ? length : size - 1;
+    memcpy(buffer, value, length);
+    buffer[length] = 0;
+    return length;
+  }
+  return urlDecodeTo(value, length, buffer, size);
+}
+
+int HttpServer::args() const {
+  const char *value;
+  size_t length;
+  int count = 0;
+  while (findArg(count, nullptr, &value, &length))
+    count++;
+  return count;
+}
+
+bool HttpServer::hasArg(const String &name) const {
+  const char *value;
+  size_t length;
+  return findArg(0, name.c_str(), &value, &length);
+}
+
+const char *HttpServer::findHeader(PGM_P name) const {
+  if (current == nullptr)
+    return nullptr;
+  const Connection &c = *current;
+  for (uint8_t i = 0; i < collectedCount; i++) {
+    if (!sameText(name, collected[i], true))
+      continue;
+    size_t offset = 0;
+    while (offset < c.headerLength) {
+      const char *value = c.headers + offset + 1;
+      if ((uint8_t)c.headers[offset] == i)
+        return value;
+      offset += strlen(value) + 2;
+    }
+  }
+  return nullptr;
+}
+
+String HttpServer::header(const String &name) const {
+  const char *value = findHeader(name.c_str());
+  return value != nullptr ? String(value) : String();
+}
+
+bool HttpServer::hasHeader(const String &name) const {
+  return findHeader(name.c_str()) != nullptr;
+}
+
+// --- Response ---
+
+void HttpServer::txAppend(PGM_P data, size_t length) {
+  while (length > 0) {
+    if (txLength == TX_SIZE)
+      txFlush();
+    size_t take = TX_SIZE - txLength;
+    if (take > length)
+      take = length;
+    memcpy_P(tx + txLength, data, take);
+    txLength += take;
+    data += take;
+    length -= take;
+  }
+}
+
+void HttpServer::txFlush() {
+  if (txLength == 0 || current == nullptr)
+    return;
+  current->client.write((const uint8_t *)tx, txLength);
+  current->lastActivity = millis();
+  responseBytes += txLength;
+  txLength = 0;
+}
+
+void HttpServer::txHeader(PGM_P name, PGM_P value, size_t valueLength) {
+  txAppend(name, strlen_P(name));
+  txAppend(Text::HTTP_HEADER_SEPARATOR.p(), 2);
+  txAppend(value, valueLength);
+  txAppend(Text::HTTP_CRLF.p(), 2);
+}
+
+void HttpServer::writeHeaders(int code, PGM_P contentType, size_t length) {
+  if (contentLength != CONTENT_LENGTH_NOT_SET)
+    length = contentLength;
+  responseCode = code;
+
+  char number[16];
+  int n = snprintf_P(number, sizeof(number), Text::FMT_HTTP_STATUS.p(),
+                     current->http10 ? 0 : 1, code);
+  txAppend(number, n);
+  PGM_P reason = reasonPhrase(code);
+  if (reason != nullptr)
+    txAppend(reason, strlen_P(reason));
+  txAppend(Text::HTTP_CRLF.p(), 2);
+
+  if (contentType != nullptr)
+    txHeader(Text::HTTP_CONTENT_TYPE.p(), contentType, strlen_P(contentType));
+  if (length == CONTENT_LENGTH_UNKNOWN) {
+    // HTTP/1.0 has no chunked encoding; the end of the body is the close
+    if (current->http10) {
+      closeAfterResponse = true;
+    } else {
+      chunked = true;
+      txHeader(Text::HTTP_TRANSFER_ENCODING.p(), Text::HTTP_CHUNKED.p(),
+               Text::HTTP_CHUNKED.length());
+    }
+  } else if (code != 204 && code != 304) {
+    n = formatDecimal(number, length);
+    txHeader(Text::HTTP_CONTENT_LENGTH.p(), number, n);
+  }
+  txAppend(extraHeaders, extraLength);
+  FlashString connection =
+      closeAfterResponse ? Text::HTTP_CLOSE : Text::HTTP_KEEP_ALIVE;
+  txHeader(Text::HTTP_CONNECTION.p(), connection.p(), connection.length());
+  txAppend(Text::HTTP_CRLF.p(), 2);
+}
+
+void HttpServer::writeBody(PGM_P content, size_t length) {
+#ifdef WORKSHOP_NATIVE
+  if (current == &simulated)
+    captureBody.append(content, length);
+#endif
+  // Small bodies share a segment with the headers; large ones go out
+  // directly instead of through the buffer
+  if (length < TX_SIZE) {
+    txAppend(content, length);
+    return;
+  }
+  txFlush();
+  current->client.write_P(content, length);
+  current->lastActivity = millis();
+  responseBytes += length;
+}
+
+void HttpServer::send(int code, const char *contentType,
+                      const String &content) {
+  send(code, contentType, content.c_str(), content.length());
+}
+
+void HttpServer::send(int code, const String &contentType,
+                      const String &content) {
+  send(code, contentType.c_str(), content.c_str(), content.length());
+}
+
+void HttpServer::send(int code, const char *contentType, const char *content) {
+  send(code, contentType, content, content != nullptr ? strlen(content) : 0);
+}
+
+void HttpServer::send(int code, const char *contentType, const char *content,
+                      size_t length) {
+  if (current == nullptr)
+    return;
+  writeHeaders(code, contentType, length);
+  if (length == 0 || current->method == HTTP_HEAD)
+    return;
+  if (chunked)
+    sendContent(content, length);
+  else
+    writeBody(content, length);
+}
+
+void HttpServer::send_P(int code, PGM_P contentType, PGM_P content) {
+  send(code, contentType, content, strlen_P(content));
+}
+
+void HttpServer::send_P(int code, PGM_P contentType, PGM_P content,
+                        size_t length) {
+  send(code, contentType, content, length);
+}
+
+void HttpServer::sendHeader(const String &name, const String &value,
+                            bool first) {
+  appendHeader(name.c_str(), name.length(), value.c_str(), value.length(),
+               first);
+}
+
+void HttpServer::sendHeader_P(PGM_P name, const char *value, bool first) {
+  appendHeader(name, strlen_P(name), value, strlen_P(value), first);
+}
+
+void HttpServer::appendHeader(PGM_P name, size_t nameLength, PGM_P value,
+                              size_t valueLength, bool first) {
+  size_t lineLength = nameLength + valueLength + 4;
+  if (extraLength + lineLength > EXTRA_HEADER_SIZE)
+    return;
+
+  char *out = extraHeaders + extraLength;
+  if (first) {
+    memmove(extraHeaders + lineLength, extraHeaders, extraLength);
+    out = extraHeaders;
+  }
+  memcpy_P(out, name, nameLength);
+  out += nameLength;
+  memcpy_P(out, Text::HTTP_HEADER_SEPARATOR.p(), 2);
+  out += 2;
+  memcpy_P(out, value, valueLength);
+  out += valueLength;
+  memcpy_P(out, Text::HTTP_CRLF.p(), 2);
+  extraLength += lineLength;
+}
+
+void HttpServer::sendContent(const String &content) {
+  sendContent(content.c_str(), content.length());
+}
+
+void HttpServer::sendContent(const char *content, size_t length) {
+  if (current == nullptr || current->method == HTTP_HEAD)
+    return;
+  if (!chunked) {
+    writeBody(content, length);
+    return;
+  }
+  if (chunkedDone)
+    return;
+  if (length == 0) {
+    txAppend(Text::HTTP_LAST_CHUNK.p(), Text::HTTP_LAST_CHUNK.length());
+    chunkedDone = true;
+    return;
+  }
+  char size[12];
+  int n = snprintf_P(size, sizeof(size), Text::FMT_HTTP_CHUNK.p(),
+                     (unsigned)length);
+  txAppend(size, n);
+  writeBody(content, length);
+  txAppend(Text::HTTP_CRLF.p(), 2);
+}
+
+void HttpServer::sendContent_P(PGM_P content) {
+  sendContent(content, strlen_P(content));
+}
+
+void HttpServer::sendContent_P(PGM_P content, size_t length) {
+  sendContent(content, length);
+}
+
+#ifdef WORKSHOP_NATIVE
+const std::string &HttpServer::simulateRequest(HTTPMethod method,
+                                               const char *uri,
+                                               const char *body, int *code,
+                                               size_t *bytes) {
+  size_t bodyLength = body != nullptr ? strlen(body) : 0;
+
+  char head[LINE_SIZE + 256];
+  int n = snprintf(head, sizeof(head), PSTR("%s %s HTTP/1.1\r\n%s"),
+                   methodName(method), uri, simulatedHeaders.c_str());
+  if (bodyLength > 0)
+    n += snprintf(head + n, sizeof(head) - n,
+                  PSTR("Content-Length: %zu\r\n"), bodyLength);
+  n += snprintf(head + n, sizeof(head) - n, PSTR("\r\n"));
+
+  captureBody.clear();
+  responseCode = 0;
+  responseBytes = 0;
+  Connection &c = simulated;
+  resetRequest(c);
+  c.open = true;
+  feed(c, (const uint8_t *)head, n);
+  if (c.open && bodyLength > 0)
+    feed(c, (const uint8_t *)body, bodyLength);
+  c.open = false;
+  simulatedHeaders.clear();
+
+  if (code != nullptr)
+    *code = responseCode;
+  if (bytes != nullptr)
+    *bytes = responseBytes;
+  return captureBody;
+}
+
+void HttpServer::simulateHeader(const char *name, const char *value) {
+  simulatedHeaders.append(name);
+  simulatedHeaders.append(PSTR(": "));
+  simulatedHeaders.append(value);
+  simulatedHeaders.append(PSTR("\r\n"));
+}
+#endif
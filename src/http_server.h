@@ -0,0 +1,276 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <Arduino.h>
+#include <ESP8266WebServer.h> // HTTPMethod, CONTENT_LENGTH_UNKNOWN
+#include <ESP8266WiFi.h>
+#include <functional>
+#ifdef WORKSHOP_NATIVE
+#include <string>
+#endif
+
+#include "event_bus.h"
+#include "rate_limiter.h"
+#include "request_arena.h"
+
+// Connection slots; lwIP has 5 TCP PCBs by default. Override with
+// -DWORKSHOP_HTTP_CLIENTS=...
+#ifndef WORKSHOP_HTTP_CLIENTS
+#define WORKSHOP_HTTP_CLIENTS 4
+#endif
+
+#ifndef WORKSHOP_HTTP_ROUTES
+#define WORKSHOP_HTTP_ROUTES 16
+#endif
+
+// Keep-alive connections with no request in progress close after this
+#ifndef WORKSHOP_HTTP_IDLE_TIMEOUT_MS
+#define WORKSHOP_HTTP_IDLE_TIMEOUT_MS 5000
+#endif
+
+// A started request must be complete within this (slow senders get 408)
+#ifndef WORKSHOP_HTTP_REQUEST_TIMEOUT_MS
+#define WORKSHOP_HTTP_REQUEST_TIMEOUT_MS 2000
+#endif
+
+// Requests parked by park() (long polls); each costs a client handle and
+// a few words, not a connection slot
+#ifndef WORKSHOP_HTTP_PARKED
+#define WORKSHOP_HTTP_PARKED 8
+#endif
+
+// Event-driven stand-in for ESP8266WebServer with the same route and
+// response API. Every handleClient() accepts new connections and feeds the
+// bytes that have arrived on each open one through an incremental parser,
+// so a slow sender never blocks the loop and several clients are served
+// per call. Connections stay open (HTTP/1.1 keep-alive, HTTP/1.0 when
+// asked) and pipelined requests are answered in order. Parse buffers are
+// fixed per connection; only the header names passed to collectHeaders()
+// and the request target, form arguments and a short body are kept.
+class HttpServer {
+public:
+  typedef std::function<void(void)> THandlerFunction;
+  // Answers a parked request; gets the tag given to park()
+  typedef std::function<void(uint32_t tag, bool timedOut)> TResumeFunction;
+
+  static const uint8_t MAX_CLIENTS = WORKSHOP_HTTP_CLIENTS;
+  static const uint8_t MAX_ROUTES = WORKSHOP_HTTP_ROUTES;
+  static const uint8_t MAX_PARKED = WORKSHOP_HTTP_PARKED;
+  static const uint8_t MAX_COLLECTED_HEADERS = 4;
+  static const size_t LINE_SIZE = 128;  // request line, one header line
+  static const size_t HEADER_SIZE = 96; // collected header values
+  static const size_t BODY_SIZE = 256;
+
+  explicit HttpServer(uint16_t port = 80);
+
+  void begin();
+  void close();
+  void stop() { close(); }
+  void handleClient();
+
+  void on(const String &uri, THandlerFunction handler);
+  void on(const String &uri, HTTPMethod method, THandlerFunction handler);
+  void onNotFound(THandlerFunction handler);
+
+  // Headers to keep for header()/hasHeader(); the array is copied, the
+  // names (RAM or flash) must stay valid
+  void collectHeaders(const char *headerKeys[], size_t count);
+
+  // Long polls. Inside a handler, park() holds the current request open
+  // without a response and frees its connection slot; false when the park
+  // table is full. After wakeParked(), or once `timeoutMs` has passed, the
+  // client gets a slot back and the onResume() handler answers it with
+  // the usual send() calls. Bytes pipelined behind a parked request in the
+  // same read are dropped.
+  bool park(uint32_t tag, unsigned long timeoutMs);
+  void wakeParked();
+  void onResume(TResumeFunction handler) { resumeHandler = handler; }
+  uint8_t parkedRequests() const;
+
+  // Arena reset after every request, so handlers answering several
+  // pipelined requests in one handleClient() each get the full arena
+  void attachArena(RequestArena &arena) { requestArena = &arena; }
+
+  // Requests over the client's budget get a 429 without running the
+  // handler; reads and writes are budgeted separately
+  void attachLimiter(RateLimiter &limiter) { rateLimiter = &limiter; }
+
+  // Publishes a ClientEvent when a client is accepted and when its
+  // connection closes; slot MAX_CLIENTS is a parked request
+  void attachBus(EventBus &bus) { eventBus = &bus; }
+
+  // Current request; valid inside a handler
+  const char *path() const;
+  String uri() const { return String(path()); }
+  HTTPMethod method() const;
+  WiFiClient &client();
+  const char *body() const;
+  size_t bodyLength() const;
+
+  String arg(const String &name) const;
+  String arg(int index) const;
+  String argName(int index) const;
+  int args() const;
+  bool hasArg(const String &name) const;
+  // Decoded value into `buffer` (cut to fit) without a String copy;
+  // returns its length, or -1 if absent. `name` may be in flash.
+  int copyArg(PGM_P name, char *buffer, size_t size) const;
+  String header(const String &name) const;
+  bool hasHeader(const String &name) const;
+  // Collected header value without a String copy; null if absent. `name`
+  // may be in flash.
+  const char *findHeader(PGM_P name) const;
+
+  // Response. Content and content type may be in flash or RAM.
+  void send(int code, const char *contentType = nullptr,
+            const String &content = String());
+  void send(int code, const String &contentType, const String &content);
+  void send(int code, const char *contentType, const char *content);
+  void send(int code, const char *contentType, const char *content,
+            size_t length);
+  void send_P(int code, PGM_P contentType, PGM_P content);
+  void send_P(int code, PGM_P contentType, PGM_P content, size_t length);
+  void setContentLength(size_t length) { contentLength = length; }
+  void sendHeader(const String &name, const String &value,
+                  bool first = false);
+  void sendHeader_P(PGM_P name, const char *value, bool first = false);
+  void sendContent(const String &content);
+  void sendContent(const char *content, size_t length);
+  void sendContent_P(PGM_P content);
+  void sendContent_P(PGM_P content, size_t length);
+
+  uint32_t requests() const { return served; }
+  uint32_t connections() const { return accepted; }
+  uint8_t openConnections() const;
+
+#ifdef WORKSHOP_NATIVE
+  // Host-only: run a request through the parser and routing table without
+  // a socket. Returns the response body; status code and raw response size
+  // are reported through the optional pointers.
+  const std::string &simulateRequest(HTTPMethod method, const char *uri,
+                                     const char *body = nullptr,
+                                     int *code = nullptr,
+                                     size_t *responseBytes = nullptr);
+  // Host-only: add a request header for the next simulateRequest()
+  void simulateHeader(const char *name, const char *value);
+#endif
+
+private:
+  enum ParseState : uint8_t { REQUEST_LINE, HEADERS, BODY };
+
+  struct Connection {
+    WiFiClient client;
+    bool open;
+    ParseState state;
+    HTTPMethod method;
+    bool http10;
+    bool keepAlive;
+    bool formBody;
+    bool lineOverflow;
+    uint16_t lineLength;
+    uint16_t pathLength; // target = path '\0' query '\0'
+    uint16_t queryLength;
+    uint16_t headerLength;
+    uint32_t bodyExpected;
+    uint32_t bodyLength;
+    uint32_t requestsServed;
+    unsigned long lastActivity; // ms, last byte received or sent
+    unsigned long requestStart; // ms, first byte of the current request
+    char line[LINE_SIZE];
+    char target[LINE_SIZE];
+    char headers[HEADER_SIZE]; // [key index][value]\0 ...
+    char body[BODY_SIZE + 1];
+  };
+
+  struct Parked {
+    WiFiClient client;
+    bool open;
+    bool woken;
+    bool http10;
+    bool keepAlive;
+    HTTPMethod method;
+    uint32_t tag;
+    unsigned long deadline; // ms
+  };
+
+  struct Route {
+    String uri;
+    HTTPMethod method;
+    THandlerFunction handler;
+  };
+
+  static const size_t TX_SIZE = 256;
+  static const size_t EXTRA_HEADER_SIZE = 128;
+  static const size_t READ_CHUNK = 128;
+  static const size_t READ_BUDGET = 1024; // per connection per call
+
+  void acceptClients();
+  Connection *freeSlot();
+  void service(Connection &c);
+  void feed(Connection &c, const uint8_t *data, size_t length);
+  void endLine(Connection &c);
+  bool parseRequestLine(Connection &c);
+  void parseHeader(Connection &c);
+  void finishRequest(Connection &c);
+  void beginResponse(Connection &c);
+  void endResponse(Connection &c);
+  void serviceParked();
+  void resume(Parked &p, bool timedOut);
+  void reject(Connection &c, int code);
+  void resetRequest(Connection &c);
+  void drop(Connection &c);
+  void announce(WiFiClient &client, uint8_t slot, bool connected);
+  void dispatch();
+  bool admit();
+
+  bool findArg(int index, const char *name, const char **value,
+               size_t *valueLength, const char **key = nullptr,
+               size_t *keyLength = nullptr) const;
+
+  void writeHeaders(int code, PGM_P contentType, size_t length);
+  void appendHeader(PGM_P name, size_t nameLength, PGM_P value,
+                    size_t valueLength, bool first);
+  void txHeader(PGM_P name, PGM_P value, size_t valueLength);
+  void writeBody(PGM_P content, size_t length);
+  void txAppend(PGM_P data, size_t length);
+  void txFlush();
+  uint8_t slotIndex(const Connection &c) const; // for the event trace
+
+  WiFiServer listener;
+  Connection slots[MAX_CLIENTS];
+  Route routes[MAX_ROUTES];
+  uint8_t routeCount;
+  THandlerFunction notFoundHandler;
+  Parked parked[MAX_PARKED];
+  TResumeFunction resumeHandler;
+  const char *collected[MAX_COLLECTED_HEADERS];
+  uint8_t collectedCount;
+  RequestArena *requestArena;
+  RateLimiter *rateLimiter;
+  EventBus *eventBus;
+
+  // Response state of the request being dispatched
+  Connection *current;
+  int responseCode;
+  size_t contentLength;
+  bool chunked;
+  bool chunkedDone;
+  bool closeAfterResponse;
+  Parked *parking; // set by park() for the request being dispatched
+  uint32_t responseBytes;
+  char extraHeaders[EXTRA_HEADER_SIZE];
+  size_t extraLength;
+  char tx[TX_SIZE];
+  size_t txLength;
+
+  uint32_t served;
+  uint32_t accepted;
+
+#ifdef WORKSHOP_NATIVE
+  Connection simulated;
+  std::string captureBody;
+  std::string simulatedHeaders;
+#endif
+};
+
+#endif
@@ -0,0 +1,131 @@
+#include "log_buffer.h"
+
+LogBuffer workshopLog;
+
+LogBuffer::LogBuffer() {
+  head = 0;
+  tail = 0;
+  open = false;
+  full = false;
+  level = WORKSHOP_LOG_INFO;
+  printLevel = WORKSHOP_LOG_INFO;
+  end = 0;
+  length = 0;
+  sent = 0;
+  mirrored = false;
+  draining = false;
+  output = &Serial;
+  drops = 0;
+}
+
+void LogBuffer::begin(uint8_t level) {
+  if (open)
+    return; // continues a line started without a newline
+  open = true;
+  this->level = level;
+  end = head + HEADER;
+  length = 0;
+  // Room for the header and the line end, or the line is dropped
+  full = CAPACITY - (head - tail) < HEADER + 2;
+}
+
+void LogBuffer::format(uint8_t level, PGM_P format, ...) {
+  char text[MAX_LINE + 1];
+  va_list args;
+  va_start(args, format);
+  int n = vsnprintf_P(text, sizeof(text), format, args);
+  va_end(args);
+  if (n < 0)
+    return;
+  printLevel = level;
+  begin(level);
+  write((const uint8_t *)text, (size_t)n < sizeof(text) ? n : MAX_LINE);
+  printLevel = WORKSHOP_LOG_INFO;
+}
+
+size_t LogBuffer::write(uint8_t c) {
+  begin(printLevel);
+  if (c == '\n') {
+    commit();
+    return 1;
+  }
+  if (c == '\r' || full || length >= MAX_LINE - 2)
+    return 1; // commit() ends lines; dropped there, or cut to MAX_LINE
+  // Keep two bytes for the line end
+  if (end - tail >= CAPACITY - 2) {
+    full = true;
+    return 1;
+  }
+  ring[end++ & MASK] = c;
+  length++;
+  return 1;
+}
+
+size_t LogBuffer::write(const uint8_t *data, size_t size) {
+  for (size_t i = 0; i < size; i++)
+    write(data[i]);
+  return size;
+}
+
+void LogBuffer::commit() {
+  open = false;
+  if (full) {
+    drops++;
+    return;
+  }
+  // "\r\n" as println() ends lines
+  ring[end++ & MASK] = '\r';
+  ring[end++ & MASK] = '\n';
+  ring[head & MASK] = level;
+  ring[(head + 1) & MASK] = length + 2;
+  head = end; // publishes the line to drain()
+}
+
+void LogBuffer::drain() { drainLines(false); }
+
+void LogBuffer::flush() {
+  drainLines(true);
+  output->flush();
+}
+
+void LogBuffer::drainLines(bool wait) {
+  if (draining)
+    return; // a mirror that logs queues its line for the next call
+  draining = true;
+
+  while (tail != head) {
+    uint32_t start = tail + HEADER;
+    size_t lineLength = ring[(tail + 1) & MASK];
+
+    if (!mirrored && mirror) {
+      char text[MAX_LINE];
+      for (size_t i = 0; i + 2 < lineLength; i++)
+        text[i] = ring[(start + i) & MASK];
+      mirror(ring[tail & MASK], text, lineLength - 2);
+    }
+    mirrored = true;
+
+    size_t want = lineLength - sent;
+    if (!wait) {
+      int room = output->availableForWrite();
+      if (room <= 0)
+        break;
+      if ((size_t)room < want)
+        want = room;
+    }
+    while (want > 0) {
+      size_t at = (start + sent) & MASK;
+      size_t chunk = CAPACITY - at < want ? CAPACITY - at : want;
+      output->write(ring + at, chunk);
+      sent += chunk;
+      want -= chunk;
+    }
+    if (sent < lineLength)
+      break;
+
+    tail = start + lineLength;
+    sent = 0;
+    mirrored = false;
+  }
+  draining = false;
+}
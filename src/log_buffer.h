@@ -0,0 +1,143 @@
+#ifndef LOG_BUFFER_H
+#define LOG_BUFFER_H
+
+#include <Arduino.h>
+#include <functional>
+
+#define WORKSHOP_LOG_NONE 0
+#define WORKSHOP_LOG_ERROR 1
+#define WORKSHOP_LOG_WARN 2
+#define WORKSHOP_LOG_INFO 3
+#define WORKSHOP_LOG_DEBUG 4
+
+// Messages above this level compile to nothing, arguments included;
+// override with -DWORKSHOP_LOG_LEVEL=WORKSHOP_LOG_DEBUG
+#ifndef WORKSHOP_LOG_LEVEL
+#define WORKSHOP_LOG_LEVEL WORKSHOP_LOG_INFO
+#endif
+
+// Bytes of queued log text, a power of two
+#ifndef WORKSHOP_LOG_SIZE
+#define WORKSHOP_LOG_SIZE 1024
+#endif
+
+// Log lines are formatted into a ring buffer and written to the serial
+// port by drain() as its TX FIFO has room, so logging from a handler
+// never waits on the UART. A line that does not fit is dropped whole and
+// counted. One writer (loop() code, not ISRs) and one reader (drain())
+// share the ring without locks.
+class LogBuffer : public Print {
+public:
+  static const size_t CAPACITY = WORKSHOP_LOG_SIZE;
+  static const size_t MAX_LINE = 255; // longer lines are cut
+
+  // Sees every line once, without the line end, when drain() reaches it
+  typedef std::function<void(uint8_t level, const char *text, size_t length)>
+      TMirrorFunction;
+
+  LogBuffer();
+
+  // One line: each part printed as by Print::print, then a newline. A
+  // '\n' inside a part ends a line early; what follows keeps `level`.
+  template <typename... Parts> void line(uint8_t level, const Parts &...parts) {
+    printLevel = level;
+    begin(level);
+    printParts(parts...);
+    write('\n');
+    printLevel = WORKSHOP_LOG_INFO;
+  }
+  // printf_P into the ring, every line at `level`; a format without a
+  // trailing newline leaves the line open for the next call
+  void format(uint8_t level, PGM_P format, ...);
+
+  // Print interface, for code that takes a Print&: text is queued at INFO
+  // and each '\n' ends a line (written out as "\r\n")
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *data, size_t size) override;
+  using Print::write;
+
+  // Writes queued lines as far as the output's availableForWrite() allows
+  // and never waits; call from loop()
+  void drain();
+  // Writes everything queued, waiting on the output (setup, before sleep)
+  void flush() override;
+
+  void setOutput(Print &out) { output = &out; }
+  void setMirror(TMirrorFunction mirror) { this->mirror = mirror; }
+
+  size_t queued() const { return head - tail; }
+  uint32_t dropped() const { return drops; }
+
+private:
+  static const uint32_t MASK = CAPACITY - 1;
+  static_assert((CAPACITY & MASK) == 0, "power of two"); // flash-ok
+  static const size_t HEADER = 2; // level, length
+
+  void begin(uint8_t level);
+  void commit();
+  void drainLines(bool wait);
+
+  void printParts() {}
+  template <typename Part, typename... Rest>
+  void printParts(const Part &part, const Rest &...rest) {
+    print(part);
+    printParts(rest...);
+  }
+
+  uint8_t ring[CAPACITY];
+  volatile uint32_t head; // end of the last complete line (writer)
+  volatile uint32_t tail; // start of the oldest unsent line (reader)
+
+  // Line being written
+  bool open;
+  bool full;
+  uint8_t level;
+  uint8_t printLevel; // for lines write() opens: INFO outside line()/format()
+  uint32_t end;
+  size_t length;
+
+  // Line being sent
+  size_t sent;
+  bool mirrored;
+  bool draining;
+
+  Print *output;
+  TMirrorFunction mirror;
+  uint32_t drops;
+};
+
+extern LogBuffer workshopLog;
+
+#if WORKSHOP_LOG_LEVEL >= WORKSHOP_LOG_ERROR
+#define LOG_ERROR(...) workshopLog.line(WORKSHOP_LOG_ERROR, __VA_ARGS__)
+#define LOGF_ERROR(...) workshopLog.format(WORKSHOP_LOG_ERROR, __VA_ARGS__)
+#else
+#define LOG_ERROR(...) ((void)0)
+#define LOGF_ERROR(...) ((void)0)
+#endif
+
+#if WORKSHOP_LOG_LEVEL >= WORKSHOP_LOG_WARN
+#define LOG_WARN(...) workshopLog.line(WORKSHOP_LOG_WARN, __VA_ARGS__)
+#define LOGF_WARN(...) workshopLog.format(WORKSHOP_LOG_WARN, __VA_ARGS__)
+#else
+#define LOG_WARN(...) ((void)0)
+#define LOGF_WARN(...) ((void)0)
+#endif
+
+#if WORKSHOP_LOG_LEVEL >= WORKSHOP_LOG_INFO
+#define LOG_INFO(...) workshopLog.line(WORKSHOP_LOG_INFO, __VA_ARGS__)
+#define LOGF_INFO(...) workshopLog.format(WORKSHOP_LOG_INFO, __VA_ARGS__)
+#else
+#define LOG_INFO(...) ((void)0)
+#define LOGF_INFO(...) ((void)0)
+#endif
+
+#if WORKSHOP_LOG_LEVEL >= WORKSHOP_LOG_DEBUG
+#define LOG_DEBUG(...) workshopLog.line(WORKSHOP_LOG_DEBUG, __VA_ARGS__)
+#define LOGF_DEBUG(...) workshopLog.format(WORKSHOP_LOG_DEBUG, __VA_ARGS__)
+#else
+#define LOG_DEBUG(...) ((void)0)
+#define LOGF_DEBUG(...) ((void)0)
+#endif
+
+#endif
@@ -6,10 +6,13 @@ WorkshopESP workshop;
 char teamName[] = "Team 1";
 
 void setup() {
+  workshop.begin();
+
   // Test go-to-definition: try Cmd+Click on setupWiFi
   String wifiSSID = String("IoT-Workshop-") + String(teamName);
   workshop.setupWiFiAP(wifiSSID.c_str(), "");
   workshop.animateHello(teamName);
+  workshop.boot().ready(Serial);
 }
 
 void loop() {
@@ -0,0 +1,101 @@
+#include "rate_limiter.h"
+
+RateLimiter::RateLimiter() {
+  for (Client &client : table)
+    client.ip = 0;
+  for (uint32_t &count : rejects)
+    count = 0;
+  evicted = 0;
+  setRate(RATE_READ, WORKSHOP_RATE_READ_PER_S, WORKSHOP_RATE_READ_BURST);
+  setRate(RATE_WRITE, WORKSHOP_RATE_WRITE_PER_S, WORKSHOP_RATE_WRITE_BURST);
+}
+
+void RateLimiter::setRate(RateClass rateClass, uint16_t perSecond,
+                          uint16_t burst) {
+  Rate &rate = rates[rateClass];
+  rate.perSecond = perSecond;
+  rate.capacity = (uint32_t)(burst > 0 ? burst : 1) * TOKEN;
+  for (Client &client : table) {
+    if (client.tokens[rateClass] > rate.capacity)
+      client.tokens[rateClass] = rate.capacity;
+  }
+}
+
+bool RateLimiter::admit(uint32_t ip, RateClass rateClass, unsigned long now,
+                        unsigned long *retryMs) {
+  const Rate &rate = rates[rateClass];
+  if (rate.perSecond == 0)
+    return true;
+
+  Client *client = lookup(ip, now);
+  uint32_t &tokens = client->tokens[rateClass];
+  if (tokens >= TOKEN) {
+    tokens -= TOKEN;
+    return true;
+  }
+
+  rejects[rateClass]++;
+  if (retryMs != nullptr)
+    *retryMs = (TOKEN - tokens + rate.perSecond - 1) / rate.perSecond;
+  return false;
+}
+
+RateLimiter::Client *RateLimiter::lookup(uint32_t ip, unsigned long now) {
+  Client *free = nullptr;
+  Client *oldest = &table[0];
+  for (Client &client : table) {
+    if (client.ip == ip) {
+      refill(client, now);
+      return &client;
+    }
+    if (client.ip == 0) {
+      if (free == nullptr)
+        free = &client;
+    } else if ((long)(client.updated - oldest->updated) < 0) {
+      oldest = &client;
+    }
+  }
+
+  Client *client = free;
+  if (client == nullptr) {
+    client = oldest;
+    evicted++;
+  }
+  client->ip = ip;
+  client->updated = now;
+  for (uint8_t i = 0; i < RATE_CLASSES; i++)
+    client->tokens[i] = rates[i].capacity; // a new client starts full
+  return client;
+}
+
+void RateLimiter::refill(Client &client, unsigned long now) {
+  unsigned long elapsed = now - client.updated;
+  client.updated = now;
+  for (uint8_t i = 0; i < RATE_CLASSES; i++) {
+    const Rate &rate = rates[i];
+    uint32_t room = rate.capacity - client.tokens[i];
+    if (rate.perSecond == 0 || room == 0)
+      continue;
+    // perSecond tokens per s is perSecond thousandths per ms
+    if (elapsed >= room / rate.perSecond)
+      client.tokens[i] = rate.capacity;
+    else
+      client.tokens[i] += elapsed * rate.perSecond;
+  }
+}
+
+uint32_t RateLimiter::rejected() const {
+  uint32_t total = 0;
+  for (uint32_t count : rejects)
+    total += count;
+  return total;
+}
+
+uint8_t RateLimiter::clients() const {
+  uint8_t count = 0;
+  for (const Client &client : table) {
+    if (client.ip != 0)
+      count++;
+  }
+  return count;
+}
@@ -0,0 +1,75 @@
+#ifndef RATE_LIMITER_H
+#define RATE_LIMITER_H
+
+#include <Arduino.h>
+
+// Client addresses tracked at once; the least recently seen one makes
+// room for a new client. Override with -DWORKSHOP_RATE_CLIENTS=...
+#ifndef WORKSHOP_RATE_CLIENTS
+#define WORKSHOP_RATE_CLIENTS 8
+#endif
+
+// Default budgets, requests per second and burst size
+#ifndef WORKSHOP_RATE_READ_PER_S
+#define WORKSHOP_RATE_READ_PER_S 20
+#endif
+#ifndef WORKSHOP_RATE_READ_BURST
+#define WORKSHOP_RATE_READ_BURST 40
+#endif
+#ifndef WORKSHOP_RATE_WRITE_PER_S
+#define WORKSHOP_RATE_WRITE_PER_S 5
+#endif
+#ifndef WORKSHOP_RATE_WRITE_BURST
+#define WORKSHOP_RATE_WRITE_BURST 10
+#endif
+
+// Route classes with separate budgets: reads (GET, HEAD, OPTIONS) and
+// writes (POST and the rest, which change state)
+enum RateClass : uint8_t { RATE_READ, RATE_WRITE, RATE_CLASSES };
+
+// Token buckets per client IP and route class in a fixed table. Tokens
+// are kept in thousandths and refilled from millis() when a client is
+// seen, so an idle client costs nothing and admit() never allocates.
+class RateLimiter {
+public:
+  static const uint8_t MAX_CLIENTS = WORKSHOP_RATE_CLIENTS;
+
+  RateLimiter();
+
+  // perSecond 0 turns limiting off for the class
+  void setRate(RateClass rateClass, uint16_t perSecond, uint16_t burst);
+
+  // Takes a token; false if the client is over budget, with the time
+  // until the next token in `retryMs`
+  bool admit(uint32_t ip, RateClass rateClass, unsigned long now,
+             unsigned long *retryMs = nullptr);
+
+  uint32_t rejected() const;
+  uint32_t rejected(RateClass rateClass) const { return rejects[rateClass]; }
+  uint32_t evictions() const { return evicted; }
+  uint8_t clients() const;
+
+private:
+  static const uint32_t TOKEN = 1000;
+
+  struct Client {
+    uint32_t ip;           // 0 = free
+    unsigned long updated; // ms, last refill
+    uint32_t tokens[RATE_CLASSES];
+  };
+
+  struct Rate {
+    uint16_t perSecond; // = thousandths of a token per ms
+    uint32_t capacity;  // burst * TOKEN
+  };
+
+  Client *lookup(uint32_t ip, unsigned long now);
+  void refill(Client &client, unsigned long now);
+
+  Client table[MAX_CLIENTS];
+  Rate rates[RATE_CLASSES];
+  uint32_t rejects[RATE_CLASSES];
+  uint32_t evicted;
+};
+
+#endif
@@ -0,0 +1,98 @@
+#include "request_arena.h"
+
+RequestArena::RequestArena() {
+  top = 0;
+  last = 0;
+  peak = 0;
+  failed = 0;
+}
+
+void *RequestArena::allocate(size_t size) {
+  size_t aligned = (size + ALIGN - 1) & ~(ALIGN - 1);
+  if (aligned == 0 || aligned > CAPACITY - top) {
+    failed++;
+    return nullptr;
+  }
+
+  last = top;
+  top += aligned;
+  if (top > peak)
+    peak = top;
+  return buffer + last;
+}
+
+bool RequestArena::extend(void *block, size_t newSize) {
+  if (block != buffer + last || top == 0)
+    return false;
+
+  size_t aligned = (newSize + ALIGN - 1) & ~(ALIGN - 1);
+  if (aligned > CAPACITY - last)
+    return false;
+
+  top = last + aligned;
+  if (top > peak)
+    peak = top;
+  return true;
+}
+
+void RequestArena::reset() {
+  top = 0;
+  last = 0;
+}
+
+ScratchString::ScratchString(RequestArena &arena, size_t reserve)
+    : arena(arena) {
+  text = nullptr;
+  len = 0;
+  capacity = 0;
+  overflow = false;
+  this->reserve(reserve);
+}
+
+bool ScratchString::reserve(size_t size) {
+  if (size <= capacity)
+    return true;
+
+  // Usually the newest block, so growing is just moving the arena top
+  if (text != nullptr && arena.extend(text, size)) {
+    capacity = size;
+    return true;
+  }
+
+  size_t grown = capacity * 2 > size ? capacity * 2 : size;
+  char *block = static_cast<char *>(arena.allocate(grown));
+  if (block == nullptr && grown != size) {
+    grown = size;
+    block = static_cast<char *>(arena.allocate(grown));
+  }
+  if (block == nullptr)
+    return false;
+
+  if (text != nullptr)
+    memcpy(block, text, len + 1);
+  else
+    block[0] = 0;
+  text = block;
+  capacity = grown;
+  return true;
+}
+
+size_t ScratchString::write(uint8_t c) { return write(&c, 1); }
+
+size_t ScratchString::write(const uint8_t *data, size_t size) {
+  if (!reserve(len + size + 1)) {
+    overflow = true;
+    return 0;
+  }
+  memcpy(text + len, data, size);
+  len += size;
+  text[len] = 0;
+  return size;
+}
+
+void ScratchString::clear() {
+  len = 0;
+  overflow = false;
+  if (text != nullptr)
+    text[0] = 0;
+}
@@ -0,0 +1,85 @@
+#ifndef REQUEST_ARENA_H
+#define REQUEST_ARENA_H
+
+#include <Arduino.h>
+
+// Scratch space for one request/message; override with
+// -DWORKSHOP_ARENA_SIZE=...
+#ifndef WORKSHOP_ARENA_SIZE
+#define WORKSHOP_ARENA_SIZE 2048
+#endif
+
+// Bump-pointer allocator for handler temporaries. Blocks are never freed
+// one by one; reset() after each HTTP request or WebSocket message drops
+// them all at once, so short-lived strings no longer punch holes in the
+// heap between long-lived blocks.
+class RequestArena {
+public:
+  static const size_t CAPACITY = WORKSHOP_ARENA_SIZE;
+
+  RequestArena();
+
+  // 4-byte aligned; nullptr when the arena is full (counted in failures())
+  void *allocate(size_t size);
+  template <typename T> T *allocate(size_t count) {
+    return static_cast<T *>(allocate(count * sizeof(T)));
+  }
+
+  // Grows the most recent block in place. False if `block` is not the
+  // last allocation or there is no room.
+  bool extend(void *block, size_t newSize);
+
+  void reset();
+
+  size_t used() const { return top; }
+  size_t available() const { return CAPACITY - top; }
+  size_t highWater() const { return peak; }
+  uint32_t failures() const { return failed; }
+
+  // Resets the arena when the enclosing handler returns
+  class Scope {
+  public:
+    explicit Scope(RequestArena &arena) : arena(arena) {}
+    ~Scope() { arena.reset(); }
+
+  private:
+    RequestArena &arena;
+  };
+
+private:
+  static const size_t ALIGN = 4;
+
+  uint8_t buffer[CAPACITY] __attribute__((aligned(4)));
+  size_t top;
+  size_t last; // offset of the most recent block
+  size_t peak;
+  uint32_t failed;
+};
+
+// Growable NUL-terminated string in arena memory. It is a Print, so
+// printf_P(), print(Text::...) and number formatting write straight into
+// it. Text that does not fit is dropped and overflowed() is set.
+class ScratchString : public Print {
+public:
+  explicit ScratchString(RequestArena &arena, size_t reserve = 64);
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *data, size_t size) override;
+  using Print::write;
+
+  const char *c_str() const { return text ? text : ""; }
+  size_t length() const { return len; }
+  bool overflowed() const { return overflow; }
+  void clear();
+
+private:
+  bool reserve(size_t size);
+
+  RequestArena &arena;
+  char *text;
+  size_t len;
+  size_t capacity; // including the terminator
+  bool overflow;
+};
+
+#endif
@@ -0,0 +1,63 @@
+#include "response_cache.h"
+#include "workshop_strings.h"
+
+ResponseCache::ResponseCache() {
+  text[0] = 0;
+  tag[0] = 0;
+  len = 0;
+  valid = false;
+  overflow = false;
+  renderedGeneration = 0;
+  renderedVariant = 0;
+  renderedAt = 0;
+  freshMs = 0;
+  hitCount = 0;
+  renderCount = 0;
+}
+
+bool ResponseCache::fresh(uint32_t generation, unsigned long now,
+                          uint8_t variant) const {
+  if (!valid || overflow || generation != renderedGeneration ||
+      variant != renderedVariant)
+    return false;
+  return freshMs == 0 || now - renderedAt < freshMs;
+}
+
+void ResponseCache::begin(uint32_t generation, unsigned long now,
+                          uint8_t variant) {
+  text[0] = 0;
+  len = 0;
+  overflow = false;
+  valid = true;
+  renderedGeneration = generation;
+  renderedVariant = variant;
+  renderedAt = now;
+  renderCount++;
+
+  // The render time keeps tags from a previous boot from matching
+  snprintf_P(tag, sizeof(tag), Text::FMT_ETAG.p(),
+             (unsigned long)generation, (unsigned long)now,
+             (unsigned)variant);
+}
+
+size_t ResponseCache::write(uint8_t c) { return write(&c, 1); }
+
+size_t ResponseCache::write(const uint8_t *data, size_t size) {
+  if (len + size >= CAPACITY) {
+    overflow = true;
+    return 0;
+  }
+  memcpy(text + len, data, size);
+  len += size;
+  text[len] = 0;
+  return size;
+}
+
+bool ResponseCache::matches(const char *ifNoneMatch) const {
+  if (ifNoneMatch == nullptr || !valid || overflow)
+    return false;
+  if (strcmp_P(ifNoneMatch, Text::ETAG_ANY.p()) == 0)
+    return true;
+  // May be a list and/or weak (W/"...")
+  return strstr(ifNoneMatch, tag) != nullptr;
+}
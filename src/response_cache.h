@@ -0,0 +1,67 @@
+#ifndef RESPONSE_CACHE_H
+#define RESPONSE_CACHE_H
+
+#include <Arduino.h>
+
+#ifndef WORKSHOP_RESPONSE_CACHE_SIZE
+#define WORKSHOP_RESPONSE_CACHE_SIZE 192
+#endif
+
+// Rendered response body tied to a state generation. The owner bumps its
+// generation on every change the body depends on; the cached copy is
+// served until the generation moves or the freshness window (for fields
+// such as uptime that change without a state change) runs out. `variant`
+// tells apart renderings of the same state (field selection, encoding).
+//
+// Each render gets an ETag built from the generation, the render time and
+// the variant, so a client whose If-None-Match still matches can be sent
+// a 304.
+class ResponseCache : public Print {
+public:
+  static const size_t CAPACITY = WORKSHOP_RESPONSE_CACHE_SIZE;
+
+  ResponseCache();
+
+  // True if the body can be served as is for `generation` at `now` (ms)
+  bool fresh(uint32_t generation, unsigned long now,
+             uint8_t variant = 0) const;
+
+  // Clears the body for a new render; write it through print()/printf_P()
+  void begin(uint32_t generation, unsigned long now, uint8_t variant = 0);
+  void invalidate() { valid = false; }
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t *data, size_t size) override;
+  using Print::write;
+
+  const char *body() const { return text; }
+  size_t length() const { return len; }
+  bool overflowed() const { return overflow; }
+  const char *etag() const { return tag; }
+
+  // If-None-Match check; null means the header was not sent
+  bool matches(const char *ifNoneMatch) const;
+
+  // 0 = no time-dependent fields, valid until the generation changes
+  void setFreshness(unsigned long ms) { freshMs = ms; }
+  unsigned long freshness() const { return freshMs; }
+
+  uint32_t hits() const { return hitCount; }
+  uint32_t renders() const { return renderCount; }
+  void countHit() { hitCount++; }
+
+private:
+  char text[CAPACITY];
+  char tag[24];
+  size_t len;
+  bool valid;
+  bool overflow;
+  uint32_t renderedGeneration;
+  uint8_t renderedVariant;
+  unsigned long renderedAt;
+  unsigned long freshMs;
+  uint32_t hitCount;
+  uint32_t renderCount;
+};
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef SENSOR_FILTER_H
+#define SENSOR_FILTER_H
+
+#include <Arduino.h>
+
+// Integer filter stages for ADC readings, chained at compile time:
+//
+//   SensorFilter::Chain<SensorFilter::Median<3>, SensorFilter::Ema<2>> pot;
+//   if (pot.push(analogRead(A0)))
+//     send(pot.value());
+//
+// Each stage is a small class with
+//   GAIN_BITS           bits its output has over its input (oversampling)
+//   push(in, out)       true when `out` holds a new output
+//   reset(value)        as if `value` had been steady forever
+// and Chain calls them directly, so the compiler sees through the whole
+// pipeline and a stage that is not listed costs nothing. No floating
+// point, no heap; state is a few words per stage.
+//
+// Values are int32_t. After an Oversample stage they carry extra bits of
+// resolution (GAIN_BITS of the chain); toInput() scales back. A chain's
+// size is its stages' state plus one word.
+namespace SensorFilter {
+
+// Sums 4^BITS readings into one with BITS more bits (oversample and
+// decimate). Gains real resolution only if the input has about an LSB of
+// noise, which the ESP8266 ADC does.
+template <uint8_t BITS> class Oversample {
+public:
+  static_assert(BITS >= 1 && BITS <= 6, "1 to 6 extra bits"); // flash-ok
+  static const uint8_t GAIN_BITS = BITS;
+  static const uint16_t RATIO = 1 << (2 * BITS); // readings per output
+
+  bool push(int32_t in, int32_t &out) {
+    sum += in;
+    if (++count < RATIO)
+      return false;
+    out = sum >> BITS;
+    sum = 0;
+    count = 0;
+    return true;
+  }
+  void reset(int32_t value) {
+    (void)value;
+    sum = 0;
+    count = 0;
+  }
+
+private:
+  int32_t sum = 0;
+  uint16_t count = 0;
+};
+
+// Median of the last TAPS (3 or 5) readings: removes spikes up to
+// TAPS / 2 readings long and passes steps without smoothing them
+template <uint8_t TAPS> class Median {
+public:
+  static_assert(TAPS == 3 || TAPS == 5, "3 or 5 taps"); // flash-ok
+  static const uint8_t GAIN_BITS = 0;
+
+  bool push(int32_t in, int32_t &out) {
+    if (!primed)
+      reset(in);
+    window[next] = in;
+    next = next + 1 < TAPS ? next + 1 : 0;
+    out = median();
+    return true;
+  }
+  void reset(int32_t value) {
+    for (uint8_t i = 0; i < TAPS; i++)
+      window[i] = value;
+    next = 0;
+    primed = true;
+  }
+
+private:
+  static void order(int32_t &a, int32_t &b) {
+    if (a > b) {
+      int32_t t = a;
+      a = b;
+      b = t;
+    }
+  }
+
+  // Partial sorting networks: just the compares that fix the middle
+  int32_t median() const {
+    int32_t a = window[0], b = window[1], c = window[2];
+    if (TAPS == 3) {
+      order(a, b);
+      order(b, c);
+      order(a, b);
+      return b;
+    }
+    int32_t d = window[TAPS > 3 ? 3 : 0], e = window[TAPS > 4 ? 4 : 0];
+    order(a, b);
+    order(d, e);
+    order(a, d);
+    order(b, e);
+    order(b, c);
+    order(c, d);
+    order(b, c);
+    return c;
+  }
+
+  int32_t window[TAPS];
+  uint8_t next = 0;
+  bool primed = false;
+};
+
+// Exponential moving average, y += (x - y) / 2^SHIFT. The state keeps
+// SHIFT + 1 fraction bits, so the output settles exactly on a steady
+// input instead of stopping up to 2^SHIFT short as the plain integer form
+// does. Time constant is about 2^SHIFT readings.
+template <uint8_t SHIFT> class Ema {
+public:
+  static_assert(SHIFT >= 1 && SHIFT <= 12, "1 to 12"); // flash-ok
+  static const uint8_t GAIN_BITS = 0;
+
+  bool push(int32_t in, int32_t &out) {
+    if (!primed)
+      reset(in);
+    state += (in * ONE - state) >> SHIFT;
+    out = (state + ONE / 2) >> FRACTION;
+    return true;
+  }
+  void reset(int32_t value) {
+    state = value * ONE;
+    primed = true;
+  }
+
+private:
+  static const uint8_t FRACTION = SHIFT + 1;
+  static const int32_t ONE = 1 << FRACTION;
+
+  int32_t state = 0;
+  bool primed = false;
+};
+
+// Runs a reading through each stage in turn, stopping at a stage that
+// has nothing to pass on yet
+template <typename... Types> class Stages;
+
+template <> class Stages<> {
+public:
+  static const uint8_t GAIN_BITS = 0;
+
+  bool push(int32_t in, int32_t &out) {
+    out = in;
+    return true;
+  }
+  void reset(int32_t value) { (void)value; }
+};
+
+template <typename First, typename... Rest>
+class Stages<First, Rest...> : private Stages<Rest...> {
+public:
+  static const uint8_t GAIN_BITS =
+      First::GAIN_BITS + Stages<Rest...>::GAIN_BITS;
+
+  bool push(int32_t in, int32_t &out) {
+    int32_t between;
+    return first.push(in, between) && Stages<Rest...>::push(between, out);
+  }
+  void reset(int32_t value) {
+    first.reset(value);
+    Stages<Rest...>::reset(value * (1 << First::GAIN_BITS));
+  }
+
+private:
+  First first;
+};
+
+// The stages plus their latest output
+template <typename... Types> class Chain : private Stages<Types...> {
+public:
+  using Stages<Types...>::GAIN_BITS;
+
+  // True when a reading made it through every stage; value() has it
+  bool push(int32_t in) { return Stages<Types...>::push(in, output); }
+  void reset(int32_t value) {
+    Stages<Types...>::reset(value);
+    output = value * (1 << GAIN_BITS);
+  }
+
+  int32_t value() const { return output; }
+  // An output in the units of the input, rounded
+  static int32_t toInput(int32_t out) {
+    return (out + (1 << GAIN_BITS >> 1)) >> GAIN_BITS;
+  }
+
+private:
+  int32_t output = 0;
+};
+
+} // namespace SensorFilter
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <string.h>
+#include <type_traits>
+
+// Shares a small struct between one writer and any number of readers
+// without locks or disabling interrupts. The writer makes the sequence
+// odd, stores the words and makes it even again; it never waits, so it
+// can run in a timer ISR. A reader copies the words and keeps the copy
+// only if the sequence was the same even number before and after,
+// otherwise it copies again. On the ESP8266 the ISR finishes before the
+// interrupted reader resumes, so a read retries at most once per write
+// that lands during it.
+//
+// The value is held as relaxed atomic words: plain loads and stores on
+// the ESP8266, and a data-race-free copy on a multicore host. One writer
+// context only; two writers (loop() and an ISR) would need two Seqlocks.
+template <typename T> class Seqlock {
+public:
+  static_assert(std::is_trivially_copyable<T>::value, "plain data"); // flash-ok
+
+  Seqlock() : sequence(0) {
+    for (std::atomic<uint32_t> &word : words)
+      word.store(0, std::memory_order_relaxed);
+  }
+
+  void write(const T &value) {
+    uint32_t buffer[WORDS] = {};
+    memcpy(buffer, &value, sizeof(T));
+    uint32_t next = sequence.load(std::memory_order_relaxed) + 1;
+    sequence.store(next, std::memory_order_relaxed); // odd: writing
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < WORDS; i++)
+      words[i].store(buffer[i], std::memory_order_relaxed);
+    sequence.store(next + 1, std::memory_order_release);
+  }
+
+  // One attempt; false if a write was under way or landed meanwhile
+  bool tryRead(T &value) const {
+    uint32_t before = sequence.load(std::memory_order_acquire);
+    if (before & 1)
+      return false;
+    uint32_t buffer[WORDS];
+    for (size_t i = 0; i < WORDS; i++)
+      buffer[i] = words[i].load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence.load(std::memory_order_relaxed) != before)
+      return false;
+    memcpy(&value, buffer, sizeof(T));
+    return true;
+  }
+
+  // Retries until a copy is consistent; `retries` counts the attempts
+  // that were not
+  T read(uint32_t *retries = nullptr) const {
+    T value;
+    uint32_t failed = 0;
+    while (!tryRead(value))
+      failed++;
+    if (retries != nullptr)
+      *retries += failed;
+    return value;
+  }
+
+  // Writes so far
+  uint32_t version() const {
+    return sequence.load(std::memory_order_acquire) / 2;
+  }
+
+private:
+  static const size_t WORDS = (sizeof(T) + 3) / 4;
+
+  std::atomic<uint32_t> sequence;
+  std::atomic<uint32_t> words[WORDS];
+};
+
+#endif
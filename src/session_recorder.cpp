@@ -0,0 +1,153 @@
+#include "session_recorder.h"
+
+SessionRecorder workshopRecorder;
+
+namespace {
+
+size_t varintSize(uint32_t value) {
+  size_t n = 1;
+  while (value >= 0x80) {
+    value >>= 7;
+    n++;
+  }
+  return n;
+}
+
+void putLE(uint8_t *out, uint32_t value, size_t bytes) {
+  for (size_t i = 0; i < bytes; i++)
+    out[i] = value >> (8 * i);
+}
+
+} // namespace
+
+SessionRecorder::SessionRecorder() {
+  head = 0;
+  tail = 0;
+  end = 0;
+  time = 0;
+  lastTime = 0;
+  tailTime = 0;
+  drops = 0;
+  enabled = true;
+  ignoredPath = nullptr;
+}
+
+void SessionRecorder::http(uint32_t ip, uint8_t method, bool formBody,
+                           const char *path, const char *query,
+                           const char *body, size_t bodyLength) {
+  if (ignoredPath != nullptr && strcmp_P(path, ignoredPath) == 0)
+    return;
+  size_t pathLength = strlen(path);
+  size_t queryLength = query != nullptr ? strlen(query) : 0;
+  size_t fields = varintSize(ip) + 2 + varintSize(pathLength) + pathLength +
+                  varintSize(queryLength) + queryLength +
+                  varintSize(bodyLength) + bodyLength;
+  if (!begin(HTTP_REQUEST, fields))
+    return;
+  putVarint(ip);
+  put(method);
+  put(formBody);
+  putText((const uint8_t *)path, pathLength);
+  putText((const uint8_t *)query, queryLength);
+  putText((const uint8_t *)body, bodyLength);
+  commit();
+}
+
+void SessionRecorder::webSocket(uint8_t client, uint8_t type,
+                                const uint8_t *payload, size_t length) {
+  if (length > MAX_PAYLOAD)
+    length = MAX_PAYLOAD;
+  if (!begin(WS_EVENT, 2 + varintSize(length) + length))
+    return;
+  put(client);
+  put(type);
+  putText(payload, length);
+  commit();
+}
+
+void SessionRecorder::sample(uint8_t pin, int value) {
+  uint32_t zigzag = ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+  if (!begin(SENSOR_SAMPLE, 1 + varintSize(zigzag)))
+    return;
+  put(pin);
+  putVarint(zigzag);
+  commit();
+}
+
+bool SessionRecorder::begin(Kind kind, size_t fieldsLength) {
+  if (!enabled)
+    return false;
+  time = micros();
+  uint32_t delta = time - lastTime;
+  size_t length = varintSize(delta) + fieldsLength;
+  size_t total = 1 + varintSize(length) + length;
+  if (CAPACITY - (head - tail) < total) {
+    drops++;
+    return false;
+  }
+  end = head;
+  put(kind);
+  putVarint(length);
+  putVarint(delta);
+  return true;
+}
+
+void SessionRecorder::putVarint(uint32_t value) {
+  while (value >= 0x80) {
+    put((uint8_t)value | 0x80);
+    value >>= 7;
+  }
+  put((uint8_t)value);
+}
+
+void SessionRecorder::putText(const uint8_t *text, size_t length) {
+  putVarint(length);
+  for (size_t i = 0; i < length; i++)
+    put(text[i]);
+}
+
+uint32_t SessionRecorder::readVarint(uint32_t &at) const {
+  uint32_t value = 0;
+  for (uint8_t shift = 0;; shift += 7) {
+    uint8_t b = ring[at++ & MASK];
+    value |= (uint32_t)(b & 0x7f) << shift;
+    if (!(b & 0x80))
+      return value;
+  }
+}
+
+void SessionRecorder::commit() {
+  lastTime = time;
+  head = end; // publishes the record to read()
+}
+
+size_t SessionRecorder::read(uint8_t *out, size_t size) {
+  if (size < CHUNK_HEADER)
+    return 0;
+
+  out[0] = 'W';
+  out[1] = 'R';
+  out[2] = VERSION;
+  out[3] = 0;
+  putLE(out + 4, tailTime, 4);
+  putLE(out + 8, drops, 4);
+
+  size_t length = CHUNK_HEADER;
+  uint32_t last = head;
+  while (tail != last) {
+    // kind, length of the rest, then the delta that starts the rest
+    uint32_t at = tail + 1;
+    uint32_t recordLength = readVarint(at);
+    size_t total = (at - tail) + recordLength;
+    uint32_t delta = readVarint(at);
+    if (size - length < total)
+      break;
+    for (size_t i = 0; i < total; i++)
+      out[length + i] = ring[(tail + i) & MASK];
+    tailTime += delta;
+    length += total;
+    tail += total;
+  }
+  putLE(out + 12, length - CHUNK_HEADER, 2);
+  return length;
+}
@@ -0,0 +1,99 @@
+#ifndef SESSION_RECORDER_H
+#define SESSION_RECORDER_H
+
+#include <Arduino.h>
+
+// -DWORKSHOP_RECORD=1 records traffic for replay on the host build
+#ifndef WORKSHOP_RECORD
+#define WORKSHOP_RECORD 0
+#endif
+
+// Bytes of queued records, a power of two
+#ifndef WORKSHOP_RECORD_SIZE
+#if WORKSHOP_RECORD
+#define WORKSHOP_RECORD_SIZE 2048
+#else
+#define WORKSHOP_RECORD_SIZE 64
+#endif
+#endif
+
+// Captures what drives a sketch - HTTP requests, WebSocket events and
+// sensor readings - with microsecond timestamps, so a session from the
+// room can be replayed against the host build (native --replay). Records
+// are queued in a ring and handed out by read() as chunks:
+//
+//   "WR" version 0 base(u32) dropped(u32) length(u16) records...
+//   record: kind, length of the rest (varint), delta (varint), fields
+//
+//   HTTP_REQUEST  ip, method, form body (0/1), path, query, body
+//   WS_EVENT      client, type, payload
+//   SENSOR_SAMPLE pin, value (zigzag)
+//
+// Numbers are little-endian, counts and lengths varints, text a varint
+// length and the bytes. Records that do not fit are dropped whole and
+// counted. One writer (loop() code, not ISRs).
+class SessionRecorder {
+public:
+  static const size_t CAPACITY = WORKSHOP_RECORD_SIZE;
+  static const size_t CHUNK_HEADER = 14;
+  static const uint8_t VERSION = 1;
+  static const size_t MAX_PAYLOAD = 256; // WebSocket payloads are cut
+
+  enum Kind : uint8_t { HTTP_REQUEST = 1, WS_EVENT, SENSOR_SAMPLE };
+
+  SessionRecorder();
+
+  void http(uint32_t ip, uint8_t method, bool formBody, const char *path,
+            const char *query, const char *body, size_t bodyLength);
+  void webSocket(uint8_t client, uint8_t type, const uint8_t *payload,
+                 size_t length);
+  void sample(uint8_t pin, int value);
+
+  // Moves whole records into `out` as one chunk and returns its length;
+  // 0 if `size` cannot hold the header
+  size_t read(uint8_t *out, size_t size);
+  size_t chunkSize() const { return CHUNK_HEADER + queued(); }
+
+  void setEnabled(bool on) { enabled = on; }
+  bool isEnabled() const { return enabled; }
+  // Requests for this path (the endpoint serving read()) are not recorded
+  void ignorePath(PGM_P path) { ignoredPath = path; }
+  size_t queued() const { return head - tail; }
+  uint32_t dropped() const { return drops; }
+
+private:
+  static const uint32_t MASK = CAPACITY - 1;
+  static_assert((CAPACITY & MASK) == 0, "power of two"); // flash-ok
+
+  bool begin(Kind kind, size_t fieldsLength);
+  void put(uint8_t value) { ring[end++ & MASK] = value; }
+  void putVarint(uint32_t value);
+  void putText(const uint8_t *text, size_t length);
+  void commit();
+  uint32_t readVarint(uint32_t &at) const;
+
+  uint8_t ring[CAPACITY];
+  volatile uint32_t head; // end of the last complete record (writer)
+  volatile uint32_t tail; // start of the oldest unread record (reader)
+  uint32_t end;           // write position of the record being built
+  uint32_t time;          // micros() of the record being built
+  uint32_t lastTime;      // micros() of the last stored record
+  uint32_t tailTime;      // micros() of the record before tail
+  uint32_t drops;
+  bool enabled;
+  PGM_P ignoredPath;
+};
+
+extern SessionRecorder workshopRecorder;
+
+#if WORKSHOP_RECORD
+#define RECORD_HTTP(...) workshopRecorder.http(__VA_ARGS__)
+#define RECORD_WS(...) workshopRecorder.webSocket(__VA_ARGS__)
+#define RECORD_SAMPLE(...) workshopRecorder.sample(__VA_ARGS__)
+#else
+#define RECORD_HTTP(...) ((void)0)
+#define RECORD_WS(...) ((void)0)
+#define RECORD_SAMPLE(...) ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,191 @@
+#include "sparkline.h"
+
+namespace {
+
+const uint8_t SCREEN_WIDTH = 128; // framebuffer stride, SSD1306 128x64
+const uint8_t SCREEN_PAGES = 8;
+const uint8_t PAGE_HEIGHT = 8;
+
+} // namespace
+
+Sparkline::Sparkline() {
+  closed = 0;
+  scaled = 0;
+  automatic = true;
+  minimumSpan = 16;
+  begin(0, 0, SCREEN_WIDTH, SCREEN_PAGES);
+}
+
+void Sparkline::begin(uint8_t x, uint8_t page, uint8_t width, uint8_t pages,
+                      Mode mode) {
+  if (x >= SCREEN_WIDTH)
+    x = SCREEN_WIDTH - 1;
+  if (page >= SCREEN_PAGES)
+    page = SCREEN_PAGES - 1;
+  if (width == 0 || width > SCREEN_WIDTH - x)
+    width = SCREEN_WIDTH - x;
+  if (pages == 0 || pages > SCREEN_PAGES - page)
+    pages = SCREEN_PAGES - page;
+  this->x = x;
+  this->page = page;
+  this->width = width;
+  this->pages = pages;
+  this->mode = mode;
+  head = 0;
+  filled = 0;
+  pending = false;
+  if (automatic) {
+    rangeLow = 0;
+    rangeHigh = 0; // set by the first column
+  }
+}
+
+void Sparkline::setRange(int16_t low, int16_t high) {
+  automatic = false;
+  rangeLow = low;
+  rangeHigh = high > low ? high : low + 1;
+}
+
+void Sparkline::autoScale(int16_t minimumSpan) {
+  automatic = true;
+  this->minimumSpan = minimumSpan > 0 ? minimumSpan : 1;
+  rangeLow = 0;
+  rangeHigh = 0;
+}
+
+void Sparkline::add(int16_t sample) {
+  if (!pending) {
+    pendingLow = sample;
+    pendingHigh = sample;
+    pending = true;
+    return;
+  }
+  if (sample < pendingLow)
+    pendingLow = sample;
+  if (sample > pendingHigh)
+    pendingHigh = sample;
+}
+
+bool Sparkline::render(Adafruit_SSD1306 &display) {
+  uint8_t *buffer = display.getBuffer();
+  if (!pending || buffer == nullptr)
+    return false;
+  pending = false;
+  closed++;
+
+  Column column = {pendingLow, pendingHigh};
+  uint8_t slot = head;
+  Column previous = filled > 0 ? ring[(slot + width - 1) % width] : column;
+  ring[slot] = column;
+  head = (slot + 1) % width;
+  if (filled < width)
+    filled++;
+
+  if (fitRange(column)) {
+    redraw(display);
+    return true;
+  }
+  if (mode == SWEEP) {
+    drawColumn(buffer, x + slot, column, previous);
+    if (width > 1)
+      blankColumn(buffer, x + head); // the gap ahead of the trace
+  } else {
+    for (uint8_t p = 0; p < pages; p++) {
+      uint8_t *row = buffer + (page + p) * SCREEN_WIDTH + x;
+      memmove(row, row + 1, width - 1);
+    }
+    drawColumn(buffer, x + width - 1, column, previous);
+    // The leftmost column lost its predecessor: drawn on its own, as
+    // redraw() would
+    uint8_t oldest = (head + width - filled) % width;
+    if (filled == width && width > 1)
+      drawColumn(buffer, x, ring[oldest], ring[oldest]);
+  }
+  return true;
+}
+
+void Sparkline::redraw(Adafruit_SSD1306 &display) {
+  uint8_t *buffer = display.getBuffer();
+  if (buffer == nullptr)
+    return;
+  for (uint8_t p = 0; p < pages; p++)
+    memset(buffer + (page + p) * SCREEN_WIDTH + x, 0, width);
+
+  // Oldest to newest; a full SWEEP ring keeps its oldest slot blank
+  uint8_t oldest = (head + width - filled) % width;
+  for (uint8_t k = 0; k < filled; k++) {
+    uint8_t slot = (oldest + k) % width;
+    if (mode == SWEEP && k == 0 && filled == width && width > 1)
+      continue;
+    const Column &previous = ring[k == 0 ? slot : (slot + width - 1) % width];
+    uint8_t at = mode == SWEEP ? slot : width - filled + k;
+    drawColumn(buffer, x + at, ring[slot], previous);
+  }
+}
+
+bool Sparkline::fitRange(const Column &column) {
+  if (!automatic)
+    return false;
+  int32_t dataLow = column.low;
+  int32_t dataHigh = column.high;
+  for (uint8_t i = 0; i < filled; i++) {
+    if (ring[i].low < dataLow)
+      dataLow = ring[i].low;
+    if (ring[i].high > dataHigh)
+      dataHigh = ring[i].high;
+  }
+  int32_t span = dataHigh - dataLow;
+  if (span < minimumSpan)
+    span = minimumSpan;
+
+  // Grow as soon as data leaves the axis, shrink once it uses less than
+  // half of it; the new axis has an eighth of headroom at both ends
+  int32_t range = (int32_t)rangeHigh - rangeLow;
+  bool outside = dataLow < rangeLow || dataHigh > rangeHigh;
+  if (range > 0 && !outside && range <= 2 * span)
+    return false;
+  int32_t middle = (dataLow + dataHigh) / 2;
+  int32_t half = (span + span / 4) / 2 + 1;
+  rangeLow = constrain(middle - half, (int32_t)INT16_MIN, (int32_t)INT16_MAX);
+  rangeHigh = constrain(middle + half, (int32_t)INT16_MIN, (int32_t)INT16_MAX);
+  scaled++;
+  return true;
+}
+
+uint8_t Sparkline::toY(int16_t value) const {
+  int32_t bottom = pages * PAGE_HEIGHT - 1;
+  int32_t clamped = constrain((int32_t)value, (int32_t)rangeLow,
+                              (int32_t)rangeHigh);
+  return bottom - (clamped - rangeLow) * bottom / (rangeHigh - rangeLow);
+}
+
+void Sparkline::drawColumn(uint8_t *buffer, uint8_t at, const Column &column,
+                           const Column &previous) {
+  // Stretched to meet the previous column so steps stay connected
+  int16_t low = column.low < previous.high ? column.low : previous.high;
+  int16_t high = column.high > previous.low ? column.high : previous.low;
+  uint8_t top = toY(high);
+  uint8_t bottom = toY(low);
+
+  uint8_t *to = buffer + page * SCREEN_WIDTH + at;
+  for (uint8_t p = 0; p < pages; p++, to += SCREEN_WIDTH) {
+    int16_t first = top - p * PAGE_HEIGHT;
+    int16_t last = bottom - p * PAGE_HEIGHT;
+    if (last < 0 || first >= PAGE_HEIGHT) {
+      *to = 0;
+      continue;
+    }
+    if (first < 0)
+      first = 0;
+    if (last >= PAGE_HEIGHT)
+      last = PAGE_HEIGHT - 1;
+    // Bits first..last set, top pixel in bit 0
+    *to = (0xFF >> (PAGE_HEIGHT - 1 - last)) & (0xFF << first);
+  }
+}
+
+void Sparkline::blankColumn(uint8_t *buffer, uint8_t at) {
+  uint8_t *to = buffer + page * SCREEN_WIDTH + at;
+  for (uint8_t p = 0; p < pages; p++, to += SCREEN_WIDTH)
+    *to = 0;
+}
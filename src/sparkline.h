@@ -0,0 +1,74 @@
+#ifndef SPARKLINE_H
+#define SPARKLINE_H
+
+#include <Adafruit_SSD1306.h>
+#include <Arduino.h>
+
+// Scrolling plot of a sampled signal in a page-aligned box of the SSD1306
+// framebuffer. add() takes samples at any rate and folds them into the
+// min/max of the column being collected; render(), once per frame, closes
+// that column and writes it as page bytes straight into the framebuffer.
+//
+//   SWEEP   the column overwrites the oldest one and blanks the next, like
+//           an oscilloscope: two columns per page change a frame, so
+//           DisplayFlusher sends a few bytes per page
+//   SCROLL  the box moves one column left and the new one enters on the
+//           right: every column of the box changes, a full-width span
+//
+// Each column is drawn from its min to its max and stretched to meet the
+// previous one, so a fast signal shows its envelope and a slow one a
+// connected line. The Y axis follows the data unless setRange() fixed it;
+// changing the scale redraws the box from the column history.
+class Sparkline {
+public:
+  enum Mode : uint8_t { SWEEP, SCROLL };
+
+  static const uint8_t MAX_WIDTH = 128;
+
+  Sparkline();
+
+  // Box at column x, pages page..page+pages-1; clears its history
+  void begin(uint8_t x, uint8_t page, uint8_t width, uint8_t pages,
+             Mode mode = SWEEP);
+  void setRange(int16_t low, int16_t high); // fixed Y axis
+  void autoScale(int16_t minimumSpan = 16);  // Y axis follows the data
+
+  void add(int16_t sample);
+  // Draws the column collected since the last call; false (nothing drawn)
+  // when no sample came in
+  bool render(Adafruit_SSD1306 &display);
+  // Draws every column again, e.g. after the framebuffer was cleared
+  void redraw(Adafruit_SSD1306 &display);
+
+  int16_t low() const { return rangeLow; }
+  int16_t high() const { return rangeHigh; }
+  uint32_t columns() const { return closed; }
+  uint32_t rescales() const { return scaled; }
+
+private:
+  struct Column {
+    int16_t low, high;
+  };
+
+  void drawColumn(uint8_t *buffer, uint8_t at, const Column &column,
+                  const Column &previous);
+  void blankColumn(uint8_t *buffer, uint8_t at);
+  bool fitRange(const Column &column);
+  uint8_t toY(int16_t value) const;
+
+  Column ring[MAX_WIDTH];
+  uint8_t head;   // slot the next column goes to
+  uint8_t filled; // slots holding a column
+  int16_t pendingLow, pendingHigh;
+  bool pending;
+
+  Mode mode;
+  uint8_t x, page, width, pages;
+  bool automatic;
+  int16_t minimumSpan;
+  int16_t rangeLow, rangeHigh;
+  uint32_t closed;
+  uint32_t scaled;
+};
+
+#endif
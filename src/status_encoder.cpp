@@ -0,0 +1,188 @@
+#include "status_encoder.h"
+#include "workshop_strings.h"
+
+namespace {
+
+// One map level at a time; JSON needs commas, MessagePack needs the
+// entry count up front
+class MapWriter {
+public:
+  MapWriter(Print &out, bool msgpack) : out(out), msgpack(msgpack) {}
+
+  void begin(uint8_t entries) {
+    if (msgpack) {
+      out.write((uint8_t)(0x80 | entries)); // fixmap
+    } else {
+      out.print(Text::JSON_OPEN);
+    }
+    first[depth++] = true;
+  }
+
+  void end() {
+    depth--;
+    if (!msgpack)
+      out.print(Text::JSON_CLOSE);
+  }
+
+  void key(FlashString name) {
+    if (msgpack) {
+      out.write((uint8_t)(0xa0 | name.length())); // fixstr
+      out.print(name);
+      return;
+    }
+    if (!first[depth - 1])
+      out.print(Text::JSON_COMMA);
+    first[depth - 1] = false;
+    out.print(Text::JSON_QUOTE);
+    out.print(name);
+    out.print(Text::JSON_KEY_END);
+  }
+
+  void boolean(bool value) {
+    if (msgpack)
+      out.write((uint8_t)(value ? 0xc3 : 0xc2));
+    else
+      out.print(Text::jsonBool(value));
+  }
+
+  void number(uint32_t value) {
+    if (!msgpack) {
+      out.print(value);
+      return;
+    }
+    // Smallest unsigned form, big-endian
+    uint8_t bytes[5];
+    size_t n;
+    if (value < 0x80) {
+      bytes[0] = value; // positive fixint
+      n = 1;
+    } else if (value <= 0xff) {
+      bytes[0] = 0xcc;
+      bytes[1] = value;
+      n = 2;
+    } else if (value <= 0xffff) {
+      bytes[0] = 0xcd;
+      bytes[1] = value >> 8;
+      bytes[2] = value;
+      n = 3;
+    } else {
+      bytes[0] = 0xce;
+      bytes[1] = value >> 24;
+      bytes[2] = value >> 16;
+      bytes[3] = value >> 8;
+      bytes[4] = value;
+      n = 5;
+    }
+    out.write(bytes, n);
+  }
+
+private:
+  Print &out;
+  bool msgpack;
+  bool first[2];
+  uint8_t depth = 0;
+};
+
+uint8_t countBits(uint8_t value) {
+  uint8_t count = 0;
+  for (; value != 0; value &= value - 1)
+    count++;
+  return count;
+}
+
+// Exact match of text[0..length) against a flash string
+bool matches(const char *text, size_t length, FlashString name) {
+  return length == name.length() && memcmp_P(text, name.p(), length) == 0;
+}
+
+uint8_t fieldFor(const char *name, size_t length) {
+  if (matches(name, length, Text::STATUS_KEY_WIFI) ||
+      matches(name, length, Text::STATUS_SHORT_WIFI))
+    return STATUS_WIFI;
+  if (matches(name, length, Text::STATUS_KEY_UPTIME) ||
+      matches(name, length, Text::STATUS_SHORT_UPTIME))
+    return STATUS_UPTIME;
+  if (matches(name, length, Text::STATUS_KEY_FREE_HEAP) ||
+      matches(name, length, Text::STATUS_SHORT_FREE_HEAP))
+    return STATUS_FREE_HEAP;
+  if (matches(name, length, Text::STATUS_KEY_TIMESTAMP) ||
+      matches(name, length, Text::STATUS_SHORT_TIMESTAMP))
+    return STATUS_TIMESTAMP;
+
+  // leds, leds.1, leds.2 (or l, l.1, l.2)
+  const char *dot = (const char *)memchr(name, '.', length);
+  size_t base = dot != nullptr ? dot - name : length;
+  if (!matches(name, base, Text::STATUS_KEY_LEDS) &&
+      !matches(name, base, Text::STATUS_SHORT_LEDS))
+    return 0;
+  if (dot == nullptr)
+    return STATUS_LED1 | STATUS_LED2;
+  if (matches(dot + 1, length - base - 1, Text::STATUS_KEY_LED1))
+    return STATUS_LED1;
+  if (matches(dot + 1, length - base - 1, Text::STATUS_KEY_LED2))
+    return STATUS_LED2;
+  return 0;
+}
+
+} // namespace
+
+bool StatusEncoder::parseFields(const char *list, uint8_t &fields) {
+  fields = 0;
+  const char *p = list;
+  while (true) {
+    const char *comma = strchr(p, ',');
+    size_t length = comma != nullptr ? (size_t)(comma - p) : strlen(p);
+    if (length > 0) {
+      uint8_t field = fieldFor(p, length);
+      if (field == 0)
+        return false;
+      fields |= field;
+    }
+    if (comma == nullptr)
+      break;
+    p = comma + 1;
+  }
+  return fields != 0;
+}
+
+void StatusEncoder::write(Print &out, const StatusSnapshot &status,
+                          const StatusFormat &format) {
+  uint8_t fields = format.fields;
+  bool shortKeys = format.shortKeys;
+  uint8_t leds = fields & (STATUS_LED1 | STATUS_LED2);
+  MapWriter map(out, format.msgpack);
+
+  map.begin(countBits(fields & ~leds) + (leds ? 1 : 0));
+  if (fields & STATUS_WIFI) {
+    map.key(shortKeys ? Text::STATUS_SHORT_WIFI : Text::STATUS_KEY_WIFI);
+    map.boolean(status.wifiConnected);
+  }
+  if (fields & STATUS_UPTIME) {
+    map.key(shortKeys ? Text::STATUS_SHORT_UPTIME : Text::STATUS_KEY_UPTIME);
+    map.number(status.uptime);
+  }
+  if (fields & STATUS_FREE_HEAP) {
+    map.key(shortKeys ? Text::STATUS_SHORT_FREE_HEAP
+                      : Text::STATUS_KEY_FREE_HEAP);
+    map.number(status.freeHeap);
+  }
+  if (leds) {
+    map.key(shortKeys ? Text::STATUS_SHORT_LEDS : Text::STATUS_KEY_LEDS);
+    map.begin(countBits(leds));
+    if (leds & STATUS_LED1) {
+      map.key(Text::STATUS_KEY_LED1);
+      map.boolean(status.led1);
+    }
+    if (leds & STATUS_LED2) {
+      map.key(Text::STATUS_KEY_LED2);
+      map.boolean(status.led2);
+    }
+    map.end();
+  }
+  if (fields & STATUS_TIMESTAMP) {
+    map.key(shortKeys ? Text::STATUS_SHORT_TIMESTAMP
+                      : Text::STATUS_KEY_TIMESTAMP);
+    map.number(status.timestamp);
+  }
+  map.end();
+}
@@ -0,0 +1,56 @@
+#ifndef STATUS_ENCODER_H
+#define STATUS_ENCODER_H
+
+#include <Arduino.h>
+
+// Fields of /api/status, selectable with ?fields=
+enum StatusField : uint8_t {
+  STATUS_WIFI = 0x01,
+  STATUS_UPTIME = 0x02,
+  STATUS_FREE_HEAP = 0x04,
+  STATUS_LED1 = 0x08,
+  STATUS_LED2 = 0x10,
+  STATUS_TIMESTAMP = 0x20,
+  STATUS_ALL = 0x3f
+};
+
+struct StatusSnapshot {
+  bool wifiConnected;
+  uint32_t uptime; // s
+  uint32_t freeHeap;
+  bool led1;
+  bool led2;
+  uint32_t timestamp; // ms
+};
+
+// What to send and how: a field mask, short keys ("u" for "uptime", ...)
+// and JSON or MessagePack
+struct StatusFormat {
+  uint8_t fields = STATUS_ALL;
+  bool shortKeys = false;
+  bool msgpack = false;
+
+  // Distinct per format, for cache keys and ETags
+  uint8_t variant() const {
+    return fields | (shortKeys ? 0x40 : 0) | (msgpack ? 0x80 : 0);
+  }
+  bool isDefault() const { return variant() == STATUS_ALL; }
+};
+
+class StatusEncoder {
+public:
+  // Longest list naming each field once: every long name (leds.1 and
+  // leds.2 rather than leds) and the five commas between them
+  static const size_t MAX_FIELDS_LENGTH = 55;
+
+  // Comma-separated names, long or short: wifi_connected, uptime,
+  // free_heap, leds, leds.1, leds.2, timestamp. False on an unknown name.
+  static bool parseFields(const char *list, uint8_t &fields);
+
+  // Writes only the selected fields. With every field in JSON with long
+  // keys the output is the original /api/status body.
+  static void write(Print &out, const StatusSnapshot &status,
+                    const StatusFormat &format);
+};
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef TRACE_EVENTS_H
+#define TRACE_EVENTS_H
+
+#include <Arduino.h>
+
+// Trace event table: X(ID, phase, category, name, format). The device
+// records only the ID, a time delta and the raw arguments; the format
+// strings never reach the image. tools/trace_decode.py reads this file to
+// turn a dump back into text and a Chrome trace.
+//
+// Phase is B (begin), E (end, closes the latest open B) or I (instant).
+// Placeholders: %u and %x unsigned, %d signed, %s text (cut to
+// EventTrace::MAX_TEXT bytes). Arguments must match them in order.
+//
+// IDs are numbered in table order, so add new events at the end; the
+// decoder only knows events from the table it was given.
+#define WORKSHOP_TRACE_EVENTS(X)                                              \
+  X(DROPPED, I, trace, dropped, "%u events lost")                              \
+  X(HTTP_REQUEST, B, http, request, "%s %s slot %u")                           \
+  X(HTTP_RESPONSE, E, http, request, "%u, %u bytes")                           \
+  X(HTTP_REJECTED, I, http, rejected, "%u, slot %u")                           \
+  X(HTTP_PARKED, E, http, request, "parked, tag %u")                           \
+  X(HTTP_RESUMED, B, http, resume, "tag %u, timed out %u")                     \
+  X(LED_CHANGED, I, led, led, "LED %u -> %u")                                  \
+  X(DISPLAY_FLUSH, B, display, flush, "%u pages")                              \
+  X(DISPLAY_FLUSHED, E, display, flush, "")                                    \
+  X(WIFI_CONNECT, B, wifi, connect, "%s")                                      \
+  X(WIFI_CONNECTED, E, wifi, connect, "status %u after %u attempts")           \
+  X(WIFI_AP, I, wifi, ap, "%s, created %u")                                    \
+  X(WIFI_STATE, I, wifi, state, "connected %u, status %u")                     \
+  X(FRAMES_DROPPED, I, display, dropped, "%u frames")
+
+#define WORKSHOP_TRACE_ID(id, phase, category, name, format) TRACE_##id,
+enum TraceEvent : uint8_t {
+  WORKSHOP_TRACE_EVENTS(WORKSHOP_TRACE_ID) TRACE_EVENT_COUNT
+};
+#undef WORKSHOP_TRACE_ID
+
+#endif
@@ -0,0 +1,203 @@
+#include "widget_screen.h"
+
+#include <stdarg.h>
+
+namespace {
+
+const uint8_t CHAR_WIDTH = 6; // classic 5x7 font plus spacing
+const uint8_t CHAR_HEIGHT = 8;
+const uint16_t BLACK_PIXEL = 0;
+const uint16_t WHITE_PIXEL = 1;
+
+} // namespace
+
+WidgetScreen::WidgetScreen() {
+  count = 0;
+  drawn = 0;
+}
+
+uint8_t WidgetScreen::add(Kind kind, int16_t x, int16_t y, uint8_t width,
+                          uint8_t height) {
+  if (count >= CAPACITY)
+    return NONE;
+  Widget &w = widgets[count];
+  w.kind = kind;
+  w.textSize = 1;
+  w.visible = true;
+  w.dirty = true;
+  w.x = x;
+  w.y = y;
+  w.width = width;
+  w.height = height;
+  w.value = 0;
+  w.low = 0;
+  w.high = 0;
+  w.source = nullptr;
+  w.text[0] = '\0';
+  return count++;
+}
+
+uint8_t WidgetScreen::addText(int16_t x, int16_t y, uint8_t chars,
+                              uint8_t size) {
+  uint8_t fits = 255 / (CHAR_WIDTH * size); // box width is a byte
+  if (chars > fits)
+    chars = fits;
+  if (chars > TEXT_SIZE - 1)
+    chars = TEXT_SIZE - 1;
+  uint8_t id = add(TEXT, x, y, chars * CHAR_WIDTH * size, CHAR_HEIGHT * size);
+  if (id != NONE)
+    widgets[id].textSize = size;
+  return id;
+}
+
+uint8_t WidgetScreen::addValue(int16_t x, int16_t y, uint8_t chars,
+                               PGM_P format, uint8_t size) {
+  uint8_t id = addText(x, y, chars, size);
+  if (id != NONE) {
+    widgets[id].kind = VALUE;
+    widgets[id].source = format;
+    widgets[id].value = INT32_MIN; // first setValue() always differs
+  }
+  return id;
+}
+
+uint8_t WidgetScreen::addBar(int16_t x, int16_t y, uint8_t width,
+                             uint8_t height, int32_t low, int32_t high) {
+  uint8_t id = add(BAR, x, y, width, height);
+  if (id != NONE) {
+    widgets[id].low = low;
+    widgets[id].high = high > low ? high : low + 1;
+  }
+  return id;
+}
+
+uint8_t WidgetScreen::addIcon(int16_t x, int16_t y, uint8_t width,
+                              uint8_t height) {
+  return add(ICON, x, y, width, height);
+}
+
+WidgetScreen::Widget *WidgetScreen::find(uint8_t id, Kind kind) {
+  if (id >= count || widgets[id].kind != kind)
+    return nullptr;
+  return &widgets[id];
+}
+
+void WidgetScreen::storeText(Widget &w, const char *text) {
+  // Only what fits the box counts as a change
+  size_t fits = w.width / (CHAR_WIDTH * w.textSize);
+  size_t length = strnlen(text, fits);
+  if (strncmp(w.text, text, length) == 0 && w.text[length] == '\0')
+    return;
+  memcpy(w.text, text, length);
+  w.text[length] = '\0';
+  w.dirty = true;
+}
+
+void WidgetScreen::setText(uint8_t id, const char *text) {
+  Widget *w = find(id, TEXT);
+  if (w != nullptr)
+    storeText(*w, text);
+}
+
+void WidgetScreen::setText(uint8_t id, const __FlashStringHelper *text) {
+  Widget *w = find(id, TEXT);
+  if (w == nullptr)
+    return;
+  char copy[TEXT_SIZE];
+  strncpy_P(copy, (PGM_P)text, sizeof(copy) - 1);
+  copy[sizeof(copy) - 1] = '\0';
+  storeText(*w, copy);
+}
+
+void WidgetScreen::printf(uint8_t id, PGM_P format, ...) {
+  Widget *w = find(id, TEXT);
+  if (w == nullptr)
+    return;
+  char formatted[TEXT_SIZE];
+  va_list args;
+  va_start(args, format);
+  vsnprintf_P(formatted, sizeof(formatted), format, args);
+  va_end(args);
+  storeText(*w, formatted);
+}
+
+void WidgetScreen::setValue(uint8_t id, int32_t value) {
+  if (id >= count)
+    return;
+  Widget &w = widgets[id];
+  if (w.kind == BAR) {
+    // Redraw when the filled width changes, not on every value
+    int32_t clamped = constrain(value, w.low, w.high);
+    value = (int64_t)(clamped - w.low) * (w.width - 2) / (w.high - w.low);
+  } else if (w.kind != VALUE) {
+    return;
+  }
+  if (w.value == value)
+    return;
+  w.value = value;
+  w.dirty = true;
+}
+
+void WidgetScreen::setIcon(uint8_t id, const uint8_t *bitmap) {
+  Widget *w = find(id, ICON);
+  if (w == nullptr || w->source == bitmap)
+    return;
+  w->source = bitmap;
+  w->dirty = true;
+}
+
+void WidgetScreen::setVisible(uint8_t id, bool visible) {
+  if (id >= count || widgets[id].visible == visible)
+    return;
+  widgets[id].visible = visible;
+  widgets[id].dirty = true;
+}
+
+void WidgetScreen::invalidate() {
+  for (uint8_t i = 0; i < count; i++)
+    widgets[i].dirty = true;
+}
+
+uint8_t WidgetScreen::render(Adafruit_GFX &gfx) {
+  uint8_t redrawn = 0;
+  gfx.setTextWrap(false);
+  for (uint8_t i = 0; i < count; i++) {
+    Widget &w = widgets[i];
+    if (!w.dirty)
+      continue;
+    gfx.fillRect(w.x, w.y, w.width, w.height, BLACK_PIXEL);
+    if (w.visible)
+      draw(gfx, w);
+    w.dirty = false;
+    redrawn++;
+  }
+  gfx.setTextWrap(true); // the library default, other screens rely on it
+  drawn += redrawn;
+  return redrawn;
+}
+
+void WidgetScreen::draw(Adafruit_GFX &gfx, Widget &w) {
+  switch (w.kind) {
+  case VALUE:
+    snprintf_P(w.text, sizeof(w.text), (PGM_P)w.source, (long)w.value);
+    w.text[w.width / (CHAR_WIDTH * w.textSize)] = '\0';
+    // fall through
+  case TEXT:
+    gfx.setTextSize(w.textSize);
+    gfx.setTextColor(WHITE_PIXEL);
+    gfx.setCursor(w.x, w.y);
+    gfx.print(w.text);
+    break;
+  case BAR:
+    gfx.drawRect(w.x, w.y, w.width, w.height, WHITE_PIXEL);
+    if (w.value > 0)
+      gfx.fillRect(w.x + 1, w.y + 1, w.value, w.height - 2,
+                   WHITE_PIXEL);
+    break;
+  case ICON:
+    if (w.source != nullptr)
+      gfx.drawBitmap(w.x, w.y, (const uint8_t *)w.source, w.width, w.height,
+                     WHITE_PIXEL);
+    break;
+  }
+}
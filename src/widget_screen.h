@@ -0,0 +1,86 @@
+#ifndef WIDGET_SCREEN_H
+#define WIDGET_SCREEN_H
+
+#include <Adafruit_GFX.h>
+#include <Arduino.h>
+
+// Widgets one screen can hold
+#ifndef WORKSHOP_UI_WIDGETS
+#define WORKSHOP_UI_WIDGETS 14
+#endif
+
+// Retained-mode layer over the framebuffer: widgets sit at fixed places
+// and keep their last value, and render() redraws only the ones whose
+// value changed since it last ran - clear their box, then draw. With
+// DisplayFlusher skipping unchanged pages, a refresh where only the
+// uptime ticked costs one text line and one page on the bus.
+//
+//   TEXT   a string (RAM or flash), cut to what fits the box
+//   VALUE  a number through a printf format with one %ld
+//   BAR    a value between two bounds as an outlined, filled bar
+//   ICON   a PROGMEM bitmap, or nothing
+//
+// Widgets never wrap or grow; lay them out so their boxes do not overlap.
+// Fixed storage, no heap.
+class WidgetScreen {
+public:
+  static const uint8_t CAPACITY = WORKSHOP_UI_WIDGETS;
+  static const uint8_t TEXT_SIZE = 22; // 21 characters fill the 128 px row
+  static const uint8_t NONE = 0xFF;    // returned when the screen is full
+
+  WidgetScreen();
+
+  // Boxes in pixels; text widgets are `chars` characters of `size`
+  uint8_t addText(int16_t x, int16_t y, uint8_t chars, uint8_t size = 1);
+  uint8_t addValue(int16_t x, int16_t y, uint8_t chars, PGM_P format,
+                   uint8_t size = 1);
+  uint8_t addBar(int16_t x, int16_t y, uint8_t width, uint8_t height,
+                 int32_t low, int32_t high);
+  uint8_t addIcon(int16_t x, int16_t y, uint8_t width, uint8_t height);
+
+  // Each marks the widget for redraw only if what it shows changes
+  void setText(uint8_t id, const char *text);
+  void setText(uint8_t id, const __FlashStringHelper *text);
+  void printf(uint8_t id, PGM_P format, ...);
+  void setValue(uint8_t id, int32_t value); // VALUE and BAR
+  void setIcon(uint8_t id, const uint8_t *bitmap);
+  void setVisible(uint8_t id, bool visible);
+
+  // Redraws changed widgets into `gfx`; returns how many
+  uint8_t render(Adafruit_GFX &gfx);
+  // Marks every widget for redraw (framebuffer was cleared)
+  void invalidate();
+  // Removes all widgets, for laying out another screen
+  void clear() { count = 0; }
+
+  uint8_t size() const { return count; }
+  uint32_t redraws() const { return drawn; }
+
+private:
+  enum Kind : uint8_t { TEXT, VALUE, BAR, ICON };
+
+  struct Widget {
+    Kind kind;
+    uint8_t textSize;
+    bool visible;
+    bool dirty;
+    int16_t x, y;
+    uint8_t width, height;
+    int32_t value; // VALUE number, BAR fill in pixels
+    int32_t low, high;
+    const void *source; // VALUE format, ICON bitmap
+    char text[TEXT_SIZE];
+  };
+
+  uint8_t add(Kind kind, int16_t x, int16_t y, uint8_t width,
+              uint8_t height);
+  Widget *find(uint8_t id, Kind kind);
+  void storeText(Widget &w, const char *text);
+  void draw(Adafruit_GFX &gfx, Widget &w);
+
+  Widget widgets[CAPACITY];
+  uint8_t count;
+  uint32_t drawn;
+};
+
+#endif
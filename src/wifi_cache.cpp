@@ -0,0 +1,77 @@
+#include "wifi_cache.h"
+
+bool WiFiCache::load(const char *ssid, const char *password,
+                     WiFiCacheRecord &record) {
+  if (!ESP.rtcUserMemoryRead(RTC_OFFSET, (uint32_t *)&record,
+                             sizeof(record))) {
+    return false;
+  }
+
+  if (record.magic != MAGIC || record.crc != recordCRC(record)) {
+    return false;
+  }
+
+  if (record.credentialsHash != hashCredentials(ssid, password)) {
+    return false;
+  }
+
+  return record.channel != 0 && record.ip != 0;
+}
+
+void WiFiCache::save(const char *ssid, const char *password) {
+  WiFiCacheRecord record;
+  memset(&record, 0, sizeof(record));
+
+  record.magic = MAGIC;
+  record.credentialsHash = hashCredentials(ssid, password);
+  record.ip = (uint32_t)WiFi.localIP();
+  record.gateway = (uint32_t)WiFi.gatewayIP();
+  record.subnet = (uint32_t)WiFi.subnetMask();
+  record.dns = (uint32_t)WiFi.dnsIP();
+  record.channel = (uint8_t)WiFi.channel();
+
+  const uint8_t *bssid = WiFi.BSSID();
+  if (bssid != nullptr) {
+    memcpy(record.bssid, bssid, sizeof(record.bssid));
+  }
+
+  record.crc = recordCRC(record);
+  ESP.rtcUserMemoryWrite(RTC_OFFSET, (uint32_t *)&record, sizeof(record));
+}
+
+void WiFiCache::invalidate() {
+  WiFiCacheRecord record;
+  memset(&record, 0, sizeof(record));
+  ESP.rtcUserMemoryWrite(RTC_OFFSET, (uint32_t *)&record, sizeof(record));
+}
+
+uint32_t WiFiCache::hashCredentials(const char *ssid, const char *password) {
+  // FNV-1a over "ssid\0password"
+  uint32_t hash = 2166136261u;
+  for (const char *p = ssid; p != nullptr && *p; p++) {
+    hash = (hash ^ (uint8_t)*p) * 16777619u;
+  }
+  hash = (hash ^ 0) * 16777619u;
+  for (const char *p = password; p != nullptr && *p; p++) {
+    hash = (hash ^ (uint8_t)*p) * 16777619u;
+  }
+  return hash;
+}
+
+uint32_t WiFiCache::crc32(const uint8_t *data, size_t length) {
+  uint32_t crc = 0xFFFFFFFF;
+  while (length--) {
+    crc ^= *data++;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+    }
+  }
+  return ~crc;
+}
+
+uint32_t WiFiCache::recordCRC(const WiFiCacheRecord &record) {
+  // Everything after the crc field
+  const uint8_t *start = (const uint8_t *)&record.credentialsHash;
+  size_t length = sizeof(record) - offsetof(WiFiCacheRecord, credentialsHash);
+  return crc32(start, length);
+}
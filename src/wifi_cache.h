@@ -0,0 +1,47 @@
+#ifndef WIFI_CACHE_H
+#define WIFI_CACHE_H
+
+#include <Arduino.h>
+#include <ESP8266WiFi.h>
+
+// Last successful station connection, kept in RTC user memory so the next
+// boot can skip the channel scan and DHCP. RTC memory survives resets and
+// deep sleep but not a power cycle; the CRC catches garbage after power-up.
+struct WiFiCacheRecord {
+  uint32_t magic;
+  uint32_t crc;
+  uint32_t credentialsHash; // SSID + password, so a changed network misses
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint8_t reserved;
+};
+
+class WiFiCache {
+public:
+  // Returns true and fills `record` if a valid entry for these credentials
+  // is stored
+  static bool load(const char *ssid, const char *password,
+                   WiFiCacheRecord &record);
+
+  // Stores the current station connection (call only while connected)
+  static void save(const char *ssid, const char *password);
+
+  // Drops the stored entry, e.g. after the fast path failed
+  static void invalidate();
+
+private:
+  // RTC user memory offset in 4-byte blocks (first 256 bytes are left for
+  // the OTA/eboot area)
+  static const uint32_t RTC_OFFSET = 64;
+  static const uint32_t MAGIC = 0x57434331; // "WCC1"
+
+  static uint32_t hashCredentials(const char *ssid, const char *password);
+  static uint32_t crc32(const uint8_t *data, size_t length);
+  static uint32_t recordCRC(const WiFiCacheRecord &record);
+};
+
+#endif
@@ -1,238 +1,404 @@
 #include "workshop_esp.h"
+#include "workshop_strings.h"
 #include <Arduino.h>
+#include <StreamString.h>
+
+namespace {
+
+// Widget ids, in the order each screen adds them
+enum StatusWidget : uint8_t {
+  UI_STATUS_WIFI,
+  UI_STATUS_ADDRESS,
+  UI_STATUS_SIGNAL,
+  UI_STATUS_SIGNAL_BAR,
+  UI_STATUS_UPTIME,
+  UI_STATUS_HEAP,
+  UI_STATUS_RED_LABEL,
+  UI_STATUS_RED,
+  UI_STATUS_RED_ICON,
+  UI_STATUS_GREEN_LABEL,
+  UI_STATUS_GREEN,
+  UI_STATUS_GREEN_ICON
+};
+enum WelcomeWidget : uint8_t {
+  UI_WELCOME_TEAM,
+  UI_WELCOME_MEMBERS,
+  UI_WELCOME_MEMBER_1,
+  UI_WELCOME_MEMBER_2,
+  UI_WELCOME_FOOTER
+};
+enum WiFiWidget : uint8_t {
+  UI_WIFI_TITLE,
+  UI_WIFI_LINE_1,
+  UI_WIFI_LINE_2,
+  UI_WIFI_LINE_3,
+  UI_WIFI_LINE_4,
+  UI_WIFI_PROGRESS
+};
+
+// 8x8 LED indicators on the status screen
+const uint8_t LED_ON_ICON[] PROGMEM = {0x3C, 0x7E, 0xFF, 0xFF,
+                                       0xFF, 0xFF, 0x7E, 0x3C};
+const uint8_t LED_OFF_ICON[] PROGMEM = {0x3C, 0x42, 0x81, 0x81,
+                                        0x81, 0x81, 0x42, 0x3C};
+
+// RSSI span of the signal bar (dBm)
+const int32_t SIGNAL_FLOOR = -90;
+const int32_t SIGNAL_CEILING = -30;
+
+// Exactly `count` comma-separated numbers up to `max`
+bool parseNumbers(const char *text, uint16_t *values, uint8_t count,
+                  uint16_t max) {
+  for (uint8_t i = 0; i < count; i++) {
+    char *end;
+    unsigned long value = strtoul(text, &end, 10);
+    if (end == text || value > max || *end != (i + 1 < count ? ',' : 0))
+      return false;
+    values[i] = value;
+    text = end + 1;
+  }
+  return true;
+}
 
-WorkshopESP::WorkshopESP() {
+} // namespace
 
-  server = new ESP8266WebServer(80);
+WorkshopESP::WorkshopESP()
+    : webServer(80),
+      oled(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET) {
+  server = &webServer;
+  webServer.attachArena(requestArena);
+  webServer.attachLimiter(rateLimiter);
+  webServer.attachBus(bus);
+  display = &oled;
+  begun = false;
+  displayReady = false;
+  uiScreen = SCREEN_NONE;
 
-  Wire.begin(OLED_SDA, OLED_SCL);
-  display =
-      new Adafruit_SSD1306(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
+  ssid = "";
+  password = "";
 
   redLEDPin = D2;
   greenLEDPin = D3;
-  redLEDState = false;
-  greenLEDState = false;
+  bindings.setOutputHandler(writeBoundLED, this);
+  bindings.setSampleHandler(onSample, this);
+  bindings.attachBus(bus);
+  bus.subscribe(busMask(BUS_LED_CHANGED), onLEDChanged, this);
+
+  wifiConnectTime = 0;
+  wifiFastConnect = false;
+
+  memset(&leds, 0, sizeof(leds));
+  sharedLEDs.write(leds);
+  memset(&sampled, 0, sizeof(sampled));
+  sharedSamples.write(sampled);
+  wifiConnected = false;
+  statusCache.setFreshness(WORKSHOP_STATUS_FRESH_MS);
+  projectedCache.setFreshness(WORKSHOP_STATUS_FRESH_MS);
+}
+
+void WorkshopESP::begin() {
+  if (begun)
+    return;
+  begun = true;
+
+  BootTrace::Scope trace(bootTrace, Text::PHASE_BEGIN.p());
+
+  printHeapStats(Text::HEAP_BEFORE_BEGIN);
+
+  Wire.begin(OLED_SDA, OLED_SCL);
+
+  // Allocates the 1 KB framebuffer - first long-lived block on the heap
+  displayReady = display->begin(SSD1306_SWITCHCAPVCC, OLED_ADDRESS);
+  if (displayReady)
+    flusher.attach(&Wire, OLED_ADDRESS, display->getBuffer());
+
+  printHeapStats(Text::HEAP_AFTER_BEGIN);
 }
 
-WorkshopESP::~WorkshopESP() {
-  delete server;
-  if (display != nullptr)
-    delete display;
+void WorkshopESP::setDisplay(Adafruit_SSD1306 *panel) {
+  if (!begun && panel != nullptr)
+    display = panel;
 }
 
 void WorkshopESP::setupWiFi(const char *ssid, const char *password) {
+  BootTrace::Scope trace(bootTrace, Text::PHASE_SETUP_WIFI.p());
+
+  begin();
+
   this->ssid = ssid;
   this->password = password;
 
-  Serial.println("Starting WiFi setup...");
+  LOG_INFO(Text::WIFI_SETUP_START);
 
   // Display WiFi connection start
-  display->clearDisplay();
-  display->setTextSize(1);
-  display->setTextColor(SSD1306_WHITE);
-  display->setCursor(0, 0);
-  display->println("Connecting to WiFi");
-  display->setCursor(0, 15);
-  display->printf("SSID: %s", ssid);
-  display->setCursor(0, 30);
-  display->println("Initializing...");
-  display->display();
+  enterWiFiScreen();
+  ui.setText(UI_WIFI_TITLE, Text::WIFI_CONNECTING);
+  ui.printf(UI_WIFI_LINE_1, Text::FMT_SSID.p(), ssid);
+  ui.setText(UI_WIFI_LINE_2, Text::INITIALIZING);
+  ui.setText(UI_WIFI_LINE_3, "");
+  ui.setText(UI_WIFI_LINE_4, "");
+  ui.setVisible(UI_WIFI_PROGRESS, false);
+  renderScreen(true);
+
+  unsigned long connectStart = millis();
+  bootTrace.beginPhase(Text::PHASE_WIFI_CONNECT.p());
+  TRACE(WIFI_CONNECT, ssid);
 
   // Set WiFi mode and disconnect any existing connection
   WiFi.mode(WIFI_STA);
   WiFi.disconnect();
   delay(100);
 
-  Serial.println("WiFi mode set to STA");
+  LOG_DEBUG(Text::WIFI_MODE_STA);
 
-  // Begin WiFi connection with timeout
-  WiFi.begin(ssid, password);
-  Serial.println("WiFi.begin() called");
+  // Try the cached channel/BSSID/IP first, fall back to a full scan + DHCP
+  wifiFastConnect = connectWiFiFast(ssid, password);
+
+  if (!wifiFastConnect) {
+    // Begin WiFi connection with timeout
+    WiFi.begin(ssid, password);
+    LOG_DEBUG(Text::WIFI_BEGIN_CALLED);
+  }
 
   int attempts = 0;
   int maxAttempts = 10; // Reduced attempts to prevent hanging
 
   while (WiFi.status() != WL_CONNECTED && attempts < maxAttempts) {
     delay(1000); // Increased delay for stability
-    Serial.printf("WiFi status: %d, attempt %d/%d\n", WiFi.status(),
-                  attempts + 1, maxAttempts);
+    LOGF_INFO(Text::FMT_WIFI_ATTEMPT.p(), WiFi.status(), attempts + 1,
+              maxAttempts);
+    workshopLog.flush();
 
     // Update display with connection progress
-    display->setCursor(0, 45);
-    display->printf("Attempt %d/%d", attempts + 1, maxAttempts);
-    display->setCursor(0, 55);
-    display->print("Connecting");
-    for (int i = 0; i < (attempts % 3); i++) {
-      display->print(".");
-    }
-    display->display();
+    char dots[3];
+    memset(dots, '.', attempts % 3);
+    dots[attempts % 3] = '\0';
+    ui.printf(UI_WIFI_LINE_3, Text::FMT_ATTEMPT.p(), attempts + 1, maxAttempts);
+    ui.printf(UI_WIFI_LINE_4, Text::FMT_CONNECTING.p(), dots);
+    ui.setValue(UI_WIFI_PROGRESS, (attempts + 1) * 100 / maxAttempts);
+    ui.setVisible(UI_WIFI_PROGRESS, true);
+    renderScreen(true);
 
     attempts++;
 
     // Check for watchdog reset
     if (attempts % 3 == 0) {
-      Serial.println("Checking system stability...");
+      LOG_DEBUG(Text::STABILITY_CHECK);
       yield(); // Allow other tasks to run
     }
   }
 
+  wifiConnectTime = millis() - connectStart;
+  bootTrace.endPhase();
+  TRACE(WIFI_CONNECTED, (unsigned)WiFi.status(), attempts);
+
   if (WiFi.status() == WL_CONNECTED) {
-    Serial.println("\nWiFi Connected Successfully!");
-    Serial.print("IP Address: ");
-    Serial.println(WiFi.localIP());
-    Serial.print("MAC Address: ");
-    Serial.println(WiFi.macAddress());
-    Serial.print("Signal Strength: ");
-    Serial.print(WiFi.RSSI());
-    Serial.println(" dBm");
+    WiFiCache::save(ssid, password);
+
+    LOG_INFO(Text::WIFI_CONNECTED_LOG);
+    LOGF_INFO(Text::FMT_CONNECT_TIME.p(), wifiConnectTime);
+    LOG_INFO(wifiFastConnect ? Text::WIFI_PATH_CACHED
+                             : Text::WIFI_PATH_FULL_SCAN);
+    LOG_INFO(Text::IP_ADDRESS_LABEL, WiFi.localIP());
+    LOG_INFO(Text::MAC_ADDRESS_LABEL, WiFi.macAddress());
+    LOG_INFO(Text::SIGNAL_LABEL, WiFi.RSSI(), Text::DBM);
 
     // Display success message
-    display->clearDisplay();
-    display->setTextSize(1);
-    display->setTextColor(SSD1306_WHITE);
-    display->setCursor(0, 0);
-    display->println("WiFi Connected!");
-    display->setCursor(0, 15);
-    display->printf("IP: %s", WiFi.localIP().toString().c_str());
-    display->setCursor(0, 30);
-    display->printf("Signal: %d dBm", WiFi.RSSI());
-    display->setCursor(0, 45);
-    display->println("Ready for workshop!");
-    display->display();
+    enterWiFiScreen();
+    ui.setText(UI_WIFI_TITLE, Text::WIFI_CONNECTED);
+    ui.printf(UI_WIFI_LINE_1, Text::FMT_IP.p(),
+              WiFi.localIP().toString().c_str());
+    ui.printf(UI_WIFI_LINE_2, Text::FMT_SIGNAL.p(), WiFi.RSSI());
+    ui.setText(UI_WIFI_LINE_3, Text::READY_FOR_WORKSHOP);
+    ui.setText(UI_WIFI_LINE_4, "");
+    ui.setVisible(UI_WIFI_PROGRESS, false);
+    renderScreen(true);
     delay(2000);
 
   } else {
-    Serial.println("\nWiFi Connection Failed!");
-    Serial.printf("Final WiFi status: %d\n", WiFi.status());
+    LOG_WARN(Text::WIFI_FAILED_LOG);
+    LOGF_WARN(Text::FMT_FINAL_WIFI_STATUS.p(), WiFi.status());
 
     // Display failure message
-    display->clearDisplay();
-    display->setTextSize(1);
-    display->setTextColor(SSD1306_WHITE);
-    display->setCursor(0, 0);
-    display->println("WiFi Failed!");
-    display->setCursor(0, 15);
-    display->printf("Status: %d", WiFi.status());
-    display->setCursor(0, 30);
-    display->println("Continuing offline");
-    display->setCursor(0, 45);
-    display->println("Check network");
-    display->display();
+    enterWiFiScreen();
+    ui.setText(UI_WIFI_TITLE, Text::WIFI_FAILED);
+    ui.printf(UI_WIFI_LINE_1, Text::FMT_STATUS.p(), WiFi.status());
+    ui.setText(UI_WIFI_LINE_2, Text::CONTINUING_OFFLINE);
+    ui.setText(UI_WIFI_LINE_3, Text::CHECK_NETWORK);
+    ui.setText(UI_WIFI_LINE_4, "");
+    ui.setVisible(UI_WIFI_PROGRESS, false);
+    renderScreen(true);
     delay(2000);
   }
 
-  Serial.println("WiFi setup complete");
+  trackWiFiState();
+  LOG_INFO(Text::WIFI_SETUP_DONE);
+  workshopLog.flush(); // setup may wait on the UART
+}
+
+bool WorkshopESP::connectWiFiFast(const char *ssid, const char *password) {
+  BootTrace::Scope trace(bootTrace, Text::PHASE_WIFI_FAST_CONNECT.p());
+
+  WiFiCacheRecord cached;
+  if (!WiFiCache::load(ssid, password, cached)) {
+    LOG_INFO(Text::WIFI_NO_CACHE);
+    return false;
+  }
+
+  LOGF_INFO(Text::FMT_FAST_CONNECT.p(), cached.channel,
+            IPAddress(cached.ip).toString().c_str());
+
+  // Static IP skips DHCP, channel + BSSID skip the scan
+  WiFi.config(IPAddress(cached.ip), IPAddress(cached.gateway),
+              IPAddress(cached.subnet), IPAddress(cached.dns));
+  WiFi.begin(ssid, password, cached.channel, cached.bssid);
+
+  unsigned long start = millis();
+  while (WiFi.status() != WL_CONNECTED &&
+         millis() - start < WIFI_FAST_CONNECT_TIMEOUT) {
+    delay(10);
+  }
+
+  if (WiFi.status() == WL_CONNECTED) {
+    return true;
+  }
+
+  // AP moved channel or lease is gone - forget it and go back to DHCP
+  LOG_WARN(Text::FAST_CONNECT_FAILED);
+  WiFiCache::invalidate();
+  WiFi.disconnect();
+  WiFi.config(IPAddress(0, 0, 0, 0), IPAddress(0, 0, 0, 0),
+              IPAddress(0, 0, 0, 0));
+  return false;
 }
 
 void WorkshopESP::setupWiFiAP(const char *apSSID, const char *apPassword) {
+  BootTrace::Scope trace(bootTrace, Text::PHASE_SETUP_WIFI_AP.p());
+
+  begin();
+
   this->ssid = apSSID;
   this->password = apPassword;
 
-  Serial.println("Creating WiFi Access Point...");
+  LOG_INFO(Text::AP_SETUP_START);
 
   // Display AP creation start
-  display->clearDisplay();
-  display->setTextSize(1);
-  display->setTextColor(SSD1306_WHITE);
-  display->setCursor(0, 0);
-  display->println("Creating AP");
-  display->setCursor(0, 15);
-  display->printf("SSID: %s", apSSID);
-  display->setCursor(0, 30);
-  display->println("Initializing...");
-  display->display();
+  enterWiFiScreen();
+  ui.setText(UI_WIFI_TITLE, Text::AP_CREATING);
+  ui.printf(UI_WIFI_LINE_1, Text::FMT_SSID.p(), apSSID);
+  ui.setText(UI_WIFI_LINE_2, Text::INITIALIZING);
+  ui.setText(UI_WIFI_LINE_3, "");
+  ui.setText(UI_WIFI_LINE_4, "");
+  ui.setVisible(UI_WIFI_PROGRESS, false);
+  renderScreen(true);
 
   // Set WiFi mode to Access Point
   WiFi.mode(WIFI_AP);
   delay(100);
 
-  Serial.println("WiFi mode set to AP");
+  LOG_DEBUG(Text::WIFI_MODE_AP);
 
   // Create Access Point
   bool apCreated = WiFi.softAP(apSSID, apPassword);
+  TRACE(WIFI_AP, apSSID, apCreated);
 
   if (apCreated) {
-    Serial.println("\nAccess Point Created Successfully!");
-    Serial.print("AP IP Address: ");
-    Serial.println(WiFi.softAPIP());
-    Serial.println("Connect to: " + String(apSSID));
-    Serial.println("No password required!");
-    Serial.println("Dashboard: http://192.168.4.1");
+    LOG_INFO(Text::AP_CREATED_LOG);
+    LOG_INFO(Text::AP_IP_LABEL, WiFi.softAPIP());
+    LOG_INFO(Text::CONNECT_TO_LABEL, apSSID);
+    LOG_INFO(Text::NO_PASSWORD_LOG);
+    LOG_INFO(Text::AP_DASHBOARD_URL);
 
     // Display success message
-    display->clearDisplay();
-    display->setTextSize(1);
-    display->setTextColor(SSD1306_WHITE);
-    display->setCursor(0, 0);
-    display->println("AP Created!");
-    display->setCursor(0, 15);
-    display->printf("SSID: %s", apSSID);
-    display->setCursor(0, 30);
-    display->printf("IP: %s", WiFi.softAPIP().toString().c_str());
-    display->setCursor(0, 45);
-    display->println("No password!");
-    display->setCursor(0, 55);
-    display->println("Ready!");
-    display->display();
+    enterWiFiScreen();
+    ui.setText(UI_WIFI_TITLE, Text::AP_CREATED);
+    ui.printf(UI_WIFI_LINE_1, Text::FMT_SSID.p(), apSSID);
+    ui.printf(UI_WIFI_LINE_2, Text::FMT_IP.p(),
+              WiFi.softAPIP().toString().c_str());
+    ui.setText(UI_WIFI_LINE_3, Text::NO_PASSWORD);
+    ui.setText(UI_WIFI_LINE_4, Text::READY);
+    ui.setVisible(UI_WIFI_PROGRESS, false);
+    renderScreen(true);
     delay(2000);
 
   } else {
-    Serial.println("\nAccess Point Creation Failed!");
+    LOG_WARN(Text::AP_FAILED_LOG);
 
     // Display failure message
-    display->clearDisplay();
-    display->setTextSize(1);
-    display->setTextColor(SSD1306_WHITE);
-    display->setCursor(0, 0);
-    display->println("AP Failed!");
-    display->setCursor(0, 15);
-    display->println("Check settings");
-    display->setCursor(0, 30);
-    display->println("Continuing offline");
-    display->display();
+    enterWiFiScreen();
+    ui.setText(UI_WIFI_TITLE, Text::AP_FAILED);
+    ui.setText(UI_WIFI_LINE_1, Text::CHECK_SETTINGS);
+    ui.setText(UI_WIFI_LINE_2, Text::CONTINUING_OFFLINE);
+    ui.setText(UI_WIFI_LINE_3, "");
+    ui.setText(UI_WIFI_LINE_4, "");
+    ui.setVisible(UI_WIFI_PROGRESS, false);
+    renderScreen(true);
     delay(2000);
   }
 
-  Serial.println("WiFi AP setup complete");
+  trackWiFiState();
+  LOG_INFO(Text::AP_SETUP_DONE);
+  workshopLog.flush();
 }
 
 void WorkshopESP::setupWebServer() {
+  BootTrace::Scope trace(bootTrace, Text::PHASE_SETUP_WEB_SERVER.p());
+
   // Root page
-  server->on("/", [this]() { handleRoot(); });
+  server->on(Text::URI_ROOT.f(), [this]() { handleRoot(); });
 
   // API endpoints
-  server->on("/api/status", [this]() { handleStatus(); });
-  server->on("/api/led/1/toggle", HTTP_POST, [this]() {
-    toggleLED(1);
-    server->send(200, "application/json", getSystemStatusJSON());
-  });
-  server->on("/api/led/2/toggle", HTTP_POST, [this]() {
-    toggleLED(2);
-    server->send(200, "application/json", getSystemStatusJSON());
-  });
-  server->on("/api/led/1/state", HTTP_POST, [this]() { handleLEDState(); });
-  server->on("/api/led/2/state", HTTP_POST, [this]() { handleLEDState(); });
+  server->on(Text::URI_STATUS.f(), [this]() { handleStatus(); });
+  server->on(Text::URI_BOOT.f(), HTTP_GET, [this]() { handleBoot(); });
+  server->on(Text::URI_LED1_TOGGLE.f(), HTTP_POST,
+             [this]() { handleLEDToggle(); });
+  server->on(Text::URI_LED2_TOGGLE.f(), HTTP_POST,
+             [this]() { handleLEDToggle(); });
+  server->on(Text::URI_LED1_STATE.f(), HTTP_POST,
+             [this]() { handleLEDState(); });
+  server->on(Text::URI_LED2_STATE.f(), HTTP_POST,
+             [this]() { handleLEDState(); });
+  server->on(Text::URI_LEDS_WAIT.f(), HTTP_GET, [this]() { handleLEDWait(); });
+  server->on(Text::URI_TRACE.f(), HTTP_GET, [this]() { handleTrace(); });
+  server->on(Text::URI_BINDINGS.f(), HTTP_GET, [this]() { handleBindings(); });
+  server->on(Text::URI_BINDINGS.f(), HTTP_POST,
+             [this]() { handleBindingSet(); });
+#if WORKSHOP_RECORD
+  server->on(Text::URI_RECORD.f(), HTTP_GET, [this]() { handleRecord(); });
+  workshopRecorder.ignorePath(Text::URI_RECORD.p());
+#endif
+  server->onResume(
+      [this](uint32_t since, bool) { sendLEDWait(since != generation()); });
 
   // 404 handler
   server->onNotFound([this]() { handleNotFound(); });
 
+  static const char *collect[] = {Text::HTTP_IF_NONE_MATCH_P,
+                                  Text::HTTP_ACCEPT_P};
+  server->collectHeaders(collect, 2);
+
   server->begin();
-  Serial.println("Web server started");
+  LOG_INFO(Text::WEB_SERVER_STARTED);
+  workshopLog.flush();
 }
 
 void WorkshopESP::setupDisplay() {
-  Serial.println("Initializing OLED display...");
-  Serial.printf("Using SDA: D%d (GPIO%d), SCL: D%d (GPIO%d)\n", OLED_SDA,
-                OLED_SDA, OLED_SCL, OLED_SCL);
-
-  if (!display->begin(SSD1306_SWITCHCAPVCC, 0x3C)) {
-    Serial.println("SSD1306 allocation failed - Check wiring!");
-    Serial.println("Make sure OLED is connected to:");
-    Serial.printf("  SDA -> D%d (GPIO%d)\n", OLED_SDA, OLED_SDA);
-    Serial.printf("  SCL -> D%d (GPIO%d)\n", OLED_SCL, OLED_SCL);
-    Serial.println("  VCC -> 3.3V");
-    Serial.println("  GND -> GND");
+  BootTrace::Scope trace(bootTrace, Text::PHASE_SETUP_DISPLAY.p());
+
+  begin();
+
+  LOG_INFO(Text::OLED_INIT);
+  LOGF_DEBUG(Text::FMT_DISPLAY_PINS.p(), OLED_SDA, OLED_SDA, OLED_SCL,
+             OLED_SCL);
+
+  if (!displayReady) {
+    LOG_WARN(Text::OLED_FAILED);
+    LOG_WARN(Text::OLED_WIRING);
+    LOGF_WARN(Text::FMT_WIRING_SDA.p(), OLED_SDA, OLED_SDA);
+    LOGF_WARN(Text::FMT_WIRING_SCL.p(), OLED_SCL, OLED_SCL);
+    LOG_WARN(Text::WIRING_VCC);
+    LOG_WARN(Text::WIRING_GND);
+    workshopLog.flush();
     return;
   }
 
@@ -240,62 +406,104 @@ void WorkshopESP::setupDisplay() {
   display->setTextSize(1);
   display->setTextColor(SSD1306_WHITE);
   display->setCursor(0, 0);
-  display->println("IoT Workshop");
-  display->println("Initializing...");
-  display->display();
+  display->println(Text::IOT_WORKSHOP);
+  display->println(Text::INITIALIZING);
+  flushDisplay();
 
-  Serial.println("OLED Display initialized successfully!");
+  LOG_INFO(Text::OLED_READY);
+  workshopLog.flush();
 }
 
 void WorkshopESP::setupLEDs() {
+  BootTrace::Scope trace(bootTrace, Text::PHASE_SETUP_LEDS.p());
+
   pinMode(redLEDPin, OUTPUT);
   pinMode(greenLEDPin, OUTPUT);
 
   digitalWrite(redLEDPin, LOW);
   digitalWrite(greenLEDPin, LOW);
+  bindings.begin();
 
-  Serial.println("LEDs initialized");
+  LOG_INFO(Text::LEDS_READY);
+  workshopLog.flush();
 }
 
 void WorkshopESP::start() {
-  setupWiFi(ssid, password);
-  setupWebServer();
-  setupDisplay();
-  setupLEDs();
-
-  Serial.println("WorkshopESP initialized successfully!");
-  displayMessage("Ready for Workshop!", false);
+  {
+    BootTrace::Scope trace(bootTrace, Text::PHASE_START.p());
+    begin();
+    setupWiFi(ssid, password);
+    setupWebServer();
+    setupDisplay();
+    setupLEDs();
+
+    LOG_INFO(Text::LIBRARY_READY);
+    displayMessage(Text::READY_FOR_WORKSHOP_BANNER, false);
+  }
+  bootTrace.ready(workshopLog);
+  workshopLog.flush();
 }
 
 void WorkshopESP::toggleLED(int ledNumber) {
   if (ledNumber == 1) {
-    redLEDState = !redLEDState;
-    digitalWrite(redLEDPin, redLEDState);
-    Serial.printf("Red LED toggled to: %s\n", redLEDState ? "ON" : "OFF");
+    bool on = !leds.led[0];
+    digitalWrite(redLEDPin, on);
+    TRACE(LED_CHANGED, 1, on);
+    LOG_INFO(Text::RED_LED_TOGGLED, Text::onOff(on));
+    storeLED(1, on);
   } else if (ledNumber == 2) {
-    greenLEDState = !greenLEDState;
-    digitalWrite(greenLEDPin, greenLEDState);
-    Serial.printf("Green LED toggled to: %s\n", greenLEDState ? "ON" : "OFF");
+    bool on = !leds.led[1];
+    digitalWrite(greenLEDPin, on);
+    TRACE(LED_CHANGED, 2, on);
+    LOG_INFO(Text::GREEN_LED_TOGGLED, Text::onOff(on));
+    storeLED(2, on);
   }
 }
 
 void WorkshopESP::setLED(int ledNumber, bool state) {
   if (ledNumber == 1) {
-    redLEDState = state;
     digitalWrite(redLEDPin, state);
-    Serial.printf("Red LED set to: %s\n", state ? "ON" : "OFF");
+    TRACE(LED_CHANGED, 1, state);
+    LOG_INFO(Text::RED_LED_SET, Text::onOff(state));
+    storeLED(1, state);
   } else if (ledNumber == 2) {
-    greenLEDState = state;
     digitalWrite(greenLEDPin, state);
-    Serial.printf("Green LED set to: %s\n", state ? "ON" : "OFF");
+    TRACE(LED_CHANGED, 2, state);
+    LOG_INFO(Text::GREEN_LED_SET, Text::onOff(state));
+    storeLED(2, state);
+  }
+}
+
+void WorkshopESP::storeLED(int ledNumber, bool on) {
+  leds.led[ledNumber - 1] = on;
+  leds.generation++;
+  sharedLEDs.write(leds);
+  bus.publish(LedChanged{(uint8_t)ledNumber, on});
+}
+
+int WorkshopESP::ledPin(int ledNumber) const {
+  return ledNumber == 1 ? redLEDPin : greenLEDPin;
+}
+
+void WorkshopESP::writeBoundLED(void *context,
+                                const AnalogBindings::Binding &binding,
+                                uint16_t value) {
+  WorkshopESP *self = static_cast<WorkshopESP *>(context);
+  // setLED() writes the loop-owned LedState, so a switch binding needs
+  // tick() to stay in loop(); levels only touch the sampler's state
+  if (binding.mode == AnalogBindings::MODE_SWITCH)
+    self->setLED(binding.output, value != 0); // logged, traced, reported
+  else
+    analogWrite(self->ledPin(binding.output), value);
+  if (binding.mode == AnalogBindings::MODE_LEVEL) {
+    self->sampled.level[binding.output - 1] = value;
+    self->sharedSamples.write(self->sampled);
   }
 }
 
 bool WorkshopESP::getLEDState(int ledNumber) {
-  if (ledNumber == 1)
-    return redLEDState;
-  if (ledNumber == 2)
-    return greenLEDState;
+  if (ledNumber == 1 || ledNumber == 2)
+    return leds.led[ledNumber - 1];
   return false;
 }
 
@@ -306,51 +514,73 @@ bool WorkshopESP::getLEDState(int ledNumber) {
 
 void WorkshopESP::displayWelcome(const char *teamName, const char *member1,
                                  const char *member2) {
-  display->clearDisplay();
-  display->setTextSize(2);
-  display->setTextColor(SSD1306_WHITE);
-  display->setCursor(0, 0);
-  display->println(teamName);
-
-  display->setTextSize(1);
-  display->setCursor(0, 20);
-  display->println("Members:");
-  display->setCursor(0, 30);
-  display->println(member1);
-  display->setCursor(0, 40);
-  display->println(member2);
-
-  display->setCursor(0, 55);
-  display->println("Welcome");
-
-  display->display();
+  if (enterScreen(SCREEN_WELCOME)) {
+    ui.addText(0, 0, 10, 2);
+    ui.addText(0, 20, 21);
+    ui.addText(0, 30, 21);
+    ui.addText(0, 40, 21);
+    ui.addText(0, 55, 21);
+    ui.setText(UI_WELCOME_MEMBERS, Text::MEMBERS);
+    ui.setText(UI_WELCOME_FOOTER, Text::WELCOME);
+  }
+  ui.setText(UI_WELCOME_TEAM, teamName);
+  ui.setText(UI_WELCOME_MEMBER_1, member1);
+  ui.setText(UI_WELCOME_MEMBER_2, member2);
+  renderScreen(true);
 }
 
 void WorkshopESP::displayStatus() {
-  display->clearDisplay();
-  display->setTextSize(1);
-  display->setTextColor(SSD1306_WHITE);
+  if (enterScreen(SCREEN_STATUS)) {
+    ui.addText(0, 0, 21);
+    ui.addText(0, 8, 21);
+    ui.addValue(0, 16, 16, Text::FMT_STATUS_SIGNAL.p());
+    ui.addBar(100, 17, 28, 6, SIGNAL_FLOOR, SIGNAL_CEILING);
+    ui.addValue(0, 24, 21, Text::FMT_STATUS_UPTIME.p());
+    ui.addValue(0, 32, 21, Text::FMT_STATUS_FREE_HEAP.p());
+    ui.addText(0, 40, 9);
+    ui.addText(54, 40, 3);
+    ui.addIcon(120, 40, 8, 8);
+    ui.addText(0, 48, 11);
+    ui.addText(66, 48, 3);
+    ui.addIcon(120, 48, 8, 8);
+    ui.setText(UI_STATUS_RED_LABEL, Text::RED_LED_LABEL);
+    ui.setText(UI_STATUS_GREEN_LABEL, Text::GREEN_LED_LABEL);
+  }
 
-  display->setCursor(0, 0);
-  if (WiFi.status() == WL_CONNECTED) {
-    display->printf("WiFi: Connected\n");
-    display->printf("IP: %s\n", WiFi.localIP().toString().c_str());
-    display->printf("Signal: %d dBm\n", WiFi.RSSI());
+  bool connected = WiFi.status() == WL_CONNECTED;
+  if (connected) {
+    ui.setText(UI_STATUS_WIFI, Text::STATUS_WIFI_CONNECTED);
+    ui.printf(UI_STATUS_ADDRESS, Text::FMT_IP.p(),
+              WiFi.localIP().toString().c_str());
+    int32_t rssi = WiFi.RSSI();
+    ui.setValue(UI_STATUS_SIGNAL, rssi);
+    ui.setValue(UI_STATUS_SIGNAL_BAR, rssi);
   } else {
-    display->printf("WiFi: Disconnected\n");
-    display->printf("SSID: %s\n", ssid);
+    ui.setText(UI_STATUS_WIFI, Text::STATUS_WIFI_DISCONNECTED);
+    ui.printf(UI_STATUS_ADDRESS, Text::FMT_SSID.p(), ssid);
   }
-  display->printf("Uptime: %lu s\n", millis() / 1000);
-  display->printf("Free Heap: %u\n", ESP.getFreeHeap());
-  display->printf("Red LED: %s\n", redLEDState ? "ON" : "OFF");
-  display->printf("Green LED: %s\n", greenLEDState ? "ON" : "OFF");
-
-  display->display();
+  ui.setVisible(UI_STATUS_SIGNAL, connected);
+  ui.setVisible(UI_STATUS_SIGNAL_BAR, connected);
+  ui.setValue(UI_STATUS_UPTIME, millis() / 1000);
+  ui.setValue(UI_STATUS_HEAP, ESP.getFreeHeap());
+  showLEDs();
+
+  // Refreshed from loop(): handleClient() sends it in slices
+  renderScreen(false);
 }
 
 void WorkshopESP::displayMessage(const char *message, bool header) {
-  if (display == nullptr) {
-    Serial.println("Display disabled - message: " + String(message));
+  showMessage(message, header);
+}
+
+void WorkshopESP::displayMessage(const __FlashStringHelper *message,
+                                 bool header) {
+  showMessage(message, header);
+}
+
+template <typename T> void WorkshopESP::showMessage(T message, bool header) {
+  if (!displayReady) {
+    LOG_INFO(Text::DISPLAY_DISABLED, message);
     return;
   }
 
@@ -359,34 +589,46 @@ void WorkshopESP::displayMessage(const char *message, bool header) {
   display->setTextColor(SSD1306_WHITE);
   display->setCursor(0, 0);
   display->println(message);
-  display->display();
+  flushDisplay();
 }
 
 void WorkshopESP::animateHello(const char *teamName) {
+  BootTrace::Scope trace(bootTrace, Text::PHASE_ANIMATE_HELLO.p());
+
+  FrameClock &clock = animationClock;
+  clock.restart();
   for (int i = 0; i < 3; i++) {
     display->clearDisplay();
-    display->setTextSize(2);
-    display->setTextColor(SSD1306_WHITE);
     display->setCursor(0, 20);
-    display->println("Hello");
+    printGlyphs(Text::HELLO, 2);
     display->setCursor(0, 40);
-    display->println(teamName);
-    display->display();
-    delay(500);
+    printGlyphs(teamName, 2);
+    flushDisplay();
+    clock.hold(500);
 
     display->clearDisplay();
-    display->display();
-    delay(200);
+    flushDisplay();
+    clock.hold(200);
   }
+  logFrames();
+}
+
+void WorkshopESP::logFrames() {
+  LOGF_INFO(Text::FMT_ANIMATION_FRAMES.p(), animationClock.frames(),
+            animationClock.dropped(), animationClock.achievedFps(),
+            animationClock.worstFrameMicros());
 }
 
 void WorkshopESP::animateTeamWelcome(const char *teamName) {
+  BootTrace::Scope trace(bootTrace, Text::PHASE_TEAM_WELCOME.p());
+
   // Animate "Hello" message
   animateHello(teamName);
 
   // Display welcome message
-  displayWelcome(teamName, "Member 1", "Member 2");
-  delay(3000);
+  displayWelcome(teamName, String(Text::MEMBER_1).c_str(),
+                 String(Text::MEMBER_2).c_str());
+  animationClock.hold(3000);
 
   // Show status
   displayStatus();
@@ -396,134 +638,138 @@ void WorkshopESP::playCompleteAnimation(const char *teamName,
                                         const char *member1,
                                         const char *member2,
                                         const char *member3) {
-  Serial.println("Starting animation sequence...");
+  BootTrace::Scope trace(bootTrace, Text::PHASE_COMPLETE_ANIMATION.p());
+
+  LOG_INFO(Text::ANIMATION_START);
+  workshopLog.flush();
+
+  // Frames keep to their times whatever drawing and flushing take; a
+  // sequence that falls behind skips steps
+  FrameClock &clock = animationClock;
+  clock.restart();
 
   // Phase 1: Boot sequence with loading bars
   display->clearDisplay();
-  display->setTextSize(2); // Bigger text
   display->setTextColor(SSD1306_WHITE);
   display->setCursor(0, 0);
-  display->println("IoT Workshop");
+  printGlyphs(Text::IOT_WORKSHOP, 2); // Bigger text
   display->setCursor(0, 20);
-  display->println("Initializing...");
+  printGlyphs(Text::INITIALIZING, 2);
 
-  // Animated loading bar
-  for (int i = 0; i <= 100; i += 5) {
+  // Animated loading bar, 10 fps
+  clock.setFps(10);
+  for (uint32_t step = 0; step <= 20; step = clock.advance(step, 20)) {
+    int i = step * 5;
     display->setTextSize(1); // Smaller for loading text
     display->setCursor(0, 40);
-    display->printf("Loading: %d%%", i);
+    display->printf_P(Text::FMT_LOADING.p(), i);
     display->setCursor(0, 50);
-    display->print("[");
+    display->print(Text::BAR_OPEN);
     for (int j = 0; j < 20; j++) {
       if (j < (i / 5)) {
-        display->print("=");
+        display->print(Text::BAR_FILL);
       } else {
-        display->print(" ");
+        display->print(Text::BAR_EMPTY);
       }
     }
-    display->print("]");
-    display->display();
-    delay(100);
+    display->print(Text::BAR_CLOSE);
+    flushDisplay();
   }
 
-  delay(1000);
+  clock.hold(1000);
 
   // Phase 2: Matrix-style text effect
-  const char *matrixText[] = {"IoT Workshop"};
+  clock.setPeriodMs(150);
+  const FlashString matrixText[] = {Text::IOT_WORKSHOP};
+  const int matrixLines = sizeof(matrixText) / sizeof(matrixText[0]);
   for (int phase = 0; phase < 2; phase++) {
-    for (int i = 0; i < 3; i++) {
+    for (int i = 0; i < matrixLines; i++) {
       display->clearDisplay();
-      display->setTextSize(2); // Bigger text
-      display->setTextColor(SSD1306_WHITE);
 
       // Typewriter effect
-      String text = matrixText[i];
-      for (int j = 0; j <= text.length(); j++) {
+      size_t length = matrixText[i].length();
+      for (size_t j = 0; j <= length; j = clock.advance(j, length)) {
         display->setCursor(0, 25);
-        display->print(text.substring(0, j));
+        printGlyphs(matrixText[i], 2, j); // Bigger text
         display->setCursor(0, 45);
-        display->print("_");
-        display->display();
-        delay(150);
+        printGlyphs(Text::CURSOR, 2);
+        flushDisplay();
       }
-      delay(500);
+      clock.hold(500);
     }
   }
 
   // Phase 3: Pulsing welcome
   for (int pulse = 0; pulse < 5; pulse++) {
     display->clearDisplay();
-    display->setTextSize(3); // Bigger welcome text
-    display->setTextColor(SSD1306_WHITE);
     display->setCursor(0, 25);
-    display->println("Welcome!");
-    display->display();
-    delay(300);
+    printGlyphs(Text::WELCOME_BANNER, 3); // Bigger welcome text
+    flushDisplay();
+    clock.hold(300);
 
     display->clearDisplay();
-    display->display();
-    delay(200);
+    flushDisplay();
+    clock.hold(200);
   }
 
   // Phase 4: Team introduction with style
   display->clearDisplay();
-  display->setTextSize(3); // Big team name
-  display->setTextColor(SSD1306_WHITE);
   display->setCursor(0, 0);
-  display->println(teamName);
+  printGlyphs(teamName, 3); // Big team name
 
   display->setTextSize(1); // Small member text to fit screen
+  display->setTextColor(SSD1306_WHITE);
   display->setCursor(0, 25);
-  display->println("Members:");
+  display->println(Text::MEMBERS);
   display->setCursor(0, 35);
-  display->printf("-- %s", member1);
+  display->printf_P(Text::FMT_MEMBER.p(), member1);
   display->setCursor(0, 45);
-  display->printf("-- %s", member2);
+  display->printf_P(Text::FMT_MEMBER.p(), member2);
   display->setCursor(0, 55);
-  display->printf("-- %s", member3);
-  display->display();
-  delay(30000); // Show all members for 30 seconds
+  display->printf_P(Text::FMT_MEMBER.p(), member3);
+  flushDisplay();
+  clock.hold(30000); // Show all members for 30 seconds
 
   // Phase 5: LED light show
   display->clearDisplay();
   display->setTextSize(1);
   display->setTextColor(SSD1306_WHITE);
   display->setCursor(0, 0);
-  display->println("LED Light Show");
+  display->println(Text::LIGHT_SHOW);
   display->setCursor(0, 15);
-  display->println("Watch the LEDs!");
-  display->display();
+  display->println(Text::WATCH_LEDS);
+  flushDisplay();
 
   // LED animation sequence
   for (int cycle = 0; cycle < 3; cycle++) {
     // Red LED sequence
     setLED(1, true);
     display->setCursor(0, 30);
-    display->println("Red LED ON");
-    display->display();
-    delay(500);
+    display->println(Text::RED_LED_ON);
+    flushDisplay();
+    clock.hold(500);
 
     setLED(1, false);
     setLED(2, true);
     display->setCursor(0, 30);
-    display->println("Green LED ON");
-    display->display();
-    delay(500);
+    display->println(Text::GREEN_LED_ON);
+    flushDisplay();
+    clock.hold(500);
 
     setLED(2, false);
     setLED(1, true);
     setLED(2, true);
     display->setCursor(0, 30);
-    display->println("Both LEDs ON");
-    display->display();
-    delay(500);
+    display->println(Text::BOTH_LEDS_ON);
+    flushDisplay();
+    clock.hold(500);
 
     setLED(1, false);
     setLED(2, false);
     display->setCursor(0, 30);
-    display->println("LEDs OFF");
-    display->display();
-    delay(300);
+    display->println(Text::LEDS_OFF);
+    flushDisplay();
+    clock.hold(300);
   }
 
   // Phase 6: System status with animations
@@ -531,173 +777,455 @@ void WorkshopESP::playCompleteAnimation(const char *teamName,
   display->setTextSize(1);
   display->setTextColor(SSD1306_WHITE);
   display->setCursor(0, 0);
-  display->println("System Status");
+  display->println(Text::SYSTEM_STATUS);
   display->setCursor(0, 15);
-  display->printf("Uptime: %lu s", millis() / 1000);
+  display->printf_P(Text::FMT_UPTIME.p(), millis() / 1000);
   display->setCursor(0, 25);
-  display->printf("Free RAM: %u", ESP.getFreeHeap());
+  display->printf_P(Text::FMT_FREE_RAM.p(), ESP.getFreeHeap());
   display->setCursor(0, 35);
-  display->println("WiFi: Ready");
+  display->println(Text::WIFI_READY);
   display->setCursor(0, 45);
-  display->println("OLED: Working");
+  display->println(Text::OLED_WORKING);
   display->setCursor(0, 55);
-  display->println("System: GO!");
-  display->display();
-  delay(2000);
+  display->println(Text::SYSTEM_GO);
+  flushDisplay();
+  clock.hold(2000);
 
   // Phase 7: Final countdown
   display->clearDisplay();
-  display->setTextSize(2);
-  display->setTextColor(SSD1306_WHITE);
   display->setCursor(0, 20);
-  display->println("Starting in");
-  display->display();
-  delay(1000);
+  printGlyphs(Text::STARTING_IN, 2);
+  flushDisplay();
+  clock.hold(1000);
 
   for (int count = 3; count > 0; count--) {
+    char digits[8];
+    snprintf_P(digits, sizeof(digits), Text::FMT_COUNTDOWN.p(), count);
     display->clearDisplay();
-    display->setTextSize(3);
-    display->setTextColor(SSD1306_WHITE);
     display->setCursor(50, 25);
-    display->printf("%d", count);
-    display->display();
-    delay(1000);
+    printGlyphs(digits, 3);
+    flushDisplay();
+    clock.hold(1000);
   }
 
   // Final blast
   display->clearDisplay();
-  display->setTextSize(2);
-  display->setTextColor(SSD1306_WHITE);
   display->setCursor(0, 20);
-  display->println("LET'S GO!");
+  printGlyphs(Text::LETS_GO, 2);
   display->setCursor(0, 40);
-  display->println("IoT Workshop");
-  display->display();
+  printGlyphs(Text::IOT_WORKSHOP, 2);
+  flushDisplay();
 
   // Flash LEDs for final effect
   for (int flash = 0; flash < 5; flash++) {
     setLED(1, true);
     setLED(2, true);
-    delay(100);
+    clock.hold(100);
     setLED(1, false);
     setLED(2, false);
-    delay(100);
+    clock.hold(100);
   }
 
-  delay(2000);
+  clock.hold(2000);
 
-  Serial.println("WOW animation sequence complete!");
+  LOG_INFO(Text::ANIMATION_DONE);
+  logFrames();
+  workshopLog.flush();
 }
 
 void WorkshopESP::handleRoot() {
-  String html = "<!DOCTYPE html><html><head>";
-  html += "<title>IoT Workshop Dashboard</title>";
-  html +=
-      "<meta name='viewport' content='width=device-width, initial-scale=1'>";
-  html += "<style>";
-  html += "body { font-family: Arial, sans-serif; margin: 20px; background: "
-          "#f0f0f0; }";
-  html += ".container { max-width: 600px; margin: 0 auto; background: white; "
-          "padding: 20px; border-radius: 10px; }";
-  html += "h1 { color: #333; text-align: center; }";
-  html += ".led-control { margin: 20px 0; padding: 15px; border: 1px solid "
-          "#ddd; border-radius: 5px; }";
-  html += "button { background: #007bff; color: white; border: none; padding: "
-          "10px 20px; border-radius: 5px; cursor: pointer; margin: 5px; }";
-  html += "button:hover { background: #0056b3; }";
-  html += ".status { background: #e9ecef; padding: 10px; border-radius: 5px; "
-          "margin: 10px 0; }";
-  html += "</style></head><body>";
-  html += "<div class='container'>";
-  html += "<h1>IoT Workshop Dashboard</h1>";
-  html += "<div class='status' id='status'>Loading...</div>";
-  html += "<div class='led-control'>";
-  html += "<h3>LED Control</h3>";
-  html += "<button onclick='toggleLED(1)'>Toggle Red LED</button>";
-  html += "<button onclick='toggleLED(2)'>Toggle Green LED</button>";
-  html += "</div>";
-  html += "</div>";
-  html += "<script>";
-  html += "function toggleLED(led) {";
-  html += "  fetch('/api/led/' + led + '/toggle', {method: 'POST'})";
-  html += "    .then(response => response.json())";
-  html += "    .then(data => updateStatus());";
-  html += "}";
-  html += "function updateStatus() {";
-  html += "  fetch('/api/status')";
-  html += "    .then(response => response.json())";
-  html += "    .then(data => {";
-  html += "      document.getElementById('status').innerHTML = ";
-  html += "        'WiFi: ' + (data.wifi_connected ? 'Connected' : "
-          "'Disconnected') + '<br>' +";
-  html += "        'Uptime: ' + data.uptime + 's<br>' +";
-  html += "        'Free Heap: ' + data.free_heap + ' bytes<br>' +";
-  html += "        'Red LED: ' + (data.leds['1'] ? 'ON' : 'OFF') + '<br>' +";
-  html += "        'Green LED: ' + (data.leds['2'] ? 'ON' : 'OFF');";
-  html += "    });";
-  html += "}";
-  html += "setInterval(updateStatus, 2000);";
-  html += "updateStatus();";
-  html += "</script></body></html>";
-
-  server->send(200, "text/html", html);
+  server->send_P(200, Text::MIME_HTML.p(), Text::DASHBOARD_HTML.p());
 }
 
 void WorkshopESP::handleStatus() {
-  server->send(200, "application/json", getSystemStatusJSON());
+  StatusFormat format;
+  if (acceptStatusFormat(format))
+    sendStatus(format);
+}
+
+// The reply format is checked first, so a bad ?fields= changes nothing
+void WorkshopESP::handleLEDToggle() {
+  StatusFormat format;
+  if (!acceptStatusFormat(format))
+    return;
+  toggleLED(strcmp_P(server->path(), Text::URI_LED1_TOGGLE.p()) == 0 ? 1 : 2);
+  sendStatus(format);
 }
 
 void WorkshopESP::handleLEDState() {
-  if (server->hasArg("plain")) {
-    String body = server->arg("plain");
+  if (server->bodyLength() > 0) {
+    StatusFormat format;
+    if (!acceptStatusFormat(format))
+      return;
+
     // Parse JSON body for state
-    bool state = body.indexOf("\"state\":true") > -1;
-    String uri = server->uri();
+    bool state = strstr_P(server->body(), Text::JSON_STATE_TRUE.p()) != nullptr;
+    const char *uri = server->path();
 
-    if (uri.indexOf("/1/state") > -1) {
+    if (strstr_P(uri, Text::URI_PART_LED1_STATE.p())) {
       setLED(1, state);
-    } else if (uri.indexOf("/2/state") > -1) {
+    } else if (strstr_P(uri, Text::URI_PART_LED2_STATE.p())) {
       setLED(2, state);
     }
 
-    server->send(200, "application/json", getSystemStatusJSON());
+    sendStatus(format);
   } else {
-    server->send(400, "application/json",
-                 "{\"error\":\"Invalid request body\"}");
+    server->send_P(400, Text::MIME_JSON.p(), Text::JSON_ERROR_BAD_BODY.p());
+  }
+}
+
+void WorkshopESP::handleBoot() {
+  ScratchString json(requestArena, 512);
+  bootTrace.printJSON(json);
+  sendJSON(200, json);
+}
+
+// Long poll: answers at once when the LEDs changed since generation
+// ?since=, otherwise parks the request until an LED changes or ?timeout=
+// (ms) runs out. Either way the reply carries the generation to
+// wait on next.
+void WorkshopESP::handleLEDWait() {
+  char value[12];
+  bool hasSince =
+      server->copyArg(Text::ARG_SINCE.p(), value, sizeof(value)) > 0;
+  uint32_t since = hasSince ? strtoul(value, nullptr, 10) : 0;
+  unsigned long timeout = WORKSHOP_LED_WAIT_TIMEOUT_MS;
+  if (server->copyArg(Text::ARG_TIMEOUT.p(), value, sizeof(value)) > 0)
+    timeout = strtoul(value, nullptr, 10);
+  if (timeout > WORKSHOP_LED_WAIT_MAX_MS)
+    timeout = WORKSHOP_LED_WAIT_MAX_MS;
+
+  uint32_t current = generation();
+  if (!hasSince || since != current || timeout == 0) {
+    sendLEDWait(hasSince && since != current);
+    return;
+  }
+  if (!server->park(since, timeout)) {
+    server->sendHeader_P(Text::HTTP_RETRY_AFTER.p(),
+                         Text::RETRY_AFTER_SECONDS.p());
+    server->send_P(503, Text::MIME_JSON.p(), Text::JSON_ERROR_BUSY.p());
   }
 }
 
+void WorkshopESP::sendLEDWait(bool changed) {
+  // The generation and the LEDs it stands for, from one copy
+  LedState device = sharedLEDs.read();
+  ScratchString json(requestArena, 64);
+  json.print(Text::JSON_WAIT_GENERATION);
+  json.print(device.generation);
+  json.print(Text::JSON_WAIT_CHANGED);
+  json.print(Text::jsonBool(changed));
+  json.print(Text::JSON_WAIT_LED1);
+  json.print(Text::jsonBool(device.led[0]));
+  json.print(Text::JSON_WAIT_LED2);
+  json.print(Text::jsonBool(device.led[1]));
+  json.print(Text::JSON_CLOSE2);
+  sendJSON(200, json);
+}
+
+// Queued trace events as one binary chunk (see event_trace.h). Reading
+// moves them out, so polling this collects a whole session;
+// tools/trace_decode.py turns the result into text or a Chrome trace.
+void WorkshopESP::handleTrace() {
+  size_t size = workshopTrace.chunkSize();
+  if (size > requestArena.available())
+    size = requestArena.available();
+  uint8_t *chunk = requestArena.allocate<uint8_t>(size);
+  size_t length = chunk != nullptr ? workshopTrace.read(chunk, size) : 0;
+  if (length == 0) {
+    server->send_P(500, Text::MIME_JSON.p(), Text::JSON_ERROR_TOO_LARGE.p());
+    return;
+  }
+  server->send_P(200, Text::MIME_OCTET.p(), (PGM_P)chunk, length);
+}
+
+// Recorded traffic as one binary chunk (see session_recorder.h), moved out
+// like /api/trace; replay the collected file with the host build's
+// --replay option
+void WorkshopESP::handleRecord() {
+  size_t size = workshopRecorder.chunkSize();
+  if (size > requestArena.available())
+    size = requestArena.available();
+  uint8_t *chunk = requestArena.allocate<uint8_t>(size);
+  size_t length = chunk != nullptr ? workshopRecorder.read(chunk, size) : 0;
+  if (length == 0) {
+    server->send_P(500, Text::MIME_JSON.p(), Text::JSON_ERROR_TOO_LARGE.p());
+    return;
+  }
+  server->send_P(200, Text::MIME_OCTET.p(), (PGM_P)chunk, length);
+}
+
+void WorkshopESP::handleBindings() {
+  ScratchString json(requestArena, 256);
+  bindings.printJSON(json);
+  sendJSON(200, json);
+}
+
+// led=1|2 and mode=off, mode=level [curve=linear|gamma|inverted, or
+// curve=custom with points=17 comma-separated values 0..1023], or
+// mode=switch with on= and off= thresholds; answers with the bindings
+void WorkshopESP::handleBindingSet() {
+  char value[96];
+  int led = server->copyArg(Text::ARG_LED.p(), value, sizeof(value)) > 0
+                ? atoi(value)
+                : 0;
+  AnalogBindings::Mode mode = AnalogBindings::MODE_OFF;
+  bool ok = (led == 1 || led == 2) &&
+            server->copyArg(Text::ARG_MODE.p(), value, sizeof(value)) > 0 &&
+            AnalogBindings::modeFromName(value, mode);
+
+  if (ok && mode == AnalogBindings::MODE_LEVEL) {
+    AnalogBindings::Curve curve = AnalogBindings::CURVE_LINEAR;
+    if (server->copyArg(Text::ARG_CURVE.p(), value, sizeof(value)) > 0)
+      ok = AnalogBindings::curveFromName(value, curve);
+    if (ok && curve == AnalogBindings::CURVE_CUSTOM) {
+      uint16_t points[AnalogBindings::CURVE_POINTS];
+      ok = server->copyArg(Text::ARG_POINTS.p(), value, sizeof(value)) > 0 &&
+           parseNumbers(value, points, AnalogBindings::CURVE_POINTS,
+                        AnalogBindings::OUTPUT_MAX) &&
+           bindings.bindLevel(led, A0) && bindings.setCurve(led, points);
+    } else if (ok) {
+      ok = bindings.bindLevel(led, A0, curve);
+    }
+  } else if (ok && mode == AnalogBindings::MODE_SWITCH) {
+    uint16_t on = 0, off = 0;
+    ok = server->copyArg(Text::ARG_ON.p(), value, sizeof(value)) > 0 &&
+         parseNumbers(value, &on, 1, AnalogBindings::INPUT_MAX) &&
+         server->copyArg(Text::ARG_OFF.p(), value, sizeof(value)) > 0 &&
+         parseNumbers(value, &off, 1, AnalogBindings::INPUT_MAX) &&
+         bindings.bindSwitch(led, A0, on, off);
+  } else if (ok) {
+    bindings.unbind(led);
+  }
+  if (!ok) {
+    server->send_P(400, Text::MIME_JSON.p(),
+                   Text::JSON_ERROR_BAD_BINDING.p());
+    return;
+  }
+
+  // Off PWM: the LED shows its on/off state again until the switch, if
+  // any, decides
+  if (mode != AnalogBindings::MODE_LEVEL)
+    digitalWrite(ledPin(led), getLEDState(led));
+  FlashString name = mode == AnalogBindings::MODE_LEVEL ? Text::BINDING_LEVEL
+                     : mode == AnalogBindings::MODE_SWITCH
+                         ? Text::BINDING_SWITCH
+                         : Text::BINDING_OFF;
+  LOG_INFO(led == 1 ? Text::RED_LED_BINDING : Text::GREEN_LED_BINDING, name);
+  handleBindings();
+}
+
 void WorkshopESP::handleNotFound() {
-  server->send(404, "application/json", "{\"error\":\"Not found\"}");
+  server->send_P(404, Text::MIME_JSON.p(), Text::JSON_ERROR_NOT_FOUND.p());
+}
+
+void WorkshopESP::sendJSON(int code, const ScratchString &json) {
+  if (json.overflowed()) {
+    server->send_P(500, Text::MIME_JSON.p(), Text::JSON_ERROR_TOO_LARGE.p());
+    return;
+  }
+  server->send_P(code, Text::MIME_JSON.p(), json.c_str(), json.length());
+}
+
+// Served from a cache while nothing changed; a client that already has
+// the current render gets a 304. ?fields=, ?compact=1 and an Accept of
+// application/msgpack pick the form.
+bool WorkshopESP::acceptStatusFormat(StatusFormat &format) {
+  if (readStatusFormat(format))
+    return true;
+  server->send_P(400, Text::MIME_JSON.p(), Text::JSON_ERROR_BAD_FIELDS.p());
+  return false;
+}
+
+void WorkshopESP::sendStatus(const StatusFormat &format) {
+  trackWiFiState();
+  ResponseCache &cache = format.isDefault() ? statusCache : projectedCache;
+  unsigned long now = millis();
+  // Wi-Fi does not bump the LED generation, so it is part of the key
+  uint32_t key = generation() << 1 | wifiConnected;
+  if (cache.fresh(key, now, format.variant())) {
+    cache.countHit();
+  } else {
+    cache.begin(key, now, format.variant());
+    StatusEncoder::write(cache, statusSnapshot(), format);
+  }
+  if (cache.overflowed()) {
+    server->send_P(500, Text::MIME_JSON.p(), Text::JSON_ERROR_TOO_LARGE.p());
+    return;
+  }
+
+  server->sendHeader_P(Text::HTTP_ETAG.p(), cache.etag());
+  server->sendHeader_P(Text::HTTP_CACHE_CONTROL.p(), Text::HTTP_NO_CACHE.p());
+  if (cache.matches(server->findHeader(Text::HTTP_IF_NONE_MATCH.p()))) {
+    server->send(304);
+    return;
+  }
+  FlashString type = format.msgpack ? Text::MIME_MSGPACK : Text::MIME_JSON;
+  server->send_P(200, type.p(), cache.body(), cache.length());
+}
+
+bool WorkshopESP::readStatusFormat(StatusFormat &format) {
+  // One byte over the longest valid list, so a cut one shows
+  char value[StatusEncoder::MAX_FIELDS_LENGTH + 2];
+  int length = server->copyArg(Text::ARG_FIELDS.p(), value, sizeof(value));
+  if (length > (int)StatusEncoder::MAX_FIELDS_LENGTH)
+    return false;
+  if (length >= 0 && !StatusEncoder::parseFields(value, format.fields))
+    return false;
+
+  length = server->copyArg(Text::ARG_COMPACT.p(), value, sizeof(value));
+  format.shortKeys = length >= 0 && !(length == 1 && value[0] == '0');
+
+  const char *accept = server->findHeader(Text::HTTP_ACCEPT.p());
+  format.msgpack =
+      accept != nullptr && strstr_P(accept, Text::MSGPACK.p()) != nullptr;
+  return true;
+}
+
+StatusSnapshot WorkshopESP::statusSnapshot() {
+  StatusSnapshot status;
+  status.wifiConnected = WiFi.status() == WL_CONNECTED;
+  status.uptime = millis() / 1000;
+  status.freeHeap = ESP.getFreeHeap();
+  LedState device = sharedLEDs.read();
+  status.led1 = device.led[0];
+  status.led2 = device.led[1];
+  status.timestamp = millis();
+  return status;
+}
+
+void WorkshopESP::trackWiFiState() {
+  bool connected = WiFi.status() == WL_CONNECTED;
+  if (connected != wifiConnected) {
+    wifiConnected = connected;
+    TRACE(WIFI_STATE, connected, (unsigned)WiFi.status());
+    bus.publish(WiFiState{connected, (uint8_t)WiFi.status()});
+  }
+}
+
+void WorkshopESP::onLEDChanged(void *context, const BusEvent &) {
+  // storeLED() already wrote the new state
+  WorkshopESP *workshop = static_cast<WorkshopESP *>(context);
+  workshop->server->wakeParked(); // answers /api/leds/wait
+  // The rest of the status screen waits for the next displayStatus()
+  if (workshop->uiScreen == SCREEN_STATUS) {
+    workshop->showLEDs();
+    workshop->renderScreen(false);
+  }
+}
+
+void WorkshopESP::onSample(void *context, uint8_t input, uint16_t reading) {
+  WorkshopESP *workshop = static_cast<WorkshopESP *>(context);
+  SampleState &sampled = workshop->sampled;
+  sampled.samples++;
+  sampled.sample = reading;
+  sampled.sampleInput = input;
+  workshop->sharedSamples.write(sampled);
+}
+
+void WorkshopESP::showLEDs() {
+  ui.setText(UI_STATUS_RED, Text::onOff(leds.led[0]));
+  ui.setIcon(UI_STATUS_RED_ICON, leds.led[0] ? LED_ON_ICON : LED_OFF_ICON);
+  ui.setText(UI_STATUS_GREEN, Text::onOff(leds.led[1]));
+  ui.setIcon(UI_STATUS_GREEN_ICON, leds.led[1] ? LED_ON_ICON : LED_OFF_ICON);
+}
+
+void WorkshopESP::flushDisplay() {
+  uiScreen = SCREEN_NONE; // drawn directly, the widgets start over
+  flusher.present();
+  flusher.finish();
+}
+
+bool WorkshopESP::enterScreen(UiScreen screen) {
+  if (uiScreen == screen)
+    return false;
+  uiScreen = screen;
+  ui.clear();
+  display->clearDisplay();
+  return true;
+}
+
+// Connecting, connected and failed screens share the layout and set every
+// line, so moving from one to the next redraws only the lines that differ
+void WorkshopESP::enterWiFiScreen() {
+  if (enterScreen(SCREEN_WIFI)) {
+    ui.addText(0, 0, 21);
+    ui.addText(0, 15, 21);
+    ui.addText(0, 30, 21);
+    ui.addText(0, 45, 14); // leaves room for the progress bar
+    ui.addText(0, 55, 21);
+    ui.addBar(88, 46, 40, 6, 0, 100);
+  }
+}
+
+void WorkshopESP::renderScreen(bool wait) {
+  ui.render(*display);
+  flusher.present();
+  if (wait)
+    flusher.finish();
 }
 
 void WorkshopESP::printSystemInfo() {
-  Serial.println("=== System Information ===");
-  Serial.printf("WiFi Status: %s\n",
-                WiFi.status() == WL_CONNECTED ? "Connected" : "Disconnected");
-  Serial.printf("IP Address: %s\n", WiFi.localIP().toString().c_str());
-  Serial.printf("MAC Address: %s\n", WiFi.macAddress().c_str());
-  Serial.printf("Signal Strength: %d dBm\n", WiFi.RSSI());
-  Serial.printf("Uptime: %lu seconds\n", millis() / 1000);
-  Serial.printf("Free Heap: %u bytes\n", ESP.getFreeHeap());
-  Serial.printf("Red LED: %s\n", redLEDState ? "ON" : "OFF");
-  Serial.printf("Green LED: %s\n", greenLEDState ? "ON" : "OFF");
-  Serial.println("==========================");
+  LOG_INFO(Text::SYSINFO_HEADER);
+  LOG_INFO(Text::SYSINFO_WIFI_STATUS,
+           WiFi.status() == WL_CONNECTED ? Text::CONNECTED
+                                         : Text::DISCONNECTED);
+  LOGF_INFO(Text::FMT_SYSINFO_IP.p(), WiFi.localIP().toString().c_str());
+  LOGF_INFO(Text::FMT_SYSINFO_MAC.p(), WiFi.macAddress().c_str());
+  LOGF_INFO(Text::FMT_SYSINFO_SIGNAL.p(), WiFi.RSSI());
+  LOGF_INFO(Text::FMT_SYSINFO_CONNECT_TIME.p(), wifiConnectTime);
+  LOG_INFO(wifiFastConnect ? Text::WIFI_PATH_CACHED
+                           : Text::WIFI_PATH_FULL_SCAN);
+  LOGF_INFO(Text::FMT_SYSINFO_UPTIME.p(), millis() / 1000);
+  printHeapStats(Text::HEAP);
+  LOGF_INFO(Text::FMT_SYSINFO_ARENA.p(),
+            (unsigned)requestArena.highWater(),
+            (unsigned)RequestArena::CAPACITY,
+            (unsigned long)requestArena.failures());
+  LOGF_INFO(Text::FMT_SYSINFO_HTTP.p(),
+            (unsigned long)server->requests(),
+            (unsigned long)server->connections(),
+            (unsigned)server->openConnections(),
+            (unsigned)server->parkedRequests());
+  LOGF_INFO(Text::FMT_SYSINFO_STATUS_CACHE.p(),
+            (unsigned long)(statusCache.hits() + projectedCache.hits()),
+            (unsigned long)(statusCache.renders() + projectedCache.renders()));
+  LOGF_INFO(Text::FMT_SYSINFO_RATE_LIMIT.p(),
+            (unsigned long)rateLimiter.rejected(RATE_READ),
+            (unsigned long)rateLimiter.rejected(RATE_WRITE),
+            (unsigned)rateLimiter.clients());
+  LOGF_INFO(Text::FMT_SYSINFO_LOG.p(), (unsigned)workshopLog.queued(),
+            (unsigned)LogBuffer::CAPACITY,
+            (unsigned long)workshopLog.dropped());
+  LOGF_INFO(Text::FMT_SYSINFO_TRACE.p(), (unsigned)workshopTrace.queued(),
+            (unsigned)EventTrace::CAPACITY,
+            (unsigned long)workshopTrace.dropped());
+  LOG_INFO(Text::RED_LED_LABEL, Text::onOff(leds.led[0]));
+  LOG_INFO(Text::GREEN_LED_LABEL, Text::onOff(leds.led[1]));
+  LOG_INFO(Text::SYSINFO_FOOTER);
+}
+
+void WorkshopESP::printHeapStats(const __FlashStringHelper *label) {
+  char stats[64];
+  snprintf_P(stats, sizeof(stats), Text::FMT_HEAP_STATS.p(), ESP.getFreeHeap(),
+             ESP.getMaxFreeBlockSize(), ESP.getHeapFragmentation());
+  LOG_INFO(label, stats);
 }
 
 String WorkshopESP::getSystemStatusJSON() {
-  String json = "{";
-  json += "\"wifi_connected\":" +
-          String(WiFi.status() == WL_CONNECTED ? "true" : "false") + ",";
-  json += "\"uptime\":" + String(millis() / 1000) + ",";
-  json += "\"free_heap\":" + String(ESP.getFreeHeap()) + ",";
-  json += "\"leds\":{";
-  json += "\"1\":" + String(redLEDState ? "true" : "false") + ",";
-  json += "\"2\":" + String(greenLEDState ? "true" : "false");
-  json += "},";
-  json += "\"timestamp\":" + String(millis());
-  json += "}";
+  StreamString json;
+  writeSystemStatusJSON(json);
   return json;
 }
 
-void WorkshopESP::handleClient() { server->handleClient(); }
\ No newline at end of file
+void WorkshopESP::writeSystemStatusJSON(Print &out) {
+  StatusEncoder::write(out, statusSnapshot(), StatusFormat());
+}
+
+void WorkshopESP::handleClient() {
+  bindings.tick();
+  trackWiFiState();
+  server->handleClient();
+  flusher.tick();
+  workshopLog.drain();
+}
\ No newline at end of file
@@ -5,38 +5,194 @@
 #include <Adafruit_SSD1306.h>
 #include <Arduino.h>
 #include <ArduinoOTA.h>
-#include <ESP8266WebServer.h>
 #include <ESP8266WiFi.h>
 #include <SPI.h>
 #include <Wire.h>
 
+#include "boot_trace.h"
+#include "analog_bindings.h"
+#include "display_flusher.h"
+#include "event_bus.h"
+#include "event_trace.h"
+#include "frame_clock.h"
+#include "glyph_cache.h"
+#include "http_server.h"
+#include "log_buffer.h"
+#include "rate_limiter.h"
+#include "request_arena.h"
+#include "response_cache.h"
+#include "seqlock.h"
+#include "session_recorder.h"
+#include "status_encoder.h"
+#include "wifi_cache.h"
+#include "widget_screen.h"
+
+// How long /api/status may repeat its uptime/timestamp/free_heap values
+// while no state changed; override with -DWORKSHOP_STATUS_FRESH_MS=...
+#ifndef WORKSHOP_STATUS_FRESH_MS
+#define WORKSHOP_STATUS_FRESH_MS 1000
+#endif
+
+// /api/leds/wait holds a request this long without ?timeout=, and never
+// longer than the maximum (ms)
+#ifndef WORKSHOP_LED_WAIT_TIMEOUT_MS
+#define WORKSHOP_LED_WAIT_TIMEOUT_MS 25000
+#endif
+#ifndef WORKSHOP_LED_WAIT_MAX_MS
+#define WORKSHOP_LED_WAIT_MAX_MS 60000
+#endif
+
+// The LEDs and their generation, written from loop() only; see
+// WorkshopESP::ledState()
+struct LedState {
+  uint32_t generation; // bumped by every LED change, /api/leds/wait
+  bool led[2];
+};
+
+// Written by the analog sampler only (AnalogBindings::tick(), which can
+// move into a timer ISR); see WorkshopESP::sampleState()
+struct SampleState {
+  uint32_t samples;  // readings taken for the analog bindings
+  int32_t sample;    // the latest of them
+  uint16_t level[2]; // PWM level of LED 1 and 2 when bound as a level
+  uint8_t sampleInput;
+};
+
 class WorkshopESP {
 private:
-  ESP8266WebServer *server;
+  // Embedded by value so constructing the global instance never touches
+  // the heap or the hardware; begin() does the hardware init
+  HttpServer webServer;
+  Adafruit_SSD1306 oled;
+
+  HttpServer *server;
   Adafruit_SSD1306 *display;
 
+  // Sends finished frames to the panel a few transactions per loop
+  DisplayFlusher flusher;
+
+  // Retained widgets of the status, welcome and Wi-Fi screens; uiScreen
+  // says which one they make up, SCREEN_NONE once something else drew
+  enum UiScreen : uint8_t {
+    SCREEN_NONE,
+    SCREEN_STATUS,
+    SCREEN_WELCOME,
+    SCREEN_WIFI
+  };
+  WidgetScreen ui;
+  UiScreen uiScreen;
+
+  // Pre-rendered text for the animations
+  GlyphCache glyphs;
+  // Schedule of the running (or last) animation
+  FrameClock animationClock;
+
+  bool begun;
+  bool displayReady;
+
   // LED pins
   int redLEDPin;
   int greenLEDPin;
 
-  // LED states
-  bool redLEDState;
-  bool greenLEDState;
+  // LEDs driven from A0 without the browser, set up over /api/bindings
+  AnalogBindings bindings;
 
   // WiFi credentials
   const char *ssid;
   const char *password;
 
+  // WiFi connect timing (last setupWiFi call)
+  unsigned long wifiConnectTime;
+  bool wifiFastConnect;
+  static const unsigned long WIFI_FAST_CONNECT_TIMEOUT = 3000; // ms
+
+  // Boot phase timings, served at /api/boot
+  BootTrace bootTrace;
+
+  // Handler scratch memory, reset after every request
+  RequestArena requestArena;
+
+  // Per-client request budgets, checked before any handler runs
+  RateLimiter rateLimiter;
+
+  // LED, Wi-Fi, sample and client changes, from their owners to whoever
+  // shows or sends them
+  EventBus bus;
+
+  // One Seqlock per writer: the working copy is the writer's, the JSON
+  // handlers read the Seqlock and never see a torn copy
+  LedState leds; // the LED states; setLED() and toggleLED() write them
+  Seqlock<LedState> sharedLEDs;
+  SampleState sampled;
+  Seqlock<SampleState> sharedSamples;
+  bool wifiConnected;
+  ResponseCache statusCache;    // full JSON body, as the dashboard polls it
+  ResponseCache projectedCache; // most recent ?fields=/compact/msgpack form
+
   // Display settings
   static const int SCREEN_WIDTH = 128;
   static const int SCREEN_HEIGHT = 64;
   static const int OLED_RESET = -1;
   static const int OLED_SDA = 14; // GPIO14 (correct pin)
   static const int OLED_SCL = 12; // GPIO12 (correct pin)
+  static const uint8_t OLED_ADDRESS = 0x3C;
+
+  // Direct connect using the cached channel/BSSID and static IP
+  bool connectWiFiFast(const char *ssid, const char *password);
+
+  // Shared body of the displayMessage() overloads
+  template <typename T> void showMessage(T message, bool header);
+  void sendJSON(int code, const ScratchString &json);
+  void sendStatus(const StatusFormat &format);
+  bool readStatusFormat(StatusFormat &format);
+  // readStatusFormat(), answering 400 when it fails
+  bool acceptStatusFormat(StatusFormat &format);
+  StatusSnapshot statusSnapshot();
+  void sendLEDWait(bool changed);
+  // Stores LED `ledNumber` in `leds`, bumps the generation and publishes
+  // the LedChanged
+  void storeLED(int ledNumber, bool on);
+  // Bus subscriber for LED changes: parked /api/leds/wait requests and
+  // the status screen's LED lines
+  static void onLEDChanged(void *context, const BusEvent &event);
+  // AnalogBindings sample handler, in the sampler's context
+  static void onSample(void *context, uint8_t input, uint16_t reading);
+  void showLEDs();
+  void trackWiFiState();
+  int ledPin(int ledNumber) const;
+  // AnalogBindings output handler: outputs are LED numbers
+  static void writeBoundLED(void *context,
+                            const AnalogBindings::Binding &binding,
+                            uint16_t value);
+  // Whole frame on the panel before returning, for sequences that delay()
+  void flushDisplay();
+  // Clears the panel and the widgets unless `screen` is already up; true
+  // when the caller has to add its widgets
+  bool enterScreen(UiScreen screen);
+  void enterWiFiScreen();
+  // Draws changed widgets; `wait` as flushDisplay(), otherwise
+  // handleClient() sends the frame
+  void renderScreen(bool wait);
+  // Frames, drops and rate of the animation that just finished
+  void logFrames();
+  // print() at the cursor through the glyph cache (white, wrapping)
+  void printGlyphs(const char *text, uint8_t size) {
+    glyphs.print(*display, text, size);
+  }
+  void printGlyphs(const __FlashStringHelper *text, uint8_t size,
+                   size_t length = SIZE_MAX) {
+    glyphs.print(*display, text, size, length);
+  }
 
 public:
   WorkshopESP();
-  ~WorkshopESP();
+
+  // Hardware init (I2C bus, OLED). Safe to call more than once; the setup
+  // methods call it themselves if the sketch did not.
+  void begin();
+  // Draws on `panel` instead of the built-in SSD1306 (the host build's
+  // HeadlessDisplay captures frames); only before begin()
+  void setDisplay(Adafruit_SSD1306 *panel);
 
   // Setup methods
   void setupWiFi(const char *ssid, const char *password);
@@ -57,6 +213,7 @@ public:
                       const char *member2);
   void displayStatus();
   void displayMessage(const char *message, bool header);
+  void displayMessage(const __FlashStringHelper *message, bool header);
   void animateHello(const char *teamName);
 
   // Web server handlers
@@ -65,11 +222,37 @@ public:
   void handleLEDToggle();
   void handleLEDState();
   void handleNotFound();
+  void handleBoot();
+  void handleLEDWait();
+  void handleTrace();
+  void handleRecord();
+  void handleBindings();
+  void handleBindingSet();
 
   // Utility methods
   void printSystemInfo();
+  void printHeapStats(const __FlashStringHelper *label);
   String getSystemStatusJSON();
+  void writeSystemStatusJSON(Print &out);
   void handleClient();
+  BootTrace &boot() { return bootTrace; }
+  RequestArena &arena() { return requestArena; }
+  RateLimiter &limiter() { return rateLimiter; }
+  AnalogBindings &analogBindings() { return bindings; }
+  EventBus &events() { return bus; } // subscribe for LED, Wi-Fi, ... changes
+  DisplayFlusher &displayFlusher() { return flusher; } // bus speed, budget
+  // Achieved FPS and dropped frames of the last animation
+  const FrameClock &animationFrames() const { return animationClock; }
+  uint32_t generation() const { return sharedLEDs.read().generation; }
+  // Never torn; the two come from different writers, so they are not
+  // consistent with each other
+  LedState ledState() const { return sharedLEDs.read(); }
+  SampleState sampleState() const { return sharedSamples.read(); }
+  void setStatusFreshness(unsigned long ms) {
+    statusCache.setFreshness(ms);
+    projectedCache.setFreshness(ms);
+  }
+  HttpServer &httpServer() { return *server; } // for extra routes
 
   // Team welcome animation
   void animateTeamWelcome(const char *teamName);
@@ -0,0 +1,59 @@
+#include "workshop_strings.h"
+
+namespace Text {
+
+#define WORKSHOP_TEXT_DEFINE(name, text) const char name##_P[] PROGMEM = text;
+WORKSHOP_TEXT_TABLE(WORKSHOP_TEXT_DEFINE)
+#undef WORKSHOP_TEXT_DEFINE
+
+const char DASHBOARD_HTML_P[] PROGMEM =
+    "<!DOCTYPE html><html><head>"
+    "<title>IoT Workshop Dashboard</title>"
+    "<meta name='viewport' content='width=device-width, initial-scale=1'>"
+    "<style>"
+    "body { font-family: Arial, sans-serif; margin: 20px; background: "
+    "#f0f0f0; }"
+    ".container { max-width: 600px; margin: 0 auto; background: white; "
+    "padding: 20px; border-radius: 10px; }"
+    "h1 { color: #333; text-align: center; }"
+    ".led-control { margin: 20px 0; padding: 15px; border: 1px solid "
+    "#ddd; border-radius: 5px; }"
+    "button { background: #007bff; color: white; border: none; padding: "
+    "10px 20px; border-radius: 5px; cursor: pointer; margin: 5px; }"
+    "button:hover { background: #0056b3; }"
+    ".status { background: #e9ecef; padding: 10px; border-radius: 5px; "
+    "margin: 10px 0; }"
+    "</style></head><body>"
+    "<div class='container'>"
+    "<h1>IoT Workshop Dashboard</h1>"
+    "<div class='status' id='status'>Loading...</div>"
+    "<div class='led-control'>"
+    "<h3>LED Control</h3>"
+    "<button onclick='toggleLED(1)'>Toggle Red LED</button>"
+    "<button onclick='toggleLED(2)'>Toggle Green LED</button>"
+    "</div>"
+    "</div>"
+    "<script>"
+    "function toggleLED(led) {"
+    "  fetch('/api/led/' + led + '/toggle', {method: 'POST'})"
+    "    .then(response => response.json())"
+    "    .then(data => updateStatus());"
+    "}"
+    "function updateStatus() {"
+    "  fetch('/api/status')"
+    "    .then(response => response.json())"
+    "    .then(data => {"
+    "      document.getElementById('status').innerHTML = "
+    "        'WiFi: ' + (data.wifi_connected ? 'Connected' : "
+    "'Disconnected') + '<br>' +"
+    "        'Uptime: ' + data.uptime + 's<br>' +"
+    "        'Free Heap: ' + data.free_heap + ' bytes<br>' +"
+    "        'Red LED: ' + (data.leds['1'] ? 'ON' : 'OFF') + '<br>' +"
+    "        'Green LED: ' + (data.leds['2'] ? 'ON' : 'OFF');"
+    "    });"
+    "}"
+    "setInterval(updateStatus, 2000);"
+    "updateStatus();"
+    "</script></body></html>";
+
+} // namespace Text
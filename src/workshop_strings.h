@@ -0,0 +1,345 @@
+#ifndef WORKSHOP_STRINGS_H
+#define WORKSHOP_STRINGS_H
+
+#include <Arduino.h>
+
+// Every piece of text the library prints, draws or serves. The strings are
+// stored in flash (PROGMEM) so they cost no DRAM; library sources must not
+// use plain "..." literals (tools/check_flash_strings.py fails the build).
+
+// Handle to a PROGMEM string. Converts to __FlashStringHelper so it can be
+// passed straight to Serial/display print()/println() and String +=.
+class FlashString {
+public:
+  constexpr explicit FlashString(PGM_P text) : text(text) {}
+
+  operator const __FlashStringHelper *() const { return f(); }
+  const __FlashStringHelper *f() const { return FPSTR(text); }
+
+  // Raw flash pointer for the *_P APIs (printf_P, send_P, strstr_P, ...)
+  PGM_P p() const { return text; }
+  size_t length() const { return strlen_P(text); }
+
+private:
+  PGM_P text;
+};
+
+// X(NAME, "text") - formats used with printf_P are prefixed FMT_
+#define WORKSHOP_TEXT_TABLE(X)                                                 \
+  /* Shared */                                                                 \
+  X(ON, "ON")                                                                  \
+  X(OFF, "OFF")                                                                \
+  X(JSON_TRUE, "true")                                                         \
+  X(JSON_FALSE, "false")                                                       \
+  X(INITIALIZING, "Initializing...")                                           \
+  X(CONTINUING_OFFLINE, "Continuing offline")                                  \
+  X(IOT_WORKSHOP, "IoT Workshop")                                              \
+  X(FMT_SSID, "SSID: %s")                                                      \
+  X(FMT_IP, "IP: %s")                                                          \
+  X(FMT_SIGNAL, "Signal: %d dBm")                                              \
+                                                                               \
+  /* Station mode */                                                           \
+  X(WIFI_SETUP_START, "Starting WiFi setup...")                                \
+  X(WIFI_CONNECTING, "Connecting to WiFi")                                     \
+  X(WIFI_MODE_STA, "WiFi mode set to STA")                                     \
+  X(WIFI_BEGIN_CALLED, "WiFi.begin() called")                                  \
+  X(FMT_WIFI_ATTEMPT, "WiFi status: %d, attempt %d/%d\n")                      \
+  X(FMT_ATTEMPT, "Attempt %d/%d")                                              \
+  X(FMT_CONNECTING, "Connecting%s")                                            \
+  X(STABILITY_CHECK, "Checking system stability...")                           \
+  X(WIFI_CONNECTED_LOG, "\nWiFi Connected Successfully!")                      \
+  X(FMT_CONNECT_TIME, "Connect time: %lu ms ")                                 \
+  X(WIFI_PATH_CACHED, "(cached)")                                              \
+  X(WIFI_PATH_FULL_SCAN, "(full scan)")                                        \
+  X(IP_ADDRESS_LABEL, "IP Address: ")                                          \
+  X(MAC_ADDRESS_LABEL, "MAC Address: ")                                        \
+  X(SIGNAL_LABEL, "Signal Strength: ")                                         \
+  X(DBM, " dBm")                                                               \
+  X(WIFI_CONNECTED, "WiFi Connected!")                                         \
+  X(READY_FOR_WORKSHOP, "Ready for workshop!")                                 \
+  X(WIFI_FAILED_LOG, "\nWiFi Connection Failed!")                              \
+  X(FMT_FINAL_WIFI_STATUS, "Final WiFi status: %d\n")                          \
+  X(WIFI_FAILED, "WiFi Failed!")                                               \
+  X(FMT_STATUS, "Status: %d")                                                  \
+  X(CHECK_NETWORK, "Check network")                                            \
+  X(WIFI_SETUP_DONE, "WiFi setup complete")                                    \
+  X(WIFI_NO_CACHE, "No cached WiFi connection, doing full scan")               \
+  X(FMT_FAST_CONNECT, "Fast connect: channel %u, cached IP %s\n")              \
+  X(FAST_CONNECT_FAILED, "Fast connect failed, falling back to full scan")     \
+                                                                               \
+  /* Access point mode */                                                      \
+  X(AP_SETUP_START, "Creating WiFi Access Point...")                           \
+  X(AP_CREATING, "Creating AP")                                                \
+  X(WIFI_MODE_AP, "WiFi mode set to AP")                                       \
+  X(AP_CREATED_LOG, "\nAccess Point Created Successfully!")                    \
+  X(AP_IP_LABEL, "AP IP Address: ")                                            \
+  X(CONNECT_TO_LABEL, "Connect to: ")                                          \
+  X(NO_PASSWORD_LOG, "No password required!")                                  \
+  X(AP_DASHBOARD_URL, "Dashboard: http://192.168.4.1")                         \
+  X(AP_CREATED, "AP Created!")                                                 \
+  X(NO_PASSWORD, "No password!")                                               \
+  X(READY, "Ready!")                                                           \
+  X(AP_FAILED_LOG, "\nAccess Point Creation Failed!")                          \
+  X(AP_FAILED, "AP Failed!")                                                   \
+  X(CHECK_SETTINGS, "Check settings")                                          \
+  X(AP_SETUP_DONE, "WiFi AP setup complete")                                   \
+                                                                               \
+  /* Web server */                                                             \
+  X(URI_ROOT, "/")                                                             \
+  X(URI_STATUS, "/api/status")                                                 \
+  X(URI_BOOT, "/api/boot")                                                     \
+  X(URI_LED1_TOGGLE, "/api/led/1/toggle")                                      \
+  X(URI_LED2_TOGGLE, "/api/led/2/toggle")                                      \
+  X(URI_LED1_STATE, "/api/led/1/state")                                        \
+  X(URI_LED2_STATE, "/api/led/2/state")                                        \
+  X(URI_LEDS_WAIT, "/api/leds/wait")                                           \
+  X(URI_TRACE, "/api/trace")                                                   \
+  X(URI_RECORD, "/api/record")                                                 \
+  X(URI_PART_LED1_STATE, "/1/state")                                           \
+  X(URI_PART_LED2_STATE, "/2/state")                                           \
+  X(WEB_SERVER_STARTED, "Web server started")                                  \
+  X(MIME_HTML, "text/html")                                                    \
+  X(MIME_JSON, "application/json")                                             \
+  X(ARG_PLAIN, "plain")                                                        \
+  X(JSON_STATE_TRUE, "\"state\":true")                                         \
+  X(JSON_ERROR_BAD_BODY, "{\"error\":\"Invalid request body\"}")               \
+  X(JSON_ERROR_NOT_FOUND, "{\"error\":\"Not found\"}")                         \
+  X(JSON_ERROR_TOO_LARGE, "{\"error\":\"Response too large\"}")                \
+  X(JSON_CLOSE, "}")                                                           \
+  X(JSON_OPEN, "{")                                                            \
+  X(JSON_QUOTE, "\"")                                                          \
+  X(JSON_KEY_END, "\":")                                                       \
+  X(JSON_ERROR_BAD_FIELDS, "{\"error\":\"Unknown field\"}")                    \
+  X(ARG_FIELDS, "fields")                                                      \
+  X(ARG_COMPACT, "compact")                                                    \
+  X(HTTP_ACCEPT, "Accept")                                                     \
+  X(MSGPACK, "msgpack")                                                        \
+  X(MIME_MSGPACK, "application/msgpack")                                       \
+  X(MIME_OCTET, "application/octet-stream")                                    \
+  X(ARG_SINCE, "since")                                                        \
+  X(ARG_TIMEOUT, "timeout")                                                    \
+  X(JSON_WAIT_GENERATION, "{\"generation\":")                                  \
+  X(JSON_WAIT_CHANGED, ",\"changed\":")                                        \
+  X(JSON_WAIT_LED1, ",\"leds\":{\"1\":")                                       \
+  X(JSON_WAIT_LED2, ",\"2\":")                                                 \
+  X(JSON_CLOSE2, "}}")                                                         \
+  X(JSON_ERROR_BUSY, "{\"error\":\"Too many waiters\"}")                       \
+  X(JSON_ERROR_RATE_LIMITED, "{\"error\":\"Too many requests\"}")              \
+  X(HTTP_RETRY_AFTER, "Retry-After")                                           \
+  X(RETRY_AFTER_SECONDS, "1")                                                  \
+  X(STATUS_KEY_WIFI, "wifi_connected")                                         \
+  X(STATUS_KEY_UPTIME, "uptime")                                               \
+  X(STATUS_KEY_FREE_HEAP, "free_heap")                                         \
+  X(STATUS_KEY_LEDS, "leds")                                                   \
+  X(STATUS_KEY_LED1, "1")                                                      \
+  X(STATUS_KEY_LED2, "2")                                                      \
+  X(STATUS_KEY_TIMESTAMP, "timestamp")                                         \
+  X(STATUS_SHORT_WIFI, "w")                                                    \
+  X(STATUS_SHORT_UPTIME, "u")                                                  \
+  X(STATUS_SHORT_FREE_HEAP, "h")                                               \
+  X(STATUS_SHORT_LEDS, "l")                                                    \
+  X(STATUS_SHORT_TIMESTAMP, "t")                                               \
+                                                                               \
+  /* HTTP server */                                                            \
+  X(HTTP_METHOD_GET, "GET")                                                    \
+  X(HTTP_METHOD_HEAD, "HEAD")                                                  \
+  X(HTTP_METHOD_POST, "POST")                                                  \
+  X(HTTP_METHOD_PUT, "PUT")                                                    \
+  X(HTTP_METHOD_PATCH, "PATCH")                                                \
+  X(HTTP_METHOD_DELETE, "DELETE")                                              \
+  X(HTTP_METHOD_OPTIONS, "OPTIONS")                                            \
+  X(HTTP_VERSION_1, "HTTP/1.")                                                 \
+  X(HTTP_CONTENT_LENGTH, "Content-Length")                                     \
+  X(HTTP_CONTENT_TYPE, "Content-Type")                                         \
+  X(HTTP_CONNECTION, "Connection")                                             \
+  X(HTTP_TRANSFER_ENCODING, "Transfer-Encoding")                               \
+  X(HTTP_CLOSE, "close")                                                       \
+  X(HTTP_KEEP_ALIVE, "keep-alive")                                             \
+  X(HTTP_CHUNKED, "chunked")                                                   \
+  X(HTTP_HEADER_SEPARATOR, ": ")                                               \
+  X(HTTP_CRLF, "\r\n")                                                         \
+  X(HTTP_LAST_CHUNK, "0\r\n\r\n")                                              \
+  X(FMT_HTTP_STATUS, "HTTP/1.%d %d ")                                          \
+  X(FMT_HTTP_CHUNK, "%x\r\n")                                                  \
+  X(MIME_FORM, "application/x-www-form-urlencoded")                            \
+  X(MIME_PLAIN, "text/plain")                                                  \
+  X(HTTP_NOT_FOUND, "Not found")                                               \
+  X(HTTP_ROUTES_FULL, "HTTP route table full, dropped: ")                      \
+  X(REASON_200, "OK")                                                          \
+  X(REASON_204, "No Content")                                                  \
+  X(REASON_304, "Not Modified")                                                \
+  X(REASON_400, "Bad Request")                                                 \
+  X(REASON_404, "Not Found")                                                   \
+  X(REASON_408, "Request Timeout")                                             \
+  X(REASON_413, "Payload Too Large")                                           \
+  X(REASON_414, "URI Too Long")                                                \
+  X(REASON_429, "Too Many Requests")                                           \
+  X(REASON_500, "Internal Server Error")                                       \
+  X(REASON_503, "Service Unavailable")                                         \
+  X(HTTP_ETAG, "ETag")                                                         \
+  X(HTTP_IF_NONE_MATCH, "If-None-Match")                                       \
+  X(HTTP_CACHE_CONTROL, "Cache-Control")                                       \
+  X(HTTP_NO_CACHE, "no-cache")                                                 \
+  X(FMT_ETAG, "\"%lx-%lx-%x\"")                                                \
+  X(ETAG_ANY, "*")                                                             \
+                                                                               \
+  /* Analog bindings */                                                        \
+  X(URI_BINDINGS, "/api/bindings")                                             \
+  X(ARG_LED, "led")                                                            \
+  X(ARG_MODE, "mode")                                                          \
+  X(ARG_CURVE, "curve")                                                        \
+  X(ARG_POINTS, "points")                                                      \
+  X(ARG_ON, "on")                                                              \
+  X(ARG_OFF, "off")                                                            \
+  X(BINDING_OFF, "off")                                                        \
+  X(BINDING_LEVEL, "level")                                                    \
+  X(BINDING_SWITCH, "switch")                                                  \
+  X(CURVE_LINEAR, "linear")                                                    \
+  X(CURVE_GAMMA, "gamma")                                                      \
+  X(CURVE_INVERTED, "inverted")                                                \
+  X(CURVE_CUSTOM, "custom")                                                    \
+  X(FMT_JSON_BINDINGS, "{\"period_us\":%lu,\"samples\":%lu,"                   \
+                       "\"worst_us\":%lu,\"bindings\":[")                      \
+  X(FMT_JSON_BINDING, "{\"output\":%u,\"input\":%u,\"reading\":%u,"            \
+                      "\"value\":%d,\"mode\":\"")                              \
+  X(FMT_JSON_BINDING_SWITCH, "\",\"on\":%u,\"off\":%u}")                       \
+  X(JSON_BINDING_CURVE, "\",\"curve\":\"")                                     \
+  X(JSON_BINDING_POINTS, "\",\"points\":[")                                    \
+  X(JSON_ERROR_BAD_BINDING, "{\"error\":\"Invalid binding\"}")                 \
+  X(RED_LED_BINDING, "Red LED binding: ")                                      \
+  X(GREEN_LED_BINDING, "Green LED binding: ")                                  \
+  /* Display / LEDs */                                                         \
+  X(FMT_DISPLAY_PINS, "Using SDA: D%d (GPIO%d), SCL: D%d (GPIO%d)\n")          \
+  X(OLED_INIT, "Initializing OLED display...")                                 \
+  X(OLED_FAILED, "SSD1306 allocation failed - Check wiring!")                  \
+  X(OLED_WIRING, "Make sure OLED is connected to:")                            \
+  X(FMT_WIRING_SDA, "  SDA -> D%d (GPIO%d)\n")                                 \
+  X(FMT_WIRING_SCL, "  SCL -> D%d (GPIO%d)\n")                                 \
+  X(WIRING_VCC, "  VCC -> 3.3V")                                               \
+  X(WIRING_GND, "  GND -> GND")                                                \
+  X(OLED_READY, "OLED Display initialized successfully!")                      \
+  X(LEDS_READY, "LEDs initialized")                                            \
+  X(LIBRARY_READY, "WorkshopESP initialized successfully!")                    \
+  X(READY_FOR_WORKSHOP_BANNER, "Ready for Workshop!")                          \
+  X(RED_LED_TOGGLED, "Red LED toggled to: ")                                   \
+  X(GREEN_LED_TOGGLED, "Green LED toggled to: ")                               \
+  X(RED_LED_SET, "Red LED set to: ")                                           \
+  X(GREEN_LED_SET, "Green LED set to: ")                                       \
+  X(RED_LED_LABEL, "Red LED: ")                                                \
+  X(GREEN_LED_LABEL, "Green LED: ")                                            \
+  X(MEMBERS, "Members:")                                                       \
+  X(MEMBER_1, "Member 1")                                                      \
+  X(MEMBER_2, "Member 2")                                                      \
+  X(WELCOME, "Welcome")                                                        \
+  X(STATUS_WIFI_CONNECTED, "WiFi: Connected")                                  \
+  X(STATUS_WIFI_DISCONNECTED, "WiFi: Disconnected")                            \
+  X(FMT_STATUS_SIGNAL, "Signal: %ld dBm")                                      \
+  X(FMT_STATUS_UPTIME, "Uptime: %ld s")                                        \
+  X(FMT_STATUS_FREE_HEAP, "Free Heap: %ld")                                    \
+  X(DISPLAY_DISABLED, "Display disabled - message: ")                          \
+                                                                               \
+  /* Animations */                                                             \
+  X(HELLO, "Hello")                                                            \
+  X(ANIMATION_START, "Starting animation sequence...")                         \
+  X(FMT_LOADING, "Loading: %d%%")                                              \
+  X(BAR_OPEN, "[")                                                             \
+  X(BAR_FILL, "=")                                                             \
+  X(BAR_EMPTY, " ")                                                            \
+  X(BAR_CLOSE, "]")                                                            \
+  X(CURSOR, "_")                                                               \
+  X(WELCOME_BANNER, "Welcome!")                                                \
+  X(FMT_MEMBER, "-- %s")                                                       \
+  X(LIGHT_SHOW, "LED Light Show")                                              \
+  X(WATCH_LEDS, "Watch the LEDs!")                                             \
+  X(RED_LED_ON, "Red LED ON")                                                  \
+  X(GREEN_LED_ON, "Green LED ON")                                              \
+  X(BOTH_LEDS_ON, "Both LEDs ON")                                              \
+  X(LEDS_OFF, "LEDs OFF")                                                      \
+  X(SYSTEM_STATUS, "System Status")                                            \
+  X(FMT_UPTIME, "Uptime: %lu s")                                               \
+  X(FMT_FREE_RAM, "Free RAM: %u")                                              \
+  X(WIFI_READY, "WiFi: Ready")                                                 \
+  X(OLED_WORKING, "OLED: Working")                                             \
+  X(SYSTEM_GO, "System: GO!")                                                  \
+  X(STARTING_IN, "Starting in")                                                \
+  X(FMT_COUNTDOWN, "%d")                                                       \
+  X(LETS_GO, "LET'S GO!")                                                      \
+  X(ANIMATION_DONE, "WOW animation sequence complete!")                        \
+  X(FMT_ANIMATION_FRAMES, "Frames: %u, %u dropped, %.1f fps, worst %u us\n")   \
+                                                                               \
+  /* System info */                                                            \
+  X(SYSINFO_HEADER, "=== System Information ===")                              \
+  X(SYSINFO_WIFI_STATUS, "WiFi Status: ")                                      \
+  X(CONNECTED, "Connected")                                                    \
+  X(DISCONNECTED, "Disconnected")                                              \
+  X(FMT_SYSINFO_IP, "IP Address: %s\n")                                        \
+  X(FMT_SYSINFO_MAC, "MAC Address: %s\n")                                      \
+  X(FMT_SYSINFO_SIGNAL, "Signal Strength: %d dBm\n")                           \
+  X(FMT_SYSINFO_CONNECT_TIME, "WiFi Connect Time: %lu ms ")                    \
+  X(FMT_SYSINFO_UPTIME, "Uptime: %lu seconds\n")                               \
+  X(FMT_SYSINFO_ARENA, "Request arena: %u of %u bytes peak, %lu failed\n")     \
+  X(FMT_SYSINFO_HTTP, "HTTP: %lu requests, %lu conns, %u open, %u parked\n")   \
+  X(FMT_SYSINFO_STATUS_CACHE, "Status cache: %lu hits, %lu renders\n")         \
+  X(FMT_SYSINFO_RATE_LIMIT, "Rate limited: %lu read, %lu write, %u IPs\n")     \
+  X(FMT_SYSINFO_LOG, "Log: %u of %u bytes queued, %lu lines dropped\n")        \
+  X(FMT_SYSINFO_TRACE, "Trace: %u of %u bytes queued, %lu events dropped\n")   \
+  X(TRACE_HEX_PREFIX, "#wtr ")                                                 \
+  X(SYSINFO_FOOTER, "==========================")                              \
+  X(HEAP, "Heap")                                                              \
+  X(HEAP_BEFORE_BEGIN, "Heap before begin()")                                  \
+  X(HEAP_AFTER_BEGIN, "Heap after begin()")                                    \
+  X(FMT_HEAP_STATS,                                                            \
+    ": %u bytes free, largest block %u, fragmentation %u%%")                   \
+                                                                               \
+  /* Boot trace phases and report */                                           \
+  X(PHASE_BEGIN, "begin")                                                      \
+  X(PHASE_SETUP_WIFI, "setupWiFi")                                             \
+  X(PHASE_WIFI_CONNECT, "wifi.connect")                                        \
+  X(PHASE_WIFI_FAST_CONNECT, "wifi.fastConnect")                               \
+  X(PHASE_SETUP_WIFI_AP, "setupWiFiAP")                                        \
+  X(PHASE_SETUP_WEB_SERVER, "setupWebServer")                                  \
+  X(PHASE_SETUP_DISPLAY, "setupDisplay")                                       \
+  X(PHASE_SETUP_LEDS, "setupLEDs")                                             \
+  X(PHASE_START, "start")                                                      \
+  X(PHASE_ANIMATE_HELLO, "animateHello")                                       \
+  X(PHASE_TEAM_WELCOME, "animateTeamWelcome")                                  \
+  X(PHASE_COMPLETE_ANIMATION, "playCompleteAnimation")                         \
+  X(BOOT_HEADER, "=== Boot Phases ===")                                        \
+  X(BOOT_COLUMNS, "  start ms   time ms  phase")                               \
+  X(FMT_BOOT_ROW, "%9lu %9lu  ")                                               \
+  X(BOOT_INDENT, "  ")                                                         \
+  X(FMT_BOOT_PHASE_OVER, "  <-- over %lu ms budget")                           \
+  X(FMT_BOOT_DROPPED, "(%u phases not recorded, table full)\n")                \
+  X(FMT_BOOT_TOTAL, "Time to ready: %lu ms (budget %lu ms)")                   \
+  X(BOOT_OVER_BUDGET, "  <-- OVER BUDGET")                                     \
+  X(BOOT_FOOTER, "===================")                                        \
+  X(JSON_BOOT_READY, "{\"ready\":")                                            \
+  X(FMT_JSON_BOOT_TIMES, ",\"time_to_ready_ms\":%lu,\"budget_ms\":%lu,"        \
+                         "\"over_budget\":")                                   \
+  X(FMT_JSON_BOOT_DROPPED, ",\"dropped\":%u,\"phases\":[")                     \
+  X(JSON_BOOT_PHASE_NAME, "{\"name\":\"")                                      \
+  X(FMT_JSON_BOOT_PHASE, "\",\"depth\":%u,\"start_us\":%lu,"                   \
+                         "\"duration_us\":%lu,\"budget_us\":%lu}")             \
+  X(JSON_COMMA, ",")                                                           \
+  X(JSON_ARRAY_OBJECT_CLOSE, "]}")
+
+namespace Text {
+
+#define WORKSHOP_TEXT_DECLARE(name, text)                                      \
+  extern const char name##_P[];                                                \
+  constexpr FlashString name{name##_P};
+WORKSHOP_TEXT_TABLE(WORKSHOP_TEXT_DECLARE)
+#undef WORKSHOP_TEXT_DECLARE
+
+// Dashboard page served at /
+extern const char DASHBOARD_HTML_P[];
+constexpr FlashString DASHBOARD_HTML{DASHBOARD_HTML_P};
+
+inline FlashString onOff(bool state) { return state ? ON : OFF; }
+inline FlashString jsonBool(bool value) {
+  return value ? JSON_TRUE : JSON_FALSE;
+}
+
+} // namespace Text
+
+#endif
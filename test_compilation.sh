@@ -1,6 +1,11 @@
 #!/bin/bash
 echo "🔨 Testing compilation..."
 
+if ! python3 tools/check_flash_strings.py; then
+    echo "❌ Library text must live in flash - see src/workshop_strings.h"
+    exit 1
+fi
+
 if pio run --environment nodemcuv2; then
     echo "✅ Compilation successful!"
     echo "   Your code is working fine - linting errors are just IDE issues"
@@ -8,3 +13,13 @@ else
     echo "❌ Compilation failed - there are real code issues"
     echo "   Check the error messages above"
 fi
+
+echo "🖥️  Testing host (native) build..."
+
+if pio run --environment native_bench && \
+    .pio/build/native_bench/program --soak 100000 > /dev/null; then
+    echo "✅ Host build and heap soak passed"
+    echo "   Benchmarks: .pio/build/native_bench/program"
+else
+    echo "❌ Host build or heap soak failed"
+fi
@@ -0,0 +1,123 @@
+#!/usr/bin/env python3
+"""Fail the build if library sources use string literals that land in RAM.
+
+On the ESP8266 a plain "..." literal is copied into DRAM at boot. Library
+text belongs in the flash string table (src/workshop_strings.h) or inside
+PSTR()/F(). Allowed without a wrapper:
+  - the empty string ""
+  - #include lines
+  - lines ending in a // flash-ok comment
+
+Runs standalone (python3 tools/check_flash_strings.py [files...]) or as a
+PlatformIO pre: extra script.
+"""
+
+import os
+import re
+import sys
+
+try:
+    ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+except NameError:
+    ROOT = os.getcwd()  # SCons does not set __file__; fixed up below
+SRC = os.path.join(ROOT, "src")
+
+# Sketch entry point and the table itself are exempt, as is the trace
+# event table, whose format strings are only read by tools/trace_decode.py
+EXEMPT = {"main.cpp", "workshop_strings.h", "workshop_strings.cpp",
+          "trace_events.h"}
+WRAPPERS = {"PSTR", "F"}
+
+
+def library_sources():
+    for name in sorted(os.listdir(SRC)):
+        if name.endswith((".cpp", ".h")) and name not in EXEMPT:
+            yield os.path.join(SRC, name)
+
+
+def ram_literals(path):
+    """Yields (line number, literal) for every unwrapped literal."""
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    lines = text.split("\n")
+
+    parens = []  # identifier before each open '('
+    ident = ""
+    i = 0
+    line = 1
+    while i < len(text):
+        c = text[i]
+        if c == "\n":
+            line += 1
+        if text.startswith("//", i):
+            i = text.find("\n", i)
+            if i < 0:
+                break
+            continue
+        if text.startswith("/*", i):
+            end = text.find("*/", i + 2)
+            line += text.count("\n", i, end)
+            i = end + 2
+            continue
+        if c == "#" and text[text.rfind("\n", 0, i) + 1:i].strip() == "":
+            # Preprocessor line; only #include carries quotes we accept
+            end = text.find("\n", i)
+            directive = text[i:end if end >= 0 else len(text)]
+            if not directive.lstrip("# \t").startswith("include"):
+                for m in re.finditer(r'"(?:[^"\\]|\\.)*"', directive):
+                    if m.group(0) != '""':
+                        yield line, m.group(0)
+            i = end if end >= 0 else len(text)
+            continue
+        if c == "'":
+            m = re.match(r"'(?:[^'\\]|\\.)*'", text[i:])
+            i += len(m.group(0)) if m else 1
+            ident = ""
+            continue
+        if c == '"':
+            m = re.match(r'"(?:[^"\\\n]|\\.)*"', text[i:])
+            literal = m.group(0)
+            wrapped = any(p in WRAPPERS for p in parens)
+            tagged = lines[line - 1].rstrip().endswith("// flash-ok")
+            if literal != '""' and not wrapped and not tagged:
+                yield line, literal
+            i += len(literal)
+            ident = ""
+            continue
+        if c.isalnum() or c == "_":
+            ident += c
+        elif c == "(":
+            parens.append(ident)
+            ident = ""
+        elif c == ")":
+            if parens:
+                parens.pop()
+            ident = ""
+        elif not c.isspace():
+            ident = ""
+        i += 1
+
+
+def check(paths):
+    failures = 0
+    for path in paths:
+        for line, literal in ram_literals(path):
+            rel = os.path.relpath(path, ROOT)
+            print("%s:%d: RAM string literal %s - add it to "
+                  "src/workshop_strings.h or wrap it in PSTR()/F()"
+                  % (rel, line, literal))
+            failures += 1
+    return failures
+
+
+if __name__ == "__main__":
+    sys.exit(1 if check(sys.argv[1:] or list(library_sources())) else 0)
+else:
+    # PlatformIO extra_scripts = pre:tools/check_flash_strings.py
+    Import("env")  # noqa: F821 - provided by SCons
+
+    ROOT = env.subst("$PROJECT_DIR")  # noqa: F821
+    SRC = os.path.join(ROOT, "src")
+    if check(list(library_sources())):
+        print("Flash string check failed")
+        env.Exit(1)  # noqa: F821
@@ -0,0 +1,500 @@
+// HTTP load generator for the host-built WorkshopESP server.
+//
+// Simulates N open dashboards, each doing what handleRoot()'s page does:
+// load the page, poll /api/status every 2 s, and now and then toggle an
+// LED (POST /api/led/<n>/toggle followed by a status refresh). Reports
+// throughput and latency percentiles and can compare them to a baseline.
+//
+//   loadgen [--port 8080] [--clients 10] [--duration 30] [--speed 1]
+//           [--sweep 1,10,50] [--baseline file] [--write-baseline file]
+//           [--close]
+//
+// --speed N divides every think time by N, to push past the real polling
+// rate and find where latency falls apart. Like a browser, each dashboard
+// keeps its connection open between requests; --close opens a new one per
+// request instead.
+
+#include <arpa/inet.h>
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+  const char *host = "127.0.0.1";
+  int port = 8080;
+  int clients = 10;
+  double duration = 30;
+  double speed = 1;
+  std::vector<int> sweep;
+  const char *baseline = nullptr;
+  const char *writeBaseline = nullptr;
+  double tolerance = 0.25;
+  bool keepAlive = true;
+};
+
+// Dashboard JS timings (handleRoot)
+const double POLL_INTERVAL_S = 2.0;
+const double TOGGLE_MEAN_S = 15.0; // a click every ~15 s per open page
+const double REQUEST_TIMEOUT_S = 10.0;
+
+enum RequestKind { PAGE, STATUS, TOGGLE, KIND_COUNT };
+const char *KIND_NAMES[KIND_COUNT] = {"page", "status", "toggle"};
+
+struct Request {
+  RequestKind kind;
+  std::string text;
+  double dueAt; // intended send time; latency is measured from here
+};
+
+struct Dashboard {
+  std::deque<Request> queue;
+  double nextPoll = 0;
+  double nextToggle = 0;
+
+  int fd = -1;
+  bool reused = false; // fd has carried a request before
+
+  // In-flight request
+  bool active = false;
+  bool retried = false;
+  size_t sent = 0;
+  std::string response;
+};
+
+struct Result {
+  int clients = 0;
+  double seconds = 0;
+  uint64_t completed = 0;
+  uint64_t errors = 0;
+  uint64_t perKind[KIND_COUNT] = {};
+  std::vector<uint32_t> latencyUs;
+
+  double throughput() const { return seconds > 0 ? completed / seconds : 0; }
+  uint32_t percentile(double p) const {
+    if (latencyUs.empty())
+      return 0;
+    size_t index = (size_t)(p * (latencyUs.size() - 1) + 0.5);
+    return latencyUs[index];
+  }
+};
+
+double now() {
+  static const auto start = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                       start)
+      .count();
+}
+
+std::string get(const Options &options, const char *path) {
+  return std::string("GET ") + path + " HTTP/1.1\r\nHost: workshop\r\n" +
+         (options.keepAlive ? "" : "Connection: close\r\n") + "\r\n";
+}
+
+std::string post(const Options &options, const char *path) {
+  return std::string("POST ") + path + " HTTP/1.1\r\nHost: workshop\r\n" +
+         (options.keepAlive ? "" : "Connection: close\r\n") +
+         "Content-Length: 0\r\n\r\n";
+}
+
+// True once the headers and Content-Length bytes of body are in
+bool responseComplete(const std::string &response, bool *serverCloses) {
+  size_t end = response.find("\r\n\r\n");
+  if (end == std::string::npos)
+    return false;
+  std::string head = response.substr(0, end);
+  for (char &c : head)
+    c = tolower(c);
+  *serverCloses = head.find("\r\nconnection: close") != std::string::npos;
+  size_t length = head.find("\r\ncontent-length:");
+  if (length == std::string::npos)
+    return false; // read until close
+  size_t body = strtoul(head.c_str() + length + 17, nullptr, 10);
+  return response.size() >= end + 4 + body;
+}
+
+void closeConnection(Dashboard &dash) {
+  close(dash.fd);
+  dash.fd = -1;
+  dash.reused = false;
+}
+
+int openConnection(const Options &options) {
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  if (fd < 0)
+    return -1;
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+
+  sockaddr_in addr = {};
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(options.port);
+  inet_pton(AF_INET, options.host, &addr.sin_addr);
+  if (connect(fd, (sockaddr *)&addr, sizeof(addr)) < 0 &&
+      errno != EINPROGRESS) {
+    close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+void finish(Dashboard &dash, Result &result, bool ok, bool keepOpen) {
+  const Request &request = dash.queue.front();
+  int code = 0;
+  if (ok && dash.response.compare(0, 5, "HTTP/") == 0) {
+    size_t space = dash.response.find(' ');
+    if (space != std::string::npos)
+      code = atoi(dash.response.c_str() + space + 1);
+  }
+
+  if (code >= 200 && code < 300) {
+    result.completed++;
+    result.perKind[request.kind]++;
+    result.latencyUs.push_back((uint32_t)((now() - request.dueAt) * 1e6));
+  } else {
+    result.errors++;
+  }
+
+  if (keepOpen && ok)
+    dash.reused = true;
+  else
+    closeConnection(dash);
+  dash.active = false;
+  dash.retried = false;
+  dash.sent = 0;
+  dash.response.clear();
+  dash.queue.pop_front();
+}
+
+// A kept-alive connection the server closed just as the request went out
+// is retried once on a new one, as a browser does
+bool retryStale(Dashboard &dash, const Options &options) {
+  if (!dash.reused || dash.retried || !dash.response.empty())
+    return false;
+  closeConnection(dash);
+  dash.fd = openConnection(options);
+  dash.retried = true;
+  dash.sent = 0;
+  return dash.fd >= 0;
+}
+
+Result run(const Options &options, int clients) {
+  std::mt19937 random(12345 + clients);
+  std::exponential_distribution<double> toggleGap(options.speed /
+                                                  TOGGLE_MEAN_S);
+  std::uniform_real_distribution<double> jitter(0, POLL_INTERVAL_S /
+                                                       options.speed);
+  double pollInterval = POLL_INTERVAL_S / options.speed;
+
+  std::vector<Dashboard> dashboards(clients);
+  double start = now();
+  for (Dashboard &dash : dashboards) {
+    // Pages open at random points in the first polling period
+    double opened = start + jitter(random);
+    dash.queue.push_back({PAGE, get(options, "/"), opened});
+    dash.queue.push_back({STATUS, get(options, "/api/status"), opened});
+    dash.nextPoll = opened + pollInterval;
+    dash.nextToggle = opened + toggleGap(random);
+  }
+
+  Result result;
+  result.clients = clients;
+  double end = start + options.duration;
+  std::vector<pollfd> fds;
+  std::vector<Dashboard *> owners;
+
+  while (true) {
+    double t = now();
+    bool running = t < end;
+    bool busy = false;
+
+    // Schedule the page's timers and start queued requests
+    for (Dashboard &dash : dashboards) {
+      if (running) {
+        while (dash.nextPoll <= t) {
+          dash.queue.push_back(
+              {STATUS, get(options, "/api/status"), dash.nextPoll});
+          dash.nextPoll += pollInterval;
+        }
+        while (dash.nextToggle <= t) {
+          const char *path = (random() & 1) ? "/api/led/1/toggle"
+                                            : "/api/led/2/toggle";
+          dash.queue.push_back(
+              {TOGGLE, post(options, path), dash.nextToggle});
+          dash.queue.push_back(
+              {STATUS, get(options, "/api/status"), dash.nextToggle});
+          dash.nextToggle += toggleGap(random);
+        }
+      }
+      bool due = !dash.queue.empty() && dash.queue.front().dueAt <= t;
+      if (!dash.active && due) {
+        if (dash.fd < 0)
+          dash.fd = openConnection(options);
+        if (dash.fd < 0) {
+          result.errors++;
+          dash.queue.pop_front();
+        } else {
+          dash.active = true;
+        }
+      }
+      if (dash.active && t - dash.queue.front().dueAt > REQUEST_TIMEOUT_S)
+        finish(dash, result, false, false);
+      busy = busy || dash.active;
+    }
+
+    if (!running && !busy) {
+      for (Dashboard &dash : dashboards) {
+        if (dash.fd >= 0)
+          closeConnection(dash);
+      }
+      break;
+    }
+
+    fds.clear();
+    owners.clear();
+    for (Dashboard &dash : dashboards) {
+      if (dash.fd < 0)
+        continue;
+      // Idle kept-alive connections are watched for the server closing them
+      bool writing =
+          dash.active && dash.sent < dash.queue.front().text.size();
+      fds.push_back({dash.fd, (short)(writing ? POLLOUT : POLLIN), 0});
+      owners.push_back(&dash);
+    }
+    poll(fds.data(), fds.size(), 1);
+
+    for (size_t i = 0; i < fds.size(); i++) {
+      Dashboard &dash = *owners[i];
+      if (fds[i].revents == 0)
+        continue;
+      char buffer[4096];
+      if (!dash.active) {
+        ssize_t n = recv(dash.fd, buffer, sizeof(buffer), 0);
+        if (n == 0 || (n < 0 && errno != EAGAIN))
+          closeConnection(dash);
+        continue;
+      }
+
+      const std::string &text = dash.queue.front().text;
+      if (dash.sent < text.size()) {
+        ssize_t n = send(dash.fd, text.data() + dash.sent,
+                         text.size() - dash.sent, MSG_NOSIGNAL);
+        if (n > 0)
+          dash.sent += n;
+        else if (n < 0 && errno != EAGAIN && !retryStale(dash, options))
+          finish(dash, result, false, false);
+        continue;
+      }
+
+      ssize_t n = recv(dash.fd, buffer, sizeof(buffer), 0);
+      bool serverCloses = false;
+      if (n > 0) {
+        dash.response.append(buffer, n);
+        if (responseComplete(dash.response, &serverCloses))
+          finish(dash, result, true, options.keepAlive && !serverCloses);
+      } else if (n == 0 || errno != EAGAIN) {
+        if (!retryStale(dash, options))
+          finish(dash, result, n == 0, false);
+      }
+    }
+  }
+
+  result.seconds = now() - start;
+  std::sort(result.latencyUs.begin(), result.latencyUs.end());
+  return result;
+}
+
+void printHeader() {
+  printf("%8s %10s %10s %10s %10s %10s %8s\n", "clients", "req/s", "p50 ms",
+         "p99 ms", "p999 ms", "max ms", "errors");
+}
+
+void printResult(const Result &r) {
+  printf("%8d %10.1f %10.2f %10.2f %10.2f %10.2f %8llu\n", r.clients,
+         r.throughput(), r.percentile(0.50) / 1000.0,
+         r.percentile(0.99) / 1000.0, r.percentile(0.999) / 1000.0,
+         r.latencyUs.empty() ? 0 : r.latencyUs.back() / 1000.0,
+         (unsigned long long)r.errors);
+}
+
+// Baseline file: "key value" lines, # comments
+struct Baseline {
+  double throughput = 0;
+  double p50 = 0;
+  double p99 = 0;
+  double p999 = 0;
+};
+
+bool readBaseline(const char *path, Baseline &baseline) {
+  FILE *file = fopen(path, "r");
+  if (file == nullptr)
+    return false;
+  char line[256];
+  while (fgets(line, sizeof(line), file)) {
+    char key[64];
+    double value;
+    if (line[0] == '#' || sscanf(line, "%63s %lf", key, &value) != 2)
+      continue;
+    if (strcmp(key, "throughput_rps") == 0)
+      baseline.throughput = value;
+    else if (strcmp(key, "p50_us") == 0)
+      baseline.p50 = value;
+    else if (strcmp(key, "p99_us") == 0)
+      baseline.p99 = value;
+    else if (strcmp(key, "p999_us") == 0)
+      baseline.p999 = value;
+  }
+  fclose(file);
+  return true;
+}
+
+bool writeBaseline(const char *path, const Options &options,
+                   const Result &r) {
+  FILE *file = fopen(path, "w");
+  if (file == nullptr)
+    return false;
+  fprintf(file, "# loadgen baseline: clients=%d duration=%.0f speed=%.0f\n",
+          r.clients, options.duration, options.speed);
+  fprintf(file, "throughput_rps %.1f\n", r.throughput());
+  fprintf(file, "p50_us %u\n", r.percentile(0.50));
+  fprintf(file, "p99_us %u\n", r.percentile(0.99));
+  fprintf(file, "p999_us %u\n", r.percentile(0.999));
+  fclose(file);
+  return true;
+}
+
+// Latency may grow and throughput may drop by `tolerance` (p999 gets
+// twice that, it is the noisiest number)
+int compare(const Baseline &base, const Result &r, double tolerance) {
+  struct {
+    const char *name;
+    double baseline;
+    double current;
+    double limit;
+    bool higherIsBetter;
+  } checks[] = {
+      {"throughput", base.throughput, r.throughput(), tolerance, true},
+      {"p50", base.p50, (double)r.percentile(0.50), tolerance, false},
+      {"p99", base.p99, (double)r.percentile(0.99), tolerance, false},
+      {"p999", base.p999, (double)r.percentile(0.999), tolerance * 2, false},
+  };
+
+  int regressions = 0;
+  for (auto &check : checks) {
+    if (check.baseline <= 0)
+      continue;
+    double change = (check.current - check.baseline) / check.baseline;
+    bool bad = check.higherIsBetter ? change < -check.limit
+                                    : change > check.limit;
+    printf("%-10s baseline %10.1f  now %10.1f  %+6.1f%%%s\n", check.name,
+           check.baseline, check.current, change * 100,
+           bad ? "  REGRESSION" : "");
+    regressions += bad;
+  }
+  if (r.errors)
+    printf("errors     %llu  REGRESSION\n", (unsigned long long)r.errors);
+  return regressions + (r.errors ? 1 : 0);
+}
+
+void usage(const char *name) {
+  fprintf(stderr,
+          "usage: %s [--host ip] [--port n] [--clients n] [--duration s]\n"
+          "          [--speed x] [--sweep n,n,...] [--baseline file]\n"
+          "          [--write-baseline file] [--tolerance fraction]\n"
+          "          [--close]\n",
+          name);
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+  Options options;
+  for (int i = 1; i < argc; i++) {
+    const char *arg = argv[i];
+    if (strcmp(arg, "--close") == 0) {
+      options.keepAlive = false;
+      continue;
+    }
+    const char *value = i + 1 < argc ? argv[i + 1] : nullptr;
+    if (value == nullptr) {
+      usage(argv[0]);
+      return 2;
+    }
+    i++;
+    if (strcmp(arg, "--host") == 0)
+      options.host = value;
+    else if (strcmp(arg, "--port") == 0)
+      options.port = atoi(value);
+    else if (strcmp(arg, "--clients") == 0)
+      options.clients = std::max(1, atoi(value));
+    else if (strcmp(arg, "--duration") == 0)
+      options.duration = atof(value);
+    else if (strcmp(arg, "--speed") == 0)
+      options.speed = std::max(0.01, atof(value));
+    else if (strcmp(arg, "--baseline") == 0)
+      options.baseline = value;
+    else if (strcmp(arg, "--write-baseline") == 0)
+      options.writeBaseline = value;
+    else if (strcmp(arg, "--tolerance") == 0)
+      options.tolerance = atof(value);
+    else if (strcmp(arg, "--sweep") == 0) {
+      for (const char *p = value; p != nullptr; p = strchr(p, ',')) {
+        if (*p == ',')
+          p++;
+        options.sweep.push_back(std::max(1, atoi(p)));
+      }
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+  }
+
+  if (!options.sweep.empty()) {
+    printHeader();
+    for (int clients : options.sweep)
+      printResult(run(options, clients));
+    return 0;
+  }
+
+  Result result = run(options, options.clients);
+  printHeader();
+  printResult(result);
+  printf("mix:");
+  for (int k = 0; k < KIND_COUNT; k++)
+    printf(" %s=%llu", KIND_NAMES[k], (unsigned long long)result.perKind[k]);
+  printf("\n");
+
+  if (options.writeBaseline &&
+      !writeBaseline(options.writeBaseline, options, result)) {
+    fprintf(stderr, "cannot write %s\n", options.writeBaseline);
+    return 2;
+  }
+  if (options.baseline) {
+    Baseline baseline;
+    if (!readBaseline(options.baseline, baseline)) {
+      fprintf(stderr, "cannot read %s\n", options.baseline);
+      return 2;
+    }
+    if (compare(baseline, result, options.tolerance)) {
+      printf("FAILED: regression against %s\n", options.baseline);
+      return 1;
+    }
+    printf("OK: within %.0f%% of %s\n", options.tolerance * 100,
+           options.baseline);
+  }
+  return result.errors ? 1 : 0;
+}
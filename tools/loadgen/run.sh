@@ -0,0 +1,26 @@
+#!/bin/bash
+# Builds the host web server and the load generator, runs the load test
+# and compares it with the stored baseline. Extra arguments go to loadgen,
+# e.g. tools/loadgen/run.sh --sweep 1,10,50,100 --speed 20
+#
+# Record a new baseline (on the machine that runs the check):
+#   tools/loadgen/run.sh --write-baseline tools/loadgen/baseline.txt
+set -e
+cd "$(dirname "$0")/../.."
+
+pio run -e native_http_target -e loadgen
+
+.pio/build/native_http_target/program --quiet &
+TARGET=$!
+trap 'kill $TARGET 2>/dev/null' EXIT
+
+# Wait for the server to listen
+for i in $(seq 50); do
+    (exec 3<>/dev/tcp/127.0.0.1/8080) 2>/dev/null && break
+    sleep 0.1
+done
+
+if [ $# -eq 0 ]; then
+    set -- --baseline tools/loadgen/baseline.txt
+fi
+.pio/build/loadgen/program --clients 20 --duration 20 --speed 10 "$@"
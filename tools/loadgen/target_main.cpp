@@ -0,0 +1,23 @@
+// Host sketch the load generator runs against: just the library's web
+// server with its stock routes, no animations or Wi-Fi setup delays.
+//
+//   pio run -e native_http_target && .pio/build/native_http_target/program
+
+#include <Arduino.h>
+
+#include "workshop_esp.h"
+
+WorkshopESP workshop;
+
+void setup() {
+  workshop.begin();
+  workshop.setupLEDs();
+  workshop.setupWebServer();
+  // Every load generator connection comes from 127.0.0.1; measure the
+  // server, not the per-client limit
+  workshop.limiter().setRate(RATE_READ, 0, 0);
+  workshop.limiter().setRate(RATE_WRITE, 0, 0);
+  workshop.boot().ready(Serial);
+}
+
+void loop() { workshop.handleClient(); }
@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+"""Decode the library's binary event trace into text or a Chrome trace.
+
+The board records events as IDs, time deltas and raw arguments (see
+src/event_trace.h); the names and format strings live only in
+src/trace_events.h, which this script reads. Input is either the bytes
+from GET /api/trace (several responses may be concatenated into one file)
+or a serial capture holding the "#wtr ..." lines written by
+workshopTrace.dump(Serial); other lines in the capture are ignored.
+
+  curl -s http://192.168.1.100/api/trace >> session.wtr   # poll as needed
+  python3 tools/trace_decode.py session.wtr
+  python3 tools/trace_decode.py serial.log --chrome session.json
+
+Open the JSON in chrome://tracing or https://ui.perfetto.dev.
+"""
+
+import argparse
+import json
+import os
+import re
+import struct
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+EVENTS = os.path.join(ROOT, "src", "trace_events.h")
+
+MAGIC = b"WT"
+VERSION = 1
+HEADER = struct.Struct("<2sBBIIH")
+HEX_PREFIX = "#wtr "
+PLACEHOLDER = re.compile(r"%([%udxs])")
+ENTRY = re.compile(
+    r'X\(\s*(\w+)\s*,\s*([BEI])\s*,\s*(\w+)\s*,\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)'
+)
+
+
+class Event:
+    def __init__(self, ident, phase, category, name, fmt):
+        self.ident = ident
+        self.phase = phase
+        self.category = category
+        self.name = name
+        self.fmt = fmt
+        self.kinds = [k for k in PLACEHOLDER.findall(fmt) if k != "%"]
+
+
+def load_events(path):
+    with open(path, encoding="utf-8") as f:
+        text = f.read()
+    start = text.find("#define WORKSHOP_TRACE_EVENTS")
+    if start < 0:
+        sys.exit("%s: no WORKSHOP_TRACE_EVENTS table" % path)
+    return [Event(*m.groups()) for m in ENTRY.finditer(text, start)]
+
+
+def read_chunks(data):
+    """Yields raw chunks from a binary dump or a serial capture."""
+    if data.startswith(MAGIC):
+        yield from split_chunks(data)
+        return
+    for line in data.decode("latin-1").splitlines():
+        at = line.find(HEX_PREFIX)
+        if at < 0:
+            continue
+        try:
+            chunk = bytes.fromhex(line[at + len(HEX_PREFIX):].strip())
+        except ValueError:
+            print("skipping damaged line: %s" % line.strip(), file=sys.stderr)
+            continue
+        yield from split_chunks(chunk)
+
+
+def split_chunks(data):
+    while len(data) >= HEADER.size:
+        magic, version, _, _, _, length = HEADER.unpack_from(data)
+        end = HEADER.size + length
+        if magic != MAGIC or version != VERSION or end > len(data):
+            print("stopping at a damaged chunk", file=sys.stderr)
+            return
+        yield data[:end]
+        data = data[end:]
+
+
+def varint(data, at):
+    value = shift = 0
+    while at < len(data):
+        b = data[at]
+        at += 1
+        value |= (b & 0x7F) << shift
+        shift += 7
+        if not b & 0x80:
+            return value, at
+    raise IndexError("varint runs past the record")
+
+
+def decode_args(event, payload, at):
+    values = []
+    for kind in event.kinds:
+        try:
+            if kind == "s":
+                n = payload[at]
+                if at + 1 + n > len(payload):
+                    raise IndexError
+                values.append(payload[at + 1:at + 1 + n].decode("utf-8", "replace"))
+                at += 1 + n
+            else:
+                raw, at = varint(payload, at)
+                values.append((raw >> 1) ^ -(raw & 1))
+        except IndexError:
+            values.append(None)  # cut on the device
+    return values
+
+
+def format_args(event, values):
+    it = iter(values)
+
+    def sub(m):
+        kind = m.group(1)
+        if kind == "%":
+            return "%"
+        value = next(it, None)
+        if value is None:
+            return "?"
+        if kind == "x":
+            return "%x" % value
+        return str(value)
+
+    return PLACEHOLDER.sub(sub, event.fmt)
+
+
+def decode(chunks, events):
+    """Yields (time us, Event, text) with times unwrapped past 2^32 us."""
+    clock = None
+    for chunk in chunks:
+        _, _, count, base, _, _ = HEADER.unpack_from(chunk)
+        if count != len(events):
+            print(
+                "warning: dump has %d event types, table has %d; "
+                "decode with the trace_events.h it was built from" % (count, len(events)),
+                file=sys.stderr,
+            )
+        if clock is None:
+            clock = base
+        else:
+            clock = (clock & ~0xFFFFFFFF) | base
+            if clock < previous - (1 << 31):
+                clock += 1 << 32
+        at = HEADER.size
+        while at + 2 <= len(chunk):
+            ident, length = chunk[at], chunk[at + 1]
+            payload = chunk[at + 2:at + 2 + length]
+            at += 2 + length
+            delta, args_at = varint(payload, 0)
+            clock += delta
+            if ident < len(events):
+                event = events[ident]
+                text = format_args(event, decode_args(event, payload, args_at))
+            else:
+                event = Event("UNKNOWN", "I", "trace", "event%d" % ident, "")
+                text = ""
+            yield clock, event, text
+        previous = clock
+
+
+def write_text(records, out):
+    open_spans = {}  # category -> start times of open B events
+    first = None
+    for ts, event, text in records:
+        if first is None:
+            first = ts
+        suffix = ""
+        stack = open_spans.setdefault(event.category, [])
+        if event.phase == "B":
+            stack.append(ts)
+        elif event.phase == "E" and stack:
+            suffix = "  [%d us]" % (ts - stack.pop())
+        out.write(
+            "%12.3f ms  %-8s %s %-9s %s%s\n"
+            % ((ts - first) / 1000.0, event.category, event.phase,
+               event.name, text, suffix)
+        )
+
+
+def chrome_trace(records):
+    lanes = {}
+    trace = []
+    for ts, event, text in records:
+        tid = lanes.setdefault(event.category, len(lanes) + 1)
+        entry = {
+            "name": event.name,
+            "cat": event.category,
+            "ph": event.phase.lower() if event.phase == "I" else event.phase,
+            "ts": ts,
+            "pid": 1,
+            "tid": tid,
+        }
+        if event.phase == "I":
+            entry["s"] = "t"
+        if text:
+            entry["args"] = {"detail": text}
+        trace.append(entry)
+    for category, tid in lanes.items():
+        trace.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": tid,
+                      "args": {"name": category}})
+    return {"traceEvents": trace, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("inputs", nargs="+",
+                        help="/api/trace dumps or serial captures ('-' = stdin)")
+    parser.add_argument("--events", default=EVENTS,
+                        help="event table (default: src/trace_events.h)")
+    parser.add_argument("--chrome", metavar="FILE",
+                        help="also write a Chrome trace JSON timeline")
+    parser.add_argument("--quiet", action="store_true",
+                        help="no text listing")
+    args = parser.parse_args()
+
+    events = load_events(args.events)
+    chunks = []
+    for name in args.inputs:
+        if name == "-":
+            data = sys.stdin.buffer.read()
+        else:
+            with open(name, "rb") as f:
+                data = f.read()
+        chunks.extend(read_chunks(data))
+    if not chunks:
+        sys.exit("no trace data found")
+
+    records = list(decode(chunks, events))
+    if not args.quiet:
+        write_text(records, sys.stdout)
+    if args.chrome:
+        with open(args.chrome, "w", encoding="utf-8") as f:
+            json.dump(chrome_trace(records), f)
+    _, _, _, _, dropped, _ = HEADER.unpack_from(chunks[-1])
+    print("%d events, %d dropped on the device" % (len(records), dropped),
+          file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()